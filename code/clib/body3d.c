@@ -5,6 +5,7 @@
 
    Copyright (C) 1998 Per Kraulis
     10-Jun-1998  first attempts, generalized from other code
+    18-Oct-2026  shared unit meshes, cached by subdivision
 */
 
 #include "body3d.h"
@@ -17,6 +18,8 @@
 #include <stdlib.h>
 #include <math.h>
 
+#include <angle.h>
+
 
 /*============================================================*/
 static vector3 *icosahedron = NULL;
@@ -25,6 +28,50 @@ static int count;
 static int parts;
 static double fraction;
 
+typedef struct s_unit_mesh unit_mesh;
+
+struct s_unit_mesh {
+  int key;
+  int count;
+  void *data;
+  unit_mesh *next;
+};
+
+static unit_mesh *ico_points = NULL;
+static unit_mesh *ico_faces = NULL;
+static unit_mesh *globes = NULL;
+static unit_mesh *circles = NULL;
+
+
+/*------------------------------------------------------------*/
+static unit_mesh *
+unit_mesh_lookup (unit_mesh *list, int key)
+{
+  for ( ; list; list = list->next) {
+    if (list->key == key) return list;
+  }
+  return NULL;
+}
+
+
+/*------------------------------------------------------------*/
+static unit_mesh *
+unit_mesh_add (unit_mesh **list, int key, int count, void *data)
+{
+  unit_mesh *um;
+
+  assert (list);
+  assert (data);
+
+  um = malloc (sizeof (unit_mesh));
+  um->key = key;
+  um->count = count;
+  um->data = data;
+  um->next = *list;
+  *list = um;
+  return um;
+}
+
 
 /*------------------------------------------------------------*/
 static void
@@ -228,3 +275,185 @@ icosahedron_vertices (void)
 
   return v;
 }
+
+
+/*------------------------------------------------------------*/
+const vector3 *
+sphere_ico_points_get (int level)
+     /*
+       As 'sphere_ico_points', but the array is made once per level
+       and shared; it must not be changed or freed.
+     */
+{
+  unit_mesh *um;
+
+  /* pre */
+  assert (level >= 1);
+
+  um = unit_mesh_lookup (ico_points, level);
+  if (um == NULL)
+    um = unit_mesh_add (&ico_points, level, sphere_ico_point_count (level),
+			sphere_ico_points (level));
+  return um->data;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+ico_faces_divide (vector3 *p1, vector3 *p2, vector3 *p3, int depth)
+{
+  assert (p1);
+  assert (p2);
+  assert (p3);
+
+  if (depth <= 0) {
+    *(current + count++) = *p1;
+    *(current + count++) = *p2;
+    *(current + count++) = *p3;
+
+  } else {
+    vector3 p12, p23, p13;
+    v3_sum (&p12, p1, p2);
+    v3_normalize (&p12);
+    v3_sum (&p23, p2, p3);
+    v3_normalize (&p23);
+    v3_sum (&p13, p1, p3);
+    v3_normalize (&p13);
+    ico_faces_divide (&p13, p1, &p12, depth-1);
+    ico_faces_divide (p3, &p13, &p23, depth-1);
+    ico_faces_divide (&p23, &p13, &p12, depth-1);
+    ico_faces_divide (&p23, &p12, p2, depth-1);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+const vector3 *
+sphere_ico_faces_get (int depth, int *triangles)
+     /*
+       Return the triangles on the unit sphere from recursive division
+       of the icosahedron faces, three points per triangle. The points
+       are also the normals. The array is made once per depth and
+       shared; it must not be changed or freed.
+     */
+{
+  static const int faces[20][3] = {
+    {0, 2, 1}, {0, 1, 4}, {0, 4, 8}, {0, 8, 3}, {0, 3, 2},
+    {9, 5, 7}, {9, 7, 10}, {9, 10, 11}, {9, 11, 6}, {9, 6, 5},
+    {1, 5, 6}, {1, 6, 4}, {6, 11, 4}, {11, 8, 4}, {11, 10, 8},
+    {10, 3, 8}, {10, 7, 3}, {7, 2, 3}, {7, 5, 2}, {5, 1, 2}
+  };
+  unit_mesh *um;
+  int slot, total;
+
+  /* pre */
+  assert (depth >= 0);
+  assert (triangles);
+
+  um = unit_mesh_lookup (ico_faces, depth);
+  if (um == NULL) {
+    if (icosahedron == NULL) icosahedron = icosahedron_vertices();
+    total = 20;
+    for (slot = 0; slot < depth; slot++) total *= 4;
+    current = malloc (3 * total * sizeof (vector3));
+    count = 0;
+    for (slot = 0; slot < 20; slot++) {
+      ico_faces_divide (icosahedron + faces[slot][0],
+			icosahedron + faces[slot][1],
+			icosahedron + faces[slot][2], depth);
+    }
+    assert (count == 3 * total);
+    um = unit_mesh_add (&ico_faces, depth, total, current);
+  }
+
+  *triangles = um->count;
+  return um->data;
+}
+
+
+/*------------------------------------------------------------*/
+const vector3 *
+sphere_globe_points_get (int segments)
+     /*
+       Return the points on the unit sphere for the globe subdivision
+       into segments stacks and 2 * segments slices. The array is made
+       once per segments value and shared; it must not be changed or
+       freed. The points are also the normals. Their order:
+         0                        north pole
+         1 + (stack-1) * slices   start of ring stack = 1 ... stacks-1
+         1 + (stacks-1) * slices  start of the ring of the south cap
+         1 + stacks * slices      south pole
+       Each ring starts at slice 0, which is (sr, 0.0, z) exactly.
+       The south cap ring is computed from the angle of the north cap
+       ring, in the same way as the globe sphere always has been.
+     */
+{
+  unit_mesh *um;
+  vector3 *points, *p;
+  double angle, sr, z;
+  int slices, stacks, slice, stack;
+
+  /* pre */
+  assert (segments >= 2);
+
+  um = unit_mesh_lookup (globes, segments);
+  if (um) return um->data;
+
+  slices = 2 * segments;
+  stacks = segments;
+  p = points = malloc ((2 + stacks * slices) * sizeof (vector3));
+
+  v3_initialize (p++, 0.0, 0.0, 1.0);
+  for (stack = 1; stack <= stacks; stack++) {
+    if (stack < stacks) {
+      angle = (double) stack * ANGLE_PI / (double) stacks;
+      sr = sin (angle);
+      z = cos (angle);
+    } else {
+      angle = ANGLE_PI / (double) stacks;
+      sr = sin (angle);
+      z = - cos (angle);
+    }
+    v3_initialize (p++, sr, 0.0, z);
+    for (slice = 1; slice < slices; slice++) {
+      angle = (double) slice * 2.0 * ANGLE_PI / (double) slices;
+      v3_initialize (p++, sr * cos (angle), sr * sin (angle), z);
+    }
+  }
+  v3_initialize (p++, 0.0, 0.0, -1.0);
+
+  um = unit_mesh_add (&globes, segments, 2 + stacks * slices, points);
+  return um->data;
+}
+
+
+/*------------------------------------------------------------*/
+const double *
+circle_points_get (int segments)
+     /*
+       Return the cosine and sine pairs for the angles 2 pi slot/segments,
+       slot = 0 ... segments-1; for the unit cylinder and disk. The array
+       is made once per segments value and shared; it must not be changed
+       or freed.
+     */
+{
+  unit_mesh *um;
+  double *cs, angle;
+  int slot;
+
+  /* pre */
+  assert (segments >= 1);
+
+  um = unit_mesh_lookup (circles, segments);
+  if (um) return um->data;
+
+  cs = malloc (2 * segments * sizeof (double));
+  for (slot = 0; slot < segments; slot++) {
+    angle = 2.0 * ANGLE_PI * (double) slot / (double) segments;
+    cs[2 * slot] = cos (angle);
+    cs[2 * slot + 1] = sin (angle);
+  }
+
+  um = unit_mesh_add (&circles, segments, segments, cs);
+  return um->data;
+}
@@ -21,4 +21,16 @@ cube_vertices (void);
 vector3 *
 icosahedron_vertices (void);
 
+const vector3 *
+sphere_ico_points_get (int level);
+
+const vector3 *
+sphere_ico_faces_get (int depth, int *triangles);
+
+const vector3 *
+sphere_globe_points_get (int segments);
+
+const double *
+circle_points_get (int segments);
+
 #endif
@@ -12,6 +12,7 @@
 
    Copyright (C) 1997 Per Kraulis
      27-Aug-1997  first attempts
+    18-Oct-2026  table size coprime with probe steps; fixed resize
 */
 
 #include "double_hash.h"
@@ -25,6 +26,20 @@
 #define H2(s) (8 - ((s) % 8))
 
 
+/*------------------------------------------------------------*/
+static int
+table_size (int size)
+     /*
+       The probe step is 1 to 8, so the table size must have no factor
+       in common with any of these, or the probe sequence may cycle
+       without ever reaching an empty slot.
+     */
+{
+  while ((size % 2 == 0) || (size % 3 == 0) ||
+	 (size % 5 == 0) || (size % 7 == 0)) size++;
+  return size;
+}
+
 /*------------------------------------------------------------*/
 dhash_table *
 dhash_create (const int max_entries)
@@ -45,7 +60,7 @@ dhash_create_size (const int size)
 
   new = malloc (sizeof (dhash_table));
   new->count = 0;
-  new->size = size;
+  new->size = table_size (size);
   new->keys = calloc (new->size, sizeof (char *));
   new->objects = calloc (new->size, sizeof (void *));
   new->auto_resize = 0.666666;
@@ -71,18 +86,18 @@ dhash_resize (dhash_table *table, const int new)
   size = table->size;
 
   table->count = 0;
-  table->size = new;
+  table->size = table_size (new);
   table->keys = calloc (table->size, sizeof (char *));
   table->objects = calloc (table->size, sizeof (void *));
 
   for (slot = 0; slot < size; slot++) {
-    dhash_insert (table, keys[slot], objects[slot]);
+    if (keys[slot]) dhash_insert (table, keys[slot], objects[slot]);
   }
 
   free (keys);
   free (objects);
 
-  assert (table->size == new);
+  assert (table->size >= new);
 }
 
 
@@ -7,15 +7,23 @@
      2-Feb-1997  fairly finished
     28-Oct-1997  added tangent routine
     17-Jun-1998  mod's for hgen
+    18-Oct-2026  reentrant evaluation of whole chains using basis tables
 */
 
 #include "hermite_curve.h"
 
 /* public ====================
 #include <vector3.h>
+
+typedef struct {
+  int segments;
+  double *point;
+  double *tangent;
+} hermite_basis;
 ==================== public */
 
 #include <assert.h>
+#include <stdlib.h>
 
 
 /*============================================================*/
@@ -24,6 +32,13 @@ static vector3 p2;
 static vector3 v1;
 static vector3 v2;
 
+typedef struct s_basis_node basis_node;
+
+struct s_basis_node {
+  hermite_basis hb;
+  basis_node *next;
+};
+
 
 /*------------------------------------------------------------*/
 void
@@ -97,3 +112,130 @@ hermite_get_tangent (vector3 *v, double t)
   v->y = p1.y * tp1 + p2.y * tp2 + v1.y * tv1 + v2.y * tv2;
   v->z = p1.z * tp1 + p2.z * tp2 + v1.z * tv1 + v2.z * tv2;
 }
+
+
+/*------------------------------------------------------------*/
+hermite_basis *
+hermite_basis_get (int segments)
+     /*
+       Return the table of the cubic basis values for the parameter
+       values t = segment / segments, segment = 0 ... segments. The
+       tables are kept, one per segments value, and are never changed
+       once created; get them before evaluating curves concurrently.
+     */
+{
+  static basis_node *bases = NULL;
+  basis_node *node;
+  hermite_basis *hb;
+  double t, t2, t3, *b;
+  int slot;
+
+  /* pre */
+  assert (segments >= 1);
+
+  for (node = bases; node; node = node->next) {
+    if (node->hb.segments == segments) return &(node->hb);
+  }
+
+  node = malloc (sizeof (basis_node));
+  hb = &(node->hb);
+  hb->segments = segments;
+  hb->point = malloc (4 * (segments + 1) * sizeof (double));
+  hb->tangent = malloc (4 * (segments + 1) * sizeof (double));
+
+  for (slot = 0; slot <= segments; slot++) {
+    t = ((double) slot) / ((double) segments);
+    t2 = t * t;
+    t3 = t2 * t;
+    b = hb->point + 4 * slot;
+    b[0] = 2.0 * t3 - 3.0 * t2 + 1.0;
+    b[1] = -2.0 * t3 + 3.0 * t2;
+    b[2] = t3 - 2.0 * t2 + t;
+    b[3] = t3 - t2;
+    b = hb->tangent + 4 * slot;
+    b[0] = 6.0 * (t2 - t);
+    b[1] = 6.0 * (-t2 + t);
+    b[2] = 3.0 * t2 - 4.0 * t + 1.0;
+    b[3] = 3.0 * t2 - 2.0 * t;
+  }
+
+  node->next = bases;
+  bases = node;
+
+  return hb;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+evaluate (vector3 *p, const double *basis, int segments,
+	  const vector3 *points, const vector3 *vectors, int count)
+{
+  register const vector3 *ps, *pf, *vs, *vf;
+  register const double *b;
+  int span, segment;
+
+  for (span = 0; span < count - 1; span++) {
+    ps = points + span;
+    pf = ps + 1;
+    vs = vectors + span;
+    vf = vs + 1;
+    b = basis + 4;
+    for (segment = 1; segment < segments; segment++, b += 4) {
+      p++;
+      p->x = ps->x * b[0] + pf->x * b[1] + vs->x * b[2] + vf->x * b[3];
+      p->y = ps->y * b[0] + pf->y * b[1] + vs->y * b[2] + vf->y * b[3];
+      p->z = ps->z * b[0] + pf->z * b[1] + vs->z * b[2] + vf->z * b[3];
+    }
+    p++;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+void
+hermite_evaluate (vector3 *p, const hermite_basis *hb,
+		  const vector3 *points, const vector3 *vectors, int count)
+     /*
+       Evaluate the Hermite curve through the given points, with the
+       given vectors at the points, at all parameter values of the
+       basis table. The (count - 1) * segments + 1 positions are
+       written to p; p[span * segments] is points[span].
+     */
+{
+  int span;
+
+  /* pre */
+  assert (p);
+  assert (hb);
+  assert (points);
+  assert (vectors);
+  assert (count >= 2);
+
+  for (span = 0; span < count; span++) p[span * hb->segments] = points[span];
+  evaluate (p, hb->point, hb->segments, points, vectors, count);
+}
+
+
+/*------------------------------------------------------------*/
+void
+hermite_evaluate_tangents (vector3 *v, const hermite_basis *hb,
+			   const vector3 *points, const vector3 *vectors,
+			   int count)
+     /*
+       Evaluate the tangent vectors of the Hermite curve, as for
+       'hermite_evaluate'; v[span * segments] is vectors[span].
+     */
+{
+  int span;
+
+  /* pre */
+  assert (v);
+  assert (hb);
+  assert (points);
+  assert (vectors);
+  assert (count >= 2);
+
+  for (span = 0; span < count; span++) v[span * hb->segments] = vectors[span];
+  evaluate (v, hb->tangent, hb->segments, points, vectors, count);
+}
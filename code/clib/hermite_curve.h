@@ -3,6 +3,12 @@
 
 #include <vector3.h>
 
+typedef struct {
+  int segments;
+  double *point;		/* position basis, 4 values per sample */
+  double *tangent;		/* tangent basis, 4 values per sample */
+} hermite_basis;
+
 void
 hermite_set (vector3 *pos_start, vector3 *pos_finish,
 	     vector3 *vec_start, vector3 *vec_finish);
@@ -13,4 +19,16 @@ hermite_get (vector3 *p, double t);
 void
 hermite_get_tangent (vector3 *v, double t);
 
+hermite_basis *
+hermite_basis_get (int segments);
+
+void
+hermite_evaluate (vector3 *p, const hermite_basis *hb,
+		  const vector3 *points, const vector3 *vectors, int count);
+
+void
+hermite_evaluate_tangents (vector3 *v, const hermite_basis *hb,
+			   const vector3 *points, const vector3 *vectors,
+			   int count);
+
 #endif
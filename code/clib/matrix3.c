@@ -7,11 +7,15 @@
     27-Dec-1996  first attempts
     29-Jan-1997  fairly finished
     17-Jun-1998  mod's for hgen
+    18-Oct-2026  array transform and rotate, vectorized and threaded
+    18-Oct-2026  array parts run by the shared thread jobs
+    18-Oct-2026  transform and rotate of single precision points
 */
 
 #include "matrix3.h"
 
 /* public ====================
+#include <stddef.h>
 #include <vector3.h>
 ==================== public */
 
@@ -19,6 +23,17 @@
 #include <string.h>
 #include <math.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <thread_jobs.h>
+
+#define THREAD_MIN_COUNT 262144	/* smaller arrays are done in one go */
+
 
 /*------------------------------------------------------------*/
 void
@@ -258,3 +273,287 @@ matrix3_rotate_translate (vector3 *v, double m[4][4])
   v->y = x * m[0][1] + y * m[1][1] + z * m[2][1] + m[3][1];
   v->z = x * m[0][2] + y * m[1][2] + z * m[2][2] + m[3][2];
 }
+
+
+/*------------------------------------------------------------*/
+void
+matrix3_transform_float (float v[3], double m[4][4])
+     /* As 'matrix3_transform', for a single precision point. */
+{
+  vector3 vec;
+
+  /* pre */
+  assert (v);
+  assert (m);
+
+  vec.x = v[0];
+  vec.y = v[1];
+  vec.z = v[2];
+  matrix3_transform (&vec, m);
+  v[0] = (float) vec.x;
+  v[1] = (float) vec.y;
+  v[2] = (float) vec.z;
+}
+
+
+/*------------------------------------------------------------*/
+void
+matrix3_rotate_float (float v[3], double m[4][4])
+     /* As 'matrix3_rotate', for a single precision normal. */
+{
+  vector3 vec;
+
+  /* pre */
+  assert (v);
+  assert (m);
+
+  vec.x = v[0];
+  vec.y = v[1];
+  vec.z = v[2];
+  matrix3_rotate (&vec, m);
+  v[0] = (float) vec.x;
+  v[1] = (float) vec.y;
+  v[2] = (float) vec.z;
+}
+
+
+/*============================================================*/
+typedef struct {
+  char *first;
+  int count;
+  int part;
+  size_t stride;
+  double (*m)[4];
+  void (*kernel) (char *first, int count, size_t stride, double m[4][4]);
+} array_job;
+
+
+/*------------------------------------------------------------*/
+static int
+is_affine (double m[4][4])
+{
+  return m[0][3] == 0.0 && m[1][3] == 0.0 && m[2][3] == 0.0 && m[3][3] == 1.0;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+transform_kernel (char *first, int count, size_t stride, double m[4][4])
+     /*
+       The sums are formed in the same order as in matrix3_transform,
+       so the result is identical whichever code path is taken. The
+       division is skipped for an affine matrix, where w is exactly 1.
+     */
+{
+  vector3 *v;
+  int affine = is_affine (m);
+
+#if defined(__AVX2__)
+  __m256d m0 = _mm256_loadu_pd (m[0]);
+  __m256d m1 = _mm256_loadu_pd (m[1]);
+  __m256d m2 = _mm256_loadu_pd (m[2]);
+  __m256d m3 = _mm256_loadu_pd (m[3]);
+  __m256i mask = _mm256_set_epi64x (0, -1, -1, -1);
+  __m256d r;
+
+  for ( ; count > 0; count--, first += stride) {
+    v = (vector3 *) first;
+    r = _mm256_add_pd (_mm256_add_pd (_mm256_add_pd
+				      (_mm256_mul_pd (_mm256_set1_pd (v->x), m0),
+				       _mm256_mul_pd (_mm256_set1_pd (v->y), m1)),
+				      _mm256_mul_pd (_mm256_set1_pd (v->z), m2)),
+		       m3);
+    if (!affine) {
+      __m256d w = _mm256_permute4x64_pd (r, 0xff);
+      r = _mm256_div_pd (r, w);
+    }
+    _mm256_maskstore_pd ((double *) v, mask, r);
+  }
+#elif defined(__SSE2__)
+  __m128d m0a = _mm_loadu_pd (m[0]), m0b = _mm_loadu_pd (m[0] + 2);
+  __m128d m1a = _mm_loadu_pd (m[1]), m1b = _mm_loadu_pd (m[1] + 2);
+  __m128d m2a = _mm_loadu_pd (m[2]), m2b = _mm_loadu_pd (m[2] + 2);
+  __m128d m3a = _mm_loadu_pd (m[3]), m3b = _mm_loadu_pd (m[3] + 2);
+  __m128d x, y, z, xy, zw;
+
+  for ( ; count > 0; count--, first += stride) {
+    v = (vector3 *) first;
+    x = _mm_set1_pd (v->x);
+    y = _mm_set1_pd (v->y);
+    z = _mm_set1_pd (v->z);
+    xy = _mm_add_pd (_mm_add_pd (_mm_add_pd (_mm_mul_pd (x, m0a),
+					     _mm_mul_pd (y, m1a)),
+				 _mm_mul_pd (z, m2a)),
+		     m3a);
+    zw = _mm_add_pd (_mm_add_pd (_mm_add_pd (_mm_mul_pd (x, m0b),
+					     _mm_mul_pd (y, m1b)),
+				 _mm_mul_pd (z, m2b)),
+		     m3b);
+    if (!affine) {
+      __m128d w = _mm_unpackhi_pd (zw, zw);
+      xy = _mm_div_pd (xy, w);
+      zw = _mm_div_sd (zw, w);
+    }
+    _mm_storeu_pd (&(v->x), xy);
+    _mm_store_sd (&(v->z), zw);
+  }
+#else
+  double x, y, z, w;
+
+  for ( ; count > 0; count--, first += stride) {
+    v = (vector3 *) first;
+    x = v->x;
+    y = v->y;
+    z = v->z;
+    if (affine) {
+      v->x = x * m[0][0] + y * m[1][0] + z * m[2][0] + m[3][0];
+      v->y = x * m[0][1] + y * m[1][1] + z * m[2][1] + m[3][1];
+      v->z = x * m[0][2] + y * m[1][2] + z * m[2][2] + m[3][2];
+    } else {
+      w = x * m[0][3] + y * m[1][3] + z * m[2][3] + m[3][3];
+      v->x = (x * m[0][0] + y * m[1][0] + z * m[2][0] + m[3][0]) / w;
+      v->y = (x * m[0][1] + y * m[1][1] + z * m[2][1] + m[3][1]) / w;
+      v->z = (x * m[0][2] + y * m[1][2] + z * m[2][2] + m[3][2]) / w;
+    }
+  }
+#endif
+}
+
+
+/*------------------------------------------------------------*/
+static void
+rotate_kernel (char *first, int count, size_t stride, double m[4][4])
+{
+  vector3 *v;
+
+#if defined(__AVX2__)
+  __m256d m0 = _mm256_loadu_pd (m[0]);
+  __m256d m1 = _mm256_loadu_pd (m[1]);
+  __m256d m2 = _mm256_loadu_pd (m[2]);
+  __m256i mask = _mm256_set_epi64x (0, -1, -1, -1);
+  __m256d r;
+
+  for ( ; count > 0; count--, first += stride) {
+    v = (vector3 *) first;
+    r = _mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (_mm256_set1_pd (v->x), m0),
+				      _mm256_mul_pd (_mm256_set1_pd (v->y), m1)),
+		       _mm256_mul_pd (_mm256_set1_pd (v->z), m2));
+    _mm256_maskstore_pd ((double *) v, mask, r);
+  }
+#elif defined(__SSE2__)
+  __m128d m0a = _mm_loadu_pd (m[0]), m0b = _mm_load_sd (m[0] + 2);
+  __m128d m1a = _mm_loadu_pd (m[1]), m1b = _mm_load_sd (m[1] + 2);
+  __m128d m2a = _mm_loadu_pd (m[2]), m2b = _mm_load_sd (m[2] + 2);
+  __m128d x, y, z, xy, zz;
+
+  for ( ; count > 0; count--, first += stride) {
+    v = (vector3 *) first;
+    x = _mm_set1_pd (v->x);
+    y = _mm_set1_pd (v->y);
+    z = _mm_set1_pd (v->z);
+    xy = _mm_add_pd (_mm_add_pd (_mm_mul_pd (x, m0a), _mm_mul_pd (y, m1a)),
+		     _mm_mul_pd (z, m2a));
+    zz = _mm_add_sd (_mm_add_sd (_mm_mul_sd (x, m0b), _mm_mul_sd (y, m1b)),
+		     _mm_mul_sd (z, m2b));
+    _mm_storeu_pd (&(v->x), xy);
+    _mm_store_sd (&(v->z), zz);
+  }
+#else
+  double x, y, z;
+
+  for ( ; count > 0; count--, first += stride) {
+    v = (vector3 *) first;
+    x = v->x;
+    y = v->y;
+    z = v->z;
+    v->x = x * m[0][0] + y * m[1][0] + z * m[2][0];
+    v->y = x * m[0][1] + y * m[1][1] + z * m[2][1];
+    v->z = x * m[0][2] + y * m[1][2] + z * m[2][2];
+  }
+#endif
+}
+
+
+/*------------------------------------------------------------*/
+static void
+run_parts (thread_jobs *tj)
+{
+  array_job *job = (array_job *) tj->data;
+  int slot, count;
+
+  while ((slot = thread_jobs_take (tj)) >= 0) {
+    count = job->count - slot * job->part;
+    if (count > job->part) count = job->part;
+    job->kernel (job->first + (size_t) slot * job->part * job->stride,
+		 count, job->stride, job->m);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+run_array (void (*kernel) (char *first, int count, size_t stride,
+			   double m[4][4]),
+	   vector3 *v, int count, size_t stride, double m[4][4])
+     /*
+       Apply the kernel to the array. A very large array is split
+       into contiguous parts, one per processor, if THREAD_SUPPORT
+       is defined.
+     */
+{
+  thread_jobs tj;
+  array_job job;
+  int parts = 1;
+
+  if (count >= THREAD_MIN_COUNT) parts = thread_jobs_count (count);
+  if (parts == 1) {
+    kernel ((char *) v, count, stride, m);
+    return;
+  }
+
+  job.first = (char *) v;
+  job.count = count;
+  job.part = (count + parts - 1) / parts;
+  job.stride = stride;
+  job.m = m;
+  job.kernel = kernel;
+  parts = (count + job.part - 1) / job.part;
+  thread_jobs_run (&tj, parts, run_parts, &job);
+}
+
+
+/*------------------------------------------------------------*/
+void
+matrix3_transform_array (vector3 *v, int count, size_t stride, double m[4][4])
+     /*
+       Transform 'count' vectors, the first at 'v' and the others
+       following at 'stride' bytes apart. Gives the same result as
+       calling matrix3_transform for each vector.
+     */
+{
+  /* pre */
+  assert (count >= 0);
+  assert (count == 0 || v);
+  assert (stride >= sizeof (vector3));
+  assert (m);
+
+  if (count > 0) run_array (transform_kernel, v, count, stride, m);
+}
+
+
+/*------------------------------------------------------------*/
+void
+matrix3_rotate_array (vector3 *v, int count, size_t stride, double m[4][4])
+     /*
+       Rotate 'count' vectors, 'stride' bytes apart, as by
+       matrix3_rotate; the translation part is not applied.
+     */
+{
+  /* pre */
+  assert (count >= 0);
+  assert (count == 0 || v);
+  assert (stride >= sizeof (vector3));
+  assert (m);
+
+  if (count > 0) run_array (rotate_kernel, v, count, stride, m);
+}
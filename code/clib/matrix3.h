@@ -1,6 +1,7 @@
 #ifndef MATRIX3_H
 #define MATRIX3_H 1
 
+#include <stddef.h>
 #include <vector3.h>
 
 void
@@ -42,4 +43,16 @@ matrix3_rotate (vector3 *v, double m[4][4]);
 void
 matrix3_rotate_translate (vector3 *v, double m[4][4]);
 
+void
+matrix3_transform_float (float v[3], double m[4][4]);
+
+void
+matrix3_rotate_float (float v[3], double m[4][4]);
+
+void
+matrix3_transform_array (vector3 *v, int count, size_t stride, double m[4][4]);
+
+void
+matrix3_rotate_array (vector3 *v, int count, size_t stride, double m[4][4]);
+
 #endif
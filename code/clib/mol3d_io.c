@@ -11,6 +11,7 @@
      4-May-1998  broken out of mol3d, modified write procedures
      4-Jun-1998  set secondary structure directly if given
     25-Nov-1998  fixed bug in mol3d_read_pdb_file
+    18-Oct-2026  DCD and XTC trajectory file types
 */
 
 #include "mol3d_io.h"
@@ -22,7 +23,7 @@
 
 enum mol3d_file_types { MOL3D_UNKNOWN_FILE, MOL3D_PDB_FILE, MOL3D_MSA_FILE,
 			MOL3D_DG_FILE, MOL3D_RD_FILE, MOL3D_CDS_FILE,
-			MOL3D_WAH_FILE };
+			MOL3D_WAH_FILE, MOL3D_DCD_FILE, MOL3D_XTC_FILE };
 ==================== public */
 
 #include <assert.h>
@@ -95,6 +96,10 @@ mol3d_file_type (char *filename)
 	result = MOL3D_CDS_FILE;
       } else if (str_eq (suffix, ".wah") || str_eq (suffix, ".WAH")) {
 	result = MOL3D_WAH_FILE;
+      } else if (str_eq (suffix, ".dcd") || str_eq (suffix, ".DCD")) {
+	result = MOL3D_DCD_FILE;
+      } else if (str_eq (suffix, ".xtc") || str_eq (suffix, ".XTC")) {
+	result = MOL3D_XTC_FILE;
       }
     }
   }
@@ -7,7 +7,7 @@
 
 enum mol3d_file_types { MOL3D_UNKNOWN_FILE, MOL3D_PDB_FILE, MOL3D_MSA_FILE,
 			MOL3D_DG_FILE, MOL3D_RD_FILE, MOL3D_CDS_FILE,
-			MOL3D_WAH_FILE };
+			MOL3D_WAH_FILE, MOL3D_DCD_FILE, MOL3D_XTC_FILE };
 
 int
 mol3d_file_type (char *filename);
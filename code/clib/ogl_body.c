@@ -8,6 +8,7 @@
 
   Copyright (C) 1998 Per Kraulis
    10-Jun-1998  first attempts
+   18-Oct-2026  spheres and cylinders from the shared unit meshes
 
 to do:
 - sphere solid, ico subdivide 
@@ -34,8 +35,6 @@ to do:
 
 
 /*============================================================*/
-static vector3 *sphere_icopoints = NULL;
-static int sphere_icopoint_count, sphere_icopoint_level = 0;
 static vector3 *tetrahedron = NULL;
 static vector3 *octahedron = NULL;
 static vector3 *cube = NULL;
@@ -78,8 +77,8 @@ ogl_sphere_vertices_ico (vector3 *pos, double radius, int level)
        icosahedron. The level controls the granularity.
      */
 {
-  vector3 *point;
-  register int slot;
+  const vector3 *point;
+  register int slot, count;
   register double x, y, z;
 
   /* pre */
@@ -87,19 +86,14 @@ ogl_sphere_vertices_ico (vector3 *pos, double radius, int level)
   assert (radius > 0.0);
   assert (level >= 1);
 
-  if (sphere_icopoint_level != level) {
-    if (sphere_icopoints) free (sphere_icopoints);
-    sphere_icopoints = sphere_ico_points (level);
-    sphere_icopoint_count = sphere_ico_point_count (level);
-    sphere_icopoint_level = level;
-  }
-  point = sphere_icopoints;
+  point = sphere_ico_points_get (level);
+  count = sphere_ico_point_count (level);
   x = pos->x;
   y = pos->y;
   z = pos->z;
 
   glBegin (GL_POINTS);
-  for (slot = 0; slot < sphere_icopoint_count; slot++) {
+  for (slot = 0; slot < count; slot++) {
     VXR (point);
     point++;
   }
@@ -107,46 +101,6 @@ ogl_sphere_vertices_ico (vector3 *pos, double radius, int level)
 }
 
 
-/*------------------------------------------------------------*/
-static void
-sphere_faces_ico_divide (vector3 *p1, vector3 *p2, vector3 *p3,
-			 vector3 *pos, double radius, int depth)
-{
-  assert (p1);
-  assert (p2);
-  assert (p3);
-  assert (pos);
-  assert (radius > 0.0);
-
-  if (depth <= 0) {
-    register double x, y, z;
-    x = pos->x;
-    y = pos->y;
-    z = pos->z;
-
-    NO (p1);
-    VXR (p1);
-    NO (p2);
-    VXR (p2);
-    NO (p3);
-    VXR (p3);
-
-  } else {
-    vector3 p12, p23, p13;
-    v3_sum (&p12, p1, p2);
-    v3_normalize (&p12);
-    v3_sum (&p23, p2, p3);
-    v3_normalize (&p23);
-    v3_sum (&p13, p1, p3);
-    v3_normalize (&p13);
-    sphere_faces_ico_divide (&p13, p1, &p12, pos, radius, depth-1);
-    sphere_faces_ico_divide (p3, &p13, &p23, pos, radius, depth-1);
-    sphere_faces_ico_divide (&p23, &p13, &p12, pos, radius, depth-1);
-    sphere_faces_ico_divide (&p23, &p12, p2, pos, radius, depth-1);
-  }
-}
-
-
 /*------------------------------------------------------------*/
 void
 ogl_sphere_faces_ico_recursive (vector3 *pos, double radius, int depth)
@@ -155,54 +109,27 @@ ogl_sphere_faces_ico_recursive (vector3 *pos, double radius, int depth)
        Requires mode glShadeModel(GL_SMOOTH) for correct rendering.
      */
 {
+  const vector3 *point;
+  int slot, count;
+  register double x, y, z;
+
   /* pre */
   assert (pos);
   assert (radius > 0.0);
   assert (depth >= 0);
 
-  if (icosahedron == NULL) icosahedron = icosahedron_vertices();
+  point = sphere_ico_faces_get (depth, &count);
+  count *= 3;
+  x = pos->x;
+  y = pos->y;
+  z = pos->z;
 
   glBegin (GL_TRIANGLES);
-  sphere_faces_ico_divide (icosahedron + 0, icosahedron + 2, icosahedron + 1,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 0, icosahedron + 1, icosahedron + 4,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 0, icosahedron + 4, icosahedron + 8,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 0, icosahedron + 8, icosahedron + 3,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 0, icosahedron + 3, icosahedron + 2,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 9, icosahedron + 5, icosahedron + 7,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 9, icosahedron + 7, icosahedron + 10,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 9, icosahedron + 10, icosahedron + 11,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 9, icosahedron + 11, icosahedron + 6,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 9, icosahedron + 6, icosahedron + 5,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 1, icosahedron + 5, icosahedron + 6,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 1, icosahedron + 6, icosahedron + 4,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 6, icosahedron + 11, icosahedron + 4,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 11, icosahedron + 8, icosahedron + 4,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 11, icosahedron + 10, icosahedron + 8,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 10, icosahedron + 3, icosahedron + 8,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 10, icosahedron + 7, icosahedron + 3,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 7, icosahedron + 2, icosahedron + 3,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 7, icosahedron + 5, icosahedron + 2,
-			   pos, radius, depth);
-  sphere_faces_ico_divide (icosahedron + 5, icosahedron + 1, icosahedron + 2,
-			   pos, radius, depth);
+  for (slot = 0; slot < count; slot++) {
+    NO (point);
+    VXR (point);
+    point++;
+  }
   glEnd();
 }
 
@@ -216,8 +143,8 @@ ogl_sphere_faces_globe (vector3 *pos, double radius, int segments)
        Requires mode glShadeModel(GL_SMOOTH) for correct rendering.
      */
 {
-  vector3 point;
-  double x, y, z, angle, z1, z2, sr1, sr2, sinangle, cosangle;
+  const vector3 *points, *ring1, *ring2;
+  double x, y, z;
   int slices, stacks, slice, stack;
 
   /* pre */
@@ -227,110 +154,56 @@ ogl_sphere_faces_globe (vector3 *pos, double radius, int segments)
 
   slices = 2 * segments;
   stacks = segments;
+  points = sphere_globe_points_get (segments);
   x = pos->x;
   y = pos->y;
   z = pos->z;
 
   glBegin (GL_TRIANGLE_FAN);
-  point.x = 0.0;
-  point.y = 0.0;
-  point.z = 1.0;
-  NOD (point);
-  VXRD (point);
-  angle = ANGLE_PI / (double) stacks;
-  sr1 = sin (angle);
-  z1 = cos (angle);
-  point.x = sr1;
-  point.y = 0.0;
-  point.z = z1;
-  NOD (point);
-  VXRD (point);
-  for (slice = 1; slice < slices; slice++) {
-    angle = (double) slice * 2.0 * ANGLE_PI / (double) slices;
-    point.x = sr1 * cos (angle);
-    point.y = sr1 * sin (angle);
-    NOD (point);
-    VXRD (point);
+  NO (points);
+  VXR (points);
+  ring1 = points + 1;
+  for (slice = 0; slice < slices; slice++) {
+    NO (ring1 + slice);
+    VXR (ring1 + slice);
   }
-  point.x = sr1;
-  point.y = 0.0;
-  point.z = z1;
-  NOD (point);
-  VXRD (point);
+  NO (ring1);
+  VXR (ring1);
   glEnd();
 
   for (stack = 1; stack < stacks - 1; stack++) {
+    ring1 = points + 1 + (stack - 1) * slices;
+    ring2 = ring1 + slices;
     glBegin (GL_QUAD_STRIP);
-    angle = (double) (stack + 1) * ANGLE_PI / (double) stacks;
-    sr2 = sin (angle);
-    z2 = cos (angle);
-    point.x = sr2;
-    point.y = 0.0;
-    point.z = z2;
-    NOD (point);
-    VXRD (point);
-    angle = (double) stack * ANGLE_PI / (double) stacks;
-    sr1 = sin (angle);
-    z1 = cos (angle);
-    point.x = sr1;
-    point.y = 0.0;
-    point.z = z1;
-    NOD (point);
-    VXRD (point);
+    NO (ring2);
+    VXR (ring2);
+    NO (ring1);
+    VXR (ring1);
     for (slice = slices - 1; slice >= 1; slice--) {
-      angle = (double) slice * 2.0 * ANGLE_PI / (double) slices;
-      cosangle = cos (angle);
-      sinangle = sin (angle);
-      point.x = sr2 * cosangle;
-      point.y = sr2 * sinangle;
-      point.z = z2;
-      NOD (point);
-      VXRD (point);
-      point.x = sr1 * cosangle;
-      point.y = sr1 * sinangle;
-      point.z = z1;
-      NOD (point);
-      VXRD (point);
+      NO (ring2 + slice);
+      VXR (ring2 + slice);
+      NO (ring1 + slice);
+      VXR (ring1 + slice);
     }
-    point.x = sr2;
-    point.y = 0.0;
-    point.z = z2;
-    NOD (point);
-    VXRD (point);
-    point.x = sr1;
-    point.y = 0.0;
-    point.z = z1;
-    NOD (point);
-    VXRD (point);
+    NO (ring2);
+    VXR (ring2);
+    NO (ring1);
+    VXR (ring1);
     glEnd();
   }
 
   glBegin (GL_TRIANGLE_FAN);
-  point.x = 0.0;
-  point.y = 0.0;
-  point.z = -1.0;
-  NOD (point);
-  VXRD (point);
-  angle = ANGLE_PI / (double) stacks;
-  sr1 = sin (angle);
-  z1 = - cos (angle);
-  point.x = sr1;
-  point.y = 0.0;
-  point.z = z1;
-  NOD (point);
-  VXRD (point);
+  ring1 = points + 1 + (stacks - 1) * slices;
+  NO (ring1 + slices);
+  VXR (ring1 + slices);
+  NO (ring1);
+  VXR (ring1);
   for (slice = slices - 1; slice >= 1; slice--) {
-    angle = (double) slice * 2.0 * ANGLE_PI / (double) slices;
-    point.x = sr1 * cos (angle);
-    point.y = sr1 * sin (angle);
-    NOD (point);
-    VXRD (point);
+    NO (ring1 + slice);
+    VXR (ring1 + slice);
   }
-  point.x = sr1;
-  point.y = 0.0;
-  point.z = z1;
-  NOD (point);
-  VXRD (point);
+  NO (ring1);
+  VXR (ring1);
   glEnd();
 }
 
@@ -967,7 +840,7 @@ disk (vector3 *pos, vector3 *axis, vector3 *arad, vector3 *brad,
       double radius, int segments)
 {
   int slot;
-  double angle;
+  const double *cs;
   vector3 point;
 
   assert (pos);
@@ -977,15 +850,16 @@ disk (vector3 *pos, vector3 *axis, vector3 *arad, vector3 *brad,
   assert (radius > 0.0);
   assert (segments >= 3);
 
+  cs = circle_points_get (segments);
+
   glBegin (GL_TRIANGLE_FAN);
   NO (axis);
   VX (pos);
   v3_sum_scaled (&point, pos, radius, arad);
   VXD (point);
   for (slot = segments - 1; slot >= 1; slot--) {
-    angle = 2.0 * ANGLE_PI * (double) slot / (double) segments;
-    v3_scaled (&point, cos (angle), arad);
-    v3_add_scaled (&point, sin (angle), brad);
+    v3_scaled (&point, cs[2 * slot], arad);
+    v3_add_scaled (&point, cs[2 * slot + 1], brad);
     v3_sum_scaled (&point, pos, radius, &point);
     VXD (point);
   }
@@ -1004,7 +878,7 @@ ogl_cylinder_faces (vector3 *pos1, vector3 *pos2,
      */
 {
   int slot;
-  double angle;
+  const double *cs;
   vector3 point, axis, arad, brad, rad;
 
   assert (pos1);
@@ -1021,6 +895,7 @@ ogl_cylinder_faces (vector3 *pos1, vector3 *pos2,
   v3_normalize (&arad);
   v3_cross_product (&brad, &arad, &axis);
   v3_normalize (&brad);
+  cs = circle_points_get (segments);
 
   glBegin (GL_QUAD_STRIP);
   NOD (arad);
@@ -1029,9 +904,8 @@ ogl_cylinder_faces (vector3 *pos1, vector3 *pos2,
   v3_sum_scaled (&point, pos2, radius, &arad);
   VXD (point);
   for (slot = 1; slot < segments; slot++) {
-    angle = 2.0 * ANGLE_PI * (double) slot / (double) segments;
-    v3_scaled (&rad, cos (angle), &arad);
-    v3_add_scaled (&rad, sin (angle), &brad);
+    v3_scaled (&rad, cs[2 * slot], &arad);
+    v3_add_scaled (&rad, cs[2 * slot + 1], &brad);
     NOD (rad);
     v3_sum_scaled (&point, pos1, radius, &rad);
     VXD (point);
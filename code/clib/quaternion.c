@@ -6,6 +6,7 @@
    Copyright (C) 1997-1998 Per Kraulis
     23-Jun-1997  started writing
     17-Jun-1998  mod's for hgen
+    18-Oct-2026  interpolation safe for rounding of equal quaternions
 */
 
 #include "quaternion.h"
@@ -147,6 +148,7 @@ quat_interpolate (quaternion *dest, quaternion *q0, quaternion *q1, double t)
         q0->axis.y * q1->axis.y +
         q0->axis.z * q1->axis.z +
         q0->phi * q1->phi;
+  if (sum > 1.0) sum = 1.0;
   theta = acos (sum);
   if (theta < 1.0e-10) {
     beta1 = 1.0 - t;
@@ -10,6 +10,7 @@
    Copyright (C) 1997-1998 Per Kraulis
     26-Sep-1997  started
     28-Sep-1997  write char routine implemented
+    18-Oct-2026  sizes up to the 16-bit limit of the format
 
    to do:
    - short routines not implemented
@@ -73,9 +74,9 @@ sgiimg_set_size (sgi_image *img, int width, int height)
   assert (img);
   assert (img->file == NULL);
   assert (width > 0);
-  assert (width < 8191);
+  assert (width <= 65535);
   assert (height > 0);
-  assert (height < 8191);
+  assert (height <= 65535);
 
   img->xsize = width;
   img->ysize = height;
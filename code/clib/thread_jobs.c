@@ -0,0 +1,155 @@
+/* thread_jobs.c
+
+   Run a number of jobs by worker threads, which take the jobs in
+   order from a shared counter. A worker may keep its own scratch
+   data between the jobs it takes. The jobs are run by the calling
+   thread alone, if THREAD_SUPPORT is not defined or if no threads
+   can be created.
+
+   clib v1.1
+
+   Copyright (C) 1998 Per Kraulis
+    18-Oct-2026  first attempts, generalized from the image renderers
+*/
+
+#include "thread_jobs.h"
+
+/* public ====================
+typedef struct {
+  int count;
+  int next;
+  void *data;
+  void *lock;
+} thread_jobs;
+==================== public */
+
+#include <assert.h>
+
+#ifdef THREAD_SUPPORT
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+
+#define MAX_THREADS 64
+
+
+/*============================================================*/
+#ifdef THREAD_SUPPORT
+typedef struct {
+  thread_jobs *tj;
+  void (*worker) (thread_jobs *tj);
+} worker_arg;
+#endif
+
+
+/*------------------------------------------------------------*/
+int
+thread_jobs_count (int jobs)
+     /*
+       The number of threads worth starting for the given number of
+       jobs: one per processor, but not more than jobs.
+     */
+{
+  int count = 1;
+
+  /* pre */
+  assert (jobs >= 0);
+
+#ifdef THREAD_SUPPORT
+  count = (int) sysconf (_SC_NPROCESSORS_ONLN);
+  if (count > MAX_THREADS) count = MAX_THREADS;
+#endif
+  if (count > jobs) count = jobs;
+  if (count < 1) count = 1;
+
+  return count;
+}
+
+
+/*------------------------------------------------------------*/
+#ifdef THREAD_SUPPORT
+static void *
+start_worker (void *arg)
+{
+  worker_arg *wa = (worker_arg *) arg;
+
+  wa->worker (wa->tj);
+  return NULL;
+}
+#endif
+
+
+/*------------------------------------------------------------*/
+void
+thread_jobs_run (thread_jobs *tj, int count,
+		 void (*worker) (thread_jobs *tj), void *data)
+     /*
+       Run the worker in as many threads as is worth it, the calling
+       thread included, and return when all jobs are done. The worker
+       takes jobs by 'thread_jobs_take' until there are none left.
+     */
+{
+#ifdef THREAD_SUPPORT
+  pthread_t threads[MAX_THREADS];
+  pthread_mutex_t mutex;
+  worker_arg wa;
+  int thread_count, slot;
+#endif
+
+  /* pre */
+  assert (tj);
+  assert (count >= 0);
+  assert (worker);
+
+  tj->count = count;
+  tj->next = 0;
+  tj->data = data;
+  tj->lock = NULL;
+  if (count == 0) return;
+
+#ifdef THREAD_SUPPORT
+  thread_count = thread_jobs_count (count);
+  if (thread_count > 1) {
+    pthread_mutex_init (&mutex, NULL);
+    tj->lock = &mutex;
+    wa.tj = tj;
+    wa.worker = worker;
+    for (slot = 0; slot < thread_count - 1; slot++) {
+      if (pthread_create (threads + slot, NULL, start_worker, &wa)) break;
+    }
+    thread_count = slot;
+    worker (tj);
+    for (slot = 0; slot < thread_count; slot++)
+      pthread_join (threads[slot], NULL);
+    pthread_mutex_destroy (&mutex);
+    tj->lock = NULL;
+    return;
+  }
+#endif
+
+  worker (tj);
+}
+
+
+/*------------------------------------------------------------*/
+int
+thread_jobs_take (thread_jobs *tj)
+     /* Return the next job, or -1 if there are no more. */
+{
+  int job;
+
+  /* pre */
+  assert (tj);
+
+#ifdef THREAD_SUPPORT
+  if (tj->lock) pthread_mutex_lock ((pthread_mutex_t *) tj->lock);
+#endif
+  job = tj->next;
+  if (job < tj->count) tj->next++;
+#ifdef THREAD_SUPPORT
+  if (tj->lock) pthread_mutex_unlock ((pthread_mutex_t *) tj->lock);
+#endif
+
+  return (job < tj->count) ? job : -1;
+}
@@ -0,0 +1,21 @@
+#ifndef THREAD_JOBS_H
+#define THREAD_JOBS_H 1
+
+typedef struct {
+  int count;			/* number of jobs */
+  int next;			/* the next job to take */
+  void *data;			/* for the worker */
+  void *lock;			/* mutex, if run by threads */
+} thread_jobs;
+
+int
+thread_jobs_count (int jobs);
+
+void
+thread_jobs_run (thread_jobs *tj, int count,
+		 void (*worker) (thread_jobs *tj), void *data);
+
+int
+thread_jobs_take (thread_jobs *tj);
+
+#endif
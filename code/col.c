@@ -7,6 +7,7 @@
    Copyright (C) 1997-1998 Per Kraulis
      4-Dec-1996  first attempts
     29-Jan-1997  use clib colour
+    18-Oct-2026  constant_colours_init
 */
 
 #include <assert.h>
@@ -30,6 +31,23 @@ colour blue_colour  = { COLOUR_RGB,  0.0, 0.0, 1.0 };
 colour ramp_from_colour, ramp_to_colour;
 
 
+/*------------------------------------------------------------*/
+void
+constant_colours_init (void)
+     /* Undo any earlier 'constant_colours_to_rgb'. */
+{
+  colour white = { COLOUR_GREY, 1.0, 0.0, 0.0 };
+  colour black = { COLOUR_GREY, 0.0, 0.0, 0.0 };
+  colour grey  = { COLOUR_GREY, 0.5, 0.0, 0.0 };
+  colour grey02  = { COLOUR_GREY, 0.2, 0.0, 0.0 };
+
+  white_colour = white;
+  black_colour = black;
+  grey_colour = grey;
+  grey02_colour = grey02;
+}
+
+
 /*------------------------------------------------------------*/
 void
 constant_colours_to_rgb (void)
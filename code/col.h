@@ -7,6 +7,7 @@
    Copyright (C) 1997-1998 Per Kraulis
      4-Dec-1996  first attempts
     29-Jan-1997  use clib colour
+    18-Oct-2026  constant_colours_init
 */
 
 #ifndef COL_H
@@ -19,6 +20,7 @@ extern colour white_colour, black_colour, grey_colour, grey02_colour,
               red_colour, blue_colour;
 extern colour ramp_from_colour, ramp_to_colour;
 
+void constant_colours_init (void);
 void constant_colours_to_rgb (void);
 int invalid_colour (colour *c);
 void set_rgb (void);
@@ -8,10 +8,19 @@
      3-Dec-1996  first attempts
      3-Jan-1997  fairly finished
     30-Jan-1997  use clib mol3d
+    18-Oct-2026  molecule file cache for batch mode
+    18-Oct-2026  cache warmed by the render server
+    18-Oct-2026  coordinate files noted for watch mode
+    18-Oct-2026  trajectory frames set into a topology molecule
+    18-Oct-2026  coordinate data noted for the reuse of geometry
 */
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "clib/str_utils.h"
 
@@ -19,6 +28,8 @@
 #include "global.h"
 #include "lex.h"
 #include "select.h"
+#include "watch.h"
+#include "trajectory.h"
 
 
 /*============================================================*/
@@ -28,6 +39,19 @@ int total_residues = 0;
 
 static char *molname = NULL;
 
+typedef struct s_cached_file cached_file;
+
+struct s_cached_file {
+  char *filename;
+  time_t mtime;
+  mol3d *mol;			/* as read; never changed */
+  cached_file *next;
+};
+
+static boolean use_cache = FALSE;
+static cached_file *cached_files = NULL;
+static int cache_report = -1;
+
 
 /*------------------------------------------------------------*/
 void
@@ -41,6 +65,207 @@ store_molname (char *name)
 }
 
 
+/*------------------------------------------------------------*/
+void
+cache_molecules (void)
+     /*
+       Keep the molecules read from files, and give copies of them when
+       the same file is read again, unless it has been modified.
+     */
+{
+  use_cache = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static mol3d *
+clone_molecules (mol3d *first_mol)
+     /* Copy the molecules, residues and atoms; not the named data. */
+{
+  mol3d *mol, *new_mol;
+  mol3d *new_first = NULL;
+  res3d *res, *new_res;
+  res3d *curr_res;
+  at3d *at, *new_at;
+  at3d *curr_at;
+
+  assert (first_mol);
+
+  for (mol = first_mol; mol; mol = mol->next) {
+    new_mol = mol3d_create();
+    new_mol->model = mol->model;
+    new_mol->init = mol->init;
+
+    curr_res = NULL;
+    for (res = mol->first; res; res = res->next) {
+      new_res = res3d_clone (res);
+      if (curr_res) {
+	res3d_add (curr_res, new_res);
+      } else {
+	mol3d_append_residue (new_mol, new_res);
+      }
+      curr_res = new_res;
+
+      curr_at = NULL;
+      for (at = res->first; at; at = at->next) {
+	new_at = at3d_clone (at);
+	if (curr_at) {
+	  at3d_add (curr_at, new_at);
+	} else {
+	  res3d_append_atom (new_res, new_at);
+	}
+	curr_at = new_at;
+      }
+    }
+
+    if (new_first) {
+      mol3d_append (new_first, new_mol);
+    } else {
+      new_first = new_mol;
+    }
+  }
+
+  return new_first;
+}
+
+
+/*------------------------------------------------------------*/
+static cached_file *
+cache_entry (char *filename, time_t mtime)
+     /* The molecules are NULL if the file has not been read, or changed. */
+{
+  cached_file *cf;
+
+  assert (filename);
+  assert (*filename);
+
+  for (cf = cached_files; cf; cf = cf->next) {
+    if (str_eq (cf->filename, filename)) break;
+  }
+
+  if (cf == NULL) {
+    cf = malloc (sizeof (cached_file));
+    cf->filename = str_clone (filename);
+    cf->mol = NULL;
+    cf->next = cached_files;
+    cached_files = cf;
+  } else if (cf->mol && (cf->mtime != mtime)) {
+    mol3d_delete_all (cf->mol);
+    cf->mol = NULL;
+  }
+
+  return cf;
+}
+
+
+/*------------------------------------------------------------*/
+static mol3d *
+read_pdb_filename (char *filename)
+{
+  cached_file *cf;
+  struct stat st;
+
+  assert (filename);
+  assert (*filename);
+
+  if (! use_cache || (stat (filename, &st) != 0))
+    return mol3d_read_pdb_filename (filename);
+
+  cf = cache_entry (filename, st.st_mtime);
+  if (cf->mol == NULL) {
+    cf->mol = mol3d_read_pdb_filename (filename);
+    if (cf->mol == NULL) return NULL;
+    cf->mtime = st.st_mtime;
+    if (cache_report >= 0) {
+      write (cache_report, filename, strlen (filename));
+      write (cache_report, "\n", 1);
+    }
+  } else if (message_mode) {
+    fprintf (stderr, "(copy of the molecule file read earlier)\n");
+  }
+
+  return clone_molecules (cf->mol);
+}
+
+
+/*------------------------------------------------------------*/
+void
+cache_molecules_report (int fd)
+     /* Write the name of each file read into the cache to 'fd'. */
+{
+  cache_report = fd;
+}
+
+
+/*------------------------------------------------------------*/
+void
+cache_molecule_file (char *filename)
+     /* Read the file into the cache, unless already there. */
+{
+  cached_file *cf;
+  struct stat st;
+
+  assert (filename);
+  assert (*filename);
+
+  if (stat (filename, &st) != 0) return;
+
+  cf = cache_entry (filename, st.st_mtime);
+  if (cf->mol == NULL) {
+    cf->mol = mol3d_read_pdb_filename (filename);
+    cf->mtime = st.st_mtime;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+read_trajectory_frame (char *filename, int type)
+     /*
+       Set the current frame of the trajectory into the atoms of the
+       topology: the molecules already read under the same name.
+     */
+{
+  mol3d *mol;
+  res3d *res;
+  at3d *at;
+  float *xyz;
+  int atom_count;
+  int count = 0;
+
+  assert (filename);
+
+  xyz = trajectory_frame (filename, type, &atom_count);
+
+  for (mol = first_molecule; mol; mol = mol->next) {
+    if (! str_eq (mol->name, molname)) continue;
+    for (res = mol->first; res; res = res->next) {
+      for (at = res->first; at; at = at->next) count++;
+    }
+  }
+  if (count == 0)
+    yyerror ("no topology for the trajectory; read a PDB file into the molecule first");
+  if (count != atom_count)
+    yyerror ("different number of atoms in the trajectory and its topology");
+
+  for (mol = first_molecule; mol; mol = mol->next) {
+    if (! str_eq (mol->name, molname)) continue;
+    for (res = mol->first; res; res = res->next) {
+      for (at = res->first; at; at = at->next) {
+	at->xyz.x = xyz[0];
+	at->xyz.y = xyz[1];
+	at->xyz.z = xyz[2];
+	xyz += 3;
+      }
+    }
+  }
+
+  if (message_mode)
+    fprintf (stderr, "trajectory coordinates set for %i atoms in molecule %s\n",
+	     count, molname);
+}
+
+
 /*------------------------------------------------------------*/
 void
 read_coordinate_file (char *filename)
@@ -64,7 +289,8 @@ read_coordinate_file (char *filename)
       case MOL3D_UNKNOWN_FILE:
       case MOL3D_PDB_FILE:
 	if (message_mode) fprintf (stderr, "reading PDB file...\n");
-	mol = mol3d_read_pdb_filename (filename);
+	mol = read_pdb_filename (filename);
+	watch_data_file (filename);
 	break;
       case MOL3D_MSA_FILE:
 	not_implemented ("MSA coordinate file format");
@@ -81,6 +307,11 @@ read_coordinate_file (char *filename)
       case MOL3D_WAH_FILE:
 	not_implemented ("WAH coordinate file format");
 	break;
+      case MOL3D_DCD_FILE:
+      case MOL3D_XTC_FILE:
+	read_trajectory_frame (filename, mol3d_file_type (filename));
+	watch_data_file (filename);
+	return;
       }
     }
 
@@ -89,6 +320,7 @@ read_coordinate_file (char *filename)
     FILE *file = lex_input_file();
     if (message_mode)
       fprintf (stderr, "reading inline PDB coordinate data...\n");
+    watch_inline_data();
     while ((ch = fgetc (file)) != '\n') {
       if (ch == EOF) yyerror ("no inline PDB coordinate data");
     }
@@ -8,6 +8,8 @@
      4-Dec-1996  first attempts
      3-Jan-1997  fairly finished
     30-Jan-1997  use clib mol3d
+    18-Oct-2026  molecule file cache for batch mode
+    18-Oct-2026  cache warmed by the render server
 */
 
 #ifndef COORD_H
@@ -28,6 +30,9 @@ extern int total_atoms;
 extern int total_residues;
 
 void store_molname (char *name);
+void cache_molecules (void);
+void cache_molecules_report (int fd);
+void cache_molecule_file (char *filename);
 void read_coordinate_file (char *filename);
 void init_molecule (mol3d *mol);
 void update_totals (void);
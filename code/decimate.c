@@ -0,0 +1,670 @@
+/* decimate.c
+
+   MolScript v2.1.2
+
+   Decimation of triangle objects by quadric error edge collapse
+   (Garland and Heckbert, SIGGRAPH 1997).
+
+   The triangles of an object file, or of a surface, are collected into
+   a welded mesh. Edges are collapsed in order of increasing error until
+   the target number of triangles is reached, or until the next collapse
+   would move the surface more than the given number of output pixels.
+   The error is the area-weighted mean squared distance to the planes of
+   the original triangles merged into the vertex.
+
+   Vertices are welded on position, normal and colour, so a seam in the
+   normals or colours is a border of the mesh. Vertices on a border are
+   never moved, which keeps seams and open edges closed. The normal and
+   colour of a merged vertex are interpolated along the collapsed edge.
+   A colour difference across an edge adds to its error, scaled by the
+   length of the edge, since the colour border may move that far.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "clib/vector3.h"
+
+#include "decimate.h"
+#include "global.h"
+#include "graphics.h"
+#include "mesh.h"
+
+
+/*============================================================*/
+#define DEFAULT_PIXELS 0.5	/* tolerance at coarser detail levels */
+
+typedef struct {
+  double q[10];			/* quadric: aa ab ac ad bb bc bd cc cd dd */
+  double area;			/* of the triangles in the quadric */
+  int *faces;			/* incident triangles; may include removed */
+  int face_count;
+  int face_alloc;
+  int stamp;			/* changed when the vertex is changed */
+  int mark;
+  boolean locked;		/* on a border; never moved */
+  boolean removed;
+} dvertex;
+
+typedef struct {
+  double cost;
+  int keep, remove;		/* vertex 'remove' is merged into 'keep' */
+  int keep_stamp, remove_stamp;
+  double t;			/* position along the edge from 'keep' */
+  vector3 pos;
+} dedge;
+
+static mesh *dm;
+static dvertex *vertices;
+static boolean *face_removed;
+static int face_count;
+static int mark_count;
+
+static dedge *heap;
+static int heap_count;
+static int heap_alloc;
+
+static mesh *meshes[4];		/* collected, by triangle code */
+
+
+/*------------------------------------------------------------*/
+static void
+quadric_add_plane (double *q, vector3 *n, double d, double weight)
+{
+  q[0] += weight * n->x * n->x;
+  q[1] += weight * n->x * n->y;
+  q[2] += weight * n->x * n->z;
+  q[3] += weight * n->x * d;
+  q[4] += weight * n->y * n->y;
+  q[5] += weight * n->y * n->z;
+  q[6] += weight * n->y * d;
+  q[7] += weight * n->z * n->z;
+  q[8] += weight * n->z * d;
+  q[9] += weight * d * d;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+quadric_value (double *q, vector3 *p)
+{
+  return q[0] * p->x * p->x + 2.0 * q[1] * p->x * p->y +
+    2.0 * q[2] * p->x * p->z + 2.0 * q[3] * p->x +
+    q[4] * p->y * p->y + 2.0 * q[5] * p->y * p->z + 2.0 * q[6] * p->y +
+    q[7] * p->z * p->z + 2.0 * q[8] * p->z + q[9];
+}
+
+
+/*------------------------------------------------------------*/
+static double
+det3 (double a, double b, double c,
+      double d, double e, double f,
+      double g, double h, double i)
+{
+  return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+quadric_minimum (double *q, vector3 *p)
+     /* The position of least error, if the quadric is not singular. */
+{
+  double det, trace;
+
+  det = det3 (q[0], q[1], q[2], q[1], q[4], q[5], q[2], q[5], q[7]);
+  trace = q[0] + q[4] + q[7];
+  if (fabs (det) <= 1.0e-6 * trace * trace * trace) return FALSE;
+				/* Cramer's rule */
+  p->x = det3 (-q[3], q[1], q[2], -q[6], q[4], q[5], -q[8], q[5], q[7]) / det;
+  p->y = det3 (q[0], -q[3], q[2], q[1], -q[6], q[5], q[2], -q[8], q[7]) / det;
+  p->z = det3 (q[0], q[1], -q[3], q[1], q[4], -q[6], q[2], q[5], -q[8]) / det;
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+add_face (int vertex, int face)
+{
+  dvertex *dv = vertices + vertex;
+
+  if (dv->face_count >= dv->face_alloc) {
+    dv->face_alloc = dv->face_alloc ? 2 * dv->face_alloc : 8;
+    dv->faces = realloc (dv->faces, dv->face_alloc * sizeof (int));
+  }
+  dv->faces[dv->face_count++] = face;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+face_has (int face, int vertex)
+{
+  int *tri = dm->triangles + 3 * face;
+
+  return (tri[0] == vertex) || (tri[1] == vertex) || (tri[2] == vertex);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+heap_push (dedge *e)
+{
+  int slot, parent;
+
+  if (heap_count >= heap_alloc) {
+    heap_alloc *= 2;
+    heap = realloc (heap, heap_alloc * sizeof (dedge));
+  }
+
+  for (slot = heap_count++; slot > 0; slot = parent) {
+    parent = (slot - 1) / 2;
+    if (heap[parent].cost <= e->cost) break;
+    heap[slot] = heap[parent];
+  }
+  heap[slot] = *e;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+heap_pop (dedge *e)
+{
+  int slot, child;
+  dedge *last;
+
+  assert (heap_count > 0);
+
+  *e = heap[0];
+  last = heap + --heap_count;
+
+  for (slot = 0; (child = 2 * slot + 1) < heap_count; slot = child) {
+    if ((child + 1 < heap_count) && (heap[child + 1].cost < heap[child].cost))
+      child++;
+    if (last->cost <= heap[child].cost) break;
+    heap[slot] = heap[child];
+  }
+  heap[slot] = *last;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+edge_cost (double *q, double area, vector3 *p)
+{
+  double cost = quadric_value (q, p);
+
+  if (area > 0.0) cost /= area;
+  return (cost > 0.0) ? cost : 0.0;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+push_edge (int v1, int v2)
+     /*
+       Find the best position for merging the two vertices, and put
+       the collapse of the edge on the heap.
+     */
+{
+  dedge e;
+  dvertex *dv1, *dv2;
+  double q[10];
+  double area, cost, length2, colour_cost, t;
+  vector3 *p1, *p2, d, p;
+  int slot;
+
+  dv1 = vertices + v1;
+  dv2 = vertices + v2;
+  if (dv1->locked && dv2->locked) return;
+
+  if (dv2->locked) {		/* the locked vertex is the one kept */
+    slot = v1;
+    v1 = v2;
+    v2 = slot;
+    dv1 = vertices + v1;
+    dv2 = vertices + v2;
+  }
+
+  for (slot = 0; slot < 10; slot++) q[slot] = dv1->q[slot] + dv2->q[slot];
+  area = dv1->area + dv2->area;
+  p1 = dm->points + v1;
+  p2 = dm->points + v2;
+
+  v3_difference (&d, p2, p1);
+  length2 = v3_dot_product (&d, &d);
+
+  e.keep = v1;
+  e.remove = v2;
+  e.keep_stamp = dv1->stamp;
+  e.remove_stamp = dv2->stamp;
+  e.t = 0.0;
+  e.pos = *p1;
+  e.cost = edge_cost (q, area, p1);
+
+  if (! dv1->locked) {
+    cost = edge_cost (q, area, p2);
+    if (cost < e.cost) {
+      e.cost = cost;
+      e.t = 1.0;
+      e.pos = *p2;
+    }
+
+    v3_middle (&p, p1, p2);
+    cost = edge_cost (q, area, &p);
+    if (cost < e.cost) {
+      e.cost = cost;
+      e.t = 0.5;
+      e.pos = p;
+    }
+				/* only close to the edge */
+    if (quadric_minimum (q, &p) && (length2 > 0.0) &&
+	(v3_sqdistance (&p, &(e.pos)) <= length2)) {
+      cost = edge_cost (q, area, &p);
+      if (cost < e.cost) {
+	e.cost = cost;
+	v3_difference (&d, p2, p1);
+	t = (v3_dot_product (&d, &p) - v3_dot_product (&d, p1)) / length2;
+	if (t < 0.0) t = 0.0;
+	if (t > 1.0) t = 1.0;
+	e.t = t;
+	e.pos = p;
+      }
+    }
+  }
+				/* a colour border moves about one edge */
+  if (dm->colours) {
+    colour_cost = v3_sqdistance (dm->colours + v1, dm->colours + v2);
+    e.cost += colour_cost * length2;
+  }
+
+  heap_push (&e);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+face_normal (vector3 *n, vector3 *p1, vector3 *p2, vector3 *p3)
+     /* Not normalized; the length is twice the area of the triangle. */
+{
+  vector3 p12, p13;
+
+  v3_difference (&p12, p2, p1);
+  v3_difference (&p13, p3, p1);
+  v3_cross_product (n, &p12, &p13);
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+flips (int face, int moved, vector3 *pos)
+     /* Would the triangle turn over if the vertex is moved? */
+{
+  int *tri = dm->triangles + 3 * face;
+  vector3 *p[3];
+  vector3 before, after;
+  int corner;
+
+  for (corner = 0; corner < 3; corner++) p[corner] = dm->points + tri[corner];
+  face_normal (&before, p[0], p[1], p[2]);
+
+  for (corner = 0; corner < 3; corner++) {
+    if (tri[corner] == moved) p[corner] = pos;
+  }
+  face_normal (&after, p[0], p[1], p[2]);
+
+  return (v3_dot_product (&before, &after) <= 0.0) &&
+    (v3_dot_product (&before, &before) > 0.0);
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+collapse_valid (dedge *e)
+     /*
+       The collapse must keep the mesh manifold: the two vertices must
+       share exactly the two neighbours on either side of the edge. No
+       remaining triangle may turn over.
+     */
+{
+  dvertex *keep = vertices + e->keep;
+  dvertex *remove = vertices + e->remove;
+  int slot, corner, vertex, face, shared;
+  int *tri;
+
+  mark_count++;
+  for (slot = 0; slot < keep->face_count; slot++) {
+    face = keep->faces[slot];
+    if (face_removed[face]) continue;
+    tri = dm->triangles + 3 * face;
+    for (corner = 0; corner < 3; corner++) vertices[tri[corner]].mark = mark_count;
+  }
+
+  mark_count++;
+  shared = 0;
+  for (slot = 0; slot < remove->face_count; slot++) {
+    face = remove->faces[slot];
+    if (face_removed[face]) continue;
+    tri = dm->triangles + 3 * face;
+    for (corner = 0; corner < 3; corner++) {
+      vertex = tri[corner];
+      if ((vertex == e->keep) || (vertex == e->remove)) continue;
+      if (vertices[vertex].mark == mark_count - 1) {
+	vertices[vertex].mark = mark_count;
+	shared++;
+      }
+    }
+  }
+  if (shared != 2) return FALSE;
+
+  for (slot = 0; slot < keep->face_count; slot++) {
+    face = keep->faces[slot];
+    if (face_removed[face] || face_has (face, e->remove)) continue;
+    if (flips (face, e->keep, &(e->pos))) return FALSE;
+  }
+  for (slot = 0; slot < remove->face_count; slot++) {
+    face = remove->faces[slot];
+    if (face_removed[face] || face_has (face, e->keep)) continue;
+    if (flips (face, e->remove, &(e->pos))) return FALSE;
+  }
+
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+interpolate (vector3 *v1, vector3 *v2, double t)
+{
+  v1->x += t * (v2->x - v1->x);
+  v1->y += t * (v2->y - v1->y);
+  v1->z += t * (v2->z - v1->z);
+}
+
+
+/*------------------------------------------------------------*/
+static int
+collapse (dedge *e)
+     /* Merge the vertex into the one kept. Return the triangles removed. */
+{
+  dvertex *keep = vertices + e->keep;
+  dvertex *remove = vertices + e->remove;
+  int slot, corner, face, kept, removed = 0;
+  int *tri;
+
+  dm->points[e->keep] = e->pos;
+  if (dm->normals) {
+    interpolate (dm->normals + e->keep, dm->normals + e->remove, e->t);
+    if (v3_length (dm->normals + e->keep) > 0.0)
+      v3_normalize (dm->normals + e->keep);
+  }
+  if (dm->colours)
+    interpolate (dm->colours + e->keep, dm->colours + e->remove, e->t);
+
+  for (slot = 0; slot < 10; slot++) keep->q[slot] += remove->q[slot];
+  keep->area += remove->area;
+  keep->stamp++;
+  remove->removed = TRUE;
+
+  for (slot = 0; slot < remove->face_count; slot++) {
+    face = remove->faces[slot];
+    if (face_removed[face]) continue;
+    if (face_has (face, e->keep)) {
+      face_removed[face] = TRUE;
+      removed++;
+    } else {
+      tri = dm->triangles + 3 * face;
+      for (corner = 0; corner < 3; corner++) {
+	if (tri[corner] == e->remove) tri[corner] = e->keep;
+      }
+      add_face (e->keep, face);
+    }
+  }
+  free (remove->faces);
+  remove->faces = NULL;
+  remove->face_count = 0;
+
+  kept = 0;			/* drop the removed triangles */
+  for (slot = 0; slot < keep->face_count; slot++) {
+    face = keep->faces[slot];
+    if (! face_removed[face]) keep->faces[kept++] = face;
+  }
+  keep->face_count = kept;
+
+  mark_count++;			/* new collapses for the edges around */
+  vertices[e->keep].mark = mark_count;
+  for (slot = 0; slot < keep->face_count; slot++) {
+    tri = dm->triangles + 3 * keep->faces[slot];
+    for (corner = 0; corner < 3; corner++) {
+      if (vertices[tri[corner]].mark == mark_count) continue;
+      vertices[tri[corner]].mark = mark_count;
+      push_edge (e->keep, tri[corner]);
+    }
+  }
+
+  return removed;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+setup_vertices (void)
+     /*
+       The quadrics from the planes of the triangles, and the vertices
+       on a border, i.e. on an edge not shared by exactly two triangles.
+     */
+{
+  int slot, face, corner, other, vertex, count;
+  int *tri;
+  vector3 normal;
+  double length;
+  dvertex *dv;
+
+  vertices = calloc (dm->count, sizeof (dvertex));
+  face_removed = calloc (face_count, sizeof (boolean));
+
+  for (face = 0; face < face_count; face++) {
+    tri = dm->triangles + 3 * face;
+    face_normal (&normal, dm->points + tri[0],
+		 dm->points + tri[1], dm->points + tri[2]);
+    length = v3_length (&normal);
+    if (length > 0.0) v3_scale (&normal, 1.0 / length);
+    for (corner = 0; corner < 3; corner++) {
+      dv = vertices + tri[corner];
+      quadric_add_plane (dv->q, &normal,
+			 -v3_dot_product (&normal, dm->points + tri[0]),
+			 0.5 * length);
+      dv->area += 0.5 * length;
+      add_face (tri[corner], face);
+    }
+  }
+
+  for (vertex = 0; vertex < dm->count; vertex++) {
+    dv = vertices + vertex;
+    for (slot = 0; slot < dv->face_count; slot++) {
+      tri = dm->triangles + 3 * dv->faces[slot];
+      for (corner = 0; corner < 3; corner++) {
+	other = tri[corner];
+	if (other == vertex) continue;
+	count = 0;
+	for (face = 0; face < dv->face_count; face++) {
+	  if (face_has (dv->faces[face], other)) count++;
+	}
+	if (count != 2) {
+	  dv->locked = TRUE;
+	  vertices[other].locked = TRUE;
+	}
+      }
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static int
+decimate_mesh (mesh *m, int target, double tolerance)
+     /*
+       Collapse edges until at most 'target' triangles remain (if >0),
+       or until the error would exceed 'tolerance' (if >0.0). Return
+       the number of triangles left.
+     */
+{
+  dedge e;
+  int slot, face, corner, triangles, kept;
+  double max_cost;
+  int *tri;
+
+  assert (m);
+
+  dm = m;
+  face_count = triangles = m->triangle_count;
+  max_cost = (tolerance > 0.0) ? tolerance * tolerance : -1.0;
+  mark_count = 0;
+  setup_vertices();
+
+  heap_count = 0;
+  heap_alloc = 3 * face_count + 16;
+  heap = malloc (heap_alloc * sizeof (dedge));
+  for (face = 0; face < face_count; face++) {
+    tri = m->triangles + 3 * face;
+    for (corner = 0; corner < 3; corner++) {
+      if (tri[corner] < tri[(corner + 1) % 3])
+	push_edge (tri[corner], tri[(corner + 1) % 3]);
+    }
+  }
+
+  while ((heap_count > 0) && (triangles > target)) {
+    heap_pop (&e);
+    if (vertices[e.keep].removed || vertices[e.remove].removed) continue;
+    if ((vertices[e.keep].stamp != e.keep_stamp) ||
+	(vertices[e.remove].stamp != e.remove_stamp)) continue;
+    if ((max_cost >= 0.0) && (e.cost > max_cost)) break;
+    if (! collapse_valid (&e)) continue;
+    triangles -= collapse (&e);
+  }
+
+  kept = 0;			/* compact the triangle list */
+  for (face = 0; face < face_count; face++) {
+    if (face_removed[face]) continue;
+    for (corner = 0; corner < 3; corner++)
+      m->triangles[3 * kept + corner] = m->triangles[3 * face + corner];
+    kept++;
+  }
+  m->triangle_count = kept;
+  assert (kept == triangles);
+
+  for (slot = 0; slot < m->count; slot++) {
+    if (vertices[slot].faces) free (vertices[slot].faces);
+  }
+  free (vertices);
+  free (face_removed);
+  free (heap);
+  vertices = NULL;
+  face_removed = NULL;
+  heap = NULL;
+  dm = NULL;
+
+  return kept;
+}
+
+
+/*------------------------------------------------------------*/
+boolean
+decimate_code (int code)
+     /*
+       Are triangles of this object code to be decimated? Always at
+       the coarser detail levels.
+     */
+{
+  if ((decimate_pixels <= 0.0) && (decimate_triangles <= 0) &&
+      (detail_level == 0)) return FALSE;
+
+  switch (code) {
+  case OBJ_TRIANGLES:
+  case OBJ_TRIANGLES_COLOURS:
+  case OBJ_TRIANGLES_NORMALS:
+  case OBJ_TRIANGLES_NORMALS_COLOURS:
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*------------------------------------------------------------*/
+void
+decimate_add (int code, vector3 *triplets, int count)
+     /* Collect the triangles for decimation by 'decimate_output'. */
+{
+  int slot = code - OBJ_TRIANGLES;
+
+  assert (decimate_code (code));
+  assert (triplets);
+  assert (count > 0);
+
+  if (meshes[slot] == NULL)
+    meshes[slot] = mesh_create ((code == OBJ_TRIANGLES_NORMALS) ||
+				(code == OBJ_TRIANGLES_NORMALS_COLOURS),
+				(code == OBJ_TRIANGLES_COLOURS) ||
+				(code == OBJ_TRIANGLES_NORMALS_COLOURS));
+  mesh_add_object (meshes[slot], code, triplets, count);
+}
+
+
+/*------------------------------------------------------------*/
+void
+decimate_output (void)
+     /*
+       Decimate the collected triangles and output them. The target
+       triangle count is shared between the object codes in proportion
+       to their triangles. At the coarser detail levels, the pixel size
+       is larger and the target count is divided by four for each level.
+     */
+{
+  int slot, code, count, total, target, before = 0, after = 0;
+  double pixels, tolerance;
+  vector3 *triplets;
+
+  total = 0;
+  for (slot = 0; slot < 4; slot++) {
+    if (meshes[slot]) total += meshes[slot]->triangle_count;
+  }
+  if (total == 0) goto cleanup;
+
+  pixels = decimate_pixels;
+  if ((pixels <= 0.0) && (detail_level > 0)) pixels = DEFAULT_PIXELS;
+  tolerance = (pixels > 0.0) ? pixels * pixel_size() : 0.0;
+
+  for (slot = 0; slot < 4; slot++) {
+    if (meshes[slot] == NULL) continue;
+    code = OBJ_TRIANGLES + slot;
+    count = meshes[slot]->triangle_count;
+    before += count;
+    target = 0;
+    if (decimate_triangles > 0) {
+      target = (int) ((double) decimate_triangles * (double) count /
+		      (double) total) >> (2 * detail_level);
+      if (target < 1) target = 1;
+    }
+    after += decimate_mesh (meshes[slot], target, tolerance);
+    triplets = mesh_to_object (meshes[slot], code, &count);
+    if (triplets) {
+      output_object (code, triplets, count);
+      free (triplets);
+    }
+  }
+
+  if (message_mode)
+    fprintf (stderr, "%i of %i triangles left after decimation\n",
+	     after, before);
+
+cleanup:
+  for (slot = 0; slot < 4; slot++) {
+    if (meshes[slot]) mesh_delete (meshes[slot]);
+    meshes[slot] = NULL;
+  }
+}
@@ -0,0 +1,21 @@
+/* decimate.h
+
+   MolScript v2.1.2
+
+   Decimation of triangle objects by quadric error edge collapse.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#ifndef DECIMATE_H
+#define DECIMATE_H 1
+
+#include "clib/boolean.h"
+#include "clib/vector3.h"
+
+boolean decimate_code (int code);
+void decimate_add (int code, vector3 *triplets, int count);
+void decimate_output (void);
+
+#endif
@@ -4,23 +4,22 @@
 
    Encapsulated PostScript (EPS) image file.
 
-   This implementation relies on the 'image.c' code, and therefore
-   implicitly on OpenGL and GLX.
+   This implementation relies on the 'image.c' code for rendering.
 
    Copyright (C) 1997-1998 Per Kraulis
     13-Sep-1997  working
+    18-Oct-2026  use image_read_row; no direct OpenGL calls
+    18-Oct-2026  one image file per plot
+    18-Oct-2026  options reset for each output (batch mode)
 */
 
 #include <assert.h>
 #include <stdlib.h>
 
-#include <GL/gl.h>
-
 #include "eps_img.h"
 #include "global.h"
 #include "graphics.h"
 #include "image.h"
-#include "opengl.h"
 
 
 /*============================================================*/
@@ -32,15 +31,14 @@ static float scale = 1.0;
 void
 eps_set (void)
 {
-  ogl_set();
-
-  output_first_plot = eps_first_plot;
-  output_finish_output = eps_finish_output;
-  output_start_plot = ogl_start_plot_general;
+  image_set (eps_first_plot, eps_finish_output);
 
   output_pickable = NULL;
 
   output_mode = EPS_MODE;
+
+  components = 3;
+  scale = 1.0;
 }
 
 
@@ -48,7 +46,6 @@ eps_set (void)
 void
 eps_first_plot (void)
 {
-  image_first_plot();
   set_outfile ("w");
 
   if (fprintf (outfile, "%%!PS-Adobe-3.0 EPSF-3.0\n") < 0)
@@ -92,8 +89,8 @@ eps_first_plot (void)
   fprintf (outfile, "[%i 0 0 %i 0 0]\n", output_width, output_height);
   PRINT ("{currentfile picstr readhexstring pop}\n");
   fprintf (outfile, "false %i\n", components);
-  fprintf (outfile, "%%%%BeginData: %i Hex Bytes\n",
-	            2 * output_width * output_height * components + 11);
+  fprintf (outfile, "%%%%BeginData: %.0f Hex Bytes\n",
+	   2.0 * output_width * output_height * components + 11.0);
   PRINT ("colorimage\n");
 }
 
@@ -104,22 +101,22 @@ eps_finish_output (void)
 {
   int byte_count = output_width * components;
   int row, pos, slot;
-  GLenum format;
+  int format;
   unsigned char *buffer;
-  char *pix;
+  unsigned char *pix;
 
-  format = (components == 1) ? GL_LUMINANCE : GL_RGB;
+  format = (components == 1) ? IMAGE_LUMINANCE : IMAGE_RGB;
 
   image_render();
 
   buffer = malloc (byte_count * sizeof (unsigned char));
 
   for (row = 0; row < output_height; row++) {
-    glReadPixels (0, row, output_width, 1, format, GL_UNSIGNED_BYTE, buffer);
+    image_read_row (row, format, buffer);
     pos = 0;
-    pix = (char *) buffer;
+    pix = buffer;
     for (slot = 0; slot < byte_count; slot++) {
-      fprintf (outfile, "%02hx", *pix++);
+      fprintf (outfile, "%02x", *pix++);
       if (++pos >= 32) {
 	fprintf (outfile, "\n");
 	pos = 0;
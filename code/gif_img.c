@@ -8,24 +8,23 @@
    http://www.boutell.com. The source code for this library does *not*
    use LZW compression, so there is no conflict with the (infamous)
    Unisys patent on the LZW algorithm. This implementation relies on
-   the 'image.c' code, and therefore implicitly on OpenGL and GLX.
+   the 'image.c' code for rendering.
 
    Copyright (C) 1998 Per Kraulis
     29-Jul-1998  first attempts
+    18-Oct-2026  use image_read_row; no direct OpenGL calls
+    18-Oct-2026  one image file per plot
 */
 
 #include <assert.h>
 #include <stdlib.h>
 
-#include <GL/gl.h>
-
 #include <gd.h>
 
 #include "gif_img.h"
 #include "global.h"
 #include "graphics.h"
 #include "image.h"
-#include "opengl.h"
 
 
 /*============================================================*/
@@ -36,11 +35,7 @@ static gdImagePtr image;
 void
 gifi_set (void)
 {
-  ogl_set();
-
-  output_first_plot = gifi_first_plot;
-  output_finish_output = gifi_finish_output;
-  output_start_plot = ogl_start_plot_general;
+  image_set (gifi_first_plot, gifi_finish_output);
 
   output_pickable = NULL;
 
@@ -54,7 +49,6 @@ gifi_first_plot (void)
 {
   int r, g, b, slot;
 
-  image_first_plot();
   set_outfile ("wb");
 
   image = gdImageCreate (output_width, output_height);
@@ -99,8 +93,7 @@ gifi_finish_output (void)
       bnext[col] = 0;
     }
 
-    glReadPixels (0, output_height - row - 1, output_width, 1,
-		  GL_RGB, GL_UNSIGNED_BYTE, buffer);
+    image_read_row (output_height - row - 1, IMAGE_RGB, buffer);
     buf = buffer;
     for (col = 0; col < output_width; col++) {
       rcurr[col] += *buf++;
@@ -6,27 +6,50 @@
 
    Copyright (C) 1997-1998 Per Kraulis
      1-Dec-1996  first attempts
+    18-Oct-2026  batch mode
+    18-Oct-2026  render server
+    18-Oct-2026  watch mode
+    18-Oct-2026  animation frames
+    18-Oct-2026  trajectory frames
+    18-Oct-2026  adaptive spline segments
+    18-Oct-2026  conversion of object files to the binary format
+    18-Oct-2026  decimation of triangle objects
+    18-Oct-2026  batch jobs rendered by render_input; the output file of
+                 a failed batch job is removed
+    18-Oct-2026  numbered output file names shared by plots and frames
+    18-Oct-2026  option -adaptive replaced by the state adaptivesegments
 */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "clib/args.h"
 #include "clib/str_utils.h"
+#include "clib/dynstring.h"
 
 #include "global.h"
 #include "lex.h"
+#include "col.h"
 #include "state.h"
 #include "graphics.h"
 #include "xform.h"
+#include "coord.h"
+#include "select.h"
 #include "postscript.h"
 #include "raster3d.h"
+#include "raytrace.h"
 #include "vrml.h"
+#include "gltf.h"
+#include "trajectory.h"
+#include "objfile.h"
 
 #ifdef OPENGL_SUPPORT
 #include "opengl.h"
+#endif
 #ifdef IMAGE_SUPPORT
 #include "image.h"
+#include "swrender.h"
 #include "eps_img.h"
 #include "sgi_img.h"
 #ifdef JPEG_SUPPORT
@@ -39,7 +62,8 @@
 #include "gif_img.h"
 #endif
 #endif
-#endif
+
+#define MAX_BATCH_ARGS 32
 
 
 /*------------------------------------------------------------*/
@@ -47,15 +71,24 @@ const char program_str[] = "MolScript v2.1.2";
 const char copyright_str[] = "Copyright (C) 1997-1998 Per J. Kraulis";
 char user_str[81];
 
+static char *created_filename = NULL; /* output file opened by set_outfile */
+
 int output_mode = UNDEFINED_MODE;
 
 char *input_filename = NULL;
 char *output_filename = NULL;
 char *tmp_filename = NULL;
+char *batch_filename = NULL;
+char *server_filename = NULL;
+boolean watch_mode = FALSE;
+boolean trajectory_mode = FALSE;
 FILE *outfile;
 boolean message_mode = TRUE;
 boolean exit_on_error = TRUE;
+jmp_buf *error_return = NULL;
 boolean pretty_format = FALSE;
+double decimate_pixels = 0.0;
+int decimate_triangles = 0;
 int output_width = 500;
 int output_height = 500;
 
@@ -173,56 +206,19 @@ argument_error (const char *msg, int slot)
   } else {
     fprintf (stderr, "Error: %s\n", msg);
   }
+  if (error_return) longjmp (*error_return, 1);
   exit (1);
 }
 
 
 /*------------------------------------------------------------*/
-void
-process_arguments (int *argcp, char *argv[])
+static void
+format_arguments (void)
+     /* The output format options; also used for each batch job. */
 {
   int slot, slot2;
   char *str;
 
-  args_initialize (*argcp, argv);
-  args_flag (0);
-
-  slot = args_exists ("-h");
-  if (slot) {
-    fprintf (stderr, "Usage: molscript [options] < script > outfile\n");
-    fprintf (stderr, "-ps -postscript      PostScript file output (default)\n");
-    fprintf (stderr, "-r -raster3d [alias] Raster3D file output (for 'render'), alias=1,2,3\n");
-    fprintf (stderr, "-vrml                VRML 2.0 file output\n");
-#ifdef OPENGL_SUPPORT
-    fprintf (stderr, "-gl -opengl          OpenGL interactive graphics output (no file)\n");
-#ifdef IMAGE_SUPPORT
-    fprintf (stderr, "-eps [scale]         Encapsulated PS image file output, scale>0.0 (default 1.0)\n");
-    fprintf (stderr, "-epsbw [scale]       Encapsulated PS black-and-white image file output\n");
-    fprintf (stderr, "-sgi -rgb            SGI (aka RGB) image file output\n");
-#ifdef JPEG_SUPPORT
-    fprintf (stderr, "-jpeg [quality]      JPEG image file output, quality=1-100 (default 90)\n");
-#endif
-#ifdef PNG_SUPPORT
-    fprintf (stderr, "-png [compress]      PNG image file output, compress=default,none,speed,size\n");
-#endif
-#ifdef GIF_SUPPORT
-    fprintf (stderr, "-gif                 GIF image file output\n");
-#endif
-#endif
-    fprintf (stderr, "-accum number        image accumulation steps, number>=1 (only OpenGL & images)\n");
-#endif
-    fprintf (stderr, "-pretty              nicely formatted output (VRML only)\n");
-    fprintf (stderr, "-size width height   size of output image (pixels; default 500 500)\n");
-    fprintf (stderr, "-s -silent           silent execution; no messages\n");
-    fprintf (stderr, "-out filename        output to the named file, instead of stdout\n");
-    fprintf (stderr, "-in filename         input from the named file, instead of stdin\n");
-    fprintf (stderr, "-log filename        messages to the named log file, instead of stderr\n");
-    fprintf (stderr, "-tmp filename        temporary file to use, if needed\n");
-    fprintf (stderr, "-h                   output this message\n");
-    banner();
-    exit (0);
-  }
-
   slot = args_exists ("-ps");
   slot2 = args_exists ("-postscript");
   if (slot || slot2) {
@@ -261,6 +257,13 @@ process_arguments (int *argcp, char *argv[])
     vrml_set();
   }
 
+  slot = args_exists ("-gltf");
+  if (slot) {
+    if (output_mode != UNDEFINED_MODE) goto format_error;
+    args_flag (slot);
+    gltf_set();
+  }
+
 #ifdef OPENGL_SUPPORT
 
   slot = args_exists ("-gl");
@@ -272,6 +275,8 @@ process_arguments (int *argcp, char *argv[])
     ogl_set();
   }
 
+#endif /* OPENGL_SUPPORT */
+
 #ifdef IMAGE_SUPPORT
 
   slot = args_exists ("-eps");
@@ -334,6 +339,17 @@ process_arguments (int *argcp, char *argv[])
     str = args_item (slot + 1);
     if (str && pngi_set_compression (str)) args_flag (slot + 1);
   }
+
+  slot = args_exists ("-pngfilter");
+  if (slot) {
+    args_flag (slot);
+    str = args_item (slot + 1);
+    if (str == NULL)
+      argument_error ("no filter given for option -pngfilter", -1);
+    if (! pngi_set_filter (str))
+      argument_error ("invalid filter for option -pngfilter", slot + 1);
+    args_flag (slot + 1);
+  }
 #endif /* PNG_SUPPORT */
 
 #ifdef GIF_SUPPORT
@@ -347,6 +363,130 @@ process_arguments (int *argcp, char *argv[])
 
 #endif /* IMAGE_SUPPORT */
 
+  return;
+
+format_error:
+  argument_error ("more than one format options given", slot);
+}
+
+
+/*------------------------------------------------------------*/
+void
+process_arguments (int *argcp, char *argv[])
+{
+  int slot, slot2;
+  char *str;
+
+  args_initialize (*argcp, argv);
+  args_flag (0);
+
+  slot = args_exists ("-h");
+  if (slot) {
+    fprintf (stderr, "Usage: molscript [options] < script > outfile\n");
+    fprintf (stderr, "-ps -postscript      PostScript file output (default)\n");
+    fprintf (stderr, "-r -raster3d [alias] Raster3D file output (for 'render'), alias=1,2,3\n");
+    fprintf (stderr, "-vrml                VRML 2.0 file output\n");
+    fprintf (stderr, "-gltf                glTF 2.0 binary (GLB) file output\n");
+#ifdef OPENGL_SUPPORT
+    fprintf (stderr, "-gl -opengl          OpenGL interactive graphics output (no file)\n");
+#endif
+#ifdef IMAGE_SUPPORT
+    fprintf (stderr, "-eps [scale]         Encapsulated PS image file output, scale>0.0 (default 1.0)\n");
+    fprintf (stderr, "-epsbw [scale]       Encapsulated PS black-and-white image file output\n");
+    fprintf (stderr, "-sgi -rgb            SGI (aka RGB) image file output\n");
+#ifdef JPEG_SUPPORT
+    fprintf (stderr, "-jpeg [quality]      JPEG image file output, quality=1-100 (default 90)\n");
+#endif
+#ifdef PNG_SUPPORT
+    fprintf (stderr, "-png [compress]      PNG image file output, compress=default,none,speed,size\n");
+    fprintf (stderr, "-pngfilter filter    PNG row filter, filter=adaptive,none,sub,up,average,paeth\n");
+#endif
+#ifdef GIF_SUPPORT
+    fprintf (stderr, "-gif                 GIF image file output\n");
+#endif
+    fprintf (stderr, "-software            software rendering of image output (no X display)\n");
+    fprintf (stderr, "-raytrace [ao]       ray traced image output, ao=occlusion samples (default 0)\n");
+    fprintf (stderr, "-frames number [deg] animation frames of each plot; via its viewpoints, or turned deg about y\n");
+#endif
+#if defined(OPENGL_SUPPORT) || defined(IMAGE_SUPPORT)
+    fprintf (stderr, "-accum number        image accumulation steps, number>=1 (only OpenGL & images)\n");
+#endif
+    fprintf (stderr, "-pretty              nicely formatted output (VRML only)\n");
+    fprintf (stderr, "-decimate [pixels]   reduce object triangles to error, pixels>0.0 (default 0.5)\n");
+    fprintf (stderr, "-triangles number    reduce object triangles to at most number\n");
+    fprintf (stderr, "-size width height   size of output image (pixels; default 500 500)\n");
+    fprintf (stderr, "-s -silent           silent execution; no messages\n");
+    fprintf (stderr, "-out filename        output to the named file, instead of stdout\n");
+    fprintf (stderr, "-in filename         input from the named file, instead of stdin\n");
+    fprintf (stderr, "-batch filename      render the jobs in the named file: input output [format]\n");
+    fprintf (stderr, "-server filename     render server listening on the named Unix socket\n");
+    fprintf (stderr, "-watch               render again whenever the input or its files change\n");
+    fprintf (stderr, "-trajectory f l [s]  render for trajectory frames f to l, step s (default 1)\n");
+    fprintf (stderr, "-objconvert in out   convert the text object file to the binary format\n");
+    fprintf (stderr, "-log filename        messages to the named log file, instead of stderr\n");
+    fprintf (stderr, "-tmp filename        temporary file to use, if needed\n");
+    fprintf (stderr, "-h                   output this message\n");
+    banner();
+    exit (0);
+  }
+
+  slot = args_exists ("-objconvert");
+  if (slot) {
+    args_flag (slot);
+    str = args_item (slot + 1);
+    if ((str == NULL) || (args_item (slot + 2) == NULL))
+      argument_error ("two filenames needed for option -objconvert", -1);
+    exit (objfile_convert (str, args_item (slot + 2)) ? 0 : 1);
+  }
+
+#ifdef IMAGE_SUPPORT
+
+  slot = args_exists ("-software");
+  if (slot) {
+    args_flag (slot);
+    image_set_software();
+  }
+
+  slot = args_exists ("-raytrace");
+  if (slot) {
+    args_flag (slot);
+    image_set_raytrace();
+    str = args_item (slot + 1);
+    if (str) {
+      int samples;
+      if (sscanf (str, "%i", &samples) == 1) {
+	if (samples < 0)
+	  argument_error ("invalid occlusion samples for option -raytrace",
+			  slot + 1);
+	args_flag (slot + 1);
+	rt_set_occlusion (samples);
+      }
+    }
+  }
+
+  slot = args_exists ("-frames");
+  if (slot) {
+    int number;
+    double degrees = 360.0;
+    args_flag (slot);
+    str = args_item (slot + 1);
+    if (str) {
+      if ((sscanf (str, "%i", &number) != 1) || (number <= 0))
+	argument_error ("invalid number for option -frames", slot + 1);
+      args_flag (slot + 1);
+      str = args_item (slot + 2);
+      if (str && (sscanf (str, "%lf", &degrees) == 1)) args_flag (slot + 2);
+      image_set_frames (number, degrees);
+    } else {
+      argument_error ("no number given for option -frames", -1);
+    }
+  }
+
+#endif /* IMAGE_SUPPORT */
+
+  format_arguments();
+
+#if defined(OPENGL_SUPPORT) || defined(IMAGE_SUPPORT)
   slot = args_exists ("-accum");
   if (slot) {
     int number;
@@ -356,15 +496,20 @@ process_arguments (int *argcp, char *argv[])
       if ((sscanf (str, "%i", &number) != 1) || (number <= 0)) {
 	argument_error ("invalid number for option -accum", slot + 1);
       } else {
+#ifdef OPENGL_SUPPORT
 	ogl_set_accum (number);
+#endif
+#ifdef IMAGE_SUPPORT
+	swr_set_accum (number);
+	rt_set_accum (number);
+#endif
 	args_flag (slot + 1);
       }
     } else {
       argument_error ("no number given for option -accum", -1);
     }
   }
-
-#endif /* OPENGL_SUPPORT */
+#endif
 
   slot = args_exists ("-pretty");
   if (slot) {
@@ -372,19 +517,47 @@ process_arguments (int *argcp, char *argv[])
     pretty_format = TRUE;
   }
 
+  slot = args_exists ("-decimate");
+  if (slot) {
+    args_flag (slot);
+    decimate_pixels = 0.5;
+    str = args_item (slot + 1);
+    if (str) {
+      double pixels;
+      if (sscanf (str, "%lf", &pixels) == 1) {
+	if (pixels <= 0.0)
+	  argument_error ("invalid pixels for option -decimate", slot + 1);
+	args_flag (slot + 1);
+	decimate_pixels = pixels;
+      }
+    }
+  }
+
+  slot = args_exists ("-triangles");
+  if (slot) {
+    args_flag (slot);
+    str = args_item (slot + 1);
+    if (str == NULL)
+      argument_error ("number needed for option -triangles", -1);
+    if ((sscanf (str, "%i", &decimate_triangles) != 1) ||
+	(decimate_triangles < 1))
+      argument_error ("invalid number for option -triangles", slot + 1);
+    args_flag (slot + 1);
+  }
+
   slot = args_exists ("-size");
   if (slot) {
     args_flag (slot);
     str = args_item (slot + 1);
     if (str) {
       if ((sscanf (str, "%i", &output_width) != 1) ||
-	  output_width < 1 || output_width > 4096)
+	  output_width < 1 || output_width > 65500)
 	argument_error ("invalid width for option -size", slot + 1);
       args_flag (slot + 1);
       str = args_item (slot + 2);
       if (str) {
 	if ((sscanf (str, "%i", &output_height) != 1) ||
-	    output_height < 1 || output_height > 4096)
+	    output_height < 1 || output_height > 65500)
 	  argument_error ("invalid height for option -size", slot + 2);
 	args_flag (slot + 2);
       } else {
@@ -456,15 +629,229 @@ process_arguments (int *argcp, char *argv[])
     }
   }
 
+  slot = args_exists ("-batch");
+  if (slot) {
+    args_flag (slot);
+    str = args_item (slot + 1);
+    if (str) {
+      batch_filename = str;
+      args_flag (slot + 1);
+    } else {
+      argument_error ("no filename given for option -batch", -1);
+    }
+  }
+
+  slot = args_exists ("-server");
+  if (slot) {
+    args_flag (slot);
+    str = args_item (slot + 1);
+    if (str) {
+      server_filename = str;
+      args_flag (slot + 1);
+    } else {
+      argument_error ("no socket filename given for option -server", -1);
+    }
+    if (batch_filename)
+      argument_error ("option -batch not possible with -server", slot);
+  }
+
+  slot = args_exists ("-watch");
+  if (slot) {
+    args_flag (slot);
+    watch_mode = TRUE;
+    if (batch_filename || server_filename)
+      argument_error ("option -watch not possible with -batch or -server", slot);
+    if (input_filename == NULL)
+      argument_error ("option -watch requires option -in", slot);
+    if (output_filename == NULL)
+      argument_error ("option -watch requires option -out", slot);
+    if (output_mode == OPENGL_MODE)
+      argument_error ("option -watch not possible with OpenGL output", slot);
+  }
+
+  slot = args_exists ("-trajectory");
+  if (slot) {
+    int first, last, step = 1;
+    args_flag (slot);
+    trajectory_mode = TRUE;
+    str = args_item (slot + 1);
+    if ((str == NULL) || (sscanf (str, "%i", &first) != 1) || (first <= 0))
+      argument_error ("invalid first frame for option -trajectory", -1);
+    args_flag (slot + 1);
+    str = args_item (slot + 2);
+    if ((str == NULL) || (sscanf (str, "%i", &last) != 1) || (last < first))
+      argument_error ("invalid last frame for option -trajectory", -1);
+    args_flag (slot + 2);
+    str = args_item (slot + 3);
+    if (str && (sscanf (str, "%i", &step) == 1)) {
+      if (step <= 0)
+	argument_error ("invalid step for option -trajectory", slot + 3);
+      args_flag (slot + 3);
+    }
+    trajectory_set_range (first, last, step);
+    if (batch_filename || server_filename || watch_mode)
+      argument_error ("option -trajectory not possible with -batch, -server or -watch", slot);
+    if (input_filename == NULL)
+      argument_error ("option -trajectory requires option -in", slot);
+    if (output_filename == NULL)
+      argument_error ("option -trajectory requires option -out", slot);
+    if (output_mode == OPENGL_MODE)
+      argument_error ("option -trajectory not possible with OpenGL output", slot);
+  }
+
+  if (batch_filename || server_filename) {
+    if (input_filename || output_filename)
+      argument_error ("option -in or -out not possible with -batch or -server", -1);
+    if (output_mode != UNDEFINED_MODE)
+      argument_error ("format option not possible with -batch or -server", -1);
+  }
+
   if (args_unflagged() >= 0)
     argument_error ("invalid command line option", args_unflagged());
 
+  if (output_mode == UNDEFINED_MODE &&
+      batch_filename == NULL && server_filename == NULL) ps_set();
+}
+
+
+/*------------------------------------------------------------*/
+void
+job_format (int argc, char *argv[], int fixed)
+     /*
+       Set the output format of a batch or server job from the options
+       following the 'fixed' items in argv.
+     */
+{
+  int slot;
+
+  assert (argc > fixed);
+
+  args_initialize (argc, argv);
+  for (slot = 0; slot <= fixed; slot++) args_flag (slot);
+
+  output_mode = UNDEFINED_MODE;
+  constant_colours_init();
+  format_arguments();
+  if (args_unflagged() >= 0)
+    argument_error ("invalid job option", args_unflagged());
   if (output_mode == UNDEFINED_MODE) ps_set();
+  if (output_mode == OPENGL_MODE)
+    argument_error ("OpenGL output not possible for a job", -1);
+}
 
-  return;
 
-format_error:
-  argument_error ("more than one format options given", slot);
+/*------------------------------------------------------------*/
+int
+process_batch (void)
+     /*
+       Render the jobs in the batch file, one per line: the input
+       script, the output file and the format options, if any ('#'
+       starts a comment). All is reset between jobs; molecule files
+       are read only once. Return the number of failed jobs.
+     */
+{
+  FILE *file;
+  dynstring *contents;
+  jmp_buf env;
+  char *line, *next, *str;
+  char *argv [MAX_BATCH_ARGS];
+  volatile int argc;
+  int ch;
+  volatile int job = 0;
+  volatile int failed = 0;
+
+  assert (batch_filename);
+
+  file = fopen (batch_filename, "r");
+  if (file == NULL) argument_error ("could not open the batch file", -1);
+  contents = ds_create ("");
+  while ((ch = fgetc (file)) != EOF) ds_add (contents, ch);
+  fclose (file);
+
+  cache_molecules();
+#ifdef IMAGE_SUPPORT
+  image_detach_plots();
+#endif
+
+  for (line = contents->string; line; line = next) {
+    next = strchr (line, '\n');
+    if (next) *next++ = '\0';
+
+    argc = 0;
+    argv[argc++] = "molscript";
+    for (str = strtok (line, " \t\r"); str; str = strtok (NULL, " \t\r")) {
+      if (*str == '#') break;
+      if (argc < MAX_BATCH_ARGS) argv[argc] = str;
+      argc++;
+    }
+    if (argc == 1) continue;	/* blank or comment line */
+    job++;
+    created_filename = NULL;
+
+    if (setjmp (env)) {
+      fprintf (stderr, "Error: batch job %i failed: %s\n", job, argv[1]);
+      if (outfile && (outfile != stdout)) fclose (outfile);
+      outfile = stdout;
+      if (created_filename) remove (created_filename);
+      failed++;
+      continue;
+    }
+    error_return = &env;
+
+    if (argc > MAX_BATCH_ARGS)
+      argument_error ("too many options for batch job", -1);
+    if (argc < 3) {
+      args_initialize (argc, argv);
+      argument_error ("no output file given for batch job", 1);
+    }
+    job_format (argc, argv, 2);
+
+    if (message_mode)
+      fprintf (stderr, "batch job %i: %s -> %s\n", job, argv[1], argv[2]);
+
+    render_input (argv[1], argv[2]);
+  }
+
+  error_return = NULL;
+  input_filename = NULL;
+  output_filename = NULL;
+#ifdef IMAGE_SUPPORT
+  failed += image_wait_plots();
+#endif
+  ds_delete (contents);
+
+  return failed;
+}
+
+
+/*------------------------------------------------------------*/
+void
+render_input (char *input, char *output)
+     /*
+       Render the input file into the output file, from the initial
+       state of the interpreter. An error returns via 'error_return'.
+     */
+{
+  FILE *file;
+
+  assert (input);
+  assert (output);
+
+  global_init();
+  lex_init();
+  input_filename = input;
+  lex_set_input_file (input_filename);
+  if (lex_input_file() == NULL) yyerror ("could not open the input file");
+  output_filename = output;
+
+  yyparse();
+  output_finish_output();
+
+  if (outfile != stdout) {
+    file = outfile;
+    outfile = stdout;
+    if (fclose (file) != 0) yyerror ("could not write the output file");
+  }
 }
 
 
@@ -478,11 +865,52 @@ set_outfile (const char *mode)
   if (output_filename) {
     outfile = fopen (output_filename, mode);
     if (outfile == NULL) yyerror ("could not create the output file");
+    created_filename = output_filename;
     output_filename = NULL;
   }
 }
 
 
+/*------------------------------------------------------------*/
+char *
+numbered_filename (char *template, int number, char *error)
+     /*
+       The output file name for the number: either a 'printf' template
+       with one integer conversion, or the number is inserted before
+       the extension. An invalid template is reported by the error
+       message, and then numbered as a plain name.
+     */
+{
+  char *name, *pos, *dot;
+  int length, width;
+
+  /* pre */
+  assert (template);
+  assert (error);
+
+  length = strlen (template);
+  pos = strchr (template, '%');
+
+  if (pos) {			/* template: one integer conversion */
+    pos += strspn (pos + 1, "-+ #0") + 1;
+    width = (int) strtol (pos, &pos, 10);
+    if (((*pos == 'i') || (*pos == 'd')) && ! strchr (pos, '%')) {
+      name = malloc ((length + width + 32) * sizeof (char));
+      sprintf (name, template, number);
+      return name;
+    }
+    yyerror (error);
+  }
+
+  name = malloc ((length + 32) * sizeof (char));
+  dot = strrchr (template, '.');
+  if ((dot == NULL) || strchr (dot, '/')) dot = template + length;
+  strncpy (name, template, dot - template);
+  sprintf (name + (dot - template), "-%i%s", number, dot);
+  return name;
+}
+
+
 /*------------------------------------------------------------*/
 void
 set_title (const char *str)
@@ -503,6 +931,7 @@ start_plot (void)
 
   state_init();
   graphics_plot_init();
+  clear_selections();
   delete_all_molecules();
   xform_init();
   clear_dstack();
@@ -7,12 +7,15 @@
    Copyright (C) 1997-1998 Per Kraulis
      1-Dec-1996  first attempts
     12-Sep-1997  rearranged modes
+    18-Oct-2026  batch mode
+    18-Oct-2026  render server
 */
 
 #ifndef GLOBAL_H
 #define GLOBAL_H 1
 
 #include <stdio.h>
+#include <setjmp.h>
 
 #include "clib/boolean.h"
 #include "clib/vector3.h"
@@ -28,6 +31,7 @@
 #define SGI_MODE        7
 #define PNG_MODE        8
 #define GIF_MODE        9
+#define GLTF_MODE      10
 
 #define PRINT(str) fprintf(outfile,"%s",(str))
 
@@ -40,10 +44,17 @@ extern int output_mode;
 extern char *input_filename;
 extern char *output_filename;
 extern char *tmp_filename;
+extern char *batch_filename;
+extern char *server_filename;
+extern boolean watch_mode;
+extern boolean trajectory_mode;
 extern FILE *outfile;
 extern boolean message_mode;
 extern boolean exit_on_error;
+extern jmp_buf *error_return;
 extern boolean pretty_format;
+extern double decimate_pixels;
+extern int decimate_triangles;
 extern int output_width;
 extern int output_height;
 
@@ -76,7 +87,11 @@ void banner (void);
 void not_implemented (const char *str);
 
 void process_arguments (int *argcp, char *argv[]);
+void job_format (int argc, char *argv[], int fixed);
+int process_batch (void);
+void render_input (char *input, char *output);
 void set_outfile (const char *mode);
+char *numbered_filename (char *template, int number, char *error);
 
 void set_title (const char *str);
 void start_plot (void);
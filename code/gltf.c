@@ -0,0 +1,1732 @@
+/* gltf.c
+
+   MolScript v2.1.2
+
+   glTF 2.0 binary (GLB) file output.
+
+   All geometry is collected in a binary buffer and a JSON description
+   during the plot, and the GLB file is written when output finishes.
+   Each drawing command becomes one mesh with welded, indexed vertices.
+   Vertex positions are stored as 16-bit integers, dequantised by the
+   node transform, and normals and colours as 8-bit normalized values
+   (KHR_mesh_quantization). Spheres, cylinders and sticks are drawn as
+   instances of unit meshes (EXT_mesh_gpu_instancing), one instanced
+   node for each material.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  fixed instance accessor offsets; vertex colours of objects
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "clib/angle.h"
+#include "clib/dynstring.h"
+#include "clib/double_hash.h"
+#include "clib/str_utils.h"
+
+#include "gltf.h"
+#include "global.h"
+#include "graphics.h"
+#include "mesh.h"
+#include "segment.h"
+#include "state.h"
+
+
+/*============================================================*/
+#define GLB_MAGIC      0x46546C67 /* 'glTF' */
+#define GLB_CHUNK_JSON 0x4E4F534A /* 'JSON' */
+#define GLB_CHUNK_BIN  0x004E4942 /* 'BIN\0' */
+
+#define GLTF_BYTE           5120
+#define GLTF_UNSIGNED_BYTE  5121
+#define GLTF_SHORT          5122
+#define GLTF_UNSIGNED_SHORT 5123
+#define GLTF_UNSIGNED_INT   5125
+#define GLTF_FLOAT          5126
+
+#define GLTF_ARRAY_BUFFER         34962
+#define GLTF_ELEMENT_ARRAY_BUFFER 34963
+
+#define MODE_POINTS    0
+#define MODE_LINES     1
+#define MODE_TRIANGLES 4
+
+#define QUANTUM_MAX 32767
+
+#define SPHERE_SUBDIVISIONS 2
+#define CYLINDER_SEGMENTS 16
+
+#define MAX_PRIMITIVES 4
+
+typedef struct {
+  mesh *m;
+  int mode;
+  int *indices;			/* points and lines only */
+  int index_count;
+  int index_alloc;
+  int material;
+} primitive;
+
+static primitive primitives[MAX_PRIMITIVES];
+static int primitive_count = 0;
+
+typedef struct {
+  int material;
+  boolean sphere;		/* otherwise cylinder */
+  float *data;			/* translation, rotation, scale */
+  int count;
+  int alloc;
+} instance_group;
+
+#define INSTANCE_FLOATS 10
+
+static instance_group *groups = NULL;
+static int group_count;
+static int group_alloc;
+static int group_last;
+
+static unsigned char *bin = NULL;
+static int bin_count;
+static int bin_alloc;
+
+static dynstring *json_accessors = NULL;
+static dynstring *json_views = NULL;
+static dynstring *json_meshes = NULL;
+static dynstring *json_nodes = NULL;
+static dynstring *json_materials = NULL;
+static int accessor_count;
+static int view_count;
+static int mesh_count;
+static int node_count;
+static int material_count;
+
+static dhash_table *material_table = NULL;
+
+static boolean used_instancing;
+static boolean used_unlit;
+
+static int sphere_accessors[3];	/* position, normal, indices */
+static int sphere_index_count;
+static int cylinder_accessors[3];
+static int cylinder_index_count;
+
+static char buf[1024];
+
+static int triangle_count;
+static int line_count;
+static int sphere_count;
+static int cylinder_count;
+
+
+/*------------------------------------------------------------*/
+static void
+bin_reserve (int bytes)
+{
+  assert (bytes >= 0);
+
+  if (bin_count + bytes > bin_alloc) {
+    while (bin_count + bytes > bin_alloc) bin_alloc *= 2;
+    bin = realloc (bin, bin_alloc);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+bin_byte (int b)
+{
+  bin_reserve (1);
+  bin[bin_count++] = (unsigned char) (b & 0xff);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+bin_short (int s)
+{
+  bin_reserve (2);
+  bin[bin_count++] = (unsigned char) (s & 0xff);
+  bin[bin_count++] = (unsigned char) ((s >> 8) & 0xff);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+bin_uint (unsigned int u)
+{
+  bin_reserve (4);
+  bin[bin_count++] = (unsigned char) (u & 0xff);
+  bin[bin_count++] = (unsigned char) ((u >> 8) & 0xff);
+  bin[bin_count++] = (unsigned char) ((u >> 16) & 0xff);
+  bin[bin_count++] = (unsigned char) ((u >> 24) & 0xff);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+bin_float (double d)
+{
+  float f = (float) d;
+  unsigned int u;
+
+  assert (sizeof (float) == sizeof (unsigned int));
+
+  memcpy (&u, &f, sizeof (float));
+  bin_uint (u);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+bin_align (void)
+{
+  while (bin_count % 4 != 0) bin_byte (0);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+json_separator (dynstring *ds, int count)
+{
+  assert (ds);
+
+  if (count > 0) ds_add (ds, ',');
+}
+
+
+/*------------------------------------------------------------*/
+static void
+json_string (dynstring *ds, const char *str)
+{
+  assert (ds);
+  assert (str);
+
+  ds_add (ds, '"');
+  for (; *str; str++) {
+    if ((*str == '"') || (*str == '\\')) {
+      ds_add (ds, '\\');
+      ds_add (ds, *str);
+    } else if ((unsigned char) *str >= ' ') {
+      ds_add (ds, *str);
+    }
+  }
+  ds_add (ds, '"');
+}
+
+
+/*------------------------------------------------------------*/
+static int
+add_view (int offset, int length, int stride, int target)
+{
+  assert (offset >= 0);
+  assert (offset % 4 == 0);
+  assert (length > 0);
+
+  json_separator (json_views, view_count);
+  sprintf (buf, "{\"buffer\":0,\"byteOffset\":%i,\"byteLength\":%i",
+	   offset, length);
+  ds_cat (json_views, buf);
+  if (stride > 0) {
+    sprintf (buf, ",\"byteStride\":%i", stride);
+    ds_cat (json_views, buf);
+  }
+  if (target > 0) {		/* none for instance data */
+    sprintf (buf, ",\"target\":%i", target);
+    ds_cat (json_views, buf);
+  }
+  ds_add (json_views, '}');
+
+  return view_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+add_offset_accessor (int view, int offset, int component, boolean normalized,
+		     int count, const char *type, const char *minmax)
+{
+  assert (view >= 0);
+  assert (offset >= 0);
+  assert (offset % 4 == 0);
+  assert (count > 0);
+  assert (type);
+
+  json_separator (json_accessors, accessor_count);
+  sprintf (buf, "{\"bufferView\":%i,\"componentType\":%i,\"count\":%i,\"type\":\"%s\"",
+	   view, component, count, type);
+  ds_cat (json_accessors, buf);
+  if (offset > 0) {
+    sprintf (buf, ",\"byteOffset\":%i", offset);
+    ds_cat (json_accessors, buf);
+  }
+  if (normalized) ds_cat (json_accessors, ",\"normalized\":true");
+  if (minmax) ds_cat (json_accessors, minmax);
+  ds_add (json_accessors, '}');
+
+  return accessor_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+add_accessor (int view, int component, boolean normalized, int count,
+	      const char *type, const char *minmax)
+{
+  return add_offset_accessor (view, 0, component, normalized, count,
+			      type, minmax);
+}
+
+
+/*------------------------------------------------------------*/
+static double
+linear (double c)
+     /* glTF colours are linear; MolScript colours are as displayed. */
+{
+  if (c <= 0.0) return 0.0;
+  if (c >= 1.0) return 1.0;
+  return pow (c, 2.2);
+}
+
+
+/*------------------------------------------------------------*/
+static int
+material_index (colour *base, boolean unlit, boolean double_sided)
+{
+  colour b, e;
+  int *index;
+  double alpha = 1.0 - current_state->transparency;
+
+  assert (base);
+
+  colour_copy_to_rgb (&b, base);
+  colour_copy_to_rgb (&e, &(current_state->emissivecolour));
+  sprintf (buf, "%.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %i %i",
+	   b.x, b.y, b.z, e.x, e.y, e.z,
+	   current_state->shininess, alpha, unlit, double_sided);
+
+  index = dhash_object (material_table, buf);
+  if (index) return *index;
+
+  index = malloc (sizeof (int));
+  *index = material_count;
+  dhash_insert (material_table, str_clone (buf), index);
+
+  json_separator (json_materials, material_count);
+  sprintf (buf, "{\"pbrMetallicRoughness\":{\"baseColorFactor\":[%.4g,%.4g,%.4g,%.4g],\"metallicFactor\":0,\"roughnessFactor\":%.3g}",
+	   linear (b.x), linear (b.y), linear (b.z), alpha,
+	   1.0 - 0.8 * current_state->shininess);
+  ds_cat (json_materials, buf);
+  if (colour_unequal (&e, &black_colour)) {
+    sprintf (buf, ",\"emissiveFactor\":[%.4g,%.4g,%.4g]",
+	     linear (e.x), linear (e.y), linear (e.z));
+    ds_cat (json_materials, buf);
+  }
+  if (alpha < 1.0) ds_cat (json_materials, ",\"alphaMode\":\"BLEND\"");
+  if (double_sided) ds_cat (json_materials, ",\"doubleSided\":true");
+  if (unlit) {
+    ds_cat (json_materials, ",\"extensions\":{\"KHR_materials_unlit\":{}}");
+    used_unlit = TRUE;
+  }
+  ds_add (json_materials, '}');
+
+  return material_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static primitive *
+start_primitive (int mode, boolean normals, int material)
+{
+  primitive *pr;
+
+  assert (primitive_count < MAX_PRIMITIVES);
+  assert (material >= 0);
+
+  pr = primitives + primitive_count++;
+  pr->m = mesh_create (normals, TRUE);
+  pr->mode = mode;
+  pr->material = material;
+  if (mode == MODE_TRIANGLES) {
+    pr->indices = NULL;
+    pr->index_alloc = 0;
+  } else {
+    pr->index_alloc = 1024;
+    pr->indices = malloc (pr->index_alloc * sizeof (int));
+  }
+  pr->index_count = 0;
+
+  return pr;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+vertex (primitive *pr, vector3 *p, vector3 *n, colour *c)
+{
+  vector3 rgb;
+  colour col;
+
+  assert (pr);
+  assert (p);
+  assert (c);
+
+  colour_copy_to_rgb (&col, c);
+  rgb.x = col.x;
+  rgb.y = col.y;
+  rgb.z = col.z;
+  return mesh_vertex (pr->m, p, n, &rgb);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+point_index (primitive *pr, int index)
+{
+  assert (pr);
+  assert (pr->mode != MODE_TRIANGLES);
+
+  if (pr->index_count >= pr->index_alloc) {
+    pr->index_alloc *= 2;
+    pr->indices = realloc (pr->indices, pr->index_alloc * sizeof (int));
+  }
+  pr->indices[pr->index_count++] = index;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+line (primitive *pr, vector3 *p1, vector3 *p2, colour *c)
+{
+  assert (pr);
+  assert (pr->mode == MODE_LINES);
+
+  point_index (pr, vertex (pr, p1, NULL, c));
+  point_index (pr, vertex (pr, p2, NULL, c));
+  line_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+coloured_triangle (primitive *pr,
+		   vector3 *p1, vector3 *n1, colour *c1,
+		   vector3 *p2, vector3 *n2, colour *c2,
+		   vector3 *p3, vector3 *n3, colour *c3)
+     /*
+       The winding is made counter-clockwise seen from the side that
+       the vertex normals point to.
+     */
+{
+  vector3 d2, d3, g, ns;
+  int i1, i2, i3;
+
+  assert (pr);
+  assert (pr->mode == MODE_TRIANGLES);
+
+  v3_difference (&d2, p2, p1);
+  v3_difference (&d3, p3, p1);
+  v3_cross_product (&g, &d2, &d3);
+  if (v3_length (&g) < 1.0e-10) return;
+
+  i1 = vertex (pr, p1, n1, c1);
+  i2 = vertex (pr, p2, n2, c2);
+  i3 = vertex (pr, p3, n3, c3);
+
+  v3_sum (&ns, n1, n2);
+  v3_add (&ns, n3);
+  if (v3_dot_product (&g, &ns) < 0.0) {
+    if (mesh_triangle (pr->m, i1, i3, i2)) triangle_count++;
+  } else {
+    if (mesh_triangle (pr->m, i1, i2, i3)) triangle_count++;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+triangle (primitive *pr,
+	  vector3 *p1, vector3 *n1, vector3 *p2, vector3 *n2,
+	  vector3 *p3, vector3 *n3, colour *c)
+{
+  coloured_triangle (pr, p1, n1, c, p2, n2, c, p3, n3, c);
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+flat_normal (vector3 *n, vector3 *p1, vector3 *p2, vector3 *p3,
+	     vector3 *inside)
+     /*
+       Normal facing away from the inside point if given, otherwise
+       facing as given by the vertex order. FALSE if degenerate.
+     */
+{
+  vector3 d2, d3, out;
+
+  v3_difference (&d2, p2, p1);
+  v3_difference (&d3, p3, p1);
+  v3_cross_product (n, &d2, &d3);
+  if (v3_length (n) < 1.0e-10) return FALSE;
+  v3_normalize (n);
+
+  if (inside) {
+    v3_difference (&out, p1, inside);
+    if (v3_dot_product (n, &out) < 0.0) v3_reverse (n);
+  }
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+flat_triangle (primitive *pr, vector3 *p1, vector3 *p2, vector3 *p3,
+	       vector3 *inside, colour *c)
+{
+  vector3 n;
+
+  assert (pr);
+  assert (pr->mode == MODE_TRIANGLES);
+
+  if (flat_normal (&n, p1, p2, p3, inside))
+    triangle (pr, p1, &n, p2, &n, p3, &n, c);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+object_colour (colour *c, vector3 *v)
+{
+  c->spec = COLOUR_RGB;
+  c->x = v->x;
+  c->y = v->y;
+  c->z = v->z;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+write_positions (mesh *m, vector3 *centre, double scale, boolean normalized)
+{
+  int slot, offset, q[3], lo[3], hi[3], axis;
+  vector3 *p;
+
+  assert (m);
+  assert (m->count > 0);
+  assert (scale > 0.0);
+
+  for (axis = 0; axis < 3; axis++) {
+    lo[axis] = QUANTUM_MAX;
+    hi[axis] = -QUANTUM_MAX;
+  }
+
+  offset = bin_count;
+  for (slot = 0; slot < m->count; slot++) {
+    p = m->points + slot;
+    q[0] = (int) floor ((p->x - centre->x) / scale + 0.5);
+    q[1] = (int) floor ((p->y - centre->y) / scale + 0.5);
+    q[2] = (int) floor ((p->z - centre->z) / scale + 0.5);
+    for (axis = 0; axis < 3; axis++) {
+      if (q[axis] > QUANTUM_MAX) q[axis] = QUANTUM_MAX;
+      if (q[axis] < -QUANTUM_MAX) q[axis] = -QUANTUM_MAX;
+      if (q[axis] < lo[axis]) lo[axis] = q[axis];
+      if (q[axis] > hi[axis]) hi[axis] = q[axis];
+      bin_short (q[axis]);
+    }
+    bin_short (0);		/* pad to 4-byte stride */
+  }
+
+  if (normalized) {
+    sprintf (buf, ",\"min\":[%.6g,%.6g,%.6g],\"max\":[%.6g,%.6g,%.6g]",
+	     (double) lo[0] / QUANTUM_MAX, (double) lo[1] / QUANTUM_MAX,
+	     (double) lo[2] / QUANTUM_MAX, (double) hi[0] / QUANTUM_MAX,
+	     (double) hi[1] / QUANTUM_MAX, (double) hi[2] / QUANTUM_MAX);
+  } else {
+    sprintf (buf, ",\"min\":[%i,%i,%i],\"max\":[%i,%i,%i]",
+	     lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]);
+  }
+  {
+    char minmax[256];
+    strcpy (minmax, buf);
+    return add_accessor (add_view (offset, 8 * m->count, 8,
+				   GLTF_ARRAY_BUFFER),
+			 GLTF_SHORT, normalized, m->count, "VEC3", minmax);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static int
+quantise_unit (double d, int max)
+{
+  int q = (int) floor (d * max + 0.5);
+
+  if (q > max) return max;
+  if (q < -max) return -max;
+  return q;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+write_normals (mesh *m)
+{
+  int slot, offset;
+  vector3 n;
+
+  assert (m);
+  assert (m->normals);
+
+  offset = bin_count;
+  for (slot = 0; slot < m->count; slot++) {
+    n = m->normals[slot];
+    if (v3_length (&n) > 0.0) v3_normalize (&n);
+    bin_byte (quantise_unit (n.x, 127));
+    bin_byte (quantise_unit (n.y, 127));
+    bin_byte (quantise_unit (n.z, 127));
+    bin_byte (0);		/* pad to 4-byte stride */
+  }
+
+  return add_accessor (add_view (offset, 4 * m->count, 4, GLTF_ARRAY_BUFFER),
+		       GLTF_BYTE, TRUE, m->count, "VEC3", NULL);
+}
+
+
+/*------------------------------------------------------------*/
+static int
+write_colours (mesh *m)
+{
+  int slot, offset;
+  vector3 *c;
+
+  assert (m);
+  assert (m->colours);
+
+  offset = bin_count;
+  for (slot = 0; slot < m->count; slot++) {
+    c = m->colours + slot;
+    bin_byte ((int) floor (255.0 * linear (c->x) + 0.5));
+    bin_byte ((int) floor (255.0 * linear (c->y) + 0.5));
+    bin_byte ((int) floor (255.0 * linear (c->z) + 0.5));
+    bin_byte (255);
+  }
+
+  return add_accessor (add_view (offset, 4 * m->count, 0, GLTF_ARRAY_BUFFER),
+		       GLTF_UNSIGNED_BYTE, TRUE, m->count, "VEC4", NULL);
+}
+
+
+/*------------------------------------------------------------*/
+static int
+write_indices (int *indices, int count, int vertex_count)
+{
+  int slot, offset, length;
+
+  assert (indices);
+  assert (count > 0);
+
+  offset = bin_count;
+  if (vertex_count <= 65535) {
+    for (slot = 0; slot < count; slot++) bin_short (indices[slot]);
+    length = bin_count - offset;
+    bin_align();
+    return add_accessor (add_view (offset, length, 0,
+				   GLTF_ELEMENT_ARRAY_BUFFER),
+			 GLTF_UNSIGNED_SHORT, FALSE, count, "SCALAR", NULL);
+  } else {
+    for (slot = 0; slot < count; slot++) bin_uint (indices[slot]);
+    return add_accessor (add_view (offset, bin_count - offset, 0,
+				   GLTF_ELEMENT_ARRAY_BUFFER),
+			 GLTF_UNSIGNED_INT, FALSE, count, "SCALAR", NULL);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+add_node (int mesh_index, vector3 *translation, double scale)
+{
+  json_separator (json_nodes, node_count);
+  sprintf (buf, "{\"mesh\":%i", mesh_index);
+  ds_cat (json_nodes, buf);
+  if (translation) {
+    sprintf (buf, ",\"translation\":[%.6g,%.6g,%.6g]",
+	     translation->x, translation->y, translation->z);
+    ds_cat (json_nodes, buf);
+  }
+  if (scale != 1.0) {
+    sprintf (buf, ",\"scale\":[%.6g,%.6g,%.6g]", scale, scale, scale);
+    ds_cat (json_nodes, buf);
+  }
+  ds_add (json_nodes, '}');
+  node_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+finish_mesh (void)
+     /*
+       Output the current primitives as one mesh in one node. The
+       positions of all primitives are quantised in the same frame.
+     */
+{
+  int slot, vslot, position, normal, colour_acc, index, count, written;
+  primitive *pr;
+  vector3 lo, hi, centre, *p;
+  double size;
+
+  written = 0;
+  for (slot = 0; slot < primitive_count; slot++) {
+    pr = primitives + slot;
+    if (pr->mode == MODE_TRIANGLES) {
+      if (pr->m->triangle_count > 0) written++;
+    } else {
+      if (pr->index_count > 0) written++;
+    }
+  }
+
+  if (written == 0) goto cleanup;
+
+  v3_initialize (&lo, 1.0e30, 1.0e30, 1.0e30);
+  v3_initialize (&hi, -1.0e30, -1.0e30, -1.0e30);
+  for (slot = 0; slot < primitive_count; slot++) {
+    pr = primitives + slot;
+    for (vslot = 0; vslot < pr->m->count; vslot++) {
+      p = pr->m->points + vslot;
+      if (p->x < lo.x) lo.x = p->x;
+      if (p->y < lo.y) lo.y = p->y;
+      if (p->z < lo.z) lo.z = p->z;
+      if (p->x > hi.x) hi.x = p->x;
+      if (p->y > hi.y) hi.y = p->y;
+      if (p->z > hi.z) hi.z = p->z;
+    }
+  }
+  v3_middle (&centre, &lo, &hi);
+  size = hi.x - lo.x;
+  if (hi.y - lo.y > size) size = hi.y - lo.y;
+  if (hi.z - lo.z > size) size = hi.z - lo.z;
+  if (size < 0.001) size = 0.001;
+  size /= 2.0 * QUANTUM_MAX;
+
+  json_separator (json_meshes, mesh_count);
+  ds_cat (json_meshes, "{\"primitives\":[");
+  count = 0;
+
+  for (slot = 0; slot < primitive_count; slot++) {
+    pr = primitives + slot;
+    if (pr->mode == MODE_TRIANGLES) {
+      if (pr->m->triangle_count == 0) continue;
+    } else {
+      if (pr->index_count == 0) continue;
+    }
+
+    position = write_positions (pr->m, &centre, size, FALSE);
+    normal = pr->m->normals ? write_normals (pr->m) : -1;
+    colour_acc = write_colours (pr->m);
+    if (pr->mode == MODE_TRIANGLES) {
+      index = write_indices (pr->m->triangles, 3 * pr->m->triangle_count,
+			     pr->m->count);
+    } else {
+      index = write_indices (pr->indices, pr->index_count, pr->m->count);
+    }
+
+    json_separator (json_meshes, count++);
+    sprintf (buf, "{\"attributes\":{\"POSITION\":%i", position);
+    ds_cat (json_meshes, buf);
+    if (normal >= 0) {
+      sprintf (buf, ",\"NORMAL\":%i", normal);
+      ds_cat (json_meshes, buf);
+    }
+    sprintf (buf, ",\"COLOR_0\":%i},\"indices\":%i,\"material\":%i,\"mode\":%i}",
+	     colour_acc, index, pr->material, pr->mode);
+    ds_cat (json_meshes, buf);
+  }
+
+  ds_cat (json_meshes, "]}");
+  add_node (mesh_count++, &centre, size);
+
+cleanup:
+  for (slot = 0; slot < primitive_count; slot++) {
+    pr = primitives + slot;
+    mesh_delete (pr->m);
+    if (pr->indices) free (pr->indices);
+  }
+  primitive_count = 0;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+sphere_triangle (mesh *m, vector3 *p1, vector3 *p2, vector3 *p3, int level)
+{
+  vector3 p12, p23, p31, g, d2, d3;
+  int i1, i2, i3;
+
+  if (level > 0) {
+    v3_middle (&p12, p1, p2);
+    v3_normalize (&p12);
+    v3_middle (&p23, p2, p3);
+    v3_normalize (&p23);
+    v3_middle (&p31, p3, p1);
+    v3_normalize (&p31);
+    sphere_triangle (m, p1, &p12, &p31, level - 1);
+    sphere_triangle (m, &p12, p2, &p23, level - 1);
+    sphere_triangle (m, &p31, &p23, p3, level - 1);
+    sphere_triangle (m, &p12, &p23, &p31, level - 1);
+    return;
+  }
+
+  i1 = mesh_vertex (m, p1, p1, NULL);
+  i2 = mesh_vertex (m, p2, p2, NULL);
+  i3 = mesh_vertex (m, p3, p3, NULL);
+  v3_difference (&d2, p2, p1);
+  v3_difference (&d3, p3, p1);
+  v3_cross_product (&g, &d2, &d3);
+  if (v3_dot_product (&g, p1) < 0.0) {
+    mesh_triangle (m, i1, i3, i2);
+  } else {
+    mesh_triangle (m, i1, i2, i3);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+write_unit_mesh (mesh *m, int accessors[3], int *index_count)
+{
+  vector3 origin = {0.0, 0.0, 0.0};
+
+  assert (m);
+
+  accessors[0] = write_positions (m, &origin, 1.0 / QUANTUM_MAX, TRUE);
+  accessors[1] = write_normals (m);
+  accessors[2] = write_indices (m->triangles, 3 * m->triangle_count,
+				m->count);
+  *index_count = 3 * m->triangle_count;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+unit_sphere (void)
+     /* Icosahedron subdivided and projected on the unit sphere. */
+{
+  static int faces[20][3] = {{0,11,5}, {0,5,1}, {0,1,7}, {0,7,10}, {0,10,11},
+			     {1,5,9}, {5,11,4}, {11,10,2}, {10,7,6}, {7,1,8},
+			     {3,9,4}, {3,4,2}, {3,2,6}, {3,6,8}, {3,8,9},
+			     {4,9,5}, {2,4,11}, {6,2,10}, {8,6,7}, {9,8,1}};
+  vector3 corners[12];
+  double t = (1.0 + sqrt (5.0)) / 2.0;
+  int slot;
+  mesh *m;
+
+  if (sphere_accessors[0] >= 0) return;
+
+  v3_initialize (corners + 0, -1.0, t, 0.0);
+  v3_initialize (corners + 1, 1.0, t, 0.0);
+  v3_initialize (corners + 2, -1.0, -t, 0.0);
+  v3_initialize (corners + 3, 1.0, -t, 0.0);
+  v3_initialize (corners + 4, 0.0, -1.0, t);
+  v3_initialize (corners + 5, 0.0, 1.0, t);
+  v3_initialize (corners + 6, 0.0, -1.0, -t);
+  v3_initialize (corners + 7, 0.0, 1.0, -t);
+  v3_initialize (corners + 8, t, 0.0, -1.0);
+  v3_initialize (corners + 9, t, 0.0, 1.0);
+  v3_initialize (corners + 10, -t, 0.0, -1.0);
+  v3_initialize (corners + 11, -t, 0.0, 1.0);
+  for (slot = 0; slot < 12; slot++) v3_normalize (corners + slot);
+
+  m = mesh_create (TRUE, FALSE);
+  for (slot = 0; slot < 20; slot++) {
+    sphere_triangle (m, corners + faces[slot][0], corners + faces[slot][1],
+		     corners + faces[slot][2], SPHERE_SUBDIVISIONS);
+  }
+  write_unit_mesh (m, sphere_accessors, &sphere_index_count);
+  mesh_delete (m);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+unit_cylinder (void)
+     /* Capped cylinder of radius 1 along the y axis from -1 to 1. */
+{
+  int slot, i1, i2, i3, i4, c1, c2;
+  double angle;
+  vector3 b1, b2, t1, t2, n1, n2, bottom, top, down, up;
+  mesh *m;
+
+  if (cylinder_accessors[0] >= 0) return;
+
+  v3_initialize (&bottom, 0.0, -1.0, 0.0);
+  v3_initialize (&top, 0.0, 1.0, 0.0);
+  down = bottom;
+  up = top;
+
+  m = mesh_create (TRUE, FALSE);
+  c1 = mesh_vertex (m, &bottom, &down, NULL);
+  c2 = mesh_vertex (m, &top, &up, NULL);
+
+  for (slot = 0; slot < CYLINDER_SEGMENTS; slot++) {
+    angle = 2.0 * ANGLE_PI * (double) slot / (double) CYLINDER_SEGMENTS;
+    v3_initialize (&n1, cos (angle), 0.0, -sin (angle));
+    angle = 2.0 * ANGLE_PI * (double) (slot + 1) / (double) CYLINDER_SEGMENTS;
+    v3_initialize (&n2, cos (angle), 0.0, -sin (angle));
+    v3_initialize (&b1, n1.x, -1.0, n1.z);
+    v3_initialize (&b2, n2.x, -1.0, n2.z);
+    v3_initialize (&t1, n1.x, 1.0, n1.z);
+    v3_initialize (&t2, n2.x, 1.0, n2.z);
+
+    i1 = mesh_vertex (m, &b1, &n1, NULL); /* side, counter-clockwise */
+    i2 = mesh_vertex (m, &b2, &n2, NULL); /* seen from the outside */
+    i3 = mesh_vertex (m, &t2, &n2, NULL);
+    i4 = mesh_vertex (m, &t1, &n1, NULL);
+    mesh_triangle (m, i1, i2, i3);
+    mesh_triangle (m, i1, i3, i4);
+
+    i1 = mesh_vertex (m, &b1, &down, NULL); /* caps */
+    i2 = mesh_vertex (m, &b2, &down, NULL);
+    mesh_triangle (m, c1, i2, i1);
+    i3 = mesh_vertex (m, &t1, &up, NULL);
+    i4 = mesh_vertex (m, &t2, &up, NULL);
+    mesh_triangle (m, c2, i3, i4);
+  }
+
+  write_unit_mesh (m, cylinder_accessors, &cylinder_index_count);
+  mesh_delete (m);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+add_instance (boolean sphere, colour *c, vector3 *t, double q[4], vector3 *s)
+{
+  instance_group *g;
+  int material, slot;
+  float *f;
+
+  assert (c);
+  assert (t);
+  assert (q);
+  assert (s);
+
+  material = material_index (c, FALSE, FALSE);
+
+  g = NULL;
+  if ((group_last < group_count) &&
+      (groups[group_last].material == material) &&
+      (groups[group_last].sphere == sphere)) {
+    g = groups + group_last;
+  } else {
+    for (slot = 0; slot < group_count; slot++) {
+      if ((groups[slot].material == material) &&
+	  (groups[slot].sphere == sphere)) {
+	g = groups + slot;
+	group_last = slot;
+	break;
+      }
+    }
+  }
+
+  if (g == NULL) {
+    if (group_count >= group_alloc) {
+      group_alloc *= 2;
+      groups = realloc (groups, group_alloc * sizeof (instance_group));
+    }
+    group_last = group_count++;
+    g = groups + group_last;
+    g->material = material;
+    g->sphere = sphere;
+    g->count = 0;
+    g->alloc = 256;
+    g->data = malloc (g->alloc * INSTANCE_FLOATS * sizeof (float));
+  }
+
+  if (g->count >= g->alloc) {
+    g->alloc *= 2;
+    g->data = realloc (g->data, g->alloc * INSTANCE_FLOATS * sizeof (float));
+  }
+
+  f = g->data + INSTANCE_FLOATS * g->count++;
+  f[0] = t->x;
+  f[1] = t->y;
+  f[2] = t->z;
+  f[3] = q[0];
+  f[4] = q[1];
+  f[5] = q[2];
+  f[6] = q[3];
+  f[7] = s->x;
+  f[8] = s->y;
+  f[9] = s->z;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+add_cylinder_instance (vector3 *v1, vector3 *v2, double radius, colour *c)
+     /* The unit cylinder y axis is rotated onto the direction v1->v2. */
+{
+  vector3 dir, axis, middle, scale;
+  double length, sine, cosine, half, q[4];
+
+  assert (v1);
+  assert (v2);
+  assert (c);
+
+  v3_difference (&dir, v2, v1);
+  length = v3_length (&dir);
+  v3_scale (&dir, 1.0 / length);
+  v3_middle (&middle, v1, v2);
+
+  v3_cross_product (&axis, &yaxis, &dir);
+  sine = v3_length (&axis);
+  cosine = dir.y;
+  if (sine > 1.0e-8) {
+    v3_scale (&axis, 1.0 / sine);
+    half = atan2 (sine, cosine) / 2.0;
+    q[0] = axis.x * sin (half);
+    q[1] = axis.y * sin (half);
+    q[2] = axis.z * sin (half);
+    q[3] = cos (half);
+  } else if (cosine > 0.0) {
+    q[0] = q[1] = q[2] = 0.0;
+    q[3] = 1.0;
+  } else {
+    q[0] = 1.0;
+    q[1] = q[2] = q[3] = 0.0;
+  }
+
+  v3_initialize (&scale, radius, length / 2.0, radius);
+  add_instance (FALSE, c, &middle, q, &scale);
+  cylinder_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+finish_instances (void)
+{
+  int slot, offset, instance, fslot, view, translation, rotation, scale;
+  instance_group *g;
+
+  for (slot = 0; slot < group_count; slot++) {
+    g = groups + slot;
+
+    if (g->sphere) {
+      unit_sphere();
+    } else {
+      unit_cylinder();
+    }
+
+    offset = bin_count;
+    for (instance = 0; instance < g->count; instance++) {
+      for (fslot = 0; fslot < INSTANCE_FLOATS; fslot++)
+	bin_float (g->data[INSTANCE_FLOATS * instance + fslot]);
+    }
+    view = add_view (offset, bin_count - offset,
+		     INSTANCE_FLOATS * sizeof (float), 0);
+    translation = add_offset_accessor (view, 0, GLTF_FLOAT, FALSE, g->count,
+				       "VEC3", NULL);
+    rotation = add_offset_accessor (view, 3 * sizeof (float), GLTF_FLOAT,
+				    FALSE, g->count, "VEC4", NULL);
+    scale = add_offset_accessor (view, 7 * sizeof (float), GLTF_FLOAT,
+				 FALSE, g->count, "VEC3", NULL);
+
+    json_separator (json_meshes, mesh_count);
+    if (g->sphere) {
+      sprintf (buf, "{\"primitives\":[{\"attributes\":{\"POSITION\":%i,\"NORMAL\":%i},\"indices\":%i,\"material\":%i}]}",
+	       sphere_accessors[0], sphere_accessors[1], sphere_accessors[2],
+	       g->material);
+    } else {
+      sprintf (buf, "{\"primitives\":[{\"attributes\":{\"POSITION\":%i,\"NORMAL\":%i},\"indices\":%i,\"material\":%i}]}",
+	       cylinder_accessors[0], cylinder_accessors[1],
+	       cylinder_accessors[2], g->material);
+    }
+    ds_cat (json_meshes, buf);
+
+    json_separator (json_nodes, node_count++);
+    sprintf (buf, "{\"mesh\":%i,\"extensions\":{\"EXT_mesh_gpu_instancing\":{\"attributes\":{\"TRANSLATION\":%i,\"ROTATION\":%i,\"SCALE\":%i}}}}",
+	     mesh_count++, translation, rotation, scale);
+    ds_cat (json_nodes, buf);
+
+    used_instancing = TRUE;
+    free (g->data);
+  }
+
+  group_count = 0;
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_set (void)
+{
+  output_first_plot = gltf_first_plot;
+  output_start_plot = gltf_start_plot;
+  output_finish_plot = gltf_finish_plot;
+  output_finish_output = gltf_finish_output;
+
+  set_area = gltf_set_area;
+  set_background = gltf_set_background;
+  anchor_start = do_nothing_str;
+  anchor_description = do_nothing_str;
+  anchor_parameter = do_nothing_str;
+  anchor_start_geometry = do_nothing;
+  anchor_finish = do_nothing;
+  lod_start = do_nothing;
+  lod_finish = do_nothing;
+  lod_start_group = do_nothing;
+  lod_finish_group = do_nothing;
+  viewpoint_start = do_nothing_str;
+  viewpoint_output = do_nothing;
+  output_directionallight = do_nothing;
+  output_pointlight = do_nothing;
+  output_spotlight = do_nothing;
+  output_comment = do_nothing_str;
+
+  output_coil = gltf_coil;
+  output_cylinder = gltf_cylinder;
+  output_helix = gltf_helix;
+  output_label = gltf_label;
+  output_line = gltf_line;
+  output_sphere = gltf_sphere;
+  output_stick = gltf_stick;
+  output_strand = gltf_strand;
+
+  output_start_object = do_nothing;
+  output_object = gltf_object;
+  output_finish_object = do_nothing;
+
+  output_pickable = NULL;
+
+  constant_colours_to_rgb();
+
+  output_mode = GLTF_MODE;
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_first_plot (void)
+{
+  if (!first_plot)
+    yyerror ("only one plot per input file allowed for glTF");
+
+  set_outfile ("wb");
+
+  bin_alloc = 65536;
+  bin = malloc (bin_alloc);
+  bin_count = 0;
+
+  json_accessors = ds_allocate (4096);
+  json_views = ds_allocate (4096);
+  json_meshes = ds_allocate (4096);
+  json_nodes = ds_allocate (4096);
+  json_materials = ds_allocate (1024);
+  accessor_count = 0;
+  view_count = 0;
+  mesh_count = 0;
+  node_count = 0;
+  material_count = 0;
+
+  material_table = dhash_create (64);
+
+  group_alloc = 16;
+  groups = malloc (group_alloc * sizeof (instance_group));
+  group_count = 0;
+  group_last = 0;
+
+  used_instancing = FALSE;
+  used_unlit = FALSE;
+
+  sphere_accessors[0] = -1;
+  cylinder_accessors[0] = -1;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+write_uint (unsigned int u)
+{
+  fputc (u & 0xff, outfile);
+  fputc ((u >> 8) & 0xff, outfile);
+  fputc ((u >> 16) & 0xff, outfile);
+  fputc ((u >> 24) & 0xff, outfile);
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_finish_output (void)
+{
+  dynstring *json;
+  int slot, json_length;
+  boolean first;
+
+  json = ds_allocate (json_accessors->length + json_views->length +
+		      json_meshes->length + json_nodes->length +
+		      json_materials->length + 1024);
+
+  ds_cat (json, "{\"asset\":{\"version\":\"2.0\",\"generator\":");
+  json_string (json, program_str);
+  ds_cat (json, "}");
+
+  ds_cat (json, ",\"extensionsUsed\":[\"KHR_mesh_quantization\"");
+  if (used_instancing) ds_cat (json, ",\"EXT_mesh_gpu_instancing\"");
+  if (used_unlit) ds_cat (json, ",\"KHR_materials_unlit\"");
+  ds_cat (json, "],\"extensionsRequired\":[\"KHR_mesh_quantization\"");
+  if (used_instancing) ds_cat (json, ",\"EXT_mesh_gpu_instancing\"");
+  ds_cat (json, "]");
+
+  ds_cat (json, ",\"scene\":0,\"scenes\":[{");
+  first = TRUE;
+  if (title) {
+    ds_cat (json, "\"name\":");
+    json_string (json, title);
+    first = FALSE;
+  }
+  if (node_count > 0) {
+    if (!first) ds_add (json, ',');
+    ds_cat (json, "\"nodes\":[");
+    for (slot = 0; slot < node_count; slot++) {
+      json_separator (json, slot);
+      ds_cat_int (json, slot);
+    }
+    ds_add (json, ']');
+  }
+  ds_cat (json, "}]");
+
+  if (node_count > 0) {
+    ds_cat (json, ",\"nodes\":[");
+    ds_append (json, json_nodes);
+    ds_cat (json, "],\"meshes\":[");
+    ds_append (json, json_meshes);
+    ds_cat (json, "],\"materials\":[");
+    ds_append (json, json_materials);
+    ds_cat (json, "],\"accessors\":[");
+    ds_append (json, json_accessors);
+    ds_cat (json, "],\"bufferViews\":[");
+    ds_append (json, json_views);
+    ds_cat (json, "],\"buffers\":[{\"byteLength\":");
+    ds_cat_int (json, bin_count);
+    ds_cat (json, "}]");
+  }
+  ds_add (json, '}');
+
+  while (json->length % 4 != 0) ds_add (json, ' ');
+  json_length = json->length;
+  bin_align();
+
+  write_uint (GLB_MAGIC);
+  write_uint (2);
+  write_uint (12 + 8 + json_length + ((node_count > 0) ? 8 + bin_count : 0));
+  write_uint (json_length);
+  write_uint (GLB_CHUNK_JSON);
+  if (fwrite (json->string, 1, json_length, outfile) != (size_t) json_length)
+    yyerror ("could not write to the glTF file");
+  if (node_count > 0) {
+    write_uint (bin_count);
+    write_uint (GLB_CHUNK_BIN);
+    if (fwrite (bin, 1, bin_count, outfile) != (size_t) bin_count)
+      yyerror ("could not write to the glTF file");
+  }
+
+  ds_delete (json);
+  ds_delete (json_accessors);
+  ds_delete (json_views);
+  ds_delete (json_meshes);
+  ds_delete (json_nodes);
+  ds_delete (json_materials);
+  dhash_delete_contents (material_table);
+  material_table = NULL;
+  free (groups);
+  groups = NULL;
+  free (bin);
+  bin = NULL;
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_start_plot (void)
+{
+  triangle_count = 0;
+  line_count = 0;
+  sphere_count = 0;
+  cylinder_count = 0;
+
+  set_area_values (-1.0, -1.0, 1.0, 1.0);
+  colour_copy_to_rgb (&background_colour, &black_colour);
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_finish_plot (void)
+{
+  finish_instances();
+
+  set_extent();
+
+  if (message_mode)
+    fprintf (stderr, "%i triangles, %i lines, %i spheres and %i cylinders.\n",
+	     triangle_count, line_count, sphere_count, cylinder_count);
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_set_area (void)
+{
+  if (message_mode) fprintf (stderr, "ignoring 'area' for glTF output\n");
+  clear_dstack();
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_set_background (void)
+{
+  colour_copy_to_rgb (&background_colour, &given_colour);
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_coil (void)
+{
+  int slot;
+  coil_segment *cs1, *cs2;
+  primitive *pr;
+  colour *c;
+  vector3 normal;
+
+  pr = start_primitive (MODE_TRIANGLES, TRUE,
+			material_index (&white_colour, FALSE, FALSE));
+  c = &(current_state->planecolour);
+
+  for (slot = 1; slot < coil_segment_count; slot++) {
+    cs1 = coil_segments + slot - 1;
+    cs2 = cs1 + 1;
+    if (current_state->colourparts) c = &(cs1->c);
+    triangle (pr, &(cs1->p1), &(cs1->n1), &(cs1->p2), &(cs1->n2),
+	      &(cs2->p2), &(cs2->n2), c);
+    triangle (pr, &(cs1->p1), &(cs1->n1), &(cs2->p2), &(cs2->n2),
+	      &(cs2->p1), &(cs2->n1), c);
+    triangle (pr, &(cs1->p2), &(cs1->n2), &(cs1->p3), &(cs1->n3),
+	      &(cs2->p3), &(cs2->n3), c);
+    triangle (pr, &(cs1->p2), &(cs1->n2), &(cs2->p3), &(cs2->n3),
+	      &(cs2->p2), &(cs2->n2), c);
+    triangle (pr, &(cs1->p3), &(cs1->n3), &(cs1->p4), &(cs1->n4),
+	      &(cs2->p4), &(cs2->n4), c);
+    triangle (pr, &(cs1->p3), &(cs1->n3), &(cs2->p4), &(cs2->n4),
+	      &(cs2->p3), &(cs2->n3), c);
+    triangle (pr, &(cs1->p4), &(cs1->n4), &(cs1->p1), &(cs1->n1),
+	      &(cs2->p1), &(cs2->n1), c);
+    triangle (pr, &(cs1->p4), &(cs1->n4), &(cs2->p1), &(cs2->n1),
+	      &(cs2->p4), &(cs2->n4), c);
+  }
+
+  cs1 = coil_segments;		/* end caps */
+  if (current_state->colourparts) c = &(cs1->c);
+  v3_difference (&normal, &(cs1->p), &(cs1[1].p));
+  v3_normalize (&normal);
+  triangle (pr, &(cs1->p1), &normal, &(cs1->p2), &normal,
+	    &(cs1->p3), &normal, c);
+  triangle (pr, &(cs1->p1), &normal, &(cs1->p3), &normal,
+	    &(cs1->p4), &normal, c);
+
+  cs1 = coil_segments + coil_segment_count - 1;
+  if (current_state->colourparts) c = &(cs1->c);
+  v3_difference (&normal, &(cs1->p), &(cs1[-1].p));
+  v3_normalize (&normal);
+  triangle (pr, &(cs1->p1), &normal, &(cs1->p2), &normal,
+	    &(cs1->p3), &normal, c);
+  triangle (pr, &(cs1->p1), &normal, &(cs1->p3), &normal,
+	    &(cs1->p4), &normal, c);
+
+  finish_mesh();
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_cylinder (vector3 *v1, vector3 *v2)
+{
+  assert (v1);
+  assert (v2);
+  assert (v3_distance (v1, v2) > 0.0);
+
+  add_cylinder_instance (v1, v2, current_state->cylinderradius,
+			 &(current_state->planecolour));
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_helix (void)
+     /*
+       The outer and inner surfaces are separate single-sided
+       primitives, since glTF has no two-sided colouring.
+     */
+{
+  int slot;
+  helix_segment *hs1, *hs2;
+  primitive *outer, *inner;
+  vector3 r1, r2;
+  colour *c, *c2;
+
+  outer = start_primitive (MODE_TRIANGLES, TRUE,
+			   material_index (&white_colour, FALSE, FALSE));
+  inner = start_primitive (MODE_TRIANGLES, TRUE,
+			   material_index (&white_colour, FALSE, FALSE));
+  c = &(current_state->planecolour);
+  c2 = &(current_state->plane2colour);
+
+  for (slot = 1; slot < helix_segment_count; slot++) {
+    hs1 = helix_segments + slot - 1;
+    hs2 = hs1 + 1;
+    if (current_state->colourparts) c = c2 = &(hs1->c);
+    triangle (outer, &(hs1->p1), &(hs1->n), &(hs1->p2), &(hs1->n),
+	      &(hs2->p1), &(hs2->n), c);
+    triangle (outer, &(hs1->p2), &(hs1->n), &(hs2->p2), &(hs2->n),
+	      &(hs2->p1), &(hs2->n), c);
+    v3_scaled (&r1, -1.0, &(hs1->n));
+    v3_scaled (&r2, -1.0, &(hs2->n));
+    triangle (inner, &(hs1->p1), &r1, &(hs1->p2), &r1,
+	      &(hs2->p1), &r2, c2);
+    triangle (inner, &(hs1->p2), &r1, &(hs2->p2), &r2,
+	      &(hs2->p1), &r2, c2);
+  }
+
+  finish_mesh();
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_label (vector3 *p, char *label, colour *c)
+{
+  assert (p);
+  assert (label);
+  (void) c;
+
+  not_implemented ("gltf_label");
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_line (boolean polylines)
+{
+  int slot;
+  line_segment *ls1, *ls2;
+  primitive *pr;
+  colour *c;
+
+  if (line_segment_count < 2) return;
+
+  pr = start_primitive (MODE_LINES, FALSE,
+			material_index (&white_colour, TRUE, FALSE));
+  c = &(line_segments[0].c);
+
+  if (polylines) {
+    for (slot = 1; slot < line_segment_count; slot++) {
+      ls1 = line_segments + slot - 1;
+      ls2 = line_segments + slot;
+      if (ls2->new) continue;
+      if (current_state->colourparts) c = &(ls1->c);
+      line (pr, &(ls1->p), &(ls2->p), c);
+    }
+
+  } else {
+    for (slot = 0; slot + 1 < line_segment_count; slot += 2) {
+      ls1 = line_segments + slot;
+      ls2 = ls1 + 1;
+      if (current_state->colourparts) c = &(ls1->c);
+      line (pr, &(ls1->p), &(ls2->p), c);
+    }
+  }
+
+  finish_mesh();
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_sphere (at3d *at, double radius)
+{
+  vector3 scale;
+  double q[4] = {0.0, 0.0, 0.0, 1.0};
+
+  assert (at);
+  assert (radius > 0.0);
+
+  v3_initialize (&scale, radius, radius, radius);
+  add_instance (TRUE, &(at->colour), &(at->xyz), q, &scale);
+  sphere_count++;
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c)
+{
+  assert (v1);
+  assert (v2);
+  assert (v3_distance (v1, v2) > 0.0);
+  (void) r1;			/* the cylinder is drawn whole */
+  (void) r2;
+
+  if (c == NULL) c = &(current_state->planecolour);
+  add_cylinder_instance (v1, v2, current_state->stickradius, c);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+strand_centre (vector3 *centre, strand_segment *ss)
+{
+  assert (centre);
+  assert (ss);
+
+  v3_sum (centre, &(ss->p1), &(ss->p2));
+  v3_add (centre, &(ss->p3));
+  v3_add (centre, &(ss->p4));
+  v3_scale (centre, 0.25);
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_strand (void)
+     /* Same faces as for Raster3D output. */
+{
+  int slot;
+  boolean thickness = current_state->strandthickness >= 0.01;
+  strand_segment *ss1, *ss2;
+  primitive *pr;
+  colour *c;
+  vector3 centre;
+
+  pr = start_primitive (MODE_TRIANGLES, TRUE,
+			material_index (&white_colour, FALSE, !thickness));
+  c = &(current_state->planecolour);
+
+  for (slot = 1; slot < strand_segment_count - 2; slot++) { /* face 1 */
+    ss1 = strand_segments + slot - 1;
+    ss2 = ss1 + 1;
+    if (current_state->colourparts) c = &(ss1->c);
+    triangle (pr, &(ss1->p1), &(ss1->n1), &(ss1->p4), &(ss1->n1),
+	      &(ss2->p1), &(ss2->n1), c);
+    triangle (pr, &(ss1->p4), &(ss1->n1), &(ss2->p1), &(ss2->n1),
+	      &(ss2->p4), &(ss2->n1), c);
+  }
+  ss1 = strand_segments + strand_segment_count - 2; /* arrow tip, face 1 */
+  ss2 = ss1 + 1;
+  if (current_state->colourparts) c = &(ss1->c);
+  triangle (pr, &(ss1->p1), &(ss1->n1), &(ss1->p4), &(ss1->n1),
+	    &(ss2->p1), &(ss2->n1), c);
+
+  if (thickness) {
+    c = &(current_state->planecolour);
+    for (slot = 1; slot < strand_segment_count - 2; slot++) { /* face 2 */
+      ss1 = strand_segments + slot - 1;
+      ss2 = ss1 + 1;
+      if (current_state->colourparts) c = &(ss1->c);
+      triangle (pr, &(ss1->p2), &(ss1->n3), &(ss1->p3), &(ss1->n3),
+		&(ss2->p2), &(ss2->n3), c);
+      triangle (pr, &(ss1->p3), &(ss1->n3), &(ss2->p2), &(ss2->n3),
+		&(ss2->p3), &(ss2->n3), c);
+    }
+    ss1 = strand_segments + strand_segment_count - 2; /* arrow tip, face 2 */
+    ss2 = ss1 + 1;		/* the tip has only p1, p2, n1 and n2 */
+    if (current_state->colourparts) c = &(ss1->c);
+    triangle (pr, &(ss1->p2), &(ss1->n3), &(ss1->p3), &(ss1->n3),
+	      &(ss2->p2), &(ss2->n2), c);
+
+    c = &(current_state->plane2colour);
+    for (slot = 1; slot < strand_segment_count; slot++) { /* sides */
+      ss1 = strand_segments + slot - 1;
+      ss2 = ss1 + 1;
+      if (current_state->colourparts) c = &(ss1->c);
+      strand_centre (&centre, ss1);
+      flat_triangle (pr, &(ss1->p2), &(ss1->p1), &(ss2->p2), &centre, c);
+      flat_triangle (pr, &(ss1->p1), &(ss2->p2), &(ss2->p1), &centre, c);
+      if (slot < strand_segment_count - 1) {
+	flat_triangle (pr, &(ss1->p3), &(ss1->p4), &(ss2->p3), &centre, c);
+	flat_triangle (pr, &(ss1->p4), &(ss2->p3), &(ss2->p4), &centre, c);
+      } else {
+	flat_triangle (pr, &(ss1->p3), &(ss1->p4), &(ss2->p2), &centre, c);
+	flat_triangle (pr, &(ss1->p4), &(ss2->p2), &(ss2->p1), &centre, c);
+      }
+    }
+
+    ss1 = strand_segments + strand_segment_count - 3; /* arrow base */
+    ss2 = ss1 - 1;
+    if (current_state->colourparts) c = &(ss2->c);
+    strand_centre (&centre, ss1);
+    v3_add_scaled (&centre, 0.5, &(ss1->p1));
+    v3_add_scaled (&centre, 0.5, &(ss1->p4));
+    v3_scale (&centre, 0.5);
+    flat_triangle (pr, &(ss1->p1), &(ss1->p2), &(ss2->p1), &centre, c);
+    flat_triangle (pr, &(ss2->p1), &(ss1->p2), &(ss2->p2), &centre, c);
+    flat_triangle (pr, &(ss1->p3), &(ss1->p4), &(ss2->p3), &centre, c);
+    flat_triangle (pr, &(ss2->p3), &(ss1->p4), &(ss2->p4), &centre, c);
+
+    ss1 = strand_segments;	/* strand base */
+    if (current_state->colourparts) c = &(ss1->c);
+    strand_centre (&centre, ss1 + 1);
+    flat_triangle (pr, &(ss1->p1), &(ss1->p2), &(ss1->p3), &centre, c);
+    flat_triangle (pr, &(ss1->p3), &(ss1->p4), &(ss1->p1), &centre, c);
+  }
+
+  finish_mesh();
+}
+
+
+/*------------------------------------------------------------*/
+void
+gltf_object (int code, vector3 *triplets, int count)
+{
+  int slot, step, offset;
+  vector3 *v, n;
+  primitive *pr;
+  colour rgb = {COLOUR_RGB, 1.0, 1.0, 1.0};
+  colour c1, c2, c3;
+
+  assert (triplets);
+  assert (count > 0);
+
+  switch (code) {
+
+  case OBJ_POINTS:
+  case OBJ_POINTS_COLOURS:
+    pr = start_primitive (MODE_POINTS, FALSE,
+			  material_index (&white_colour, TRUE, FALSE));
+    step = (code == OBJ_POINTS) ? 1 : 2;
+    for (slot = 0; slot < count; slot += step) {
+      v = triplets + slot;
+      if (code == OBJ_POINTS_COLOURS) {
+	rgb.x = v[1].x;
+	rgb.y = v[1].y;
+	rgb.z = v[1].z;
+	point_index (pr, vertex (pr, v, NULL, &rgb));
+      } else {
+	point_index (pr, vertex (pr, v, NULL,
+				 &(current_state->linecolour)));
+      }
+    }
+    break;
+
+  case OBJ_LINES:
+    pr = start_primitive (MODE_LINES, FALSE,
+			  material_index (&white_colour, TRUE, FALSE));
+    for (slot = 1; slot < count; slot++) {
+      line (pr, triplets + slot - 1, triplets + slot,
+	    &(current_state->linecolour));
+    }
+    break;
+
+  case OBJ_LINES_COLOURS:
+    pr = start_primitive (MODE_LINES, FALSE,
+			  material_index (&white_colour, TRUE, FALSE));
+    for (slot = 2; slot < count; slot += 2) {
+      v = triplets + slot;
+      rgb.x = v[-1].x;
+      rgb.y = v[-1].y;
+      rgb.z = v[-1].z;
+      line (pr, v - 2, v, &rgb);
+    }
+    break;
+
+  case OBJ_TRIANGLES:
+  case OBJ_STRIP:
+    pr = start_primitive (MODE_TRIANGLES, TRUE,
+			  material_index (&white_colour, FALSE, TRUE));
+    if (code == OBJ_TRIANGLES) {
+      for (slot = 0; slot + 2 < count; slot += 3) {
+	v = triplets + slot;
+	flat_triangle (pr, v, v + 1, v + 2, NULL,
+		       &(current_state->planecolour));
+      }
+    } else {
+      for (slot = 2; slot < count; slot++) {
+	v = triplets + slot;
+	flat_triangle (pr, v - 2, v - 1, v, NULL,
+		       &(current_state->planecolour));
+      }
+    }
+    break;
+
+  case OBJ_TRIANGLES_COLOURS:
+  case OBJ_STRIP_COLOURS:
+    pr = start_primitive (MODE_TRIANGLES, TRUE,
+			  material_index (&white_colour, FALSE, TRUE));
+    if (code == OBJ_TRIANGLES_COLOURS) {
+      offset = 0;
+      step = 6;
+    } else {
+      offset = 4;
+      step = 2;
+    }
+    for (slot = offset; slot + 5 - offset < count; slot += step) {
+      v = triplets + slot - offset;
+      if (! flat_normal (&n, v, v + 2, v + 4, NULL)) continue;
+      object_colour (&c1, v + 1);
+      object_colour (&c2, v + 3);
+      object_colour (&c3, v + 5);
+      coloured_triangle (pr, v, &n, &c1, v + 2, &n, &c2, v + 4, &n, &c3);
+    }
+    break;
+
+  case OBJ_TRIANGLES_NORMALS:
+  case OBJ_STRIP_NORMALS:
+    pr = start_primitive (MODE_TRIANGLES, TRUE,
+			  material_index (&white_colour, FALSE, TRUE));
+    if (code == OBJ_TRIANGLES_NORMALS) {
+      offset = 0;
+      step = 6;
+    } else {
+      offset = 4;
+      step = 2;
+    }
+    for (slot = offset; slot + 5 - offset < count; slot += step) {
+      v = triplets + slot - offset;
+      triangle (pr, v, v + 1, v + 2, v + 3, v + 4, v + 5,
+		&(current_state->planecolour));
+    }
+    break;
+
+  case OBJ_TRIANGLES_NORMALS_COLOURS:
+  case OBJ_STRIP_NORMALS_COLOURS:
+    pr = start_primitive (MODE_TRIANGLES, TRUE,
+			  material_index (&white_colour, FALSE, TRUE));
+    if (code == OBJ_TRIANGLES_NORMALS_COLOURS) {
+      offset = 0;
+      step = 9;
+    } else {
+      offset = 6;
+      step = 3;
+    }
+    for (slot = offset; slot + 8 - offset < count; slot += step) {
+      v = triplets + slot - offset;
+      object_colour (&c1, v + 2);
+      object_colour (&c2, v + 5);
+      object_colour (&c3, v + 8);
+      coloured_triangle (pr, v, v + 1, &c1, v + 3, v + 4, &c2,
+			 v + 6, v + 7, &c3);
+    }
+    break;
+
+  default:
+    return;
+  }
+
+  finish_mesh();
+}
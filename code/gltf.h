@@ -0,0 +1,38 @@
+/* gltf.h
+
+   MolScript v2.1.2
+
+   glTF 2.0 binary (GLB) file output.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#ifndef GLTF_H
+#define GLTF_H 1
+
+#include "col.h"
+#include "coord.h"
+
+void gltf_set (void);
+
+void gltf_first_plot (void);
+void gltf_finish_output (void);
+void gltf_start_plot (void);
+void gltf_finish_plot (void);
+
+void gltf_set_area (void);
+void gltf_set_background (void);
+
+void gltf_coil (void);
+void gltf_cylinder (vector3 *v1, vector3 *v2);
+void gltf_helix (void);
+void gltf_label (vector3 *p, char *label, colour *c);
+void gltf_line (boolean polylines);
+void gltf_sphere (at3d *at, double radius);
+void gltf_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c);
+void gltf_strand (void);
+
+void gltf_object (int code, vector3 *triplets, int count);
+
+#endif
@@ -7,6 +7,18 @@
    Copyright (C) 1997-1998 Per Kraulis
      6-Dec-1996  first attempts
     10-Oct-1997  fairly finished
+    18-Oct-2026  object files noted for watch mode
+    18-Oct-2026  spline curves evaluated per chain from basis tables
+    18-Oct-2026  cartoon chains computed concurrently
+    18-Oct-2026  adaptive spline segments
+    18-Oct-2026  binary object files, mapped into memory
+    18-Oct-2026  decimation of triangle objects
+    18-Oct-2026  automatic detail levels for VRML level-of-detail
+    18-Oct-2026  object coordinates transformed as arrays
+    18-Oct-2026  chains run by the shared thread jobs
+    18-Oct-2026  segments of the chains kept for watch mode
+    18-Oct-2026  viewpoint points shared by the output formats
+    18-Oct-2026  adaptive segments by the state parameter
 */
 
 #include <assert.h>
@@ -20,6 +32,7 @@
 #include "clib/extent3d.h"
 #include "clib/hermite_curve.h"
 #include "clib/matrix3.h"
+#include "clib/thread_jobs.h"
 
 #include "graphics.h"
 #include "global.h"
@@ -27,6 +40,9 @@
 #include "lex.h"
 #include "select.h"
 #include "xform.h"
+#include "watch.h"
+#include "objfile.h"
+#include "decimate.h"
 
 				/* empirically determined factors */
 #define HELIX_HERMITE_FACTOR 4.7
@@ -48,6 +64,9 @@ double fog;
 double aspect_ratio;
 double aspect_window_x, aspect_window_y;
 
+int detail_level = 0;
+int detail_level_total = 1;
+
 
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
 void (*output_first_plot) (void);
@@ -129,6 +148,8 @@ graphics_plot_init (void)
   headlight = TRUE;
   shadows = FALSE;
   fog = 0.0;
+  detail_level = 0;
+  detail_level_total = 1;
   ext3d_initialize();
 }
 
@@ -201,6 +222,52 @@ set_fog (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+viewpoint_points (vector3 *from, vector3 *towards)
+     /*
+       The points from and towards which the viewpoint given on the
+       data stack looks; either 'from' and 'to' points, optionally
+       with the distance along the line, or 'origin' with a point and
+       the distance. The data stack is cleared.
+     */
+{
+  vector3 dir;
+
+  /* pre */
+  assert (from);
+  assert (towards);
+  assert ((dstack_size == 4) ||
+	  (dstack_size == 6) ||
+	  (dstack_size == 7));
+
+  if (dstack_size == 4) {	/* towards origin */
+    towards->x = dstack[0];
+    towards->y = dstack[1];
+    towards->z = dstack[2];
+    dir = *towards;
+    v3_normalize (&dir);
+    v3_sum_scaled (from, towards, dstack[3], &dir);
+
+  } else {			/* to, from specified points */
+    from->x = dstack[0];
+    from->y = dstack[1];
+    from->z = dstack[2];
+    towards->x = dstack[3];
+    towards->y = dstack[4];
+    towards->z = dstack[5];
+    if (dstack_size == 7) {	/* additional distance */
+      v3_difference (&dir, from, towards);
+      v3_normalize (&dir);
+      v3_add_scaled (from, dstack[6], &dir);
+    }
+  }
+  clear_dstack();
+
+  assert (dstack_size == 0);
+}
+
+
 /*------------------------------------------------------------*/
 void
 set_extent (void)
@@ -677,566 +744,1085 @@ priestle_smoothing (vector3 *points, int length, int steps)
 
 
 /*------------------------------------------------------------*/
-void
-coil (int is_peptide_chain, int smoothing)
-{
-  char *atomname, *coilname;
-  double chain_distance, t;
-  mol3d_chain *first_ch, *ch;
-  vector3 *points;
-  res3d *res;
-  at3d *first, *last;
-  vector3 vec1, vec2;
-  colour *col;
-  int slot, segment;
-  double hermite_factor = 0.5 * current_state->splinefactor;
-  int segments = current_state->segments;
+typedef struct {
+  mol3d_chain *ch;
+  segment_buffer segments;
+  vector3 low, high;		/* extent of the segments */
+} chain_job;
+
+static struct {			/* parameters; not changed by the jobs */
+  int segments;			/* maximum per span */
+  hermite_basis **bases;	/* basis tables, by segments per span */
+  double tolerance;		/* curve deviation; 0 for fixed segments */
+  char *atomname;
+  double chain_distance;
+  int smoothing;
+  double radius, thickness, width;
+} cartoon;
+
+static int coil_peptide_chain, coil_smoothing;
+static char *object_filename;
+
+static chain_job *chain_jobs;
+static int chain_job_count;
+static void (*chain_compute) (chain_job *job);
 
-  assert (count_residue_selections() == 1);
 
-				/* colourparts requires even number of seg's */
-  if (current_state->colourparts && (segments % 2)) segments++;
+/*------------------------------------------------------------*/
+double
+pixel_size (void)
+     /*
+       The size of an output pixel in the plot. If the window has not
+       been given, it is estimated from the atoms as set by 'set_extent'.
+       Each coarser detail level is for twice the viewing distance,
+       where a pixel covers twice as much.
+     */
+{
+  mol3d *mol;
+  res3d *res;
+  at3d *at;
+  double w = 0.0;
+  int pixels = output_width;
 
-  if (is_peptide_chain) {
-    atomname = PEPTIDE_CHAIN_ATOMNAME;
-    chain_distance = PEPTIDE_DISTANCE;
-    first_ch = get_peptide_chains();
-    if (smoothing) {
-      coilname = "coil";
-    } else {
-      coilname = "turn";
-    }
+  if (output_height < pixels) pixels = output_height;
 
+  if (window > 0.0) {
+    w = (aspect_window_x > aspect_window_y) ? aspect_window_x:aspect_window_y;
   } else {
-    atomname = NUCLEOTIDE_CHAIN_ATOMNAME;
-    chain_distance = NUCLEOTIDE_DISTANCE;
-    coilname = "double-helix";
-    first_ch = get_nucleotide_chains();
-  }
-
-  for (ch = first_ch; ch; ch = ch->next) {
-    if (ch->length < 2) continue;
-
-    msg_chain (coilname, ch);
-    points = get_atom_positions (ch);
-
-    first = NULL;		/* find atom before or in first residue */
-    res = ch->residues[0]->prev;
-    if (res) {
-      first = at3d_lookup (res, atomname);
-      if (first) {
-	if (v3_distance (&(first->xyz), points) >=
-	    chain_distance) first = NULL;
-      }
-    }
-    if (first == NULL) first = ch->atoms[0];
-
-    last = NULL;		/* find atom after or in last residue */
-    res = ch->residues[ch->length-1]->next;
-    if (res) {
-      last = at3d_lookup (res, atomname);
-      if (last) {
-	if (v3_distance (&(last->xyz), points + ch->length-1) >=
-	    chain_distance) last = NULL;
+    for (mol = first_molecule; mol; mol = mol->next) {
+      for (res = mol->first; res; res = res->next) {
+	for (at = res->first; at; at = at->next) {
+	  if (fabs (at->xyz.x) > w) w = fabs (at->xyz.x);
+	  if (fabs (at->xyz.y) > w) w = fabs (at->xyz.y);
+	}
       }
     }
-    if (last == NULL) last = ch->atoms[ch->length-1];
-
-    if (smoothing)
-      priestle_smoothing (points, ch->length, current_state->smoothsteps);
-
-    if (current_state->colourparts) {
-      col = &(ch->residues[0]->colour);
-    } else {
-      col = NULL;
-    }
-
-    if (current_state->coilradius < 0.01) { /* coil rendered as line */
-      line_segment *ls;
+    w += 2.0;
+  }
 
-      line_segment_init();
-      ls = line_segment_next();
-      ls->new = TRUE;
-      ls->p = *points;
-      if (col) {
-	ls->c = *col;
-      } else {
-	ls->c = current_state->planecolour;
-      }
-      ext3d_update (points, 0.0);
+  return 2.0 * w / (double) pixels * (double) (1 << detail_level);
+}
 
-      v3_difference (&vec2, points + 1, &(first->xyz));
-      if (first == ch->atoms[0]) v3_scale (&vec2, 2.0);
-      v3_scale (&vec2, hermite_factor);
 
-      for (slot = 0; slot < ch->length - 1; slot++) {
+/*------------------------------------------------------------*/
+void
+detail_levels (void (*geometry) (void), int selection)
+     /*
+       Make the geometry at each of the detail levels given by the state,
+       as the groups of a VRML level-of-detail node. The selection of
+       atoms or residues is used up by the geometry, so it is saved and
+       restored for each level after the first.
+     */
+{
+  int levels = current_state->detaillevels;
+  int *flags = NULL;
 
-	vec1 = vec2;
-	if (slot == ch->length - 2) {
-	  v3_difference (&vec2, &(last->xyz), points + ch->length - 2);
-	  if (last == ch->atoms[ch->length-1]) v3_scale (&vec2, 2.0);
-	} else {
-	  v3_difference (&vec2, points + slot + 2, points + slot);
-	}
-	v3_scale (&vec2, hermite_factor);
+  assert (geometry);
+  assert ((selection == DETAIL_NO_SELECTION) ||
+	  (selection == DETAIL_ATOM_SELECTION) ||
+	  (selection == DETAIL_RESIDUE_SELECTION));
 
-	hermite_set (points + slot, points + slot + 1, &vec1, &vec2);
-	for (segment = 1; segment < segments; segment++) {
-	  t = ((double) segment) / ((double) segments);
-	  ls = line_segment_next();
-	  hermite_get (&(ls->p), t);
-	  if (current_state->colourparts &&
-	      (segment == segments / 2) &&
-	      colour_unequal (col, &(ch->residues[slot+1]->colour))) {
-	    ls->c = *col;
-	    ls = line_segment_next();
-	    ls->new = TRUE;
-	    ls->p = (ls - 1)->p;
-	    col = &(ch->residues[slot+1]->colour);
-	  }
-	  if (col) ls->c = *col;
-	  ext3d_update (&(ls->p), 0.0);
-	}
+  if (output_mode != VRML_MODE) levels = 1;
+  if (levels <= 1) {
+    geometry();
+    return;
+  }
 
-	ls = line_segment_next();
-	ls->p = *(points + slot + 1);
-	if (col) ls->c = *col;
-	ext3d_update (points + slot + 1, 0.0);
-      }
+  lod_start();
+  detail_level_total = levels;
+  for (detail_level = 0; detail_level < levels; detail_level++) {
+    if (selection == DETAIL_ATOM_SELECTION) {
+      if (detail_level > 0) restore_atom_selection (flags);
+      flags = (detail_level < levels - 1) ? save_atom_selection() : NULL;
+    } else if (selection == DETAIL_RESIDUE_SELECTION) {
+      if (detail_level > 0) restore_residue_selection (flags);
+      flags = (detail_level < levels - 1) ? save_residue_selection() : NULL;
+    }
+    lod_start_group();
+    geometry();
+    lod_finish_group();
+  }
+  detail_level = 0;
+  detail_level_total = 1;
+  lod_finish();
+}
 
-      output_line (TRUE);
 
-    } else {			/* coil rendered as solid */
-      coil_segment *cs;
-      vector3 side = {1.0, 0.0, 0.0};
-      vector3 normal, dir;
-      double radius = current_state->coilradius / sqrt (2.0);
+/*------------------------------------------------------------*/
+static int
+detail_segments (void)
+     /* The segments for the detail level; halved for each level. */
+{
+  int segments = current_state->segments >> detail_level;
 
-      coil_segment_init();	/* coil path and colour*/
-      cs = coil_segment_next();
-      cs->p = *points;
-      if (col) {
-	cs->c = *col;
-      } else {
-	cs->c = current_state->planecolour;
-      }
-      ext3d_update (&(cs->p), radius);
+  return (segments < 2) ? 2 : segments;
+}
 
-      v3_difference (&vec2, points + 1, &(first->xyz));
-      if (first == ch->atoms[0]) v3_scale (&vec2, 2.0);
-      v3_scale (&vec2, hermite_factor);
 
-      for (slot = 0; slot < ch->length - 1; slot++) {
+/*------------------------------------------------------------*/
+static void
+set_cartoon_segments (int segments)
+     /*
+       Set the maximum number of segments per span, the basis tables and
+       the tolerance for adaptive segments. The tables must be made here,
+       since the jobs must not change any global state.
+     */
+{
+  int slot;
 
-	vec1 = vec2;
-	if (slot == ch->length - 2) {
-	  v3_difference (&vec2, &(last->xyz), points + ch->length - 2);
-	  if (last == ch->atoms[ch->length-1]) v3_scale (&vec2, 2.0);
-	} else {
-	  v3_difference (&vec2, points + slot + 2, points + slot);
-	}
-	v3_scale (&vec2, hermite_factor);
-
-	hermite_set (points + slot, points + slot + 1, &vec1, &vec2);
-	for (segment = 1; segment < segments; segment++) {
-	  t = ((double) segment) / ((double) segments);
-	  cs = coil_segment_next();
-	  hermite_get (&(cs->p), t);
-	  if (current_state->colourparts &&
-	      (segment == segments / 2)) col = &(ch->residues[slot+1]->colour);
-	  if (col) cs->c = *col;
-	  ext3d_update (&(cs->p), radius);
-	}
+  assert (segments >= 1);
 
-	cs = coil_segment_next();
-	cs->p = *(points +slot + 1);
-	if (col) cs->c = *col;
-	ext3d_update (points + slot + 1, radius);
-      }
-				/* coil plane coordinates */
-      v3_difference (&dir, &(coil_segments[1].p), &(coil_segments[0].p));
-      v3_normalize (&dir);
-      v3_cross_product (&normal, &side, &dir);
-      if (v3_length (&normal) < 1.0e-6) {
-	v3_initialize (&side, 0.0, 1.0, 0.0);
-	v3_cross_product (&normal, &side, &dir);
-	if (v3_length (&normal) < 1.0e-6) {
-	  v3_initialize (&side, 0.0, 0.0, 1.0);
-	  v3_cross_product (&normal, &side, &dir);
-	}
-      }
-      v3_normalize (&normal);
-      v3_cross_product (&side, &dir, &normal);
-      v3_normalize (&side);
+  cartoon.segments = segments;
+  if (cartoon.bases) free (cartoon.bases);
+  cartoon.bases = malloc ((segments + 1) * sizeof (hermite_basis *));
+  for (slot = 0; slot < segments; slot++) cartoon.bases[slot] = NULL;
+  cartoon.bases[segments] = hermite_basis_get (segments);
 
-      cs = coil_segments;
-      v3_sum_scaled (&(cs->p1), &(cs->p), radius, &normal);
-      v3_add_scaled (&(cs->p1), radius, &side);
-      v3_sum_scaled (&(cs->p2), &(cs->p), -radius, &normal);
-      v3_add_scaled (&(cs->p2), radius, &side);
-      v3_sum_scaled (&(cs->p3), &(cs->p), -radius, &normal);
-      v3_add_scaled (&(cs->p3), -radius, &side);
-      v3_sum_scaled (&(cs->p4), &(cs->p), radius, &normal);
-      v3_add_scaled (&(cs->p4), -radius, &side);
+  if (current_state->adaptivesegments > 0.0) {
+    cartoon.tolerance = current_state->adaptivesegments * pixel_size();
+    for (slot = 1; slot < segments; slot++)
+      cartoon.bases[slot] = hermite_basis_get (slot);
+  } else {
+    cartoon.tolerance = 0.0;
+  }
+}
 
-      for (slot = 1; slot < coil_segment_count - 1; slot++) {
-	v3_difference (&dir, &(coil_segments[slot+1].p),
-		             &(coil_segments[slot-1].p));
-	v3_cross_product (&side, &dir, &normal);
-	v3_normalize (&side);
-	v3_cross_product (&normal, &side, &dir);
-	v3_normalize (&normal);
-
-	cs = coil_segments + slot;
-	v3_sum_scaled (&(cs->p1), &(cs->p), radius, &normal);
-	v3_add_scaled (&(cs->p1), radius, &side);
-	v3_sum_scaled (&(cs->p2), &(cs->p), -radius, &normal);
-	v3_add_scaled (&(cs->p2), radius, &side);
-	v3_sum_scaled (&(cs->p3), &(cs->p), -radius, &normal);
-	v3_add_scaled (&(cs->p3), -radius, &side);
-	v3_sum_scaled (&(cs->p4), &(cs->p), radius, &normal);
-	v3_add_scaled (&(cs->p4), -radius, &side);
-      }
 
-      v3_difference (&dir, &(coil_segments[coil_segment_count-1].p),
-		           &(coil_segments[coil_segment_count-2].p));
-      v3_cross_product (&side, &dir, &normal);
-      v3_normalize (&side);
-      v3_cross_product (&normal, &side, &dir);
-      v3_normalize (&normal);
+/*------------------------------------------------------------*/
+static int
+span_segments (vector3 *p1, vector3 *p2, vector3 *v1, vector3 *v2,
+	       double bend)
+     /*
+       The number of segments for the Hermite curve span. For adaptive
+       segments, the deviation of the segments from the curve is at most
+       max|P''| / (8 n*n); P'' is linear in t, so its maximum is at one of
+       the ends. The bend is added to the maximum, for any further
+       curvature of the geometry about the curve, such as ribbon twist.
+     */
+{
+  vector3 d, a;
+  double m, m1;
+  int n;
 
-      cs = coil_segments + coil_segment_count - 1;
-      v3_sum_scaled (&(cs->p1), &(cs->p), radius, &normal);
-      v3_add_scaled (&(cs->p1), radius, &side);
-      v3_sum_scaled (&(cs->p2), &(cs->p), -radius, &normal);
-      v3_add_scaled (&(cs->p2), radius, &side);
-      v3_sum_scaled (&(cs->p3), &(cs->p), -radius, &normal);
-      v3_add_scaled (&(cs->p3), -radius, &side);
-      v3_sum_scaled (&(cs->p4), &(cs->p), radius, &normal);
-      v3_add_scaled (&(cs->p4), -radius, &side);
+  assert (p1);
+  assert (p2);
+  assert (v1);
+  assert (v2);
+  assert (bend >= 0.0);
+
+  if (cartoon.tolerance <= 0.0) return cartoon.segments;
+
+  v3_difference (&d, p2, p1);
+  a.x = 6.0 * d.x - 4.0 * v1->x - 2.0 * v2->x;
+  a.y = 6.0 * d.y - 4.0 * v1->y - 2.0 * v2->y;
+  a.z = 6.0 * d.z - 4.0 * v1->z - 2.0 * v2->z;
+  m = v3_length (&a);
+  a.x = -6.0 * d.x + 2.0 * v1->x + 4.0 * v2->x;
+  a.y = -6.0 * d.y + 2.0 * v1->y + 4.0 * v2->y;
+  a.z = -6.0 * d.z + 2.0 * v1->z + 4.0 * v2->z;
+  m1 = v3_length (&a);
+  if (m1 > m) m = m1;
+  m += bend;
+
+  m = sqrt (m / (8.0 * cartoon.tolerance));
+  if (m >= (double) cartoon.segments) return cartoon.segments;
+  n = (int) ceil (m);
+  if (n < 1) n = 1;
+				/* colourparts requires even number of seg's */
+  if (current_state->colourparts && (n % 2)) n++;
+  if (n > cartoon.segments) n = cartoon.segments;
 
-				/* coil plane normals */
-      for (slot = 0; slot < coil_segment_count; slot++) {
-	cs = coil_segments + slot;
-	v3_difference (&(cs->n1), &(cs->p1), &(cs->p));
-	v3_normalize (&(cs->n1));
-	v3_difference (&(cs->n2), &(cs->p2), &(cs->p));
-	v3_normalize (&(cs->n2));
-	v3_difference (&(cs->n3), &(cs->p3), &(cs->p));
-	v3_normalize (&(cs->n3));
-	v3_difference (&(cs->n4), &(cs->p4), &(cs->p));
-	v3_normalize (&(cs->n4));
-      }
+  return n;
+}
 
-      output_coil();
-    }
 
-    free (points);
-  }
+/*------------------------------------------------------------*/
+static double
+twist_angle (vector3 *v1, vector3 *v2)
+     /* The angle between the vectors; any length, or zero. */
+{
+  vector3 c;
 
-  if (first_ch) mol3d_chain_delete (first_ch);
+  assert (v1);
+  assert (v2);
 
-  assert (count_residue_selections() == 0);
+  v3_cross_product (&c, v1, v2);
+  return atan2 (v3_length (&c), v3_dot_product (v1, v2));
 }
 
 
 /*------------------------------------------------------------*/
-void
-cpk (void)
+static vector3 *
+spline_curve (int *spans, int *first, vector3 **tangents,
+	      vector3 *points, vector3 *vectors, int count)
+     /*
+       Evaluate the Hermite curve with the given number of segments per
+       span; first[slot] is set to the index in the curve of points[slot].
+       The tangent vectors are evaluated if asked for.
+     */
 {
-  at3d **atoms;
-  int atom_count, slot;
-  double radius;
+  vector3 *curve;
+  hermite_basis *hb;
+  int slot, total;
 
-  assert (count_atom_selections() == 1);
-
-  atoms = select_atom_list (&atom_count);
+  assert (spans);
+  assert (first);
+  assert (points);
+  assert (vectors);
+  assert (count >= 2);
 
-  assert (count_atom_selections() == 0);
+  total = 0;
+  for (slot = 0; slot < count - 1; slot++) {
+    first[slot] = total;
+    total += spans[slot];
+  }
+  first[count - 1] = total;
 
-  if (message_mode)
-    fprintf (stderr, "%i atoms selected for cpk\n", atom_count);
-  if (atoms == NULL) return;
+  curve = malloc ((total + 1) * sizeof (vector3));
+  if (tangents) *tangents = malloc ((total + 1) * sizeof (vector3));
 
-  for (slot = 0; slot < atom_count; slot++) {
-    radius = atoms[slot]->radius;
-    if (radius > 0.0) {
-      output_sphere (atoms[slot], radius);
-      ext3d_update (&(atoms[slot]->xyz), radius);
+  if (cartoon.tolerance <= 0.0) { /* same segments for all spans */
+    hb = cartoon.bases[cartoon.segments];
+    hermite_evaluate (curve, hb, points, vectors, count);
+    if (tangents) hermite_evaluate_tangents (*tangents, hb,
+					      points, vectors, count);
+  } else {
+    for (slot = 0; slot < count - 1; slot++) {
+      hb = cartoon.bases[spans[slot]];
+      hermite_evaluate (curve + first[slot], hb,
+			points + slot, vectors + slot, 2);
+      if (tangents) hermite_evaluate_tangents (*tangents + first[slot], hb,
+					       points + slot, vectors + slot, 2);
     }
   }
 
-  free (atoms);
+  return curve;
 }
 
 
 /*------------------------------------------------------------*/
-void
-cylinder (void)
+static void
+chain_extent (chain_job *job, vector3 *p, double radius)
+     /* As 'ext3d_update', but for the job; the extent is set later. */
 {
-  mol3d_chain *first_ch, *ch;
-  vector3 start, finish, dir, vec, top;
+  register double u;
 
-  assert (count_residue_selections() == 1);
+  assert (job);
+  assert (p);
+  assert (radius >= 0.0);
 
-  first_ch = get_peptide_chains();
+  u = p->x - radius;
+  if (u < job->low.x) job->low.x = u;
+  u = p->x + radius;
+  if (u > job->high.x) job->high.x = u;
+  u = p->y - radius;
+  if (u < job->low.y) job->low.y = u;
+  u = p->y + radius;
+  if (u > job->high.y) job->high.y = u;
+  u = p->z - radius;
+  if (u < job->low.z) job->low.z = u;
+  u = p->z + radius;
+  if (u > job->high.z) job->high.z = u;
+}
 
-  for (ch = first_ch; ch; ch = ch->next) {
-    if (ch->length < 3) continue;
 
-    msg_chain ("cylinder", ch);
+/*------------------------------------------------------------*/
+static void
+compute_chains (thread_jobs *tj)
+{
+  int slot;
 
-    v3_middle (&start, &(ch->atoms[0]->xyz), &(ch->atoms[2]->xyz));
-    v3_middle (&finish, &(ch->atoms[ch->length-3]->xyz),
-		             &(ch->atoms[ch->length-1]->xyz));
+  while ((slot = thread_jobs_take (tj)) >= 0) chain_compute (chain_jobs + slot);
+}
 
-    if (ch->length == 3) {	/* compute helix axis as for ordinary helix */
-      vector3 vec1, vec2, rvec;
 
-      v3_difference (&vec, &(ch->atoms[2]->xyz), &(ch->atoms[0]->xyz));
-      v3_normalize (&vec);
+/*------------------------------------------------------------*/
+static char *
+data_put (char *data, void *src, size_t size)
+{
+  if (size > 0) memcpy (data, src, size);
+  return data + size;
+}
 
-      v3_difference (&vec1, &(ch->atoms[1]->xyz), &(ch->atoms[0]->xyz));
-      v3_difference (&vec2, &(ch->atoms[2]->xyz), &(ch->atoms[1]->xyz));
-      v3_cross_product (&rvec, &vec1, &vec2);
-      v3_normalize (&rvec);
 
-      v3_scaled (&dir, cos (HELIX_ALPHA), &rvec);
-      v3_add_scaled (&dir, sin (HELIX_ALPHA), &vec);
+/*------------------------------------------------------------*/
+static char *
+data_get (char *data, void *dest, size_t size)
+{
+  if (size > 0) memcpy (dest, data, size);
+  return data + size;
+}
 
-    } else {			/* compute helix axis from terminii coords */
-      v3_difference (&dir, &finish, &start);
-    }
 
-    v3_normalize (&dir);
+/*------------------------------------------------------------*/
+static void *
+data_array (char **data, int count, size_t size)
+     /* A copy of the array at the data, which is advanced past it. */
+{
+  void *array;
 
-    v3_difference (&vec, &(ch->atoms[2]->xyz), &(ch->atoms[0]->xyz));
-    v3_scaled (&top, - 0.5 * v3_length (&vec) *
-		          cos (v3_angle (&vec, &dir)), &dir);
-    v3_add (&start, &top);
+  if (count == 0) return NULL;
+  array = malloc (count * size);
+  *data = data_get (*data, array, count * size);
+  return array;
+}
 
-    v3_difference (&vec, &(ch->atoms[ch->length-1]->xyz),
-			      &(ch->atoms[ch->length-3]->xyz));
-    v3_scaled (&top, 0.5 * v3_length (&vec) *
-		          cos (v3_angle (&vec, &dir)), &dir);
-    v3_add (&finish, &top);
 
-    output_cylinder (&start, &finish);
-    ext3d_update (&start, current_state->cylinderradius);
-    ext3d_update (&finish, current_state->cylinderradius);
+/*------------------------------------------------------------*/
+static void
+store_chain_jobs (void)
+     /* Keep a copy of the segments of the chains, for watch mode. */
+{
+  chain_job *job;
+  segment_buffer *sb;
+  size_t size = sizeof (int);
+  char *data, *p;
+
+  for (job = chain_jobs; job < chain_jobs + chain_job_count; job++) {
+    sb = &(job->segments);
+    size += 2 * sizeof (vector3) + 4 * sizeof (int) +
+      sb->line_count * sizeof (line_segment) +
+      sb->strand_count * sizeof (strand_segment) +
+      sb->helix_count * sizeof (helix_segment) +
+      sb->coil_count * sizeof (coil_segment);
   }
 
-  if (first_ch) mol3d_chain_delete (first_ch);
+  p = data = malloc (size);
+  p = data_put (p, &chain_job_count, sizeof (int));
+  for (job = chain_jobs; job < chain_jobs + chain_job_count; job++) {
+    sb = &(job->segments);
+    p = data_put (p, &(job->low), sizeof (vector3));
+    p = data_put (p, &(job->high), sizeof (vector3));
+    p = data_put (p, &(sb->line_count), sizeof (int));
+    p = data_put (p, &(sb->strand_count), sizeof (int));
+    p = data_put (p, &(sb->helix_count), sizeof (int));
+    p = data_put (p, &(sb->coil_count), sizeof (int));
+    p = data_put (p, sb->lines, sb->line_count * sizeof (line_segment));
+    p = data_put (p, sb->strands, sb->strand_count * sizeof (strand_segment));
+    p = data_put (p, sb->helices, sb->helix_count * sizeof (helix_segment));
+    p = data_put (p, sb->coils, sb->coil_count * sizeof (coil_segment));
+  }
+  assert (p == data + size);
 
-  assert (count_residue_selections() == 0);
+  watch_store (data, size);
 }
 
 
 /*------------------------------------------------------------*/
-void
-helix (void)
+static boolean
+recall_chain_jobs (void)
+     /*
+       Set the segments of the chains from those kept by watch mode
+       in the earlier run, if the command is unchanged.
+     */
 {
-  mol3d_chain *first_ch, *ch;
-  vector3 *points, *axes, *tangents;
-  vector3 cvec, rvec, vec1, vec2, pos, dir;
-  res3d *res;
-  at3d *ca_first, *ca_last, *at;
-  int slot, segment;
-  double halfwidth, t;
-  colour *col;
-  helix_segment *hs;
-  double coilradius = current_state->coilradius;
-  int segments = current_state->segments;
+  chain_job *job;
+  segment_buffer *sb;
+  size_t size;
+  char *p;
+  int count;
+
+  p = watch_recall (&size);
+  if (p == NULL) return FALSE;
+
+  p = data_get (p, &count, sizeof (int));
+  if (count != chain_job_count) return FALSE;
+
+  for (job = chain_jobs; job < chain_jobs + chain_job_count; job++) {
+    sb = &(job->segments);
+    p = data_get (p, &(job->low), sizeof (vector3));
+    p = data_get (p, &(job->high), sizeof (vector3));
+    p = data_get (p, &(sb->line_count), sizeof (int));
+    p = data_get (p, &(sb->strand_count), sizeof (int));
+    p = data_get (p, &(sb->helix_count), sizeof (int));
+    p = data_get (p, &(sb->coil_count), sizeof (int));
+    sb->lines = data_array (&p, sb->line_count, sizeof (line_segment));
+    sb->line_alloc = sb->line_count;
+    sb->strands = data_array (&p, sb->strand_count, sizeof (strand_segment));
+    sb->strand_alloc = sb->strand_count;
+    sb->helices = data_array (&p, sb->helix_count, sizeof (helix_segment));
+    sb->helix_alloc = sb->helix_count;
+    sb->coils = data_array (&p, sb->coil_count, sizeof (coil_segment));
+    sb->coil_alloc = sb->coil_count;
+  }
 
-  assert (count_residue_selections() == 1);
+  return TRUE;
+}
 
-  first_ch = get_peptide_chains();
 
-				/* colourparts requires even number of seg's */
-  if (current_state->colourparts && (segments % 2)) segments++;
+/*------------------------------------------------------------*/
+static void
+chain_jobs_run (mol3d_chain *first_ch, int min_length,
+		void (*compute) (chain_job *job))
+     /*
+       Compute the segments of the chains which are long enough,
+       concurrently if THREAD_SUPPORT is defined. The jobs must not
+       change any global state; output is done in 'chain_jobs_output'.
+       In watch mode, the segments of an unchanged command are taken
+       from the earlier run instead.
+     */
+{
+  mol3d_chain *ch;
+  chain_job *job;
+  thread_jobs tj;
 
-  if (coilradius < 0.01) coilradius = 0.01; /* not too thin */
+  assert (compute);
 
+  chain_job_count = 0;
   for (ch = first_ch; ch; ch = ch->next) {
-    if (ch->length < 3) continue;
+    if (ch->length >= min_length) chain_job_count++;
+  }
+  chain_jobs = malloc ((chain_job_count + 1) * sizeof (chain_job));
 
-    msg_chain ("helix", ch);
+  job = chain_jobs;
+  for (ch = first_ch; ch; ch = ch->next) {
+    if (ch->length < min_length) continue;
+    job->ch = ch;
+    segment_buffer_init (&(job->segments));
+    v3_initialize (&(job->low), 1.0e20, 1.0e20, 1.0e20);
+    v3_initialize (&(job->high), -1.0e20, -1.0e20, -1.0e20);
+    job++;
+  }
 
-    points = get_atom_positions (ch); /* helix axis and tangent vectors */
-    axes = malloc (ch->length * sizeof (vector3));
-    tangents = malloc (ch->length * sizeof (vector3));
+  if (watch_mode && recall_chain_jobs()) return;
 
-    for (slot = 1; slot < ch->length - 1; slot++) {
-				/* helix direction vector at (i) */
-      v3_difference (&cvec, points + slot + 1, points + slot - 1);
-      v3_normalize (&cvec);
-				/* normal vector for plane (i-1),(i),(i+1) */
-      v3_difference (&vec1, points + slot, points + slot - 1);
-      v3_difference (&vec2, points + slot + 1, points + slot);
-      v3_cross_product (&rvec, &vec1, &vec2);
-      v3_normalize (&rvec);
-				/* helix axis at (i) */
-      v3_scaled (&vec1, cos (HELIX_ALPHA), &rvec);
-      v3_scaled (&vec2, sin (HELIX_ALPHA), &cvec);
-      v3_sum (axes + slot, &vec1, &vec2);
-				/* helix tangent at (i) */
-      v3_scaled (&vec1, cos (HELIX_BETA), &cvec);
-      v3_scaled (&vec2, sin (HELIX_BETA), &rvec);
-      v3_sum (tangents + slot, &vec1, &vec2);
-      v3_scale (tangents + slot, HELIX_HERMITE_FACTOR);
-    }
+  chain_compute = compute;
+  thread_jobs_run (&tj, chain_job_count, compute_chains, NULL);
 
-    ca_first = ch->atoms[0];	/* find CA before and after chain, if any */
-    res = ch->residues[0]->prev; /* used for helix terminii tangents */
-    if (res) {
-      at = at3d_lookup (res, PEPTIDE_CHAIN_ATOMNAME);
-      if (at &&
-	  v3_distance (points, &(at->xyz)) <= PEPTIDE_DISTANCE) ca_first = at;
-    }
+  if (watch_mode) store_chain_jobs();
+}
+
+
+/*------------------------------------------------------------*/
+static void
+chain_jobs_output (char *type, void (*output) (void))
+     /* Output the segments of the chains, in the order of the chains. */
+{
+  chain_job *job;
+  segment_buffer empty;
+
+  assert (type);
+  assert (output);
+
+  for (job = chain_jobs; job < chain_jobs + chain_job_count; job++) {
+    msg_chain (type, job->ch);
+    ext3d_update (&(job->low), 0.0);
+    ext3d_update (&(job->high), 0.0);
+    segment_buffer_select (&(job->segments));
+    output();
+    segment_buffer_free (&(job->segments));
+  }
+
+  free (chain_jobs);
+  chain_jobs = NULL;
+  chain_job_count = 0;
+  segment_buffer_init (&empty);	/* no references to the freed buffers */
+  segment_buffer_select (&empty);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+coil_chain (chain_job *job)
+{
+  mol3d_chain *ch = job->ch;
+  segment_buffer *sb = &(job->segments);
+  vector3 *points, *vectors, *curve;
+  res3d *res;
+  at3d *first, *last;
+  colour *col;
+  int slot, segment;
+  int *spans, *first_segment;
+  double hermite_factor = 0.5 * current_state->splinefactor;
 
-    ca_last = ch->atoms[ch->length-1];
-    res = ch->residues[ch->length-1]->next;
-    if (res) {
-      at = at3d_lookup (res, PEPTIDE_CHAIN_ATOMNAME);
-      if (at &&
-	  v3_distance (points + ch->length - 1,
-		       &(at->xyz)) <= PEPTIDE_DISTANCE) ca_last = at;
+  points = get_atom_positions (ch);
+
+  first = NULL;		/* find atom before or in first residue */
+  res = ch->residues[0]->prev;
+  if (res) {
+    first = at3d_lookup (res, cartoon.atomname);
+    if (first) {
+      if (v3_distance (&(first->xyz), points) >=
+	  cartoon.chain_distance) first = NULL;
     }
-				/* helix terminii axes */
-    *(axes) = *(axes + 1);
-    *(axes + ch->length - 1) = *(axes + ch->length - 2);
-				/* helix terminii tangents */
-    v3_difference (&vec1, points + 1, &(ca_first->xyz));
-    v3_normalize (&vec1);
-    v3_scaled (tangents, HELIX_HERMITE_FACTOR, &vec1);
-    v3_difference (&vec1, &(ca_last->xyz), points + ch->length - 2);
-    v3_normalize (&vec1);
-    v3_scaled (tangents + ch->length - 1, HELIX_HERMITE_FACTOR, &vec1);
+  }
+  if (first == NULL) first = ch->atoms[0];
+
+  last = NULL;		/* find atom after or in last residue */
+  res = ch->residues[ch->length-1]->next;
+  if (res) {
+    last = at3d_lookup (res, cartoon.atomname);
+    if (last) {
+      if (v3_distance (&(last->xyz), points + ch->length-1) >=
+	  cartoon.chain_distance) last = NULL;
+    }
+  }
+  if (last == NULL) last = ch->atoms[ch->length-1];
 
-    if (current_state->colourparts) {
-      col = &(ch->residues[0]->colour);
+  if (cartoon.smoothing)
+    priestle_smoothing (points, ch->length, current_state->smoothsteps);
+
+				/* Hermite spline vectors and curve */
+  vectors = malloc (ch->length * sizeof (vector3));
+  v3_difference (vectors, points + 1, &(first->xyz));
+  if (first == ch->atoms[0]) v3_scale (vectors, 2.0);
+  v3_scale (vectors, hermite_factor);
+  for (slot = 1; slot < ch->length - 1; slot++) {
+    v3_difference (vectors + slot, points + slot + 1, points + slot - 1);
+    v3_scale (vectors + slot, hermite_factor);
+  }
+  v3_difference (vectors + ch->length - 1,
+		 &(last->xyz), points + ch->length - 2);
+  if (last == ch->atoms[ch->length-1]) v3_scale (vectors+ch->length-1, 2.0);
+  v3_scale (vectors + ch->length - 1, hermite_factor);
+
+  spans = malloc (ch->length * sizeof (int));
+  first_segment = malloc (ch->length * sizeof (int));
+  for (slot = 0; slot < ch->length - 1; slot++) {
+    spans[slot] = span_segments (points + slot, points + slot + 1,
+				 vectors + slot, vectors + slot + 1, 0.0);
+  }
+  curve = spline_curve (spans, first_segment, NULL,
+			points, vectors, ch->length);
+
+  if (current_state->colourparts) {
+    col = &(ch->residues[0]->colour);
+  } else {
+    col = NULL;
+  }
+
+  if (current_state->coilradius < 0.01) { /* coil rendered as line */
+    line_segment *ls;
+
+    ls = segment_buffer_line (sb);
+    ls->new = TRUE;
+    ls->p = *points;
+    if (col) {
+      ls->c = *col;
     } else {
-      col = NULL;
+      ls->c = current_state->planecolour;
     }
+    chain_extent (job, points, 0.0);
 
-    helix_segment_init();
-    hs = helix_segment_next();
-    v3_sum_scaled (&(hs->p1), points, coilradius, axes);
-    v3_sum_scaled (&(hs->p2), points, -coilradius, axes);
-    hs->a = *axes;
-    v3_cross_product (&(hs->n), tangents, axes);
-    v3_normalize (&(hs->n));
-    if (col) hs->c = *col;
-    ext3d_update (points, coilradius);
+    for (slot = 0; slot < ch->length - 1; slot++) {
 
-				/* helix start segments */
-    pos = *points;
-    hermite_set (points, points + 1, tangents, tangents + 1);
-
-    for (segment = 1; segment < segments; segment++) {
-      t = ((double) segment) / ((double) segments);
-      hermite_get (&pos, t);
-      halfwidth = coilradius +
-	(0.5 * current_state->helixwidth - coilradius) *
-	0.5 * (- cos (ANGLE_PI * t) + 1.0);
-      hs = helix_segment_next();
-      v3_sum_scaled (&(hs->p1), &pos, halfwidth, axes);
-      v3_sum_scaled (&(hs->p2), &pos, -halfwidth, axes);
-      hs->a = *axes;
-      hermite_get_tangent (&dir, t);
-      v3_cross_product (&(hs->n), &dir, axes);
-      v3_normalize (&(hs->n));
-      if (current_state->colourparts &&
-	  (segment == segments / 2)) col = &(ch->residues[1]->colour);
-      if (col) hs->c = *col;
-      ext3d_update (&pos, halfwidth);
+      for (segment = 1; segment < spans[slot]; segment++) {
+	ls = segment_buffer_line (sb);
+	ls->p = curve[first_segment[slot] + segment];
+	if (current_state->colourparts &&
+	    (segment == spans[slot] / 2) &&
+	    colour_unequal (col, &(ch->residues[slot+1]->colour))) {
+	  ls->c = *col;
+	  ls = segment_buffer_line (sb);
+	  ls->new = TRUE;
+	  ls->p = (ls - 1)->p;
+	  col = &(ch->residues[slot+1]->colour);
+	}
+	if (col) ls->c = *col;
+	chain_extent (job, &(ls->p), 0.0);
+      }
+
+      ls = segment_buffer_line (sb);
+      ls->p = *(points + slot + 1);
+      if (col) ls->c = *col;
+      chain_extent (job, points + slot + 1, 0.0);
     }
 
-    halfwidth = 0.5 * current_state->helixwidth;
-    hs = helix_segment_next();
-    v3_sum_scaled (&(hs->p1), points + 1, halfwidth, axes + 1);
-    v3_sum_scaled (&(hs->p2), points + 1, -halfwidth, axes + 1);
-    hs->a = *(axes + 1);
-    v3_cross_product (&(hs->n), tangents + 1, axes + 1);
-    v3_normalize (&(hs->n));
-    if (col) hs->c = *col;
-    ext3d_update (points + 1, halfwidth);
+  } else {			/* coil rendered as solid */
+    coil_segment *cs;
+    vector3 side = {1.0, 0.0, 0.0};
+    vector3 normal, dir;
+    double radius = current_state->coilradius / sqrt (2.0);
 
-				/* helix main segments */
-    for (slot = 1; slot < ch->length - 2; slot++) {
-
-      hermite_set (points + slot, points + slot + 1,
-		   tangents + slot, tangents + slot + 1);
-
-      for (segment = 1; segment < segments; segment++) {
-	t = ((double) segment) / ((double) segments);
-	hs = helix_segment_next();
-	v3_scaled (&(hs->a), 1.0 - t, axes + slot);
-	v3_add_scaled (&(hs->a), t, axes + slot + 1);
-	v3_normalize (&(hs->a));
-	hermite_get (&pos, t);
-	v3_sum_scaled (&(hs->p1), &pos, halfwidth, &(hs->a));
-	v3_sum_scaled (&(hs->p2), &pos, -halfwidth, &(hs->a));
-	hermite_get_tangent (&dir, t);
-	v3_cross_product (&(hs->n), &dir, &(hs->a));
-	v3_normalize (&(hs->n));
-	if (current_state->colourparts && (segment == segments / 2))
-	  col = &(ch->residues[slot+1]->colour);
-	if (col) hs->c = *col;
-	ext3d_update (&pos, halfwidth);
+    cs = segment_buffer_coil (sb);
+    cs->p = *points;
+    if (col) {
+      cs->c = *col;
+    } else {
+      cs->c = current_state->planecolour;
+    }
+    chain_extent (job, &(cs->p), radius);
+
+    for (slot = 0; slot < ch->length - 1; slot++) {
+
+      for (segment = 1; segment < spans[slot]; segment++) {
+	cs = segment_buffer_coil (sb);
+	cs->p = curve[first_segment[slot] + segment];
+	if (current_state->colourparts &&
+	    (segment == spans[slot] / 2)) col = &(ch->residues[slot+1]->colour);
+	if (col) cs->c = *col;
+	chain_extent (job, &(cs->p), radius);
       }
 
-      hs = helix_segment_next();
-      v3_sum_scaled (&(hs->p1), points + slot + 1, halfwidth, axes + slot + 1);
-      v3_sum_scaled (&(hs->p2), points + slot + 1, -halfwidth, axes + slot +1);
-      hs->a = *(axes + slot + 1);
-      v3_cross_product (&(hs->n), tangents + slot + 1, axes + slot + 1);
-      v3_normalize (&(hs->n));
-      if (col) hs->c = *col;
-      ext3d_update (points + slot + 1, halfwidth);
+      cs = segment_buffer_coil (sb);
+      cs->p = *(points +slot + 1);
+      if (col) cs->c = *col;
+      chain_extent (job, points + slot + 1, radius);
     }
-				/* helix finish segments */
-    pos = *(points + ch->length - 2);
-    hermite_set (points + ch->length - 2, points + ch->length - 1,
-		 tangents + ch->length - 2, tangents + ch->length - 1);
-
-    for (segment = 1; segment < segments; segment++) {
-      t = ((double) segment) / ((double) segments);
-      hermite_get (&pos, t);
-      halfwidth = coilradius +
-	(0.5 * current_state->helixwidth - coilradius) *
-	0.5 * (cos (ANGLE_PI * t) + 1.0);
-      hs = helix_segment_next();
-      v3_sum_scaled (&(hs->p1), &pos, halfwidth, axes + ch->length - 1);
-      v3_sum_scaled (&(hs->p2), &pos, -halfwidth, axes + ch->length - 1);
-      hs->a = *(axes + ch->length - 1);
-      hermite_get_tangent (&dir, t);
-      v3_cross_product (&(hs->n), &dir, axes + ch->length - 1);
+				/* coil plane coordinates */
+    v3_difference (&dir, &(sb->coils[1].p), &(sb->coils[0].p));
+    v3_normalize (&dir);
+    v3_cross_product (&normal, &side, &dir);
+    if (v3_length (&normal) < 1.0e-6) {
+      v3_initialize (&side, 0.0, 1.0, 0.0);
+      v3_cross_product (&normal, &side, &dir);
+      if (v3_length (&normal) < 1.0e-6) {
+	v3_initialize (&side, 0.0, 0.0, 1.0);
+	v3_cross_product (&normal, &side, &dir);
+      }
+    }
+    v3_normalize (&normal);
+    v3_cross_product (&side, &dir, &normal);
+    v3_normalize (&side);
+
+    cs = sb->coils;
+    v3_sum_scaled (&(cs->p1), &(cs->p), radius, &normal);
+    v3_add_scaled (&(cs->p1), radius, &side);
+    v3_sum_scaled (&(cs->p2), &(cs->p), -radius, &normal);
+    v3_add_scaled (&(cs->p2), radius, &side);
+    v3_sum_scaled (&(cs->p3), &(cs->p), -radius, &normal);
+    v3_add_scaled (&(cs->p3), -radius, &side);
+    v3_sum_scaled (&(cs->p4), &(cs->p), radius, &normal);
+    v3_add_scaled (&(cs->p4), -radius, &side);
+
+    for (slot = 1; slot < sb->coil_count - 1; slot++) {
+      v3_difference (&dir, &(sb->coils[slot+1].p),
+			   &(sb->coils[slot-1].p));
+      v3_cross_product (&side, &dir, &normal);
+      v3_normalize (&side);
+      v3_cross_product (&normal, &side, &dir);
+      v3_normalize (&normal);
+
+      cs = sb->coils + slot;
+      v3_sum_scaled (&(cs->p1), &(cs->p), radius, &normal);
+      v3_add_scaled (&(cs->p1), radius, &side);
+      v3_sum_scaled (&(cs->p2), &(cs->p), -radius, &normal);
+      v3_add_scaled (&(cs->p2), radius, &side);
+      v3_sum_scaled (&(cs->p3), &(cs->p), -radius, &normal);
+      v3_add_scaled (&(cs->p3), -radius, &side);
+      v3_sum_scaled (&(cs->p4), &(cs->p), radius, &normal);
+      v3_add_scaled (&(cs->p4), -radius, &side);
+    }
+
+    v3_difference (&dir, &(sb->coils[sb->coil_count-1].p),
+			 &(sb->coils[sb->coil_count-2].p));
+    v3_cross_product (&side, &dir, &normal);
+    v3_normalize (&side);
+    v3_cross_product (&normal, &side, &dir);
+    v3_normalize (&normal);
+
+    cs = sb->coils + sb->coil_count - 1;
+    v3_sum_scaled (&(cs->p1), &(cs->p), radius, &normal);
+    v3_add_scaled (&(cs->p1), radius, &side);
+    v3_sum_scaled (&(cs->p2), &(cs->p), -radius, &normal);
+    v3_add_scaled (&(cs->p2), radius, &side);
+    v3_sum_scaled (&(cs->p3), &(cs->p), -radius, &normal);
+    v3_add_scaled (&(cs->p3), -radius, &side);
+    v3_sum_scaled (&(cs->p4), &(cs->p), radius, &normal);
+    v3_add_scaled (&(cs->p4), -radius, &side);
+
+				/* coil plane normals */
+    for (slot = 0; slot < sb->coil_count; slot++) {
+      cs = sb->coils + slot;
+      v3_difference (&(cs->n1), &(cs->p1), &(cs->p));
+      v3_normalize (&(cs->n1));
+      v3_difference (&(cs->n2), &(cs->p2), &(cs->p));
+      v3_normalize (&(cs->n2));
+      v3_difference (&(cs->n3), &(cs->p3), &(cs->p));
+      v3_normalize (&(cs->n3));
+      v3_difference (&(cs->n4), &(cs->p4), &(cs->p));
+      v3_normalize (&(cs->n4));
+    }
+  }
+
+  free (points);
+  free (vectors);
+  free (curve);
+  free (spans);
+  free (first_segment);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+output_coil_line (void)
+{
+  output_line (TRUE);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+coil_geometry (void)
+{
+  char *coilname;
+  mol3d_chain *first_ch;
+  int is_peptide_chain = coil_peptide_chain;
+  int smoothing = coil_smoothing;
+  int segments = detail_segments();
+
+  assert (count_residue_selections() == 1);
+
+				/* colourparts requires even number of seg's */
+  if (current_state->colourparts && (segments % 2)) segments++;
+  set_cartoon_segments (segments);
+  cartoon.smoothing = smoothing;
+
+  if (is_peptide_chain) {
+    cartoon.atomname = PEPTIDE_CHAIN_ATOMNAME;
+    cartoon.chain_distance = PEPTIDE_DISTANCE;
+    first_ch = get_peptide_chains();
+    if (smoothing) {
+      coilname = "coil";
+    } else {
+      coilname = "turn";
+    }
+
+  } else {
+    cartoon.atomname = NUCLEOTIDE_CHAIN_ATOMNAME;
+    cartoon.chain_distance = NUCLEOTIDE_DISTANCE;
+    coilname = "double-helix";
+    first_ch = get_nucleotide_chains();
+  }
+
+  chain_jobs_run (first_ch, 2, coil_chain);
+  if (current_state->coilradius < 0.01) { /* coil rendered as line */
+    chain_jobs_output (coilname, output_coil_line);
+  } else {
+    chain_jobs_output (coilname, output_coil);
+  }
+
+  if (first_ch) mol3d_chain_delete (first_ch);
+
+  assert (count_residue_selections() == 0);
+}
+
+
+/*------------------------------------------------------------*/
+void
+coil (int is_peptide_chain, int smoothing)
+{
+  coil_peptide_chain = is_peptide_chain;
+  coil_smoothing = smoothing;
+  detail_levels (coil_geometry, DETAIL_RESIDUE_SELECTION);
+}
+
+
+/*------------------------------------------------------------*/
+void
+cpk (void)
+{
+  at3d **atoms;
+  int atom_count, slot;
+  double radius;
+
+  assert (count_atom_selections() == 1);
+
+  atoms = select_atom_list (&atom_count);
+
+  assert (count_atom_selections() == 0);
+
+  if (message_mode)
+    fprintf (stderr, "%i atoms selected for cpk\n", atom_count);
+  if (atoms == NULL) return;
+
+  for (slot = 0; slot < atom_count; slot++) {
+    radius = atoms[slot]->radius;
+    if (radius > 0.0) {
+      output_sphere (atoms[slot], radius);
+      ext3d_update (&(atoms[slot]->xyz), radius);
+    }
+  }
+
+  free (atoms);
+}
+
+
+/*------------------------------------------------------------*/
+void
+cylinder (void)
+{
+  mol3d_chain *first_ch, *ch;
+  vector3 start, finish, dir, vec, top;
+
+  assert (count_residue_selections() == 1);
+
+  first_ch = get_peptide_chains();
+
+  for (ch = first_ch; ch; ch = ch->next) {
+    if (ch->length < 3) continue;
+
+    msg_chain ("cylinder", ch);
+
+    v3_middle (&start, &(ch->atoms[0]->xyz), &(ch->atoms[2]->xyz));
+    v3_middle (&finish, &(ch->atoms[ch->length-3]->xyz),
+		             &(ch->atoms[ch->length-1]->xyz));
+
+    if (ch->length == 3) {	/* compute helix axis as for ordinary helix */
+      vector3 vec1, vec2, rvec;
+
+      v3_difference (&vec, &(ch->atoms[2]->xyz), &(ch->atoms[0]->xyz));
+      v3_normalize (&vec);
+
+      v3_difference (&vec1, &(ch->atoms[1]->xyz), &(ch->atoms[0]->xyz));
+      v3_difference (&vec2, &(ch->atoms[2]->xyz), &(ch->atoms[1]->xyz));
+      v3_cross_product (&rvec, &vec1, &vec2);
+      v3_normalize (&rvec);
+
+      v3_scaled (&dir, cos (HELIX_ALPHA), &rvec);
+      v3_add_scaled (&dir, sin (HELIX_ALPHA), &vec);
+
+    } else {			/* compute helix axis from terminii coords */
+      v3_difference (&dir, &finish, &start);
+    }
+
+    v3_normalize (&dir);
+
+    v3_difference (&vec, &(ch->atoms[2]->xyz), &(ch->atoms[0]->xyz));
+    v3_scaled (&top, - 0.5 * v3_length (&vec) *
+		          cos (v3_angle (&vec, &dir)), &dir);
+    v3_add (&start, &top);
+
+    v3_difference (&vec, &(ch->atoms[ch->length-1]->xyz),
+			      &(ch->atoms[ch->length-3]->xyz));
+    v3_scaled (&top, 0.5 * v3_length (&vec) *
+		          cos (v3_angle (&vec, &dir)), &dir);
+    v3_add (&finish, &top);
+
+    output_cylinder (&start, &finish);
+    ext3d_update (&start, current_state->cylinderradius);
+    ext3d_update (&finish, current_state->cylinderradius);
+  }
+
+  if (first_ch) mol3d_chain_delete (first_ch);
+
+  assert (count_residue_selections() == 0);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+helix_chain (chain_job *job)
+{
+  mol3d_chain *ch = job->ch;
+  segment_buffer *sb = &(job->segments);
+  vector3 *points, *axes, *tangents, *curve, *curve_tangents;
+  vector3 cvec, rvec, vec1, vec2, pos, dir;
+  res3d *res;
+  at3d *ca_first, *ca_last, *at;
+  int slot, segment;
+  double halfwidth, t;
+  colour *col;
+  helix_segment *hs;
+  double coilradius = cartoon.radius;
+  int *spans, *first_segment;
+  double bend;
+
+  points = get_atom_positions (ch); /* helix axis and tangent vectors */
+  axes = malloc (ch->length * sizeof (vector3));
+  tangents = malloc (ch->length * sizeof (vector3));
+
+  for (slot = 1; slot < ch->length - 1; slot++) {
+				/* helix direction vector at (i) */
+    v3_difference (&cvec, points + slot + 1, points + slot - 1);
+    v3_normalize (&cvec);
+				/* normal vector for plane (i-1),(i),(i+1) */
+    v3_difference (&vec1, points + slot, points + slot - 1);
+    v3_difference (&vec2, points + slot + 1, points + slot);
+    v3_cross_product (&rvec, &vec1, &vec2);
+    v3_normalize (&rvec);
+				/* helix axis at (i) */
+    v3_scaled (&vec1, cos (HELIX_ALPHA), &rvec);
+    v3_scaled (&vec2, sin (HELIX_ALPHA), &cvec);
+    v3_sum (axes + slot, &vec1, &vec2);
+				/* helix tangent at (i) */
+    v3_scaled (&vec1, cos (HELIX_BETA), &cvec);
+    v3_scaled (&vec2, sin (HELIX_BETA), &rvec);
+    v3_sum (tangents + slot, &vec1, &vec2);
+    v3_scale (tangents + slot, HELIX_HERMITE_FACTOR);
+  }
+
+  ca_first = ch->atoms[0];	/* find CA before and after chain, if any */
+  res = ch->residues[0]->prev; /* used for helix terminii tangents */
+  if (res) {
+    at = at3d_lookup (res, PEPTIDE_CHAIN_ATOMNAME);
+    if (at &&
+	v3_distance (points, &(at->xyz)) <= PEPTIDE_DISTANCE) ca_first = at;
+  }
+
+  ca_last = ch->atoms[ch->length-1];
+  res = ch->residues[ch->length-1]->next;
+  if (res) {
+    at = at3d_lookup (res, PEPTIDE_CHAIN_ATOMNAME);
+    if (at &&
+	v3_distance (points + ch->length - 1,
+		     &(at->xyz)) <= PEPTIDE_DISTANCE) ca_last = at;
+  }
+				/* helix terminii axes */
+  *(axes) = *(axes + 1);
+  *(axes + ch->length - 1) = *(axes + ch->length - 2);
+				/* helix terminii tangents */
+  v3_difference (&vec1, points + 1, &(ca_first->xyz));
+  v3_normalize (&vec1);
+  v3_scaled (tangents, HELIX_HERMITE_FACTOR, &vec1);
+  v3_difference (&vec1, &(ca_last->xyz), points + ch->length - 2);
+  v3_normalize (&vec1);
+  v3_scaled (tangents + ch->length - 1, HELIX_HERMITE_FACTOR, &vec1);
+				/* helix Hermite curve */
+  halfwidth = 0.5 * current_state->helixwidth;
+  spans = malloc (ch->length * sizeof (int));
+  first_segment = malloc (ch->length * sizeof (int));
+  for (slot = 0; slot < ch->length - 1; slot++) {
+    if ((slot == 0) || (slot == ch->length - 2)) { /* width changes */
+      bend = 0.5 * ANGLE_PI * ANGLE_PI * fabs (halfwidth - coilradius);
+    } else {			/* edges turn about the axis */
+      t = twist_angle (axes + slot, axes + slot + 1);
+      bend = halfwidth * t * t;
+    }
+    spans[slot] = span_segments (points + slot, points + slot + 1,
+				 tangents + slot, tangents + slot + 1, bend);
+  }
+  curve = spline_curve (spans, first_segment, &curve_tangents,
+			points, tangents, ch->length);
+
+  if (current_state->colourparts) {
+    col = &(ch->residues[0]->colour);
+  } else {
+    col = NULL;
+  }
+
+  hs = segment_buffer_helix (sb);
+  v3_sum_scaled (&(hs->p1), points, coilradius, axes);
+  v3_sum_scaled (&(hs->p2), points, -coilradius, axes);
+  hs->a = *axes;
+  v3_cross_product (&(hs->n), tangents, axes);
+  v3_normalize (&(hs->n));
+  if (col) hs->c = *col;
+  chain_extent (job, points, coilradius);
+
+				/* helix start segments */
+  for (segment = 1; segment < spans[0]; segment++) {
+    t = ((double) segment) / ((double) spans[0]);
+    pos = curve[segment];
+    halfwidth = coilradius +
+      (0.5 * current_state->helixwidth - coilradius) *
+      0.5 * (- cos (ANGLE_PI * t) + 1.0);
+    hs = segment_buffer_helix (sb);
+    v3_sum_scaled (&(hs->p1), &pos, halfwidth, axes);
+    v3_sum_scaled (&(hs->p2), &pos, -halfwidth, axes);
+    hs->a = *axes;
+    dir = curve_tangents[segment];
+    v3_cross_product (&(hs->n), &dir, axes);
+    v3_normalize (&(hs->n));
+    if (current_state->colourparts &&
+	(segment == spans[0] / 2)) col = &(ch->residues[1]->colour);
+    if (col) hs->c = *col;
+    chain_extent (job, &pos, halfwidth);
+  }
+
+  halfwidth = 0.5 * current_state->helixwidth;
+  hs = segment_buffer_helix (sb);
+  v3_sum_scaled (&(hs->p1), points + 1, halfwidth, axes + 1);
+  v3_sum_scaled (&(hs->p2), points + 1, -halfwidth, axes + 1);
+  hs->a = *(axes + 1);
+  v3_cross_product (&(hs->n), tangents + 1, axes + 1);
+  v3_normalize (&(hs->n));
+  if (col) hs->c = *col;
+  chain_extent (job, points + 1, halfwidth);
+
+				/* helix main segments */
+  for (slot = 1; slot < ch->length - 2; slot++) {
+
+    for (segment = 1; segment < spans[slot]; segment++) {
+      t = ((double) segment) / ((double) spans[slot]);
+      hs = segment_buffer_helix (sb);
+      v3_scaled (&(hs->a), 1.0 - t, axes + slot);
+      v3_add_scaled (&(hs->a), t, axes + slot + 1);
+      v3_normalize (&(hs->a));
+      pos = curve[first_segment[slot] + segment];
+      v3_sum_scaled (&(hs->p1), &pos, halfwidth, &(hs->a));
+      v3_sum_scaled (&(hs->p2), &pos, -halfwidth, &(hs->a));
+      dir = curve_tangents[first_segment[slot] + segment];
+      v3_cross_product (&(hs->n), &dir, &(hs->a));
       v3_normalize (&(hs->n));
-      if (current_state->colourparts && (segment == segments / 2))
-	  col = &(ch->residues[ch->length-2]->colour);
+      if (current_state->colourparts && (segment == spans[slot] / 2))
+	col = &(ch->residues[slot+1]->colour);
       if (col) hs->c = *col;
-      ext3d_update (&pos, halfwidth);
+      chain_extent (job, &pos, halfwidth);
     }
 
-    hs = helix_segment_next();
-    v3_sum_scaled (&(hs->p1), points + ch->length - 1,
-		              coilradius, axes + ch->length - 1);
-    v3_sum_scaled (&(hs->p2), points + ch->length - 1,
-		              -coilradius, axes + ch->length - 1);
+    hs = segment_buffer_helix (sb);
+    v3_sum_scaled (&(hs->p1), points + slot + 1, halfwidth, axes + slot + 1);
+    v3_sum_scaled (&(hs->p2), points + slot + 1, -halfwidth, axes + slot +1);
+    hs->a = *(axes + slot + 1);
+    v3_cross_product (&(hs->n), tangents + slot + 1, axes + slot + 1);
+    v3_normalize (&(hs->n));
+    if (col) hs->c = *col;
+    chain_extent (job, points + slot + 1, halfwidth);
+  }
+				/* helix finish segments */
+  for (segment = 1; segment < spans[ch->length - 2]; segment++) {
+    t = ((double) segment) / ((double) spans[ch->length - 2]);
+    pos = curve[first_segment[ch->length - 2] + segment];
+    halfwidth = coilradius +
+      (0.5 * current_state->helixwidth - coilradius) *
+      0.5 * (cos (ANGLE_PI * t) + 1.0);
+    hs = segment_buffer_helix (sb);
+    v3_sum_scaled (&(hs->p1), &pos, halfwidth, axes + ch->length - 1);
+    v3_sum_scaled (&(hs->p2), &pos, -halfwidth, axes + ch->length - 1);
     hs->a = *(axes + ch->length - 1);
-    v3_cross_product (&(hs->n),
-		      tangents + ch->length - 1, axes + ch->length - 1);
+    dir = curve_tangents[first_segment[ch->length - 2] + segment];
+    v3_cross_product (&(hs->n), &dir, axes + ch->length - 1);
     v3_normalize (&(hs->n));
+    if (current_state->colourparts &&
+	(segment == spans[ch->length - 2] / 2))
+      col = &(ch->residues[ch->length-2]->colour);
     if (col) hs->c = *col;
-    ext3d_update (points + ch->length - 1, coilradius);
+    chain_extent (job, &pos, halfwidth);
+  }
+
+  hs = segment_buffer_helix (sb);
+  v3_sum_scaled (&(hs->p1), points + ch->length - 1,
+			    coilradius, axes + ch->length - 1);
+  v3_sum_scaled (&(hs->p2), points + ch->length - 1,
+			    -coilradius, axes + ch->length - 1);
+  hs->a = *(axes + ch->length - 1);
+  v3_cross_product (&(hs->n),
+		    tangents + ch->length - 1, axes + ch->length - 1);
+  v3_normalize (&(hs->n));
+  if (col) hs->c = *col;
+  chain_extent (job, points + ch->length - 1, coilradius);
+
+  free (points);
+  free (axes);
+  free (tangents);
+  free (curve);
+  free (curve_tangents);
+  free (spans);
+  free (first_segment);
+}
 
-    output_helix();
 
-    free (points);
-    free (axes);
-    free (tangents);
-  }
+/*------------------------------------------------------------*/
+static void
+helix_geometry (void)
+{
+  mol3d_chain *first_ch;
+  int segments = detail_segments();
+
+  assert (count_residue_selections() == 1);
+
+  first_ch = get_peptide_chains();
+
+				/* colourparts requires even number of seg's */
+  if (current_state->colourparts && (segments % 2)) segments++;
+  set_cartoon_segments (segments);
+
+  cartoon.radius = current_state->coilradius;
+  if (cartoon.radius < 0.01) cartoon.radius = 0.01; /* not too thin */
+
+  chain_jobs_run (first_ch, 3, helix_chain);
+  chain_jobs_output ("helix", output_helix);
 
   if (first_ch) mol3d_chain_delete (first_ch);
 
@@ -1244,6 +1830,14 @@ helix (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+helix (void)
+{
+  detail_levels (helix_geometry, DETAIL_RESIDUE_SELECTION);
+}
+
+
 /*------------------------------------------------------------*/
 void
 line_start (void)
@@ -1429,16 +2023,88 @@ label_position (char *label)
 
 
 /*------------------------------------------------------------*/
-void
-object (char *filename)
+static void
+object_block (int code, vector3 *triplets, int count)
+{
+  int number, slot;
+
+  assert (triplets);
+  assert (count > 0);
+
+  number = objfile_triplets (code);
+
+  if (current_state->objecttransform) {
+    matrix3_transform_array (triplets, count / number, /* coordinate xform */
+			     number * sizeof (vector3), xform);
+    if (code == OBJ_TRIANGLES_NORMALS || /* normals rotate, not xform */
+	code == OBJ_TRIANGLES_NORMALS_COLOURS ||
+	code == OBJ_STRIP_NORMALS ||
+	code == OBJ_STRIP_NORMALS_COLOURS) {
+      matrix3_rotate_array (triplets + 1, count / number,
+			    number * sizeof (vector3), xform);
+    }
+  }
+
+  for (slot = 0; slot < count; slot += number) {
+    ext3d_update (triplets + slot, 0.0);
+  }
+
+  if (decimate_code (code)) {
+    decimate_add (code, triplets, count);
+  } else {
+    output_object (code, triplets, count);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+object_binary (char *filename)
+     /* The object file is in the binary format; mapped, not read. */
+{
+  objfile_binary ob;
+  vector3 *triplets;
+  int code, count;
+  int total = 0;
+
+  if (! objfile_binary_open (&ob, filename)) {
+    yyerror ("could not map the binary object file");
+    return;
+  }
+
+  output_start_object();
+  while ((count = objfile_binary_block (&ob, &code, &triplets)) > 0) {
+    object_block (code, triplets, count);
+    total += count;
+  }
+  decimate_output();
+  output_finish_object();
+  objfile_binary_close (&ob);
+
+  if (count < 0) {
+    yyerror ("invalid format or content in binary object file");
+  } else if (message_mode) {
+    fprintf (stderr, "%i data triplets read from object file\n", total);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+object_geometry (void)
 {
   FILE *file;
-  char object_code[4];
-  int close_file, code, alloc, slot, count, number;
+  int close_file, code, alloc, count;
   vector3 *triplets;
   int total = 0;
+  char *filename = object_filename;
 
   if (filename) {
+    watch_file (filename);
+    if (objfile_is_binary (filename)) {
+      object_binary (filename);
+      return;
+    }
     file = fopen (filename, "r");
     if (file == NULL) {
       yyerror ("could not open the object file");
@@ -1455,357 +2121,284 @@ object (char *filename)
 
   output_start_object();
 
-  while (fscanf (file, "%3s", object_code) != EOF) {
-    if (str_eq (object_code, "P")) {
-      code = OBJ_POINTS;
-    } else if (str_eq (object_code, "PC")) {
-      code = OBJ_POINTS_COLOURS;
-    } else if (str_eq (object_code, "L")) {
-      code = OBJ_LINES;
-    } else if (str_eq (object_code, "LC")) {
-      code = OBJ_LINES_COLOURS;
-    } else if (str_eq (object_code, "T")) {
-      code = OBJ_TRIANGLES;
-    } else if (str_eq (object_code, "TC")) {
-      code = OBJ_TRIANGLES_COLOURS;
-    } else if (str_eq (object_code, "TN")) {
-      code = OBJ_TRIANGLES_NORMALS;
-    } else if (str_eq (object_code, "TNC")) {
-      code = OBJ_TRIANGLES_NORMALS_COLOURS;
-    } else if (str_eq (object_code, "S")) {
-      code = OBJ_STRIP;
-    } else if (str_eq (object_code, "SC")) {
-      code = OBJ_STRIP_COLOURS;
-    } else if (str_eq (object_code, "SN")) {
-      code = OBJ_STRIP_NORMALS;
-    } else if (str_eq (object_code, "SNC")) {
-      code = OBJ_STRIP_NORMALS_COLOURS;
-    } else if (str_eq (object_code, "Q")) {
-      goto finish;
-    } else {
-      goto format_error;
-    }
-
-    if (fscanf (file, "%i", &count) != 1) goto format_error;
-
-    switch (code) {
-    case OBJ_POINTS:
-      if (count < 1) goto format_error;
-      number = 1;
-      break;
-    case OBJ_POINTS_COLOURS:
-      if (count < 1) goto format_error;
-      number = 2;
-      break;
-    case OBJ_LINES:
-      if (count < 2) goto format_error;
-      number = 1;
-      break;
-    case OBJ_LINES_COLOURS:
-      if (count < 2) goto format_error;
-      number = 2;
-      break;
-    case OBJ_TRIANGLES:
-      if ((count < 3) || (count % 3 != 0)) goto format_error;
-      number = 1;
-      break;
-    case OBJ_TRIANGLES_COLOURS:
-    case OBJ_TRIANGLES_NORMALS:
-      if ((count < 3) || (count % 3 != 0)) goto format_error;
-      number = 2;
-      break;
-    case OBJ_TRIANGLES_NORMALS_COLOURS:
-      if ((count < 3) || (count % 3 != 0)) goto format_error;
-      number = 3;
-      break;
-    case OBJ_STRIP:
-      if (count < 3) goto format_error;
-      number = 1;
-      break;
-    case OBJ_STRIP_COLOURS:
-    case OBJ_STRIP_NORMALS:
-      if (count < 3) goto format_error;
-      number = 2;
-      break;
-    case OBJ_STRIP_NORMALS_COLOURS:
-      if (count < 3) goto format_error;
-      number = 3;
-      break;
-    default:
-      goto format_error;
-    }
-
-    count *= number;
-
-    if (count > alloc) {
-      alloc = count;
-      triplets = realloc (triplets, count * sizeof (vector3));
-    }
-
-    for (slot = 0; slot < count; slot++) {
-      if (fscanf (file, "%lg %lg %lg",
-		  &(triplets[slot].x),
-		  &(triplets[slot].y),
-		  &(triplets[slot].z)) != 3) goto format_error;
-    }
-
-    if (current_state->objecttransform) {
-      for (slot = 0; slot < count; slot += number) { /* coordinate xform */
-	matrix3_transform (triplets + slot, xform);
-      }
-      if (code == OBJ_TRIANGLES_NORMALS || /* normals rotate, not xform */
-	  code == OBJ_TRIANGLES_NORMALS_COLOURS ||
-	  code == OBJ_STRIP_NORMALS ||
-	  code == OBJ_STRIP_NORMALS_COLOURS) {
-	for (slot = 1; slot < count; slot += number) {
-	  matrix3_rotate (triplets + slot, xform);
-	}
-      }
-    }
-
-    for (slot = 0; slot < count; slot += number) {
-      ext3d_update (triplets + slot, 0.0);
-    }
-
-    output_object (code, triplets, count);
+  while ((count = objfile_text_block (file, &code, &triplets, &alloc)) > 0) {
+    object_block (code, triplets, count);
     total += count;
   }
 
-finish:
   free (triplets);
+  decimate_output();
   output_finish_object();
   if (close_file) fclose (file);
-  if (message_mode)
-    fprintf (stderr, "%i data triplets read from object file\n", total);
-  return;
 
-format_error:
-  free (triplets);
-  output_finish_object();
-  if (close_file) fclose (file);
-  yyerror ("invalid format or content in object file");
+  if (count < 0) {
+    yyerror ("invalid format or content in object file");
+  } else if (message_mode) {
+    fprintf (stderr, "%i data triplets read from object file\n", total);
+  }
 }
 
 
 /*------------------------------------------------------------*/
 void
-strand (void)
+object (char *filename)
 {
-  mol3d_chain *first_ch, *ch;
-  vector3 *points, *normals, *smoothed;
-  vector3 dir, dir1, dir2, pos, side, vec1, vec2, normal;
-  colour *col;
-  strand_segment *ss;
-  int slot, segment, segments;
-  double thickness, radius, t;
-  double width = current_state->strandwidth / 2.0;
-
-  assert (count_residue_selections() == 1);
-
-  if (current_state->colourparts) {         /* strand is less curved; */
-    segments = current_state->segments / 2; /* colourparts requires */
-    if (segments % 2 != 0) segments++;      /* even number of segments */
-  } else {
-    segments = current_state->segments / 2 + 1;
-  }
-
-  if (current_state->strandthickness > current_state->strandwidth) {
-    radius = current_state->strandthickness / 2.0;
+  object_filename = filename;
+  if (filename) {		/* inline data can be read only once */
+    detail_levels (object_geometry, DETAIL_NO_SELECTION);
   } else {
-    radius = current_state->strandwidth / 2.0;
+    object_geometry();
   }
+}
 
-  if (current_state->strandthickness < 0.01) {
-    thickness = 0.0;
-  } else {
-    thickness = current_state->strandthickness / 2.0;
-  }
-
-  first_ch = get_peptide_chains();
-
-  for (ch = first_ch; ch; ch = ch->next) {
-    if (ch->length < 3) continue;
-
-    msg_chain ("strand", ch);
 
-    points = get_atom_positions (ch);
+/*------------------------------------------------------------*/
+static void
+strand_chain (chain_job *job)
+{
+  mol3d_chain *ch = job->ch;
+  segment_buffer *sb = &(job->segments);
+  vector3 *points, *normals, *smoothed, *vectors, *curve;
+  vector3 dir, dir1, dir2, pos, side, normal;
+  colour *col;
+  strand_segment *ss;
+  int slot, segment;
+  double t;
+  int *spans, *first_segment;
+  double angle;
+  double thickness = cartoon.thickness;
+  double radius = cartoon.radius;
+  double width = cartoon.width;
+
+  points = get_atom_positions (ch);
 				/* normals for the strand */
-    normals = malloc (ch->length * sizeof (vector3));
-    for (slot = 1; slot < ch->length - 1; slot++) {
-      v3_middle (&pos, points + slot - 1, points + slot + 1);
-      v3_difference (normals + slot, points + slot, &pos);
-      v3_normalize (normals + slot);
-    }
+  normals = malloc (ch->length * sizeof (vector3));
+  for (slot = 1; slot < ch->length - 1; slot++) {
+    v3_middle (&pos, points + slot - 1, points + slot + 1);
+    v3_difference (normals + slot, points + slot, &pos);
+    v3_normalize (normals + slot);
+  }
 				/* just copy the normals for the terminii */
-    *(normals) = *(normals + 1);
-    *(normals + ch->length - 1) = *(normals + ch->length - 2);
+  *(normals) = *(normals + 1);
+  *(normals + ch->length - 1) = *(normals + ch->length - 2);
 
 				/* smooth CA positions */
-    priestle_smoothing (points, ch->length, current_state->smoothsteps);
+  priestle_smoothing (points, ch->length, current_state->smoothsteps);
 
 				/* normals must point the same way */
-    for (slot = 0; slot < ch->length - 1; slot++) {
-      if (v3_dot_product (normals + slot, normals + slot + 1) < 0.0) {
-	v3_reverse (normals + slot + 1);
-      }
+  for (slot = 0; slot < ch->length - 1; slot++) {
+    if (v3_dot_product (normals + slot, normals + slot + 1) < 0.0) {
+      v3_reverse (normals + slot + 1);
     }
+  }
 				/* smooth normals, one iteration */
-    smoothed = malloc (ch->length * sizeof (vector3));
-    for (slot = 1; slot < ch->length - 1; slot++) {
-      v3_sum (&dir, normals + slot - 1, normals + slot);
-      v3_add (&dir, normals + slot + 1);
-      v3_normalize (&dir);
-      *(smoothed + slot) = dir;
-    }
-    for (slot = 1; slot < ch->length - 1; slot++) {
-      *(normals + slot) = *(smoothed + slot);
-    }
-    free (smoothed);
+  smoothed = malloc (ch->length * sizeof (vector3));
+  for (slot = 1; slot < ch->length - 1; slot++) {
+    v3_sum (&dir, normals + slot - 1, normals + slot);
+    v3_add (&dir, normals + slot + 1);
+    v3_normalize (&dir);
+    *(smoothed + slot) = dir;
+  }
+  for (slot = 1; slot < ch->length - 1; slot++) {
+    *(normals + slot) = *(smoothed + slot);
+  }
+  free (smoothed);
 
 				/* normals exactly perpendicular to strand */
-    v3_difference (&dir, points + 1, points);
-    v3_cross_product (&side, &dir, normals);
-    v3_cross_product (normals, &side, &dir);
-    v3_normalize (normals);
-    for (slot = 1; slot < ch->length - 1; slot++) {
-      v3_difference (&dir, points + slot + 1, points + slot - 1);
-      v3_cross_product (&side, &dir, normals + slot);
-      v3_cross_product (normals + slot, &side, &dir);
-      v3_normalize (normals + slot);
-    }
-    v3_difference (&dir, points + ch->length - 1, points + ch->length - 2);
-    v3_cross_product (&side, &dir, normals + ch->length - 1);
-    v3_cross_product (normals + ch->length - 1, &side, &dir);
-    v3_normalize (normals + ch->length - 1);
+  v3_difference (&dir, points + 1, points);
+  v3_cross_product (&side, &dir, normals);
+  v3_cross_product (normals, &side, &dir);
+  v3_normalize (normals);
+  for (slot = 1; slot < ch->length - 1; slot++) {
+    v3_difference (&dir, points + slot + 1, points + slot - 1);
+    v3_cross_product (&side, &dir, normals + slot);
+    v3_cross_product (normals + slot, &side, &dir);
+    v3_normalize (normals + slot);
+  }
+  v3_difference (&dir, points + ch->length - 1, points + ch->length - 2);
+  v3_cross_product (&side, &dir, normals + ch->length - 1);
+  v3_cross_product (normals + ch->length - 1, &side, &dir);
+  v3_normalize (normals + ch->length - 1);
 
-    if (current_state->colourparts) {
-      col = &(ch->residues[0]->colour);
-    } else {
-      col = NULL;
-    }
+  if (current_state->colourparts) {
+    col = &(ch->residues[0]->colour);
+  } else {
+    col = NULL;
+  }
+
+				/* Hermite spline vectors and curve */
+  vectors = malloc ((ch->length - 1) * sizeof (vector3));
+  v3_difference (vectors, points + 1, points);
+  v3_scale (vectors, STRAND_HERMITE_FACTOR);
+  for (slot = 1; slot < ch->length - 1; slot++) {
+    v3_difference (vectors + slot, points + slot + 1, points + slot - 1);
+    v3_scale (vectors + slot, STRAND_HERMITE_FACTOR);
+  }
+  spans = malloc ((ch->length - 1) * sizeof (int));
+  first_segment = malloc ((ch->length - 1) * sizeof (int));
+  for (slot = 0; slot < ch->length - 2; slot++) { /* edges turn about axis */
+    angle = twist_angle (normals + slot, normals + slot + 1);
+    spans[slot] = span_segments (points + slot, points + slot + 1,
+				 vectors + slot, vectors + slot + 1,
+				 width * angle * angle);
+  }
+  curve = spline_curve (spans, first_segment, NULL,
+			points, vectors, ch->length - 1);
 
-    strand_segment_init();
 				/* strand body */
-    v3_difference (&dir2, points + 1, points);
+  v3_difference (&dir2, points + 1, points);
+  v3_normalize (&dir2);
+
+  for (slot = 0; slot < ch->length - 2; slot++) {
+
+    dir1 = dir2;		/* direction vectors */
+    v3_difference (&dir2, points + slot + 2, points + slot);
     v3_normalize (&dir2);
-    v3_difference (&vec2, points + 1, points);
-    v3_scale (&vec2, STRAND_HERMITE_FACTOR);
-
-    for (slot = 0; slot < ch->length - 2; slot++) {
-
-      dir1 = dir2;		/* direction vectors */
-      v3_difference (&dir2, points + slot + 2, points + slot);
-      v3_normalize (&dir2);
-      vec1 = vec2;		/* Hermite spline vectors */
-      v3_difference (&vec2, points + slot + 2, points + slot);
-      v3_scale (&vec2, STRAND_HERMITE_FACTOR);
-      hermite_set (points + slot, points + slot + 1, &vec1, &vec2);
-
-      for (segment = 0; segment < segments; segment++) {
-	t = ((double) segment) / ((double) segments);
-	hermite_get (&pos, t);
-	v3_scaled (&dir, 1.0 - t, &dir1);
-	v3_add_scaled (&dir, t, &dir2);
-	v3_scaled (&normal, 1.0 - t, normals + slot);
-	v3_add_scaled (&normal, t, normals + slot + 1);
-	v3_cross_product (&side, &normal, &dir);
-	v3_normalize (&side);
-	if (current_state->colourparts &&
-	    (segment == segments / 2)) col = &(ch->residues[slot+1]->colour);
-	ss = strand_segment_next();
-	v3_sum_scaled (&(ss->p1), &pos, width, &side);
-	v3_add_scaled (&(ss->p1), thickness, &normal);
-	v3_sum_scaled (&(ss->p2), &pos, width, &side);
-	v3_add_scaled (&(ss->p2), -thickness, &normal);
-	v3_sum_scaled (&(ss->p3), &pos, -width, &side);
-	v3_add_scaled (&(ss->p3), -thickness, &normal);
-	v3_sum_scaled (&(ss->p4), &pos, -width, &side);
-	v3_add_scaled (&(ss->p4), thickness, &normal);
-	ss->n1 = normal;
-	ss->n2 = side;
-	v3_scaled (&(ss->n3), -1.0, &normal);
-	v3_scaled (&(ss->n4), -1.0, &side);
-	if (col) ss->c = *col;
-	ext3d_update (&pos, radius);
-      }
+
+    for (segment = 0; segment < spans[slot]; segment++) {
+      t = ((double) segment) / ((double) spans[slot]);
+      pos = curve[first_segment[slot] + segment];
+      v3_scaled (&dir, 1.0 - t, &dir1);
+      v3_add_scaled (&dir, t, &dir2);
+      v3_scaled (&normal, 1.0 - t, normals + slot);
+      v3_add_scaled (&normal, t, normals + slot + 1);
+      v3_cross_product (&side, &normal, &dir);
+      v3_normalize (&side);
+      if (current_state->colourparts &&
+	  (segment == spans[slot] / 2)) col = &(ch->residues[slot+1]->colour);
+      ss = segment_buffer_strand (sb);
+      v3_sum_scaled (&(ss->p1), &pos, width, &side);
+      v3_add_scaled (&(ss->p1), thickness, &normal);
+      v3_sum_scaled (&(ss->p2), &pos, width, &side);
+      v3_add_scaled (&(ss->p2), -thickness, &normal);
+      v3_sum_scaled (&(ss->p3), &pos, -width, &side);
+      v3_add_scaled (&(ss->p3), -thickness, &normal);
+      v3_sum_scaled (&(ss->p4), &pos, -width, &side);
+      v3_add_scaled (&(ss->p4), thickness, &normal);
+      ss->n1 = normal;
+      ss->n2 = side;
+      v3_scaled (&(ss->n3), -1.0, &normal);
+      v3_scaled (&(ss->n4), -1.0, &side);
+      if (col) ss->c = *col;
+      chain_extent (job, &pos, radius);
     }
+  }
 				/* strand body, last segment */
-    dir = dir2;
-    normal = *(normals + ch->length - 2);
-    v3_cross_product (&side, &normal, &dir);
-    v3_normalize (&side);
-    pos = *(points + ch->length - 2);
-    ss = strand_segment_next();
-    v3_sum_scaled (&(ss->p1), &pos, width, &side);
-    v3_add_scaled (&(ss->p1), thickness, &normal);
-    v3_sum_scaled (&(ss->p2), &pos, width, &side);
-    v3_add_scaled (&(ss->p2), -thickness, &normal);
-    v3_sum_scaled (&(ss->p3), &pos, -width, &side);
-    v3_add_scaled (&(ss->p3), -thickness, &normal);
-    v3_sum_scaled (&(ss->p4), &pos, -width, &side);
-    v3_add_scaled (&(ss->p4), thickness, &normal);
-    ss->n1 = normal;
-    ss->n2 = side;
-    v3_scaled (&(ss->n3), -1.0, &normal);
-    v3_scaled (&(ss->n4), -1.0, &side);
-    if (col) ss->c = *col;
-    ext3d_update (&pos, radius);
+  dir = dir2;
+  normal = *(normals + ch->length - 2);
+  v3_cross_product (&side, &normal, &dir);
+  v3_normalize (&side);
+  pos = *(points + ch->length - 2);
+  ss = segment_buffer_strand (sb);
+  v3_sum_scaled (&(ss->p1), &pos, width, &side);
+  v3_add_scaled (&(ss->p1), thickness, &normal);
+  v3_sum_scaled (&(ss->p2), &pos, width, &side);
+  v3_add_scaled (&(ss->p2), -thickness, &normal);
+  v3_sum_scaled (&(ss->p3), &pos, -width, &side);
+  v3_add_scaled (&(ss->p3), -thickness, &normal);
+  v3_sum_scaled (&(ss->p4), &pos, -width, &side);
+  v3_add_scaled (&(ss->p4), thickness, &normal);
+  ss->n1 = normal;
+  ss->n2 = side;
+  v3_scaled (&(ss->n3), -1.0, &normal);
+  v3_scaled (&(ss->n4), -1.0, &side);
+  if (col) ss->c = *col;
+  chain_extent (job, &pos, radius);
 				/* strand arrow head: 3 segments */
-    ss = strand_segment_next();
-    v3_sum_scaled (&(ss->p1), &pos, 1.5 * width, &side);
-    v3_add_scaled (&(ss->p1), thickness, &normal);
-    v3_sum_scaled (&(ss->p2), &pos, 1.5 * width, &side);
-    v3_add_scaled (&(ss->p2), -thickness, &normal);
-    v3_sum_scaled (&(ss->p3), &pos, -1.5 * width, &side);
-    v3_add_scaled (&(ss->p3), -thickness, &normal);
-    v3_sum_scaled (&(ss->p4), &pos, -1.5 * width, &side);
-    v3_add_scaled (&(ss->p4), thickness, &normal);
-    ss->n1 = normal;
-    ss->n2 = side;
-    v3_scaled (&(ss->n3), -1.0, &normal);
-    v3_scaled (&(ss->n4), -1.0, &side);
-    if (col) ss->c = *col;
-    ext3d_update (&pos, 1.5 * radius);
-
-    dir1 = dir2;
-    v3_difference (&dir2, points + ch->length - 1, points + ch->length - 2);
-    v3_normalize (&dir1);
-    v3_middle (&dir, &dir1, &dir2);
-    v3_middle (&pos, points + ch->length - 2, points + ch->length - 1);
-    v3_middle (&normal, normals + ch->length - 2, normals + ch->length - 1);
-    v3_normalize (&normal);
-    v3_cross_product (&side, &normal, &dir);
-    v3_normalize (&side);
-    ss = strand_segment_next();
-    v3_sum_scaled (&(ss->p1), &pos, 0.75 * width, &side);
-    v3_add_scaled (&(ss->p1), thickness, &normal);
-    v3_sum_scaled (&(ss->p2), &pos, 0.75 * width, &side);
-    v3_add_scaled (&(ss->p2), -thickness, &normal);
-    v3_sum_scaled (&(ss->p3), &pos, -0.75 * width, &side);
-    v3_add_scaled (&(ss->p3), -thickness, &normal);
-    v3_sum_scaled (&(ss->p4), &pos, -0.75 * width, &side);
-    v3_add_scaled (&(ss->p4), thickness, &normal);
-    ss->n1 = normal;
-    ss->n2 = side;
-    v3_scaled (&(ss->n3), -1.0, &normal);
-    v3_scaled (&(ss->n4), -1.0, &side);
-    if (current_state->colourparts) ss->c = ch->residues[ch->length-1]->colour;
-    ext3d_update (&pos, 0.75 * radius);
-
-    pos = *(points + ch->length - 1);
-    normal = *(normals + ch->length - 1);
-    ss = strand_segment_next();
-    v3_sum_scaled (&(ss->p1), &pos, thickness, &normal);
-    v3_sum_scaled (&(ss->p2), &pos, -thickness, &normal);
-    ss->n1 = normal;
-    v3_scaled (&(ss->n2), -1.0, &normal);
-    ext3d_update (points + ch->length - 1, thickness);
-
-    output_strand();
-
-    free (normals);
-    free (points);
+  ss = segment_buffer_strand (sb);
+  v3_sum_scaled (&(ss->p1), &pos, 1.5 * width, &side);
+  v3_add_scaled (&(ss->p1), thickness, &normal);
+  v3_sum_scaled (&(ss->p2), &pos, 1.5 * width, &side);
+  v3_add_scaled (&(ss->p2), -thickness, &normal);
+  v3_sum_scaled (&(ss->p3), &pos, -1.5 * width, &side);
+  v3_add_scaled (&(ss->p3), -thickness, &normal);
+  v3_sum_scaled (&(ss->p4), &pos, -1.5 * width, &side);
+  v3_add_scaled (&(ss->p4), thickness, &normal);
+  ss->n1 = normal;
+  ss->n2 = side;
+  v3_scaled (&(ss->n3), -1.0, &normal);
+  v3_scaled (&(ss->n4), -1.0, &side);
+  if (col) ss->c = *col;
+  chain_extent (job, &pos, 1.5 * radius);
+
+  dir1 = dir2;
+  v3_difference (&dir2, points + ch->length - 1, points + ch->length - 2);
+  v3_normalize (&dir1);
+  v3_middle (&dir, &dir1, &dir2);
+  v3_middle (&pos, points + ch->length - 2, points + ch->length - 1);
+  v3_middle (&normal, normals + ch->length - 2, normals + ch->length - 1);
+  v3_normalize (&normal);
+  v3_cross_product (&side, &normal, &dir);
+  v3_normalize (&side);
+  ss = segment_buffer_strand (sb);
+  v3_sum_scaled (&(ss->p1), &pos, 0.75 * width, &side);
+  v3_add_scaled (&(ss->p1), thickness, &normal);
+  v3_sum_scaled (&(ss->p2), &pos, 0.75 * width, &side);
+  v3_add_scaled (&(ss->p2), -thickness, &normal);
+  v3_sum_scaled (&(ss->p3), &pos, -0.75 * width, &side);
+  v3_add_scaled (&(ss->p3), -thickness, &normal);
+  v3_sum_scaled (&(ss->p4), &pos, -0.75 * width, &side);
+  v3_add_scaled (&(ss->p4), thickness, &normal);
+  ss->n1 = normal;
+  ss->n2 = side;
+  v3_scaled (&(ss->n3), -1.0, &normal);
+  v3_scaled (&(ss->n4), -1.0, &side);
+  if (current_state->colourparts) ss->c = ch->residues[ch->length-1]->colour;
+  chain_extent (job, &pos, 0.75 * radius);
+
+  pos = *(points + ch->length - 1);
+  normal = *(normals + ch->length - 1);
+  ss = segment_buffer_strand (sb);
+  v3_sum_scaled (&(ss->p1), &pos, thickness, &normal);
+  v3_sum_scaled (&(ss->p2), &pos, -thickness, &normal);
+  ss->n1 = normal;
+  v3_scaled (&(ss->n2), -1.0, &normal);
+  chain_extent (job, points + ch->length - 1, thickness);
+
+  free (normals);
+  free (points);
+  free (vectors);
+  free (curve);
+  free (spans);
+  free (first_segment);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+strand_geometry (void)
+{
+  mol3d_chain *first_ch;
+  int segments;
+
+  assert (count_residue_selections() == 1);
+
+  if (current_state->colourparts) {         /* strand is less curved; */
+    segments = detail_segments() / 2;       /* colourparts requires */
+    if (segments % 2 != 0) segments++;      /* even number of segments */
+  } else {
+    segments = detail_segments() / 2 + 1;
   }
+  set_cartoon_segments (segments);
+
+  if (current_state->strandthickness > current_state->strandwidth) {
+    cartoon.radius = current_state->strandthickness / 2.0;
+  } else {
+    cartoon.radius = current_state->strandwidth / 2.0;
+  }
+
+  if (current_state->strandthickness < 0.01) {
+    cartoon.thickness = 0.0;
+  } else {
+    cartoon.thickness = current_state->strandthickness / 2.0;
+  }
+
+  cartoon.width = current_state->strandwidth / 2.0;
+
+  first_ch = get_peptide_chains();
+
+  chain_jobs_run (first_ch, 3, strand_chain);
+  chain_jobs_output ("strand", output_strand);
 
   if (first_ch) mol3d_chain_delete (first_ch);
 
@@ -1813,6 +2406,14 @@ strand (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+strand (void)
+{
+  detail_levels (strand_geometry, DETAIL_RESIDUE_SELECTION);
+}
+
+
 /*------------------------------------------------------------*/
 void
 trace (void)
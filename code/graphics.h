@@ -24,6 +24,9 @@ enum object_codes {OBJ_POINTS, OBJ_POINTS_COLOURS,
 #define LINEWIDTH_FACTOR 0.04
 #define LINEWIDTH_MINIMUM 0.005
 
+enum detail_selections {DETAIL_NO_SELECTION, DETAIL_ATOM_SELECTION,
+			DETAIL_RESIDUE_SELECTION};
+
 extern boolean frame;
 extern double area [4];
 extern colour background_colour;
@@ -37,6 +40,9 @@ extern double dynamics_time;
 extern double aspect_ratio;
 extern double aspect_window_x, aspect_window_y;
 
+extern int detail_level;
+extern int detail_level_total;
+
 extern void (*output_first_plot) (void);
 extern void (*output_start_plot) (void);
 extern void (*output_finish_plot) (void);
@@ -81,12 +87,15 @@ void set_area_values (double xlo, double ylo, double xhi, double yhi);
 void set_window (void);
 void set_slab (void);
 void set_fog (void);
+void viewpoint_points (vector3 *from, vector3 *towards);
 
 void set_extent (void);
 int outside_extent_radius (vector3 *v, double radius);
 int outside_extent_2v (vector3 *v1, vector3 *v2);
 
 double depthcue (double depth, state *st);
+double pixel_size (void);
+void detail_levels (void (*geometry) (void), int selection);
 
 void ball_and_stick (int single_selection);
 void bonds (int single_selection);
@@ -4,8 +4,37 @@
 
    Image file general output routines.
 
-   This implementation requires OpenGL and GLX (X windowing system).
-   It relies on the 'opengl.c' code.
+   If OPENGL_SUPPORT is defined and an X display is available, the
+   image is rendered by OpenGL in a GLX Pixmap, relying on the
+   'opengl.c' code. Otherwise, or if so requested, the image is
+   rendered by the software renderer in 'swrender.c'. Alternatively,
+   the Raster3D scene is ray traced by 'raytrace.c'.
+
+   Images larger than IMAGE_LIMIT in either direction are rendered in
+   bands of TILE_SIZE rows, as the rows are requested by the image
+   file writer, so that only one band is held in memory at any time.
+   For OpenGL, each band is rendered as tiles of at most TILE_SIZE
+   square, since the X Pixmap size is limited. Otherwise the OpenGL
+   image is read back in one go, rather than row by row.
+
+   Each plot of the input file is written to a separate image file.
+   The output file name is either a 'printf' template for the plot
+   number, such as 'fig%02i.png', or a plain name, in which case the
+   plot number is inserted before the extension for plots after the
+   first. For the software renderers, the image of each plot is
+   rendered and written by a child process once the geometry has been
+   built, while the next plot is being read; at most one such process
+   per processor runs at any time. In batch mode these processes may
+   run on past the end of the output, into the next batch job.
+
+   For animation, each plot may be written as a number of frames, in
+   which the scene is turned about the vertical axis through the origin
+   of the view; a full turn by default. If the plot has viewpoints, the
+   frames instead go from the plain view through each viewpoint in
+   turn, interpolating the rotation and the centre of the view between
+   them. The geometry is built once, and each frame only transforms
+   and renders it, in a child process as for a plot. The frames are
+   numbered on from the plots.
 
    Copyright (C) 1997-1998 Per Kraulis
     11-Sep-1997  split out of jpeg.c
@@ -13,19 +42,82 @@
     12-Mar-1998  fixed number of required buffer bits
     19-Aug-1998  implemented GLX Pbuffer extension
     23-Nov-1998  got rid of GLX Pbuffer extension; fixed visual depth bug
+    18-Oct-2026  software rendering fallback
+    18-Oct-2026  ray tracing
+    18-Oct-2026  tiled rendering of large images
+    18-Oct-2026  whole-frame OpenGL readback
+    18-Oct-2026  multiple plots; concurrent rendering of plots
+    18-Oct-2026  batch mode
+    18-Oct-2026  animation frames
+    18-Oct-2026  animation frames through the viewpoints
 */
 
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "clib/str_utils.h"
+#include "clib/angle.h"
+#include "clib/matrix3.h"
+#include "clib/quaternion.h"
+
+#ifdef OPENGL_SUPPORT
 #include <X11/Xlib.h>
 #include <GL/gl.h>
 #include <GL/glx.h>
+#endif
 
 #include "image.h"
 #include "global.h"
 #include "graphics.h"
+#include "raster3d.h"
+#include "raytrace.h"
+#include "swrender.h"
+
+#ifdef OPENGL_SUPPORT
 #include "opengl.h"
+#endif
 
 
 /*============================================================*/
+#define IMAGE_LIMIT 4096	/* largest image rendered in one piece */
+#define TILE_SIZE 1024		/* multiple of the software band height */
+
+enum renderers {OPENGL_RENDERER, SOFTWARE_RENDERER, RAYTRACE_RENDERER};
+
+static int renderer = OPENGL_RENDERER;
+
+static boolean tiled;
+static int band_first, band_rows;
+static unsigned char *band = NULL; /* OpenGL tiles, RGB */
+
+static void (*write_header) (void);
+static void (*write_image) (void);
+static void (*renderer_finish_plot) (void);
+
+static char *filename_template = NULL;
+static char *plot_filename = NULL;
+static int plot_number = 0;
+static int running = 0;		/* child processes writing plots */
+static int failed = 0;
+static boolean detached = FALSE;
+static int frame_count = 0;	/* 0: plots are not animated */
+static double frame_degrees = 360.0;
+static boolean holding = FALSE;	/* keep the geometry for more frames */
+
+typedef struct {
+  quaternion rotation;
+  vector3 centre;
+} key_view;
+
+static key_view *key_views = NULL; /* plain view, then the viewpoints */
+static int key_count = 0;
+static int key_alloc = 0;
+
+#ifdef OPENGL_SUPPORT
 static Display *dpy;
 static XVisualInfo *vis;
 static GLXContext ctx;
@@ -163,19 +255,176 @@ visual_alternative (int alt, int *attributes)
 
   attributes[count++] = (int) None;
 }
+#endif
+
+
+/*------------------------------------------------------------*/
+static key_view *
+new_key_view (void)
+{
+  if (key_count >= key_alloc) {
+    key_alloc = key_alloc ? 2 * key_alloc : 8;
+    key_views = realloc (key_views, key_alloc * sizeof (key_view));
+  }
+  return key_views + key_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+image_viewpoint_output (void)
+     /*
+       Keep the viewpoint as a key view for the animation frames: the
+       rotation which turns its direction onto the negative z axis, and
+       the point it looks towards, which is moved to the origin.
+     */
+{
+  key_view *kv;
+  vector3 from, towards, dir, axis;
+  vector3 zdir = {0.0, 0.0, -1.0};
+
+  viewpoint_points (&from, &towards);
+  if (frame_count == 0) return;
+
+  if (key_count == 0) {		/* the plain view of the plot */
+    kv = new_key_view();
+    quat_initialize (&(kv->rotation), 0.0, 0.0, 1.0, 0.0);
+    kv->centre.x = kv->centre.y = kv->centre.z = 0.0;
+  }
+
+  kv = new_key_view();
+  v3_difference (&dir, &towards, &from);
+  v3_cross_product (&axis, &zdir, &dir);
+  if (v3_length (&axis) < 1.0e-6 * v3_length (&dir)) {
+    axis.x = 0.0;		/* along the z axis; any normal will do */
+    axis.y = 1.0;
+    axis.z = 0.0;
+  }
+  quat_initialize_v3 (&(kv->rotation), &axis, v3_angle (&dir, &zdir));
+  kv->centre = towards;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_renderer (void)
+     /* Output routines for the renderer to use; OpenGL if possible. */
+{
+  if (renderer == RAYTRACE_RENDERER) {
+    r3d_set_raytrace();
+    return;
+  }
+
+#ifdef OPENGL_SUPPORT
+  if (getenv ("DISPLAY") == NULL) renderer = SOFTWARE_RENDERER;
+
+  if (renderer == OPENGL_RENDERER) {
+    ogl_set();
+    output_start_plot = ogl_start_plot_general;
+    return;
+  }
+#endif
+
+  renderer = SOFTWARE_RENDERER;
+  swr_set();
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_set (void (*header) (void), void (*body) (void))
+     /*
+       The image file format procedures: 'header' opens the output
+       file and writes the header, 'body' renders and writes the image.
+     */
+{
+  assert (header);
+  assert (body);
+
+  set_renderer();
+
+  write_header = header;
+  write_image = body;
+  renderer_finish_plot = output_finish_plot;
+  viewpoint_output = image_viewpoint_output;
+
+  output_first_plot = image_first_plot;
+  output_finish_plot = image_finish_plot;
+  output_finish_output = image_finish_output;
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_set_software (void)
+{
+  renderer = SOFTWARE_RENDERER;
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_set_raytrace (void)
+{
+  renderer = RAYTRACE_RENDERER;
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_set_frames (int number, double degrees)
+{
+  assert (number > 0);
+
+  frame_count = number;
+  frame_degrees = degrees;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_plot_filename (void)
+{
+  plot_number++;
+
+  if (filename_template == NULL) {
+    if (plot_number > 1)
+      yyerror ("multiple plots to standard output not possible for image file output");
+    return;
+  }
+
+  if (plot_filename) free (plot_filename);
+  if ((plot_number == 1) && ! strchr (filename_template, '%')) {
+    plot_filename = str_clone (filename_template);
+  } else {
+    plot_filename = numbered_filename (filename_template, plot_number,
+		     "invalid output file name template for image file output");
+  }
+}
 
 
 /*------------------------------------------------------------*/
 void
 image_first_plot (void)
 {
+#ifdef OPENGL_SUPPORT
   int attributes[32];
-  int slot, value;
+  int slot;
   GLboolean bparam;
+#endif
+
+  if (first_plot) {
+    filename_template = output_filename;
+    plot_number = 0;
+  }
+  key_count = 0;
+  set_plot_filename();
 
-  if (! first_plot)
-    yyerror ("only one plot per input file allowed for image file output");
+  tiled = (output_width > IMAGE_LIMIT) || (output_height > IMAGE_LIMIT);
 
+  if (renderer != OPENGL_RENDERER) return;
+
+#ifdef OPENGL_SUPPORT
   dpy = XOpenDisplay (NULL);
   if (dpy == NULL) yyerror ("X display could not be opened");
   if (! glXQueryExtension (dpy, NULL, NULL))
@@ -196,8 +445,15 @@ image_first_plot (void)
 
   out_of_memory = False;
   old_error_handler = XSetErrorHandler (x_error_handler);
-  xpixmap = XCreatePixmap (dpy, RootWindow (dpy, vis->screen),
-			   output_width, output_height, vis->depth);
+  if (tiled) {
+    xpixmap = XCreatePixmap (dpy, RootWindow (dpy, vis->screen),
+			     (output_width < TILE_SIZE) ? output_width : TILE_SIZE,
+			     (output_height < TILE_SIZE) ? output_height : TILE_SIZE,
+			     vis->depth);
+  } else {
+    xpixmap = XCreatePixmap (dpy, RootWindow (dpy, vis->screen),
+			     output_width, output_height, vis->depth);
+  }
   XSync (dpy, False);
   if (out_of_memory) {
     XSetErrorHandler (old_error_handler);
@@ -221,13 +477,35 @@ image_first_plot (void)
     glDrawBuffer (GL_FRONT);
     glReadBuffer (GL_FRONT);
   }
+#endif
 }
 
 
 /*------------------------------------------------------------*/
 void
 image_render (void)
+     /*
+       Untiled OpenGL images are rendered and read back whole. Otherwise
+       the pixels are rendered band by band as the rows are read by
+       'image_read_row'.
+     */
 {
+  band_rows = tiled ? TILE_SIZE : output_height;
+  band_first = - band_rows;
+
+  switch (renderer) {
+  case SOFTWARE_RENDERER:
+    swr_render();
+    return;
+  case RAYTRACE_RENDERER:
+    rt_render();
+    return;
+  }
+
+  if (tiled) return;
+
+#ifdef OPENGL_SUPPORT
+  band_first = 0;
   ogl_render_init();
   ogl_render_lights();
   ogl_render_lists();
@@ -237,6 +515,113 @@ image_render (void)
   glDisable (GL_FOG);
   glDisable (GL_LIGHTING);
   glFinish();
+
+  band = malloc (3 * output_width * output_height * sizeof (unsigned char));
+  glPixelStorei (GL_PACK_ALIGNMENT, 1);
+  glReadPixels (0, 0, output_width, output_height,
+		GL_RGB, GL_UNSIGNED_BYTE, band);
+#endif
+}
+
+
+/*------------------------------------------------------------*/
+static void
+render_band (int row)
+     /* Render the band of rows that contains the given row. */
+{
+  int rows;
+#ifdef OPENGL_SUPPORT
+  int x, width;
+#endif
+
+  band_first = row - row % band_rows;
+  rows = output_height - band_first;
+  if (rows > band_rows) rows = band_rows;
+
+  switch (renderer) {
+  case SOFTWARE_RENDERER:
+    swr_render_rows (band_first, rows);
+    return;
+  case RAYTRACE_RENDERER:
+    rt_render_rows (band_first, rows);
+    return;
+  }
+
+#ifdef OPENGL_SUPPORT
+  if (band == NULL)
+    band = malloc (3 * output_width * band_rows * sizeof (unsigned char));
+
+  glPixelStorei (GL_PACK_ALIGNMENT, 1);
+  glPixelStorei (GL_PACK_ROW_LENGTH, output_width);
+  for (x = 0; x < output_width; x += TILE_SIZE) {
+    width = output_width - x;
+    if (width > TILE_SIZE) width = TILE_SIZE;
+    ogl_set_tile (x, band_first, width, rows);
+    ogl_render_init();
+    ogl_render_lights();
+    ogl_render_lists();
+    glFinish();
+    glReadPixels (0, 0, width, rows, GL_RGB, GL_UNSIGNED_BYTE, band + 3 * x);
+  }
+  glPixelStorei (GL_PACK_ROW_LENGTH, 0);
+  ogl_set_tile (0, 0, 0, 0);
+#endif
+}
+
+
+/*------------------------------------------------------------*/
+static void
+convert_row (unsigned char *rgb, int format, unsigned char *buffer)
+     /* From an RGB row of the rendered image. */
+{
+  int slot, sum;
+
+  assert (rgb);
+  assert (buffer);
+
+  switch (format) {
+  case IMAGE_RGB:
+    memcpy (buffer, rgb, 3 * output_width);
+    break;
+  case IMAGE_LUMINANCE:		/* as OpenGL: sum, clamped */
+    for (slot = 0; slot < output_width; slot++) {
+      sum = rgb[3*slot] + rgb[3*slot+1] + rgb[3*slot+2];
+      buffer[slot] = (sum > 255) ? 255 : sum;
+    }
+    break;
+  case IMAGE_RED:
+  case IMAGE_GREEN:
+  case IMAGE_BLUE:
+    rgb += format - IMAGE_RED;
+    for (slot = 0; slot < output_width; slot++) buffer[slot] = rgb[3*slot];
+    break;
+  default:
+    yyerror ("internal: invalid image row format");
+  }
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_read_row (int row, int format, unsigned char *buffer)
+     /* Rows are counted from the bottom of the image. */
+{
+  assert (row >= 0);
+  assert (row < output_height);
+
+  if ((row < band_first) || (row >= band_first + band_rows)) render_band (row);
+
+  switch (renderer) {
+  case SOFTWARE_RENDERER:
+    convert_row (swr_row (row), format, buffer);
+    return;
+  case RAYTRACE_RENDERER:
+    convert_row (rt_row (row), format, buffer);
+    return;
+  }
+
+  assert (band);
+  convert_row (band + 3 * (row - band_first) * output_width, format, buffer);
 }
 
 
@@ -244,5 +629,244 @@ image_render (void)
 void
 image_close (void)
 {
+  if (band) {
+    free (band);
+    band = NULL;
+  }
+  if (holding) return;
+
+  switch (renderer) {
+  case SOFTWARE_RENDERER:
+    swr_close();
+    return;
+  case RAYTRACE_RENDERER:
+    rt_close();
+    return;
+  }
+
+#ifdef OPENGL_SUPPORT
   cleanup (5, NULL);
+#endif
+}
+
+
+/*------------------------------------------------------------*/
+static void
+write_plot (void)
+{
+  output_filename = plot_filename;
+  write_header();
+  write_image();
+
+  if (outfile == NULL) {		/* already closed by the format code */
+    outfile = stdout;
+  } else if (outfile != stdout) {
+    if (fclose (outfile) != 0) yyerror ("could not write the image file");
+    outfile = stdout;
+  } else {
+    fflush (outfile);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+wait_plot (void)
+{
+  int status;
+
+  if (wait (&status) <= 0) {
+    running = 0;
+    return;
+  }
+  running--;
+  if (! WIFEXITED (status) || (WEXITSTATUS (status) != 0)) failed++;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+key_frame_matrix (double matrix[4][4], int frame)
+     /*
+       The view of the frame, which is counted from 0, interpolated
+       between the two key views it falls between.
+     */
+{
+  quaternion q0, q1, q;
+  vector3 diff, centre;
+  double s, t;
+  int key, col;
+
+  /* pre */
+  assert (key_count >= 2);
+
+  s = (frame_count > 1) ?
+      (key_count - 1) * frame / (double) (frame_count - 1) : 0.0;
+  key = (int) s;
+  if (key > key_count - 2) key = key_count - 2;
+  t = s - key;
+
+  q0 = key_views[key].rotation;
+  q1 = key_views[key + 1].rotation;
+  if (v3_dot_product (&(q0.axis), &(q1.axis)) + q0.phi * q1.phi < 0.0) {
+    v3_reverse (&(q1.axis));	/* the same rotation, the shorter way */
+    q1.phi = - q1.phi;
+  }
+  quat_interpolate (&q, &q0, &q1, t);
+  quat_to_matrix3 (matrix, &q);
+
+  v3_difference (&diff, &(key_views[key + 1].centre),
+		 &(key_views[key].centre));
+  v3_sum_scaled (&centre, &(key_views[key].centre), t, &diff);
+  for (col = 0; col < 3; col++) {
+    matrix[3][col] = - (centre.x * matrix[0][col] +
+			centre.y * matrix[1][col] +
+			centre.z * matrix[2][col]);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_frame_view (int frame)
+     /*
+       Turn the scene for the frame, which is counted from 0; through
+       the viewpoints of the plot, if any.
+     */
+{
+  double matrix[4][4];
+
+  if (key_count >= 2) {
+    key_frame_matrix (matrix, frame);
+  } else {
+    matrix3_y_rotation (matrix,
+			to_radians (frame_degrees * frame / (double) frame_count));
+  }
+
+  switch (renderer) {
+  case SOFTWARE_RENDERER:
+    swr_transform (matrix);
+    return;
+  case RAYTRACE_RENDERER:
+    rt_transform (matrix);
+    return;
+  }
+#ifdef OPENGL_SUPPORT
+  ogl_set_view (matrix);
+#endif
+}
+
+
+/*------------------------------------------------------------*/
+static void
+write_frames (void)
+     /*
+       The software renderers transform their geometry in place, so
+       each frame must be rendered by a child process; OpenGL renders
+       them one after the other from the display lists.
+     */
+{
+  int frame;
+  pid_t pid;
+
+  holding = TRUE;
+
+  for (frame = 0; frame < frame_count; frame++) {
+    if (frame > 0) set_plot_filename();
+
+    if (renderer != OPENGL_RENDERER) {
+      while (running >= (int) sysconf (_SC_NPROCESSORS_ONLN)) wait_plot();
+      fflush (NULL);
+      pid = fork();
+      if (pid < 0) {
+	holding = FALSE;
+	yyerror ("could not create a process for an animation frame");
+      } else if (pid == 0) {
+	error_return = NULL;
+	holding = FALSE;
+	set_frame_view (frame);
+	write_plot();
+	_exit (0);
+      }
+      running++;
+
+    } else {
+      set_frame_view (frame);
+      write_plot();
+    }
+  }
+
+  holding = FALSE;
+  key_count = 0;
+  image_close();
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_finish_plot (void)
+{
+  pid_t pid;
+
+  renderer_finish_plot();
+
+  if (frame_count > 0) {
+    write_frames();
+    return;
+  }
+
+  if (renderer != OPENGL_RENDERER) {
+    while (running >= (int) sysconf (_SC_NPROCESSORS_ONLN)) wait_plot();
+    fflush (NULL);
+    pid = fork();
+    if (pid == 0) {		/* child: render and write, then done */
+      error_return = NULL;
+      write_plot();
+      _exit (0);
+    } else if (pid > 0) {
+      running++;
+      image_close();
+      return;
+    }
+  }
+
+  write_plot();			/* no child process */
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_finish_output (void)
+{
+  if (detached) return;
+
+  if (image_wait_plots() != 0)
+    yyerror ("the image file output failed for some plot");
+}
+
+
+/*------------------------------------------------------------*/
+void
+image_detach_plots (void)
+     /*
+       The plot processes are not waited for at the end of the output,
+       so that several outputs may be rendered at the same time.
+     */
+{
+  detached = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+int
+image_wait_plots (void)
+     /* Wait for all plot processes; return the number that failed. */
+{
+  int count;
+
+  while (running > 0) wait_plot();
+
+  count = failed;
+  failed = 0;
+  return count;
 }
@@ -4,18 +4,38 @@
 
    Image file output definitions and routines.
 
-   This implementation requires OpenGL, GLX (X windowing system) and
-   the GLUT library. It relies on the 'opengl.c' code.
+   The image is rendered by OpenGL, GLX (X windowing system) and the
+   GLUT library if OPENGL_SUPPORT is defined and an X display is
+   available, otherwise by the software renderer in 'swrender.c', or
+   ray traced by 'raytrace.c' if so requested.
 
    Copyright (C) 1997-1998 Per Kraulis
     11-Sep-1997  split out of jpeg.h
+    18-Oct-2026  software rendering fallback
+    18-Oct-2026  ray tracing
+    18-Oct-2026  multiple plots
+    18-Oct-2026  batch mode
+    18-Oct-2026  animation frames
 */
 
 #ifndef IMAGE_H
 #define IMAGE_H 1
 
+enum image_formats { IMAGE_RGB, IMAGE_LUMINANCE,
+		     IMAGE_RED, IMAGE_GREEN, IMAGE_BLUE };
+
+void image_set (void (*header) (void), void (*body) (void));
+void image_set_software (void);
+void image_set_raytrace (void);
+void image_set_frames (int number, double degrees);
+
 void image_first_plot (void);
+void image_finish_plot (void);
+void image_finish_output (void);
+void image_detach_plots (void);
+int image_wait_plots (void);
 void image_render (void);
+void image_read_row (int row, int format, unsigned char *buffer);
 void image_close (void);
 
 #endif
@@ -5,24 +5,24 @@
    JPEG image file.
 
    This implementation is based on the Independent JPEG Group's (IJG)
-   JPEG library (release 6a). It relies on the 'image.c' code, and
-   therefore implicitly on OpenGL and GLX.
+   JPEG library (release 6a). It relies on the 'image.c' code
+   for rendering.
 
    Copyright (C) 1997-1998 Per Kraulis
      9-Sep-1997  started
     11-Sep-1997  working
+    18-Oct-2026  use image_read_row; no direct OpenGL calls
+    18-Oct-2026  one image file per plot
+    18-Oct-2026  options reset for each output (batch mode)
 */
 
 #include <assert.h>
 #include <stdlib.h>
 
-#include <GL/gl.h>
-
 #include "jpeg_img.h"
 #include "global.h"
 #include "graphics.h"
 #include "image.h"
-#include "opengl.h"
 
 /* Must be defined at this position. */
 #define HAVE_BOOLEAN
@@ -39,15 +39,13 @@ static struct jpeg_error_mgr jerr;
 void
 jpgi_set (void)
 {
-  ogl_set();
-
-  output_first_plot = jpgi_first_plot;
-  output_finish_output = jpgi_finish_output;
-  output_start_plot = ogl_start_plot_general;
+  image_set (jpgi_first_plot, jpgi_finish_output);
 
   output_pickable = NULL;
 
   output_mode = JPEG_MODE;
+
+  quality = 90;
 }
 
 
@@ -55,7 +53,6 @@ jpgi_set (void)
 void
 jpgi_first_plot (void)
 {
-  image_first_plot();
   set_outfile ("wb");
 
   cinfo.err = jpeg_std_error (&jerr);
@@ -84,7 +81,7 @@ jpgi_finish_output (void)
   buffer = malloc (output_width * 3 * sizeof (unsigned char));
 
   for (row = output_height - 1; row >= 0; row--) {
-    glReadPixels (0, row, output_width, 1, GL_RGB, GL_UNSIGNED_BYTE, buffer);
+    image_read_row (row, IMAGE_RGB, buffer);
     jpeg_write_scanlines (&cinfo, &buffer, 1);
   }
 
@@ -14,6 +14,12 @@
     15-Jan-1998  added yytext stack
     23-Jan-1998  better error trace; no crash if empty input file
     24-Feb-1998  fixed bug in lex_cleanup
+    18-Oct-2026  lex_init resets an earlier input
+    18-Oct-2026  input stream files noted for watch mode
+    18-Oct-2026  surface commands and parameters
+    18-Oct-2026  detaillevels
+    18-Oct-2026  tokens noted for watch mode
+    18-Oct-2026  adaptivesegments
 */
 
 #include <assert.h>
@@ -27,6 +33,7 @@
 
 #include "lex.h"
 #include "global.h"
+#include "watch.h"
 #include "molscript.tab.h"
 
 #define YYTEXT_SIZE 2048
@@ -84,6 +91,8 @@ typedef struct {
 static size_t total_keywords;
 static keyword keywords[] =
 {
+  {"accessible-surface", ACCESSIBLE_SURFACE, TRUE},
+  {"adaptivesegments", ADAPTIVESEGMENTS, TRUE},
   {"amino-acids", AMINO_ACIDS, TRUE},
   {"anchor", ANCHOR, TRUE},
   {"and", AND, TRUE},
@@ -117,6 +126,7 @@ static keyword keywords[] =
   {"delete", DELETE, FALSE},
   {"depthcue", DEPTHCUE, TRUE},
   {"description", DESCRIPTION, TRUE},
+  {"detaillevels", DETAILLEVELS, TRUE},
   {"directionallight", DIRECTIONALLIGHT, TRUE},
   {"double-helix", DOUBLE_HELIX, TRUE},
   {"either", EITHER, TRUE},
@@ -159,6 +169,7 @@ static keyword keywords[] =
   {"linewidth", LINEWIDTH, TRUE},
   {"macro", MACRO, TRUE},
   {"model", MODEL, TRUE},
+  {"molecular-surface", MOLECULAR_SURFACE, TRUE},
   {"molecule", MOLECULE, FALSE},
   {"noframe", NOFRAME, TRUE},
   {"not", NOT, TRUE},
@@ -212,6 +223,8 @@ static keyword keywords[] =
   {"strandthickness", STRANDTHICKNESS, TRUE},
   {"strandwidth", STRANDWIDTH, TRUE},
   {"string", STRING, TRUE},
+  {"surfacegrid", SURFACEGRID, TRUE},
+  {"surfaceprobe", SURFACEPROBE, TRUE},
   {"title", TITLE, TRUE},
   {"to", TO, TRUE},
   {"trace", TRACE, TRUE},
@@ -263,6 +276,19 @@ lex_init (void)
     macro_table = NULL;
   }
 
+  if (in_source) {		/* reset after an earlier input */
+    lex_cleanup();
+    if (in_source->file && (in_source->file != stdin)) {
+      fclose (in_source->file);
+      opened_files--;
+    }
+    if (in_source->name) free (in_source->name);
+    free (in_source);
+  }
+  while (yytext_top) lex_yytext_pop();
+  defining_macro = FALSE;
+  test_numerical = TRUE;
+
   in_source = malloc (sizeof (input_source));
   in_source->file = stdin;
   in_source->name = NULL;
@@ -486,6 +512,7 @@ push_in_source (int is_macro)
       yyerror ("could not open the given input stream file");
     }
     opened_files++;
+    watch_file (yytext);
 
     if (message_mode)
       fprintf (stderr, "input stream file %s\n", yytext);
@@ -763,8 +790,8 @@ lex_yytext_str (void)
 
 
 /*------------------------------------------------------------*/
-int
-yylex (void)
+static int
+next_token (void)
 {
   int c;
 
@@ -806,3 +833,14 @@ yylex (void)
 
   return 0;
 }
+
+
+/*------------------------------------------------------------*/
+int
+yylex (void)
+{
+  int token = next_token();
+
+  watch_token (token, yytext);
+  return token;
+}
@@ -0,0 +1,351 @@
+/* mesh.c
+
+   MolScript v2.1.2
+
+   Indexed triangle mesh with vertex welding.
+
+   Vertices that coincide in position, normal and colour (to within
+   WELD_QUANTUM) are stored only once, so that triangle soup, e.g. from
+   the object command, becomes a mesh with shared vertices.
+
+   The quantum is absolute, in the units of the coordinates; a triangle
+   with two corners welded together is dropped as degenerate, so that
+   features of an object file smaller than the quantum may be lost.
+   VRML 2.0 has no triangle strip node, so the mesh is output as an
+   IndexedFaceSet of separate triangles.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  objects added to a mesh, and a mesh output as an object
+    18-Oct-2026  noted the weld quantum and the lack of strips
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "mesh.h"
+#include "graphics.h"
+
+
+/*============================================================*/
+#define WELD_QUANTUM 0.001
+
+
+/*------------------------------------------------------------*/
+static long
+quantise (double value)
+{
+  return (long) floor (value / WELD_QUANTUM + 0.5);
+}
+
+
+/*------------------------------------------------------------*/
+static unsigned int
+weld_key (vector3 *v, unsigned int key)
+{
+  assert (v);
+
+  key = key * 73856093U ^ (unsigned int) quantise (v->x);
+  key = key * 19349663U ^ (unsigned int) quantise (v->y);
+  key = key * 83492791U ^ (unsigned int) quantise (v->z);
+  return key;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+weld_equal (vector3 *v1, vector3 *v2)
+{
+  assert (v1);
+  assert (v2);
+
+  return ((quantise (v1->x) == quantise (v2->x)) &&
+	  (quantise (v1->y) == quantise (v2->y)) &&
+	  (quantise (v1->z) == quantise (v2->z)));
+}
+
+
+/*------------------------------------------------------------*/
+static unsigned int
+vertex_key (mesh *m, int slot)
+{
+  unsigned int key;
+
+  assert (m);
+  assert (slot >= 0);
+  assert (slot < m->count);
+
+  key = weld_key (m->points + slot, 0U);
+  if (m->normals) key = weld_key (m->normals + slot, key);
+  if (m->colours) key = weld_key (m->colours + slot, key);
+  return key;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+hash_insert (mesh *m, int slot)
+{
+  unsigned int pos;
+
+  assert (m);
+
+  pos = vertex_key (m, slot) % (unsigned int) m->hash_size;
+  while (m->hash[pos] >= 0) {
+    if (++pos >= (unsigned int) m->hash_size) pos = 0;
+  }
+  m->hash[pos] = slot;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+hash_resize (mesh *m, int size)
+{
+  int slot;
+
+  assert (m);
+  assert (size > m->count);
+
+  if (m->hash) free (m->hash);
+  m->hash_size = size;
+  m->hash = malloc (size * sizeof (int));
+  for (slot = 0; slot < size; slot++) m->hash[slot] = -1;
+
+  for (slot = 0; slot < m->count; slot++) hash_insert (m, slot);
+}
+
+
+/*------------------------------------------------------------*/
+mesh *
+mesh_create (boolean normals, boolean colours)
+{
+  mesh *new;
+
+  new = malloc (sizeof (mesh));
+  new->count = 0;
+  new->alloc = 1024;
+  new->points = malloc (new->alloc * sizeof (vector3));
+  new->normals = normals ? malloc (new->alloc * sizeof (vector3)) : NULL;
+  new->colours = colours ? malloc (new->alloc * sizeof (vector3)) : NULL;
+
+  new->triangle_count = 0;
+  new->triangle_alloc = 1024;
+  new->triangles = malloc (3 * new->triangle_alloc * sizeof (int));
+
+  new->hash = NULL;
+  hash_resize (new, 2048);
+
+  return new;
+}
+
+
+/*------------------------------------------------------------*/
+void
+mesh_delete (mesh *m)
+{
+  assert (m);
+
+  free (m->points);
+  if (m->normals) free (m->normals);
+  if (m->colours) free (m->colours);
+  free (m->triangles);
+  free (m->hash);
+  free (m);
+}
+
+
+/*------------------------------------------------------------*/
+int
+mesh_vertex (mesh *m, vector3 *p, vector3 *n, vector3 *c)
+{
+  unsigned int key, pos;
+  int slot;
+
+  assert (m);
+  assert (p);
+  assert ((m->normals == NULL) || n);
+  assert ((m->colours == NULL) || c);
+
+  key = weld_key (p, 0U);
+  if (m->normals) key = weld_key (n, key);
+  if (m->colours) key = weld_key (c, key);
+
+  for (pos = key % (unsigned int) m->hash_size;
+       m->hash[pos] >= 0;
+       pos = (pos + 1) % (unsigned int) m->hash_size) {
+    slot = m->hash[pos];
+    if (weld_equal (m->points + slot, p) &&
+	((m->normals == NULL) || weld_equal (m->normals + slot, n)) &&
+	((m->colours == NULL) || weld_equal (m->colours + slot, c)))
+      return slot;
+  }
+
+  if (m->count >= m->alloc) {
+    m->alloc *= 2;
+    m->points = realloc (m->points, m->alloc * sizeof (vector3));
+    if (m->normals)
+      m->normals = realloc (m->normals, m->alloc * sizeof (vector3));
+    if (m->colours)
+      m->colours = realloc (m->colours, m->alloc * sizeof (vector3));
+  }
+
+  slot = m->count++;
+  m->points[slot] = *p;
+  if (m->normals) m->normals[slot] = *n;
+  if (m->colours) m->colours[slot] = *c;
+  m->hash[pos] = slot;
+				/* keep load factor below 1/2 */
+  if (2 * m->count > m->hash_size) hash_resize (m, 2 * m->hash_size);
+
+  return slot;
+}
+
+
+/*------------------------------------------------------------*/
+boolean
+mesh_triangle (mesh *m, int i1, int i2, int i3)
+{
+  int *tri;
+
+  assert (m);
+  assert ((i1 >= 0) && (i1 < m->count));
+  assert ((i2 >= 0) && (i2 < m->count));
+  assert ((i3 >= 0) && (i3 < m->count));
+
+  if ((i1 == i2) || (i2 == i3) || (i3 == i1)) return FALSE; /* degenerate */
+
+  if (m->triangle_count >= m->triangle_alloc) {
+    m->triangle_alloc *= 2;
+    m->triangles = realloc (m->triangles,
+			    3 * m->triangle_alloc * sizeof (int));
+  }
+
+  tri = m->triangles + 3 * m->triangle_count++;
+  tri[0] = i1;
+  tri[1] = i2;
+  tri[2] = i3;
+
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+object_layout (int code, int *number, boolean *normals, boolean *colours)
+     /* The triplets per vertex, and the attributes, of a triangle code. */
+{
+  switch (code) {
+  case OBJ_TRIANGLES:
+    *number = 1;
+    *normals = FALSE;
+    *colours = FALSE;
+    return TRUE;
+  case OBJ_TRIANGLES_COLOURS:
+    *number = 2;
+    *normals = FALSE;
+    *colours = TRUE;
+    return TRUE;
+  case OBJ_TRIANGLES_NORMALS:
+    *number = 2;
+    *normals = TRUE;
+    *colours = FALSE;
+    return TRUE;
+  case OBJ_TRIANGLES_NORMALS_COLOURS:
+    *number = 3;
+    *normals = TRUE;
+    *colours = TRUE;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*------------------------------------------------------------*/
+void
+mesh_add_object (mesh *m, int code, vector3 *triplets, int count)
+{
+  int slot, number, i1, i2, i3;
+  vector3 *v;
+  boolean normals, colours;
+
+  assert (m);
+  assert (triplets);
+  assert (count > 0);
+
+  if (! object_layout (code, &number, &normals, &colours)) return;
+  assert (normals == (m->normals != NULL));
+  assert (colours == (m->colours != NULL));
+
+				/* normal follows vertex, colour is last */
+  for (slot = 0; slot + 3 * number <= count; slot += 3 * number) {
+    v = triplets + slot;
+    i1 = mesh_vertex (m, v, normals ? v + 1 : NULL,
+		      colours ? v + number - 1 : NULL);
+    v += number;
+    i2 = mesh_vertex (m, v, normals ? v + 1 : NULL,
+		      colours ? v + number - 1 : NULL);
+    v += number;
+    i3 = mesh_vertex (m, v, normals ? v + 1 : NULL,
+		      colours ? v + number - 1 : NULL);
+    mesh_triangle (m, i1, i2, i3);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+mesh *
+mesh_from_object (int code, vector3 *triplets, int count)
+{
+  mesh *m;
+  int number;
+  boolean normals, colours;
+
+  assert (triplets);
+  assert (count > 0);
+
+  if (! object_layout (code, &number, &normals, &colours)) return NULL;
+
+  m = mesh_create (normals, colours);
+  mesh_add_object (m, code, triplets, count);
+
+  return m;
+}
+
+
+/*------------------------------------------------------------*/
+vector3 *
+mesh_to_object (mesh *m, int code, int *count)
+     /*
+       The triangles of the mesh as triplets in the layout of the
+       object code. The array is allocated; the number of triplets is
+       returned in 'count'.
+     */
+{
+  vector3 *triplets, *v;
+  int slot, corner, vertex, number;
+  boolean normals, colours;
+
+  assert (m);
+  assert (count);
+
+  if (! object_layout (code, &number, &normals, &colours)) return NULL;
+  assert (! normals || m->normals);
+  assert (! colours || m->colours);
+
+  *count = 3 * number * m->triangle_count;
+  if (*count == 0) return NULL;
+  v = triplets = malloc (*count * sizeof (vector3));
+
+  for (slot = 0; slot < m->triangle_count; slot++) {
+    for (corner = 0; corner < 3; corner++) {
+      vertex = m->triangles[3 * slot + corner];
+      *v++ = m->points[vertex];
+      if (normals) *v++ = m->normals[vertex];
+      if (colours) *v++ = m->colours[vertex];
+    }
+  }
+
+  return triplets;
+}
@@ -0,0 +1,40 @@
+/* mesh.h
+
+   MolScript v2.1.2
+
+   Indexed triangle mesh with vertex welding.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#ifndef MESH_H
+#define MESH_H 1
+
+#include "clib/boolean.h"
+#include "clib/vector3.h"
+
+typedef struct {
+  vector3 *points;
+  vector3 *normals;		/* NULL if no vertex normals */
+  vector3 *colours;		/* NULL if no vertex colours */
+  int count;
+  int alloc;
+  int *triangles;		/* three vertex indices per triangle */
+  int triangle_count;
+  int triangle_alloc;
+  int *hash;			/* vertex index, or -1 if empty */
+  int hash_size;
+} mesh;
+
+mesh *mesh_create (boolean normals, boolean colours);
+void mesh_delete (mesh *m);
+
+int mesh_vertex (mesh *m, vector3 *p, vector3 *n, vector3 *c);
+boolean mesh_triangle (mesh *m, int i1, int i2, int i3);
+
+void mesh_add_object (mesh *m, int code, vector3 *triplets, int count);
+mesh *mesh_from_object (int code, vector3 *triplets, int count);
+vector3 *mesh_to_object (mesh *m, int code, int *count);
+
+#endif
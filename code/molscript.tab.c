@@ -1,155 +1,72 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/*  A Bison parser, made from molscript.y with Bison version GNU Bison version 1.24
-  */
-
-#define YYBISON 1  /* Identify Bison output.  */
-
-#define	INTEGER	258
-#define	REAL	259
-#define	STRING	260
-#define	ITEM	261
-#define	ON	262
-#define	OFF	263
-#define	POSITION	264
-#define	TITLE	265
-#define	MACRO	266
-#define	PLOT	267
-#define	END_PLOT	268
-#define	COMMENT	269
-#define	DEBUG	270
-#define	POSTSCRIPT	271
-#define	RASTER3D	272
-#define	VRML	273
-#define	NOFRAME	274
-#define	FRAME	275
-#define	AREA	276
-#define	BACKGROUND	277
-#define	WINDOW	278
-#define	SLAB	279
-#define	HEADLIGHT	280
-#define	SHADOWS	281
-#define	FOG	282
-#define	READ	283
-#define	INLINE_PDB	284
-#define	DELETE	285
-#define	COPY	286
-#define	ANCHOR	287
-#define	DESCRIPTION	288
-#define	PARAMETER	289
-#define	VIEWPOINT	290
-#define	ORIGIN	291
-#define	DIRECTIONALLIGHT	292
-#define	POINTLIGHT	293
-#define	SPOTLIGHT	294
-#define	LEVEL_OF_DETAIL	295
-#define	TRANSFORM	296
-#define	BY	297
-#define	CENTRE	298
-#define	TRANSLATION	299
-#define	ROTATION	300
-#define	XAXIS	301
-#define	YAXIS	302
-#define	ZAXIS	303
-#define	AXIS	304
-#define	STORE_MATRIX	305
-#define	RECALL_MATRIX	306
-#define	NOT	307
-#define	REQUIRE	308
-#define	AND	309
-#define	EITHER	310
-#define	OR	311
-#define	BACKBONE	312
-#define	PEPTIDE	313
-#define	HYDROGENS	314
-#define	ATOM	315
-#define	RES_ATOM	316
-#define	B_FACTOR	317
-#define	OCCUPANCY	318
-#define	IN	319
-#define	SPHERE	320
-#define	CLOSE	321
-#define	MODEL	322
-#define	AMINO_ACIDS	323
-#define	WATERS	324
-#define	NUCLEOTIDES	325
-#define	LIGANDS	326
-#define	MOLECULE	327
-#define	FROM	328
-#define	TO	329
-#define	RESIDUE	330
-#define	TYPE	331
-#define	CONTAINS	332
-#define	CHAIN	333
-#define	ELEMENT	334
-#define	SEGID	335
-#define	SET	336
-#define	PUSH	337
-#define	POP	338
-#define	ATOMCOLOUR	339
-#define	ATOMRADIUS	340
-#define	BONDDISTANCE	341
-#define	BONDCROSS	342
-#define	COILRADIUS	343
-#define	COLOURPARTS	344
-#define	COLOURRAMP	345
-#define	CYLINDERRADIUS	346
-#define	DEPTHCUE	347
-#define	EMISSIVECOLOUR	348
-#define	HELIXTHICKNESS	349
-#define	HELIXWIDTH	350
-#define	HSBRAMPREVERSE	351
-#define	LABELBACKGROUND	352
-#define	LABELCENTRE	353
-#define	LABELCLIP	354
-#define	LABELMASK	355
-#define	LABELOFFSET	356
-#define	LABELROTATION	357
-#define	LABELSIZE	358
-#define	LIGHTAMBIENTINTENSITY	359
-#define	LIGHTATTENUATION	360
-#define	LIGHTCOLOUR	361
-#define	LIGHTINTENSITY	362
-#define	LIGHTRADIUS	363
-#define	LINECOLOUR	364
-#define	LINEDASH	365
-#define	LINEWIDTH	366
-#define	OBJECTTRANSFORM	367
-#define	PLANECOLOUR	368
-#define	PLANE2COLOUR	369
-#define	REGULAREXPRESSION	370
-#define	RESIDUECOLOUR	371
-#define	SEGMENTS	372
-#define	SEGMENTSIZE	373
-#define	SHADING	374
-#define	SHADINGEXPONENT	375
-#define	SHININESS	376
-#define	SMOOTHSTEPS	377
-#define	SPECULARCOLOUR	378
-#define	SPLINEFACTOR	379
-#define	STICKRADIUS	380
-#define	STICKTAPER	381
-#define	STRANDTHICKNESS	382
-#define	STRANDWIDTH	383
-#define	TRANSPARENCY	384
-#define	BALL_AND_STICK	385
-#define	BONDS	386
-#define	COIL	387
-#define	CYLINDER	388
-#define	CPK	389
-#define	HELIX	390
-#define	LABEL	391
-#define	LINE	392
-#define	OBJECT	393
-#define	INLINE	394
-#define	STRAND	395
-#define	TRACE	396
-#define	TURN	397
-#define	DOUBLE_HELIX	398
-#define	RGB	399
-#define	HSB	400
-#define	GREY	401
-#define	RAINBOW	402
+/* Bison implementation for Yacc-like parsers in C
 
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
 #line 1 "molscript.y"
 
 /* MolScript v2.1.2
@@ -164,6 +81,15 @@
     15-Sep-1997  basically finished
     24-Feb-1998  problem with token X under Linux: changed to XAXIS
     23-Jul-1998  rearranged syntax for anchor command
+    18-Oct-2026  batch mode; yyerror returns to the batch job loop
+    18-Oct-2026  render server
+    18-Oct-2026  watch mode
+    18-Oct-2026  trajectory frames
+    18-Oct-2026  molecular and accessible surfaces; actions end with ';'
+                 as required by current bison
+    18-Oct-2026  detaillevels
+    18-Oct-2026  yyerror waits for the image plot processes before exit
+    18-Oct-2026  adaptivesegments
 */
 
 #include "global.h"
@@ -177,2035 +103,2997 @@
 #include "postscript.h"
 #include "raster3d.h"
 #include "vrml.h"
+#include "server.h"
+#include "watch.h"
+#include "trajectory.h"
+#include "surface.h"
 
-/* To avoid warning with 'cc -ansi -fullwarn' on SGI IRIX; ugly! */
-static void
-__yy_bcopy (char *from, char *to, int count);
+#ifdef IMAGE_SUPPORT
+#include "image.h"
+#endif
 
-static void
-__yy_memcpy (char *from, char *to, int count);
 
 
+#line 118 "molscript.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "molscript.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_INTEGER = 3,                    /* INTEGER  */
+  YYSYMBOL_REAL = 4,                       /* REAL  */
+  YYSYMBOL_STRING = 5,                     /* STRING  */
+  YYSYMBOL_ITEM = 6,                       /* ITEM  */
+  YYSYMBOL_ON = 7,                         /* ON  */
+  YYSYMBOL_OFF = 8,                        /* OFF  */
+  YYSYMBOL_POSITION = 9,                   /* POSITION  */
+  YYSYMBOL_TITLE = 10,                     /* TITLE  */
+  YYSYMBOL_MACRO = 11,                     /* MACRO  */
+  YYSYMBOL_PLOT = 12,                      /* PLOT  */
+  YYSYMBOL_END_PLOT = 13,                  /* END_PLOT  */
+  YYSYMBOL_COMMENT = 14,                   /* COMMENT  */
+  YYSYMBOL_DEBUG = 15,                     /* DEBUG  */
+  YYSYMBOL_POSTSCRIPT = 16,                /* POSTSCRIPT  */
+  YYSYMBOL_RASTER3D = 17,                  /* RASTER3D  */
+  YYSYMBOL_VRML = 18,                      /* VRML  */
+  YYSYMBOL_NOFRAME = 19,                   /* NOFRAME  */
+  YYSYMBOL_FRAME = 20,                     /* FRAME  */
+  YYSYMBOL_AREA = 21,                      /* AREA  */
+  YYSYMBOL_BACKGROUND = 22,                /* BACKGROUND  */
+  YYSYMBOL_WINDOW = 23,                    /* WINDOW  */
+  YYSYMBOL_SLAB = 24,                      /* SLAB  */
+  YYSYMBOL_HEADLIGHT = 25,                 /* HEADLIGHT  */
+  YYSYMBOL_SHADOWS = 26,                   /* SHADOWS  */
+  YYSYMBOL_FOG = 27,                       /* FOG  */
+  YYSYMBOL_READ = 28,                      /* READ  */
+  YYSYMBOL_INLINE_PDB = 29,                /* INLINE_PDB  */
+  YYSYMBOL_DELETE = 30,                    /* DELETE  */
+  YYSYMBOL_COPY = 31,                      /* COPY  */
+  YYSYMBOL_ANCHOR = 32,                    /* ANCHOR  */
+  YYSYMBOL_DESCRIPTION = 33,               /* DESCRIPTION  */
+  YYSYMBOL_PARAMETER = 34,                 /* PARAMETER  */
+  YYSYMBOL_VIEWPOINT = 35,                 /* VIEWPOINT  */
+  YYSYMBOL_ORIGIN = 36,                    /* ORIGIN  */
+  YYSYMBOL_DIRECTIONALLIGHT = 37,          /* DIRECTIONALLIGHT  */
+  YYSYMBOL_POINTLIGHT = 38,                /* POINTLIGHT  */
+  YYSYMBOL_SPOTLIGHT = 39,                 /* SPOTLIGHT  */
+  YYSYMBOL_LEVEL_OF_DETAIL = 40,           /* LEVEL_OF_DETAIL  */
+  YYSYMBOL_TRANSFORM = 41,                 /* TRANSFORM  */
+  YYSYMBOL_BY = 42,                        /* BY  */
+  YYSYMBOL_CENTRE = 43,                    /* CENTRE  */
+  YYSYMBOL_TRANSLATION = 44,               /* TRANSLATION  */
+  YYSYMBOL_ROTATION = 45,                  /* ROTATION  */
+  YYSYMBOL_XAXIS = 46,                     /* XAXIS  */
+  YYSYMBOL_YAXIS = 47,                     /* YAXIS  */
+  YYSYMBOL_ZAXIS = 48,                     /* ZAXIS  */
+  YYSYMBOL_AXIS = 49,                      /* AXIS  */
+  YYSYMBOL_STORE_MATRIX = 50,              /* STORE_MATRIX  */
+  YYSYMBOL_RECALL_MATRIX = 51,             /* RECALL_MATRIX  */
+  YYSYMBOL_NOT = 52,                       /* NOT  */
+  YYSYMBOL_REQUIRE = 53,                   /* REQUIRE  */
+  YYSYMBOL_AND = 54,                       /* AND  */
+  YYSYMBOL_EITHER = 55,                    /* EITHER  */
+  YYSYMBOL_OR = 56,                        /* OR  */
+  YYSYMBOL_BACKBONE = 57,                  /* BACKBONE  */
+  YYSYMBOL_PEPTIDE = 58,                   /* PEPTIDE  */
+  YYSYMBOL_HYDROGENS = 59,                 /* HYDROGENS  */
+  YYSYMBOL_ATOM = 60,                      /* ATOM  */
+  YYSYMBOL_RES_ATOM = 61,                  /* RES_ATOM  */
+  YYSYMBOL_B_FACTOR = 62,                  /* B_FACTOR  */
+  YYSYMBOL_OCCUPANCY = 63,                 /* OCCUPANCY  */
+  YYSYMBOL_IN = 64,                        /* IN  */
+  YYSYMBOL_SPHERE = 65,                    /* SPHERE  */
+  YYSYMBOL_CLOSE = 66,                     /* CLOSE  */
+  YYSYMBOL_MODEL = 67,                     /* MODEL  */
+  YYSYMBOL_AMINO_ACIDS = 68,               /* AMINO_ACIDS  */
+  YYSYMBOL_WATERS = 69,                    /* WATERS  */
+  YYSYMBOL_NUCLEOTIDES = 70,               /* NUCLEOTIDES  */
+  YYSYMBOL_LIGANDS = 71,                   /* LIGANDS  */
+  YYSYMBOL_MOLECULE = 72,                  /* MOLECULE  */
+  YYSYMBOL_FROM = 73,                      /* FROM  */
+  YYSYMBOL_TO = 74,                        /* TO  */
+  YYSYMBOL_RESIDUE = 75,                   /* RESIDUE  */
+  YYSYMBOL_TYPE = 76,                      /* TYPE  */
+  YYSYMBOL_CONTAINS = 77,                  /* CONTAINS  */
+  YYSYMBOL_CHAIN = 78,                     /* CHAIN  */
+  YYSYMBOL_ELEMENT = 79,                   /* ELEMENT  */
+  YYSYMBOL_SEGID = 80,                     /* SEGID  */
+  YYSYMBOL_SET = 81,                       /* SET  */
+  YYSYMBOL_PUSH = 82,                      /* PUSH  */
+  YYSYMBOL_POP = 83,                       /* POP  */
+  YYSYMBOL_ATOMCOLOUR = 84,                /* ATOMCOLOUR  */
+  YYSYMBOL_ATOMRADIUS = 85,                /* ATOMRADIUS  */
+  YYSYMBOL_BONDDISTANCE = 86,              /* BONDDISTANCE  */
+  YYSYMBOL_BONDCROSS = 87,                 /* BONDCROSS  */
+  YYSYMBOL_COILRADIUS = 88,                /* COILRADIUS  */
+  YYSYMBOL_COLOURPARTS = 89,               /* COLOURPARTS  */
+  YYSYMBOL_COLOURRAMP = 90,                /* COLOURRAMP  */
+  YYSYMBOL_CYLINDERRADIUS = 91,            /* CYLINDERRADIUS  */
+  YYSYMBOL_DEPTHCUE = 92,                  /* DEPTHCUE  */
+  YYSYMBOL_EMISSIVECOLOUR = 93,            /* EMISSIVECOLOUR  */
+  YYSYMBOL_HELIXTHICKNESS = 94,            /* HELIXTHICKNESS  */
+  YYSYMBOL_HELIXWIDTH = 95,                /* HELIXWIDTH  */
+  YYSYMBOL_HSBRAMPREVERSE = 96,            /* HSBRAMPREVERSE  */
+  YYSYMBOL_LABELBACKGROUND = 97,           /* LABELBACKGROUND  */
+  YYSYMBOL_LABELCENTRE = 98,               /* LABELCENTRE  */
+  YYSYMBOL_LABELCLIP = 99,                 /* LABELCLIP  */
+  YYSYMBOL_LABELMASK = 100,                /* LABELMASK  */
+  YYSYMBOL_LABELOFFSET = 101,              /* LABELOFFSET  */
+  YYSYMBOL_LABELROTATION = 102,            /* LABELROTATION  */
+  YYSYMBOL_LABELSIZE = 103,                /* LABELSIZE  */
+  YYSYMBOL_LIGHTAMBIENTINTENSITY = 104,    /* LIGHTAMBIENTINTENSITY  */
+  YYSYMBOL_LIGHTATTENUATION = 105,         /* LIGHTATTENUATION  */
+  YYSYMBOL_LIGHTCOLOUR = 106,              /* LIGHTCOLOUR  */
+  YYSYMBOL_LIGHTINTENSITY = 107,           /* LIGHTINTENSITY  */
+  YYSYMBOL_LIGHTRADIUS = 108,              /* LIGHTRADIUS  */
+  YYSYMBOL_LINECOLOUR = 109,               /* LINECOLOUR  */
+  YYSYMBOL_LINEDASH = 110,                 /* LINEDASH  */
+  YYSYMBOL_LINEWIDTH = 111,                /* LINEWIDTH  */
+  YYSYMBOL_OBJECTTRANSFORM = 112,          /* OBJECTTRANSFORM  */
+  YYSYMBOL_PLANECOLOUR = 113,              /* PLANECOLOUR  */
+  YYSYMBOL_PLANE2COLOUR = 114,             /* PLANE2COLOUR  */
+  YYSYMBOL_REGULAREXPRESSION = 115,        /* REGULAREXPRESSION  */
+  YYSYMBOL_RESIDUECOLOUR = 116,            /* RESIDUECOLOUR  */
+  YYSYMBOL_SEGMENTS = 117,                 /* SEGMENTS  */
+  YYSYMBOL_SEGMENTSIZE = 118,              /* SEGMENTSIZE  */
+  YYSYMBOL_SHADING = 119,                  /* SHADING  */
+  YYSYMBOL_SHADINGEXPONENT = 120,          /* SHADINGEXPONENT  */
+  YYSYMBOL_SHININESS = 121,                /* SHININESS  */
+  YYSYMBOL_SMOOTHSTEPS = 122,              /* SMOOTHSTEPS  */
+  YYSYMBOL_SPECULARCOLOUR = 123,           /* SPECULARCOLOUR  */
+  YYSYMBOL_SPLINEFACTOR = 124,             /* SPLINEFACTOR  */
+  YYSYMBOL_STICKRADIUS = 125,              /* STICKRADIUS  */
+  YYSYMBOL_STICKTAPER = 126,               /* STICKTAPER  */
+  YYSYMBOL_STRANDTHICKNESS = 127,          /* STRANDTHICKNESS  */
+  YYSYMBOL_STRANDWIDTH = 128,              /* STRANDWIDTH  */
+  YYSYMBOL_TRANSPARENCY = 129,             /* TRANSPARENCY  */
+  YYSYMBOL_BALL_AND_STICK = 130,           /* BALL_AND_STICK  */
+  YYSYMBOL_BONDS = 131,                    /* BONDS  */
+  YYSYMBOL_COIL = 132,                     /* COIL  */
+  YYSYMBOL_CYLINDER = 133,                 /* CYLINDER  */
+  YYSYMBOL_CPK = 134,                      /* CPK  */
+  YYSYMBOL_HELIX = 135,                    /* HELIX  */
+  YYSYMBOL_LABEL = 136,                    /* LABEL  */
+  YYSYMBOL_LINE = 137,                     /* LINE  */
+  YYSYMBOL_OBJECT = 138,                   /* OBJECT  */
+  YYSYMBOL_INLINE = 139,                   /* INLINE  */
+  YYSYMBOL_STRAND = 140,                   /* STRAND  */
+  YYSYMBOL_TRACE = 141,                    /* TRACE  */
+  YYSYMBOL_TURN = 142,                     /* TURN  */
+  YYSYMBOL_DOUBLE_HELIX = 143,             /* DOUBLE_HELIX  */
+  YYSYMBOL_RGB = 144,                      /* RGB  */
+  YYSYMBOL_HSB = 145,                      /* HSB  */
+  YYSYMBOL_GREY = 146,                     /* GREY  */
+  YYSYMBOL_RAINBOW = 147,                  /* RAINBOW  */
+  YYSYMBOL_ACCESSIBLE_SURFACE = 148,       /* ACCESSIBLE_SURFACE  */
+  YYSYMBOL_MOLECULAR_SURFACE = 149,        /* MOLECULAR_SURFACE  */
+  YYSYMBOL_SURFACEGRID = 150,              /* SURFACEGRID  */
+  YYSYMBOL_SURFACEPROBE = 151,             /* SURFACEPROBE  */
+  YYSYMBOL_DETAILLEVELS = 152,             /* DETAILLEVELS  */
+  YYSYMBOL_ADAPTIVESEGMENTS = 153,         /* ADAPTIVESEGMENTS  */
+  YYSYMBOL_154_ = 154,                     /* ';'  */
+  YYSYMBOL_155_ = 155,                     /* ','  */
+  YYSYMBOL_156_ = 156,                     /* '{'  */
+  YYSYMBOL_157_ = 157,                     /* '}'  */
+  YYSYMBOL_YYACCEPT = 158,                 /* $accept  */
+  YYSYMBOL_file_contents = 159,            /* file_contents  */
+  YYSYMBOL_title = 160,                    /* title  */
+  YYSYMBOL_plots = 161,                    /* plots  */
+  YYSYMBOL_plot = 162,                     /* plot  */
+  YYSYMBOL_163_1 = 163,                    /* $@1  */
+  YYSYMBOL_plot_contents = 164,            /* plot_contents  */
+  YYSYMBOL_macro_defs = 165,               /* macro_defs  */
+  YYSYMBOL_macro_def = 166,                /* macro_def  */
+  YYSYMBOL_header_commands = 167,          /* header_commands  */
+  YYSYMBOL_header_command = 168,           /* header_command  */
+  YYSYMBOL_body_commands = 169,            /* body_commands  */
+  YYSYMBOL_body_command = 170,             /* body_command  */
+  YYSYMBOL_coord_command = 171,            /* coord_command  */
+  YYSYMBOL_172_2 = 172,                    /* $@2  */
+  YYSYMBOL_173_3 = 173,                    /* $@3  */
+  YYSYMBOL_174_4 = 174,                    /* $@4  */
+  YYSYMBOL_175_5 = 175,                    /* $@5  */
+  YYSYMBOL_coordinates = 176,              /* coordinates  */
+  YYSYMBOL_177_6 = 177,                    /* $@6  */
+  YYSYMBOL_xforms = 178,                   /* xforms  */
+  YYSYMBOL_xform = 179,                    /* xform  */
+  YYSYMBOL_geom_command = 180,             /* geom_command  */
+  YYSYMBOL_181_7 = 181,                    /* $@7  */
+  YYSYMBOL_182_8 = 182,                    /* $@8  */
+  YYSYMBOL_183_9 = 183,                    /* $@9  */
+  YYSYMBOL_lines = 184,                    /* lines  */
+  YYSYMBOL_185_10 = 185,                   /* $@10  */
+  YYSYMBOL_object = 186,                   /* object  */
+  YYSYMBOL_187_11 = 187,                   /* $@11  */
+  YYSYMBOL_state_command = 188,            /* state_command  */
+  YYSYMBOL_189_12 = 189,                   /* $@12  */
+  YYSYMBOL_190_13 = 190,                   /* $@13  */
+  YYSYMBOL_191_14 = 191,                   /* $@14  */
+  YYSYMBOL_state_changes = 192,            /* state_changes  */
+  YYSYMBOL_state_change = 193,             /* state_change  */
+  YYSYMBOL_utility_command = 194,          /* utility_command  */
+  YYSYMBOL_195_15 = 195,                   /* $@15  */
+  YYSYMBOL_196_16 = 196,                   /* $@16  */
+  YYSYMBOL_ctrl_command = 197,             /* ctrl_command  */
+  YYSYMBOL_198_17 = 198,                   /* $@17  */
+  YYSYMBOL_199_18 = 199,                   /* $@18  */
+  YYSYMBOL_200_19 = 200,                   /* $@19  */
+  YYSYMBOL_201_20 = 201,                   /* $@20  */
+  YYSYMBOL_202_21 = 202,                   /* $@21  */
+  YYSYMBOL_203_22 = 203,                   /* $@22  */
+  YYSYMBOL_anchor_description = 204,       /* anchor_description  */
+  YYSYMBOL_anchor_parameters = 205,        /* anchor_parameters  */
+  YYSYMBOL_anchor_parameter = 206,         /* anchor_parameter  */
+  YYSYMBOL_basic_commands = 207,           /* basic_commands  */
+  YYSYMBOL_basic_command = 208,            /* basic_command  */
+  YYSYMBOL_lod_blocks = 209,               /* lod_blocks  */
+  YYSYMBOL_lod_block = 210,                /* lod_block  */
+  YYSYMBOL_211_23 = 211,                   /* $@23  */
+  YYSYMBOL_lod_group = 212,                /* lod_group  */
+  YYSYMBOL_view_definition = 213,          /* view_definition  */
+  YYSYMBOL_atom_selection = 214,           /* atom_selection  */
+  YYSYMBOL_atom_and = 215,                 /* atom_and  */
+  YYSYMBOL_216_24 = 216,                   /* $@24  */
+  YYSYMBOL_atom_or = 217,                  /* atom_or  */
+  YYSYMBOL_218_25 = 218,                   /* $@25  */
+  YYSYMBOL_atom_specification = 219,       /* atom_specification  */
+  YYSYMBOL_220_26 = 220,                   /* $@26  */
+  YYSYMBOL_residue_selection = 221,        /* residue_selection  */
+  YYSYMBOL_residue_and = 222,              /* residue_and  */
+  YYSYMBOL_223_27 = 223,                   /* $@27  */
+  YYSYMBOL_residue_or = 224,               /* residue_or  */
+  YYSYMBOL_225_28 = 225,                   /* $@28  */
+  YYSYMBOL_residue_specification = 226,    /* residue_specification  */
+  YYSYMBOL_227_29 = 227,                   /* $@29  */
+  YYSYMBOL_vector = 228,                   /* vector  */
+  YYSYMBOL_direction = 229,                /* direction  */
+  YYSYMBOL_colour = 230,                   /* colour  */
+  YYSYMBOL_ramp = 231,                     /* ramp  */
+  YYSYMBOL_232_30 = 232,                   /* $@30  */
+  YYSYMBOL_number_as_id = 233,             /* number_as_id  */
+  YYSYMBOL_number = 234,                   /* number  */
+  YYSYMBOL_id = 235                        /* id  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-#ifndef YYLTYPE
-typedef
-  struct yyltype
-    {
-      int timestamp;
-      int first_line;
-      int first_column;
-      int last_line;
-      int last_column;
-      char *text;
-   }
-  yyltype;
-
-#define YYLTYPE yyltype
+
+
+
+#ifdef short
+# undef short
 #endif
 
-#ifndef YYSTYPE
-#define YYSTYPE int
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
-#include <stdio.h>
 
-#ifndef __cplusplus
-#ifndef __STDC__
-#define const
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
 #endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
 
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
 
-#define	YYFINAL		497
-#define	YYFLAG		-32768
-#define	YYNTBASE	152
-
-#define YYTRANSLATE(x) ((unsigned)(x) <= 402 ? yytranslate[x] : 229)
-
-static const short yytranslate[] = {     0,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,   149,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,   148,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,   150,     2,   151,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     1,     2,     3,     4,     5,
-     6,     7,     8,     9,    10,    11,    12,    13,    14,    15,
-    16,    17,    18,    19,    20,    21,    22,    23,    24,    25,
-    26,    27,    28,    29,    30,    31,    32,    33,    34,    35,
-    36,    37,    38,    39,    40,    41,    42,    43,    44,    45,
-    46,    47,    48,    49,    50,    51,    52,    53,    54,    55,
-    56,    57,    58,    59,    60,    61,    62,    63,    64,    65,
-    66,    67,    68,    69,    70,    71,    72,    73,    74,    75,
-    76,    77,    78,    79,    80,    81,    82,    83,    84,    85,
-    86,    87,    88,    89,    90,    91,    92,    93,    94,    95,
-    96,    97,    98,    99,   100,   101,   102,   103,   104,   105,
-   106,   107,   108,   109,   110,   111,   112,   113,   114,   115,
-   116,   117,   118,   119,   120,   121,   122,   123,   124,   125,
-   126,   127,   128,   129,   130,   131,   132,   133,   134,   135,
-   136,   137,   138,   139,   140,   141,   142,   143,   144,   145,
-   146,   147
-};
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
 
-#if YYDEBUG != 0
-static const short yyprhs[] = {     0,
-     0,     3,     6,     7,     9,    12,    13,    19,    22,    24,
-    27,    28,    31,    33,    36,    38,    42,    46,    53,    57,
-    61,    65,    69,    73,    77,    81,    85,    87,    90,    92,
-    94,    96,    98,   100,   101,   106,   107,   112,   113,   119,
-   120,   126,   129,   130,   134,   137,   140,   144,   147,   150,
-   154,   158,   162,   169,   180,   182,   186,   191,   195,   200,
-   204,   208,   212,   216,   220,   221,   227,   228,   234,   235,
-   241,   244,   248,   252,   256,   259,   260,   265,   268,   269,
-   273,   274,   279,   280,   284,   285,   289,   291,   295,   299,
-   306,   310,   313,   316,   319,   322,   325,   328,   331,   334,
-   337,   340,   343,   346,   349,   352,   355,   358,   361,   364,
-   367,   370,   373,   376,   379,   382,   385,   388,   391,   394,
-   397,   400,   403,   406,   409,   412,   415,   418,   421,   424,
-   428,   435,   439,   442,   445,   448,   451,   454,   457,   460,
-   463,   466,   469,   472,   475,   478,   479,   484,   485,   490,
-   493,   494,   495,   506,   507,   508,   509,   517,   518,   524,
-   528,   532,   536,   542,   548,   551,   552,   555,   556,   559,
-   561,   564,   566,   568,   570,   572,   575,   576,   580,   583,
-   587,   589,   592,   596,   599,   603,   607,   609,   612,   613,
-   618,   621,   622,   627,   630,   631,   636,   640,   644,   647,
-   651,   655,   657,   659,   661,   664,   667,   671,   675,   677,
-   680,   681,   686,   689,   690,   695,   698,   701,   702,   708,
-   711,   714,   717,   720,   722,   724,   726,   728,   731,   734,
-   738,   743,   748,   753,   756,   758,   759,   765,   767,   769,
-   771,   773,   775,   777
-};
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
 
-static const short yyrhs[] = {   153,
-   154,     0,    10,   228,     0,     0,   155,     0,   155,   154,
-     0,     0,   158,    12,   156,   157,    13,     0,   160,   162,
-     0,   162,     0,   159,   158,     0,     0,    11,   228,     0,
-   161,     0,   161,   160,     0,    19,     0,    20,     8,   148,
-     0,    20,     7,   148,     0,    21,   227,   227,   227,   227,
-   148,     0,    22,   223,   148,     0,    23,   227,   148,     0,
-    24,   227,   148,     0,    25,     7,   148,     0,    25,     8,
-   148,     0,    26,     7,   148,     0,    26,     8,   148,     0,
-    27,   227,   148,     0,   163,     0,   163,   162,     0,   164,
-     0,   173,     0,   181,     0,   187,     0,   190,     0,     0,
-    28,   228,   165,   169,     0,     0,    30,   228,   166,   148,
-     0,     0,    31,   228,   167,   207,   148,     0,     0,    41,
-   207,   168,   171,   148,     0,    50,   148,     0,     0,   228,
-   170,   148,     0,    29,   148,     0,    42,   172,     0,    42,
-   172,   171,     0,    43,   221,     0,    44,   221,     0,    45,
-    46,   227,     0,    45,    47,   227,     0,    45,    48,   227,
-     0,    45,    49,   227,   227,   227,   227,     0,    45,   227,
-   227,   227,   227,   227,   227,   227,   227,   227,     0,    51,
-     0,   130,   207,   148,     0,   130,   207,   207,   148,     0,
-   131,   207,   148,     0,   131,   207,   207,   148,     0,   132,
-   214,   148,     0,   133,   214,   148,     0,   134,   207,   148,
-     0,   143,   214,   148,     0,   135,   214,   148,     0,     0,
-   136,   221,   228,   174,   148,     0,     0,   136,   207,   228,
-   175,   148,     0,     0,   137,   221,   176,   177,   148,     0,
-   138,   179,     0,   140,   214,   148,     0,   141,   214,   148,
-     0,   142,   214,   148,     0,    74,   221,     0,     0,    74,
-   221,   178,   177,     0,   139,   148,     0,     0,   228,   180,
-   148,     0,     0,    81,   182,   185,   148,     0,     0,    82,
-   183,   148,     0,     0,    83,   184,   148,     0,   186,     0,
-   186,   149,   185,     0,    84,   207,   223,     0,    84,   207,
-    62,   227,   227,   224,     0,    85,   207,   227,     0,    86,
-   227,     0,    87,   227,     0,    88,   227,     0,    89,     7,
-     0,    89,     8,     0,    90,   145,     0,    90,   144,     0,
-    91,   227,     0,    92,   227,     0,    93,   223,     0,    94,
-   227,     0,    95,   227,     0,    96,     7,     0,    96,     8,
-     0,    97,   227,     0,    98,     7,     0,    98,     8,     0,
-    99,     7,     0,    99,     8,     0,   100,   228,     0,   101,
-   221,     0,   102,     7,     0,   102,     8,     0,   103,   227,
-     0,   104,   227,     0,   105,   221,     0,   106,   223,     0,
-   107,   227,     0,   108,   227,     0,   109,   223,     0,   110,
-   227,     0,   111,   227,     0,   112,     7,     0,   112,     8,
-     0,   113,   223,     0,   114,   223,     0,   115,     7,     0,
-   115,     8,     0,   116,   214,   223,     0,   116,   214,    62,
-   227,   227,   224,     0,   116,   214,   224,     0,   117,     3,
-     0,   118,   227,     0,   119,   227,     0,   120,   227,     0,
-   121,   227,     0,   122,     3,     0,   123,   223,     0,   124,
-   227,     0,   125,   227,     0,   126,   227,     0,   127,   227,
-     0,   128,   227,     0,   129,   227,     0,     0,    14,   228,
-   188,   148,     0,     0,    15,   228,   189,   148,     0,   159,
-   148,     0,     0,     0,    32,   228,   191,   197,   198,   192,
-   150,   200,   151,   148,     0,     0,     0,     0,    40,   193,
-   202,   194,   205,   195,   148,     0,     0,    35,   228,   196,
-   206,   148,     0,    37,   221,   148,     0,    37,   222,   148,
-     0,    38,   221,   148,     0,    39,   221,   221,   227,   148,
-     0,    39,   221,   222,   227,   148,     0,    33,   228,     0,
-     0,   199,   198,     0,     0,    34,   228,     0,   201,     0,
-   201,   200,     0,   173,     0,   181,     0,   187,     0,   203,
-     0,   203,   202,     0,     0,   227,   204,   205,     0,   150,
-   151,     0,   150,   200,   151,     0,   222,     0,   222,   227,
-     0,    36,   221,   227,     0,    52,   207,     0,    53,   207,
-   208,     0,    55,   207,   210,     0,   212,     0,    54,   207,
-     0,     0,   149,   207,   209,   208,     0,    56,   207,     0,
-     0,   149,   207,   211,   210,     0,    60,   228,     0,     0,
-    61,   228,   213,   228,     0,    63,   227,   227,     0,    62,
-   227,   227,     0,    64,   214,     0,    65,   221,   227,     0,
-    66,   207,   227,     0,    58,     0,    57,     0,    59,     0,
-    79,   228,     0,    52,   214,     0,    53,   214,   215,     0,
-    55,   214,   217,     0,   219,     0,    54,   214,     0,     0,
-   149,   214,   216,   215,     0,    56,   214,     0,     0,   149,
-   214,   218,   217,     0,    72,   228,     0,    67,     3,     0,
-     0,    73,   226,   220,    74,   226,     0,    75,   228,     0,
-    76,   228,     0,    78,   228,     0,    77,   207,     0,    68,
-     0,    69,     0,    70,     0,    71,     0,    80,   228,     0,
-     9,   207,     0,   227,   227,   227,     0,    73,   221,    74,
-   221,     0,   144,   227,   227,   227,     0,   145,   227,   227,
-   227,     0,   146,   227,     0,   228,     0,     0,    73,   223,
-   225,    74,   223,     0,   147,     0,   227,     0,   228,     0,
-     3,     0,     4,     0,     5,     0,     6,     0
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
 };
 
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
 #endif
 
-#if YYDEBUG != 0
-static const short yyrline[] = { 0,
-    64,    66,    67,    70,    71,    74,    75,    77,    78,    81,
-    82,    85,    87,    88,    91,    92,    93,    94,    95,    96,
-    97,    98,    99,   100,   101,   102,   105,   106,   109,   110,
-   111,   112,   113,   116,   117,   117,   118,   118,   118,   120,
-   121,   122,   125,   126,   126,   129,   130,   133,   134,   135,
-   136,   137,   138,   139,   142,   145,   146,   148,   149,   150,
-   151,   152,   153,   154,   155,   156,   156,   157,   157,   157,
-   158,   159,   160,   161,   164,   165,   166,   168,   169,   169,
-   172,   172,   173,   174,   174,   175,   177,   178,   181,   182,
-   184,   185,   186,   187,   188,   189,   190,   191,   192,   193,
-   194,   195,   196,   197,   198,   199,   200,   201,   202,   203,
-   204,   205,   206,   207,   208,   209,   210,   211,   212,   213,
-   214,   215,   216,   217,   218,   219,   220,   221,   222,   223,
-   224,   226,   227,   228,   229,   230,   231,   232,   233,   234,
-   235,   236,   237,   238,   239,   242,   243,   243,   244,   244,
-   247,   248,   249,   250,   250,   251,   251,   252,   252,   253,
-   254,   255,   256,   257,   260,   261,   264,   265,   268,   270,
-   271,   274,   275,   276,   279,   280,   283,   283,   285,   286,
-   289,   290,   291,   294,   295,   296,   297,   300,   301,   302,
-   304,   305,   306,   308,   309,   310,   311,   312,   313,   314,
-   315,   316,   317,   318,   319,   322,   323,   324,   325,   328,
-   329,   330,   332,   333,   334,   336,   337,   338,   339,   342,
-   343,   344,   345,   346,   347,   348,   349,   350,   353,   354,
-   357,   359,   360,   361,   362,   365,   366,   367,   370,   371,
-   374,   375,   378,   379
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  7
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   820
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  158
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  78
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  251
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  511
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   408
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_uint8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,   155,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,   154,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,   156,     2,   157,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,   101,   102,   103,   104,
+     105,   106,   107,   108,   109,   110,   111,   112,   113,   114,
+     115,   116,   117,   118,   119,   120,   121,   122,   123,   124,
+     125,   126,   127,   128,   129,   130,   131,   132,   133,   134,
+     135,   136,   137,   138,   139,   140,   141,   142,   143,   144,
+     145,   146,   147,   148,   149,   150,   151,   152,   153
 };
 
-static const char * const yytname[] = {   "$","error","$undefined.","INTEGER",
-"REAL","STRING","ITEM","ON","OFF","POSITION","TITLE","MACRO","PLOT","END_PLOT",
-"COMMENT","DEBUG","POSTSCRIPT","RASTER3D","VRML","NOFRAME","FRAME","AREA","BACKGROUND",
-"WINDOW","SLAB","HEADLIGHT","SHADOWS","FOG","READ","INLINE_PDB","DELETE","COPY",
-"ANCHOR","DESCRIPTION","PARAMETER","VIEWPOINT","ORIGIN","DIRECTIONALLIGHT","POINTLIGHT",
-"SPOTLIGHT","LEVEL_OF_DETAIL","TRANSFORM","BY","CENTRE","TRANSLATION","ROTATION",
-"XAXIS","YAXIS","ZAXIS","AXIS","STORE_MATRIX","RECALL_MATRIX","NOT","REQUIRE",
-"AND","EITHER","OR","BACKBONE","PEPTIDE","HYDROGENS","ATOM","RES_ATOM","B_FACTOR",
-"OCCUPANCY","IN","SPHERE","CLOSE","MODEL","AMINO_ACIDS","WATERS","NUCLEOTIDES",
-"LIGANDS","MOLECULE","FROM","TO","RESIDUE","TYPE","CONTAINS","CHAIN","ELEMENT",
-"SEGID","SET","PUSH","POP","ATOMCOLOUR","ATOMRADIUS","BONDDISTANCE","BONDCROSS",
-"COILRADIUS","COLOURPARTS","COLOURRAMP","CYLINDERRADIUS","DEPTHCUE","EMISSIVECOLOUR",
-"HELIXTHICKNESS","HELIXWIDTH","HSBRAMPREVERSE","LABELBACKGROUND","LABELCENTRE",
-"LABELCLIP","LABELMASK","LABELOFFSET","LABELROTATION","LABELSIZE","LIGHTAMBIENTINTENSITY",
-"LIGHTATTENUATION","LIGHTCOLOUR","LIGHTINTENSITY","LIGHTRADIUS","LINECOLOUR",
-"LINEDASH","LINEWIDTH","OBJECTTRANSFORM","PLANECOLOUR","PLANE2COLOUR","REGULAREXPRESSION",
-"RESIDUECOLOUR","SEGMENTS","SEGMENTSIZE","SHADING","SHADINGEXPONENT","SHININESS",
-"SMOOTHSTEPS","SPECULARCOLOUR","SPLINEFACTOR","STICKRADIUS","STICKTAPER","STRANDTHICKNESS",
-"STRANDWIDTH","TRANSPARENCY","BALL_AND_STICK","BONDS","COIL","CYLINDER","CPK",
-"HELIX","LABEL","LINE","OBJECT","INLINE","STRAND","TRACE","TURN","DOUBLE_HELIX",
-"RGB","HSB","GREY","RAINBOW","';'","','","'{'","'}'","file_contents","title",
-"plots","plot","@1","plot_contents","macro_defs","macro_def","header_commands",
-"header_command","body_commands","body_command","coord_command","@2","@3","@4",
-"@5","coordinates","@6","xforms","xform","geom_command","@7","@8","@9","lines",
-"@10","object","@11","state_command","@12","@13","@14","state_changes","state_change",
-"utility_command","@15","@16","ctrl_command","@17","@18","@19","@20","@21","@22",
-"anchor_description","anchor_parameters","anchor_parameter","basic_commands",
-"basic_command","lod_blocks","lod_block","@23","lod_group","view_definition",
-"atom_selection","atom_and","@24","atom_or","@25","atom_specification","@26",
-"residue_selection","residue_and","@27","residue_or","@28","residue_specification",
-"@29","vector","direction","colour","ramp","@30","number_as_id","number","id",
-""
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    76,    76,    78,    79,    82,    83,    86,    86,    89,
+      90,    93,    94,    97,    99,   100,   103,   104,   105,   106,
+     107,   108,   109,   110,   111,   112,   113,   114,   117,   118,
+     121,   122,   123,   124,   125,   128,   128,   129,   129,   130,
+     130,   132,   132,   134,   137,   137,   138,   141,   142,   145,
+     146,   147,   148,   149,   150,   151,   154,   157,   158,   159,
+     161,   162,   163,   164,   165,   166,   167,   168,   168,   169,
+     169,   170,   170,   171,   172,   173,   174,   175,   178,   179,
+     179,   182,   183,   183,   186,   186,   187,   187,   188,   188,
+     191,   192,   195,   196,   197,   199,   200,   201,   202,   203,
+     204,   205,   206,   207,   208,   209,   210,   211,   212,   213,
+     214,   215,   216,   217,   218,   219,   220,   221,   222,   223,
+     224,   225,   226,   227,   228,   229,   230,   231,   232,   233,
+     234,   235,   236,   237,   238,   239,   240,   242,   243,   244,
+     245,   246,   247,   248,   249,   250,   251,   252,   253,   254,
+     255,   256,   257,   260,   260,   261,   261,   262,   265,   266,
+     265,   268,   268,   269,   268,   270,   270,   271,   272,   273,
+     274,   275,   278,   279,   282,   283,   286,   288,   289,   292,
+     293,   294,   297,   298,   301,   301,   303,   304,   307,   308,
+     309,   312,   313,   314,   315,   318,   319,   319,   322,   323,
+     323,   326,   327,   327,   329,   330,   331,   332,   333,   334,
+     335,   336,   337,   340,   341,   342,   343,   346,   347,   347,
+     350,   351,   351,   354,   355,   356,   356,   360,   361,   362,
+     363,   364,   365,   366,   367,   368,   371,   372,   375,   377,
+     378,   379,   380,   383,   383,   385,   388,   389,   392,   393,
+     396,   397
 };
 #endif
 
-static const short yyr1[] = {     0,
-   152,   153,   153,   154,   154,   156,   155,   157,   157,   158,
-   158,   159,   160,   160,   161,   161,   161,   161,   161,   161,
-   161,   161,   161,   161,   161,   161,   162,   162,   163,   163,
-   163,   163,   163,   165,   164,   166,   164,   167,   164,   168,
-   164,   164,   170,   169,   169,   171,   171,   172,   172,   172,
-   172,   172,   172,   172,   172,   173,   173,   173,   173,   173,
-   173,   173,   173,   173,   174,   173,   175,   173,   176,   173,
-   173,   173,   173,   173,   177,   178,   177,   179,   180,   179,
-   182,   181,   183,   181,   184,   181,   185,   185,   186,   186,
-   186,   186,   186,   186,   186,   186,   186,   186,   186,   186,
-   186,   186,   186,   186,   186,   186,   186,   186,   186,   186,
-   186,   186,   186,   186,   186,   186,   186,   186,   186,   186,
-   186,   186,   186,   186,   186,   186,   186,   186,   186,   186,
-   186,   186,   186,   186,   186,   186,   186,   186,   186,   186,
-   186,   186,   186,   186,   186,   188,   187,   189,   187,   187,
-   191,   192,   190,   193,   194,   195,   190,   196,   190,   190,
-   190,   190,   190,   190,   197,   197,   198,   198,   199,   200,
-   200,   201,   201,   201,   202,   202,   204,   203,   205,   205,
-   206,   206,   206,   207,   207,   207,   207,   208,   209,   208,
-   210,   211,   210,   212,   213,   212,   212,   212,   212,   212,
-   212,   212,   212,   212,   212,   214,   214,   214,   214,   215,
-   216,   215,   217,   218,   217,   219,   219,   220,   219,   219,
-   219,   219,   219,   219,   219,   219,   219,   219,   221,   221,
-   222,   223,   223,   223,   223,   225,   224,   224,   226,   226,
-   227,   227,   228,   228
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "INTEGER", "REAL",
+  "STRING", "ITEM", "ON", "OFF", "POSITION", "TITLE", "MACRO", "PLOT",
+  "END_PLOT", "COMMENT", "DEBUG", "POSTSCRIPT", "RASTER3D", "VRML",
+  "NOFRAME", "FRAME", "AREA", "BACKGROUND", "WINDOW", "SLAB", "HEADLIGHT",
+  "SHADOWS", "FOG", "READ", "INLINE_PDB", "DELETE", "COPY", "ANCHOR",
+  "DESCRIPTION", "PARAMETER", "VIEWPOINT", "ORIGIN", "DIRECTIONALLIGHT",
+  "POINTLIGHT", "SPOTLIGHT", "LEVEL_OF_DETAIL", "TRANSFORM", "BY",
+  "CENTRE", "TRANSLATION", "ROTATION", "XAXIS", "YAXIS", "ZAXIS", "AXIS",
+  "STORE_MATRIX", "RECALL_MATRIX", "NOT", "REQUIRE", "AND", "EITHER", "OR",
+  "BACKBONE", "PEPTIDE", "HYDROGENS", "ATOM", "RES_ATOM", "B_FACTOR",
+  "OCCUPANCY", "IN", "SPHERE", "CLOSE", "MODEL", "AMINO_ACIDS", "WATERS",
+  "NUCLEOTIDES", "LIGANDS", "MOLECULE", "FROM", "TO", "RESIDUE", "TYPE",
+  "CONTAINS", "CHAIN", "ELEMENT", "SEGID", "SET", "PUSH", "POP",
+  "ATOMCOLOUR", "ATOMRADIUS", "BONDDISTANCE", "BONDCROSS", "COILRADIUS",
+  "COLOURPARTS", "COLOURRAMP", "CYLINDERRADIUS", "DEPTHCUE",
+  "EMISSIVECOLOUR", "HELIXTHICKNESS", "HELIXWIDTH", "HSBRAMPREVERSE",
+  "LABELBACKGROUND", "LABELCENTRE", "LABELCLIP", "LABELMASK",
+  "LABELOFFSET", "LABELROTATION", "LABELSIZE", "LIGHTAMBIENTINTENSITY",
+  "LIGHTATTENUATION", "LIGHTCOLOUR", "LIGHTINTENSITY", "LIGHTRADIUS",
+  "LINECOLOUR", "LINEDASH", "LINEWIDTH", "OBJECTTRANSFORM", "PLANECOLOUR",
+  "PLANE2COLOUR", "REGULAREXPRESSION", "RESIDUECOLOUR", "SEGMENTS",
+  "SEGMENTSIZE", "SHADING", "SHADINGEXPONENT", "SHININESS", "SMOOTHSTEPS",
+  "SPECULARCOLOUR", "SPLINEFACTOR", "STICKRADIUS", "STICKTAPER",
+  "STRANDTHICKNESS", "STRANDWIDTH", "TRANSPARENCY", "BALL_AND_STICK",
+  "BONDS", "COIL", "CYLINDER", "CPK", "HELIX", "LABEL", "LINE", "OBJECT",
+  "INLINE", "STRAND", "TRACE", "TURN", "DOUBLE_HELIX", "RGB", "HSB",
+  "GREY", "RAINBOW", "ACCESSIBLE_SURFACE", "MOLECULAR_SURFACE",
+  "SURFACEGRID", "SURFACEPROBE", "DETAILLEVELS", "ADAPTIVESEGMENTS", "';'",
+  "','", "'{'", "'}'", "$accept", "file_contents", "title", "plots",
+  "plot", "$@1", "plot_contents", "macro_defs", "macro_def",
+  "header_commands", "header_command", "body_commands", "body_command",
+  "coord_command", "$@2", "$@3", "$@4", "$@5", "coordinates", "$@6",
+  "xforms", "xform", "geom_command", "$@7", "$@8", "$@9", "lines", "$@10",
+  "object", "$@11", "state_command", "$@12", "$@13", "$@14",
+  "state_changes", "state_change", "utility_command", "$@15", "$@16",
+  "ctrl_command", "$@17", "$@18", "$@19", "$@20", "$@21", "$@22",
+  "anchor_description", "anchor_parameters", "anchor_parameter",
+  "basic_commands", "basic_command", "lod_blocks", "lod_block", "$@23",
+  "lod_group", "view_definition", "atom_selection", "atom_and", "$@24",
+  "atom_or", "$@25", "atom_specification", "$@26", "residue_selection",
+  "residue_and", "$@27", "residue_or", "$@28", "residue_specification",
+  "$@29", "vector", "direction", "colour", "ramp", "$@30", "number_as_id",
+  "number", "id", YY_NULLPTR
 };
 
-static const short yyr2[] = {     0,
-     2,     2,     0,     1,     2,     0,     5,     2,     1,     2,
-     0,     2,     1,     2,     1,     3,     3,     6,     3,     3,
-     3,     3,     3,     3,     3,     3,     1,     2,     1,     1,
-     1,     1,     1,     0,     4,     0,     4,     0,     5,     0,
-     5,     2,     0,     3,     2,     2,     3,     2,     2,     3,
-     3,     3,     6,    10,     1,     3,     4,     3,     4,     3,
-     3,     3,     3,     3,     0,     5,     0,     5,     0,     5,
-     2,     3,     3,     3,     2,     0,     4,     2,     0,     3,
-     0,     4,     0,     3,     0,     3,     1,     3,     3,     6,
-     3,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     2,     2,     2,     2,     3,
-     6,     3,     2,     2,     2,     2,     2,     2,     2,     2,
-     2,     2,     2,     2,     2,     0,     4,     0,     4,     2,
-     0,     0,    10,     0,     0,     0,     7,     0,     5,     3,
-     3,     3,     5,     5,     2,     0,     2,     0,     2,     1,
-     2,     1,     1,     1,     1,     2,     0,     3,     2,     3,
-     1,     2,     3,     2,     3,     3,     1,     2,     0,     4,
-     2,     0,     4,     2,     0,     4,     3,     3,     2,     3,
-     3,     1,     1,     1,     2,     2,     3,     3,     1,     2,
-     0,     4,     2,     0,     4,     2,     2,     0,     5,     2,
-     2,     2,     2,     1,     1,     1,     1,     2,     2,     3,
-     4,     4,     4,     2,     1,     0,     5,     1,     1,     1,
-     1,     1,     1,     1
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-440)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-80)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+       3,    19,    11,    28,  -440,  -440,  -440,  -440,    19,  -440,
+      40,    37,    28,  -440,  -440,  -440,  -440,   516,    19,    19,
+    -440,    61,    76,    36,    76,    76,   125,   127,    76,    19,
+      19,    19,    19,    19,    58,    92,    92,  -440,   375,   -94,
+    -440,  -440,  -440,   375,   375,   740,   740,   375,   740,   657,
+      92,    -1,   740,   740,   740,   740,   375,   375,    64,   -89,
+     550,   275,  -440,   550,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,   -70,   -65,  -440,  -440,    76,    76,    76,    76,   -63,
+    -440,   -43,   -39,   -30,   -13,    -9,    -4,     8,  -440,  -440,
+    -440,  -440,  -440,   375,    92,    10,    13,    76,    23,    58,
+      76,   375,   375,   375,  -440,  -440,  -440,    19,    19,    76,
+      76,   740,    92,   375,    19,  -440,  -440,  -440,   653,    29,
+      50,   196,   277,   740,   740,   740,   154,  -440,  -440,  -440,
+    -440,    19,   100,    19,    19,   375,    19,    19,    57,  -440,
+      78,    82,    84,    19,    19,  -440,    88,  -440,  -440,    89,
+      90,    91,    96,   109,   110,  -440,  -440,  -440,  -440,  -440,
+     111,   112,  -440,  -440,    76,    76,    76,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,    30,   113,   375,    95,
+       1,  -440,   120,  -440,  -440,    76,  -440,    76,    76,  -440,
+      76,  -440,  -440,   -53,   -48,  -440,  -440,    76,    76,  -440,
+      76,    76,  -440,   173,   375,   375,    76,    76,    76,   129,
+      -5,    76,    76,    36,    76,    76,   153,    76,   166,   180,
+      19,    92,   192,    76,    76,    92,    36,    76,    76,    36,
+      76,    76,   206,    36,    36,   213,   740,   227,    76,    76,
+      76,    76,   265,    36,    76,    76,    76,    76,    76,    76,
+      76,    76,   266,    76,   119,   121,  -440,  -440,  -440,   124,
+    -440,   126,  -440,   -47,   -46,  -440,  -440,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,   200,  -440,   131,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,  -440,    76,    76,    76,   132,  -440,  -440,  -440,   134,
+      19,   243,    92,   135,    76,    92,  -440,   136,   151,   150,
+    -440,   150,   375,   375,  -440,   375,   375,  -440,    19,  -440,
+    -440,  -440,  -440,    74,   155,    52,    76,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,     9,  -440,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,   653,  -440,  -440,   740,   740,  -440,
+     740,   740,  -440,   205,   156,   159,    92,   160,  -440,   162,
+    -440,  -440,  -440,   163,  -440,  -440,    19,  -440,   243,    76,
+    -440,  -440,  -440,  -440,  -440,   377,  -440,  -440,  -440,  -440,
+    -440,  -440,  -440,    92,    92,   123,  -440,   173,  -440,    76,
+    -440,  -440,    76,    36,  -440,  -440,  -440,  -440,  -440,  -440,
+    -440,  -440,   100,  -440,  -440,   207,  -440,  -440,  -440,  -440,
+     152,  -440,  -440,  -440,  -440,  -440,  -440,   161,   477,   165,
+     -53,   -48,  -440,  -440,    76,    76,    76,    76,    76,  -440,
+      76,    76,  -440,   -47,   -46,  -440,   200,   477,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,    76,    76,   -61,   -61,
+     233,  -440,  -440,  -440,   164,    76,    76,  -440,  -440,    36,
+     168,    76,    76,  -440,  -440,  -440,    76,    76,    76,    76,
+    -440
 };
 
-static const short yydefact[] = {     3,
-     0,    11,   243,   244,     2,     0,     1,     4,     0,    11,
-    12,     5,     6,    10,     0,     0,     0,    15,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,   154,     0,     0,    81,    83,    85,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,     0,     0,    13,     9,    27,    29,
-    30,    31,    32,    33,   146,   148,     0,     0,   241,   242,
-     0,     0,     0,     0,     0,   235,     0,     0,     0,     0,
-     0,     0,     0,    34,    36,    38,   151,   158,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,   203,
-   202,   204,     0,     0,     0,     0,     0,     0,     0,     0,
-    40,   187,    42,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,   224,   225,   226,   227,     0,     0,     0,     0,
-     0,     0,     0,     0,   209,     0,     0,     0,     0,     0,
-    69,     0,    71,    79,     0,     0,     0,     0,     7,   150,
-     8,    14,    28,     0,     0,    17,    16,     0,     0,     0,
-   234,    19,    20,    21,    22,    23,    24,    25,    26,     0,
-     0,     0,   166,     0,   229,     0,   160,   161,     0,   162,
-     0,     0,   155,   175,   177,   184,     0,     0,   194,   195,
-     0,     0,   199,     0,     0,   205,     0,     0,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,    87,    84,    86,    56,     0,    58,
-     0,   206,     0,     0,   217,   216,   218,   239,   240,   220,
-   221,   223,   222,   228,    60,    61,    62,    64,    67,    65,
-     0,    78,     0,    72,    73,    74,    63,   147,   149,     0,
-     0,     0,     0,    35,    43,    37,     0,     0,   168,     0,
-     0,   181,     0,   230,     0,     0,     0,   176,     0,     0,
-     0,   185,     0,     0,   186,     0,   198,   197,   200,   201,
-     0,     0,     0,     0,    92,    93,    94,    95,    96,    98,
-    97,    99,   100,   101,   102,   103,   104,   105,   106,   107,
-   108,   109,   110,   111,   112,   113,   114,   115,   116,   117,
-   118,   119,   120,   121,   122,   123,   124,   125,   126,   127,
-   128,   129,     0,   133,   134,   135,   136,   137,   138,   139,
-   140,   141,   142,   143,   144,   145,    82,     0,    57,    59,
-     0,     0,   207,     0,     0,   208,     0,     0,     0,     0,
-     0,    80,     0,   232,   233,    45,     0,    39,   165,     0,
-   152,   168,     0,   159,   182,   231,   163,   164,     0,   156,
-   178,   188,   189,   191,   192,   196,     0,     0,     0,    55,
-    46,    41,     0,    89,    91,     0,     0,   238,   130,   132,
-    88,   210,   211,   213,   214,     0,    68,    66,    75,    70,
-    18,    44,   169,     0,   167,   183,   179,   172,   173,   174,
-     0,   170,     0,     0,     0,    48,    49,     0,     0,     0,
-     0,     0,    47,     0,     0,   236,     0,     0,   219,     0,
-     0,   180,   171,   157,   190,   193,    50,    51,    52,     0,
-     0,     0,     0,     0,   212,   215,    77,     0,     0,     0,
-    90,   131,     0,     0,     0,     0,   237,   153,    53,     0,
-     0,     0,     0,    54,     0,     0,     0
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       4,     0,     0,    12,   250,   251,     3,     1,     0,     2,
+       5,     0,    12,    13,     6,     7,    11,     0,     0,     0,
+      16,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,   161,     0,     0,
+      84,    86,    88,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    14,    10,    28,    30,    31,    32,    33,    34,   153,
+     155,     0,     0,   248,   249,     0,     0,     0,     0,     0,
+     242,     0,     0,     0,     0,     0,     0,     0,    35,    37,
+      39,   158,   165,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,   210,   209,   211,     0,     0,     0,
+       0,     0,     0,     0,     0,    41,   194,    43,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,   231,   232,   233,
+     234,     0,     0,     0,     0,     0,     0,     0,     0,   216,
+       0,     0,     0,     0,     0,    71,     0,    74,    82,     0,
+       0,     0,     0,     0,     0,     8,   157,     9,    15,    29,
+       0,     0,    18,    17,     0,     0,     0,   241,    20,    21,
+      22,    23,    24,    25,    26,    27,     0,     0,     0,   173,
+       0,   236,     0,   167,   168,     0,   169,     0,     0,   162,
+     182,   184,   191,     0,     0,   201,   202,     0,     0,   206,
+       0,     0,   212,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,    90,    87,    89,    58,     0,
+      60,     0,   213,     0,     0,   224,   223,   225,   246,   247,
+     227,   228,   230,   229,   235,    62,    63,    64,    66,    69,
+      67,     0,    81,     0,    75,    76,    77,    65,    57,    73,
+     154,   156,     0,     0,     0,     0,    36,    44,    38,     0,
+       0,   175,     0,     0,   188,     0,   237,     0,     0,     0,
+     183,     0,     0,     0,   192,     0,     0,   193,     0,   205,
+     204,   207,   208,     0,     0,     0,     0,    96,    97,    98,
+      99,   100,   102,   101,   103,   104,   106,   107,   108,   109,
+     110,   111,   112,   113,   114,   115,   116,   117,   118,   119,
+     120,   121,   122,   123,   124,   125,   126,   127,   128,   129,
+     130,   131,   132,   133,   134,     0,   138,   139,   140,   141,
+     142,   143,   144,   145,   146,   147,   148,   149,   152,   150,
+     151,   105,    92,    85,     0,    59,    61,     0,     0,   214,
+       0,     0,   215,     0,     0,     0,     0,     0,    83,     0,
+     239,   240,    46,     0,    40,   172,     0,   159,   175,     0,
+     166,   189,   238,   170,   171,     0,   163,   185,   195,   196,
+     198,   199,   203,     0,     0,     0,    56,    47,    42,     0,
+      93,    95,     0,     0,   245,   135,   137,    91,   217,   218,
+     220,   221,     0,    70,    68,    78,    72,    19,    45,   176,
+       0,   174,   190,   186,   179,   180,   181,     0,   177,     0,
+       0,     0,    49,    50,     0,     0,     0,     0,     0,    48,
+       0,     0,   243,     0,     0,   226,     0,     0,   187,   178,
+     164,   197,   200,    51,    52,    53,     0,     0,     0,     0,
+       0,   219,   222,    80,     0,     0,     0,    94,   136,     0,
+       0,     0,     0,   244,   160,    54,     0,     0,     0,     0,
+      55
 };
 
-static const short yydefgoto[] = {   495,
-     2,     7,     8,    15,    54,     9,    55,    56,    57,    58,
-    59,    60,   170,   171,   172,   197,   284,   387,   312,   411,
-    61,   379,   378,   271,   381,   460,   143,   273,    62,   114,
-   115,   116,   244,   245,    63,   154,   155,    64,   173,   434,
-    96,   297,   443,   174,   289,   391,   392,   441,   442,   183,
-   184,   299,   400,   291,   111,   302,   444,   305,   445,   112,
-   306,   134,   373,   457,   376,   458,   135,   377,    91,    92,
-    75,   420,   474,   257,    93,    76
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -440,  -440,  -440,   313,  -440,  -440,  -440,   312,    60,   267,
+    -440,   -20,  -440,  -440,  -440,  -440,  -440,  -440,  -440,  -440,
+    -101,  -440,  -394,  -440,  -440,  -440,  -149,  -440,  -440,  -440,
+    -385,  -440,  -440,  -440,   -40,  -440,  -365,  -440,  -440,  -440,
+    -440,  -440,  -440,  -440,  -440,  -440,  -440,   -77,  -440,  -439,
+    -440,   157,  -440,  -440,    34,  -440,   190,  -114,  -440,  -112,
+    -440,  -440,  -440,   -26,  -125,  -440,  -123,  -440,  -440,  -440,
+     -18,   -90,  -113,  -248,  -440,   -88,   -22,    15
 };
 
-static const short yypact[] = {     4,
-    20,    10,-32768,-32768,-32768,    20,-32768,    44,    26,    10,
--32768,-32768,-32768,-32768,   491,    20,    20,-32768,   103,   112,
-     5,   112,   112,   119,   122,   112,    20,    20,    20,    20,
-    20,    55,    98,    98,-32768,   287,  -132,-32768,-32768,-32768,
-   287,   287,   706,   706,   287,   706,   632,    98,    31,   706,
-   706,   706,   706,    33,   -76,   525,   229,-32768,   525,-32768,
--32768,-32768,-32768,-32768,-32768,-32768,   -71,   -69,-32768,-32768,
-   112,   112,   112,   112,   -59,-32768,   -56,   -54,   -44,   -42,
-   -35,   -14,    -3,-32768,-32768,-32768,-32768,-32768,   287,    98,
-     0,     7,   112,    15,    55,   112,   287,   287,   287,-32768,
--32768,-32768,    20,    20,   112,   112,   706,    98,   287,    20,
--32768,-32768,-32768,   628,    25,    35,   428,   526,   706,   706,
-   706,   149,-32768,-32768,-32768,-32768,    20,   116,    20,    20,
-   287,    20,    20,    39,-32768,    78,    79,    82,    20,    20,
--32768,    83,-32768,-32768,    84,    85,    86,    91,-32768,-32768,
--32768,-32768,-32768,    92,    96,-32768,-32768,   112,   112,   112,
--32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,    28,
-   109,   287,   127,   -12,-32768,   169,-32768,-32768,   112,-32768,
-   112,   112,-32768,   112,-32768,-32768,   -53,   -51,-32768,-32768,
-   112,   112,-32768,   112,   112,-32768,   216,   287,   287,   112,
-   112,   112,   124,    32,   112,   112,     5,   112,   112,   171,
-   112,   188,   201,    20,    98,   203,   112,   112,    98,     5,
-   112,   112,     5,   112,   112,   209,     5,     5,   217,   706,
-   256,   112,   112,   112,   112,   260,     5,   112,   112,   112,
-   112,   112,   112,   118,   115,-32768,-32768,-32768,   121,-32768,
-   123,-32768,   -50,   -49,-32768,-32768,-32768,-32768,-32768,-32768,
--32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,
-   193,-32768,   128,-32768,-32768,-32768,-32768,-32768,-32768,   112,
-   112,   112,   129,-32768,-32768,-32768,   130,    20,   236,    98,
-   131,   112,    98,-32768,   132,   133,   134,-32768,   134,   287,
-   287,-32768,   287,   287,-32768,    20,-32768,-32768,-32768,-32768,
-    37,   135,    12,   112,-32768,-32768,-32768,-32768,-32768,-32768,
--32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,
--32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,
--32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,
--32768,-32768,    22,-32768,-32768,-32768,-32768,-32768,-32768,-32768,
--32768,-32768,-32768,-32768,-32768,-32768,-32768,   628,-32768,-32768,
-   706,   706,-32768,   706,   706,-32768,   208,   137,   138,    98,
-   139,-32768,   142,-32768,-32768,-32768,   145,-32768,-32768,    20,
--32768,   236,   112,-32768,-32768,-32768,-32768,-32768,   192,-32768,
--32768,-32768,-32768,-32768,-32768,-32768,    98,    98,   189,-32768,
-   216,-32768,   112,-32768,-32768,   112,     5,-32768,-32768,-32768,
--32768,-32768,-32768,-32768,-32768,   116,-32768,-32768,   222,-32768,
--32768,-32768,-32768,   150,-32768,-32768,-32768,-32768,-32768,-32768,
-   152,   277,   153,   -53,   -51,-32768,-32768,   112,   112,   112,
-   112,   112,-32768,   112,   112,-32768,   -50,   -49,-32768,   193,
-   277,-32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,   112,
-   112,   -60,   -60,   230,-32768,-32768,-32768,   154,   112,   112,
--32768,-32768,     5,   158,   112,   112,-32768,-32768,-32768,   112,
-   112,   112,   112,-32768,   307,   308,-32768
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,     2,     3,     9,    10,    17,    58,    11,    59,    60,
+      61,    62,    63,    64,   176,   177,   178,   203,   296,   403,
+     324,   427,    65,   395,   394,   281,   397,   476,   147,   283,
+      66,   118,   119,   120,   254,   255,    67,   160,   161,    68,
+     179,   450,   100,   309,   459,   180,   301,   407,   408,   457,
+     458,   189,   190,   311,   416,   303,   115,   314,   460,   317,
+     461,   116,   318,   138,   389,   473,   392,   474,   139,   393,
+      95,    96,    79,   436,   490,   267,    97,    80
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      75,   312,    81,    82,     4,     5,    87,   387,   315,   188,
+     390,     7,   433,     1,     4,     5,     6,    98,    99,   479,
+     140,   454,   142,    13,     4,     5,   149,   150,   151,   152,
+     455,   144,   145,    69,    70,     4,     5,   302,   494,     8,
+     157,     4,     5,   159,    88,    89,    90,    91,    92,    15,
+     456,     8,   -12,   164,   165,   166,   167,     4,     5,   295,
+     117,    73,    74,    12,   454,   156,   148,    93,    71,    72,
+      12,   432,    12,   455,    94,   185,   182,   155,   191,    73,
+      74,   187,   433,   454,   162,   199,   434,   197,   198,   163,
+     304,   168,   455,   456,   200,    73,    74,   262,   263,   264,
+     336,    93,   313,    73,    74,     4,     5,   316,   388,   391,
+     268,   169,   456,   353,   429,   170,   356,   423,   424,   425,
+     361,   362,   195,   196,   171,   426,    73,    74,   300,   202,
+     372,    94,    83,    84,    85,    86,   330,   331,   146,   332,
+     333,   172,   292,   293,   294,   173,   266,   269,   270,   271,
+     174,   273,   274,    76,    77,    78,   434,   265,   279,   280,
+     339,   340,   175,   306,   183,   307,   308,   184,   191,   464,
+     465,   466,   467,   342,   343,   319,   320,   186,   321,   322,
+      76,    77,    78,   256,   327,   328,   329,   344,   345,   334,
+     335,   297,   337,   338,   305,   341,    76,    77,    78,   348,
+     349,   350,   351,   347,   257,   354,   355,   352,   357,   358,
+     365,   275,   430,   359,   360,   323,   367,   368,   369,   370,
+     363,   364,   373,   374,   375,   376,   377,   378,   379,   380,
+     366,   382,   276,   121,   122,   346,   277,   141,   278,   143,
+     497,   498,   282,   284,   285,   286,   153,   154,   101,   102,
+     287,   103,   435,   104,   105,   106,   107,   108,   109,   110,
+     111,   112,   113,   288,   289,   290,   291,   298,   371,   381,
+     399,   400,   401,   383,   396,   114,   384,   406,   385,   442,
+     386,   -79,   411,   181,   409,   398,   402,   412,   404,   410,
+     413,   192,   193,   194,    20,    21,    22,    23,    24,    25,
+      26,    27,    28,   201,   431,   414,   415,   499,   477,   428,
+     443,   259,   261,   444,   446,   405,   447,   448,   478,   480,
+     472,   500,   504,    14,    16,   272,   469,   493,   158,   101,
+     102,   451,   103,   422,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,   437,   417,   481,   310,   491,   482,
+     258,   492,     0,     0,   475,     0,   114,     0,     0,     0,
+       0,   438,   439,     0,   440,   441,     0,     0,   299,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,   445,     0,
+       0,     0,     0,     0,     0,     0,   503,   452,     8,     0,
+       0,    18,    19,     0,   325,   326,     0,     0,     0,     0,
+       0,     0,     0,   468,     0,   462,   463,   470,     0,     0,
+     471,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+     268,   449,     0,     0,     0,     0,     0,   101,   102,     0,
+     103,   260,   104,   105,   106,   107,   108,   109,   110,   111,
+     112,   113,   483,   484,   485,   486,   487,     0,   488,   489,
+       0,     0,     0,     0,   114,     0,     0,   269,    40,    41,
+      42,     0,     0,     0,   495,   496,     0,     0,     0,     0,
+       0,     0,     0,   501,   502,     0,     0,     0,     0,   505,
+     506,     0,     0,     0,   507,   508,   509,   510,     8,     0,
+       0,    18,    19,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,   418,   419,     0,   420,   421,    43,    44,    45,
+      46,    47,    48,    49,    50,    51,     0,    52,    53,    54,
+      55,     0,     0,     0,     0,    56,    57,     8,     0,     0,
+      18,    19,     0,     0,   453,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,     0,    30,    31,    32,     0,
+       0,    33,     0,    34,    35,    36,    37,    38,    40,    41,
+      42,     8,     0,     0,    18,    19,    39,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    29,     0,
+      30,    31,    32,     0,     0,    33,     0,    34,    35,    36,
+      37,    38,     0,     0,     0,     0,     0,    40,    41,    42,
+      39,     0,     0,     0,     0,     0,     0,    43,    44,    45,
+      46,    47,    48,    49,    50,    51,     0,    52,    53,    54,
+      55,     0,     0,     0,     0,    56,    57,     0,     0,     0,
+       0,    40,    41,    42,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,    43,    44,    45,    46,
+      47,    48,    49,    50,    51,     0,    52,    53,    54,    55,
+      73,    74,     0,     0,    56,    57,    93,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+      43,    44,    45,    46,    47,    48,    49,    50,    51,     0,
+      52,    53,    54,    55,     0,     0,     0,     0,    56,    57,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,   101,
+     102,     0,   103,     0,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,   114,   204,   205,   206,
+     207,   208,   209,   210,   211,   212,   213,   214,   215,   216,
+     217,   218,   219,   220,   221,   222,   223,   224,   225,   226,
+     227,   228,   229,   230,   231,   232,   233,   234,   235,   236,
+     237,   238,   239,   240,   241,   242,   243,   244,   245,   246,
+     247,   248,   249,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,   123,   124,     0,   125,     0,     0,     0,     0,
+       0,     0,     0,   250,   251,   252,   253,   126,   127,   128,
+     129,   130,   131,   132,     0,   133,   134,   135,   136,     0,
+     137
 };
 
-static const short yypgoto[] = {-32768,
--32768,   302,-32768,-32768,-32768,   301,    95,   255,-32768,    19,
--32768,-32768,-32768,-32768,-32768,-32768,-32768,-32768,   -98,-32768,
-  -352,-32768,-32768,-32768,  -146,-32768,-32768,-32768,  -349,-32768,
--32768,-32768,   -52,-32768,  -328,-32768,-32768,-32768,-32768,-32768,
--32768,-32768,-32768,-32768,-32768,   -77,-32768,  -413,-32768,   157,
--32768,-32768,    38,-32768,   200,  -125,-32768,  -124,-32768,-32768,
--32768,    16,  -121,-32768,  -120,-32768,-32768,-32768,   -25,   -83,
-  -188,  -273,-32768,   -72,   -20,    14
+static const yytype_int16 yycheck[] =
+{
+      22,    54,    24,    25,     5,     6,    28,    54,    56,    99,
+      56,     0,    73,    10,     5,     6,     1,    35,    36,   458,
+      46,   415,    48,     8,     5,     6,    52,    53,    54,    55,
+     415,    49,    50,    18,    19,     5,     6,    36,   477,    11,
+      60,     5,     6,    63,    29,    30,    31,    32,    33,    12,
+     415,    11,    12,    75,    76,    77,    78,     5,     6,    29,
+     154,     3,     4,     3,   458,   154,    51,     9,     7,     8,
+      10,    62,    12,   458,    73,    97,    94,    13,   100,     3,
+       4,    99,    73,   477,   154,   111,   147,   109,   110,   154,
+     180,   154,   477,   458,   112,     3,     4,   123,   124,   125,
+     213,     9,   155,     3,     4,     5,     6,   155,   155,   155,
+     132,   154,   477,   226,    62,   154,   229,    43,    44,    45,
+     233,   234,   107,   108,   154,    51,     3,     4,    33,   114,
+     243,    73,     7,     8,     7,     8,     7,     8,   139,   144,
+     145,   154,   164,   165,   166,   154,   131,   132,   133,   134,
+     154,   136,   137,   144,   145,   146,   147,     3,   143,   144,
+       7,     8,   154,   185,   154,   187,   188,   154,   190,    46,
+      47,    48,    49,     7,     8,   197,   198,   154,   200,   201,
+     144,   145,   146,   154,   206,   207,   208,     7,     8,   211,
+     212,   176,   214,   215,    74,   217,   144,   145,   146,     7,
+       8,   223,   224,   221,   154,   227,   228,   225,   230,   231,
+     236,   154,   325,     7,     8,    42,   238,   239,   240,   241,
+       7,     8,   244,   245,   246,   247,   248,   249,   250,   251,
+       3,   253,   154,    43,    44,   220,   154,    47,   154,    49,
+     488,   489,   154,   154,   154,   154,    56,    57,    52,    53,
+     154,    55,   365,    57,    58,    59,    60,    61,    62,    63,
+      64,    65,    66,   154,   154,   154,   154,   154,     3,     3,
+     292,   293,   294,   154,    74,    79,   155,    34,   154,    74,
+     154,    74,   304,    93,   302,   154,   154,   305,   154,   154,
+     154,   101,   102,   103,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,   113,   326,   154,   156,    74,   156,   154,
+     154,   121,   122,   154,   154,   300,   154,   154,   157,   154,
+     433,   157,   154,    10,    12,   135,   427,   476,    61,    52,
+      53,   408,    55,   318,    57,    58,    59,    60,    61,    62,
+      63,    64,    65,    66,   384,   311,   460,   190,   473,   461,
+     154,   474,    -1,    -1,   442,    -1,    79,    -1,    -1,    -1,
+      -1,   387,   388,    -1,   390,   391,    -1,    -1,   178,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,   396,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,   499,   409,    11,    -1,
+      -1,    14,    15,    -1,   204,   205,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,   425,    -1,   423,   424,   429,    -1,    -1,
+     432,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+     442,   406,    -1,    -1,    -1,    -1,    -1,    52,    53,    -1,
+      55,   154,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,   464,   465,   466,   467,   468,    -1,   470,   471,
+      -1,    -1,    -1,    -1,    79,    -1,    -1,   442,    81,    82,
+      83,    -1,    -1,    -1,   486,   487,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,   495,   496,    -1,    -1,    -1,    -1,   501,
+     502,    -1,    -1,    -1,   506,   507,   508,   509,    11,    -1,
+      -1,    14,    15,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,   312,   313,    -1,   315,   316,   130,   131,   132,
+     133,   134,   135,   136,   137,   138,    -1,   140,   141,   142,
+     143,    -1,    -1,    -1,    -1,   148,   149,    11,    -1,    -1,
+      14,    15,    -1,    -1,   157,    19,    20,    21,    22,    23,
+      24,    25,    26,    27,    28,    -1,    30,    31,    32,    -1,
+      -1,    35,    -1,    37,    38,    39,    40,    41,    81,    82,
+      83,    11,    -1,    -1,    14,    15,    50,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    28,    -1,
+      30,    31,    32,    -1,    -1,    35,    -1,    37,    38,    39,
+      40,    41,    -1,    -1,    -1,    -1,    -1,    81,    82,    83,
+      50,    -1,    -1,    -1,    -1,    -1,    -1,   130,   131,   132,
+     133,   134,   135,   136,   137,   138,    -1,   140,   141,   142,
+     143,    -1,    -1,    -1,    -1,   148,   149,    -1,    -1,    -1,
+      -1,    81,    82,    83,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,   130,   131,   132,   133,
+     134,   135,   136,   137,   138,    -1,   140,   141,   142,   143,
+       3,     4,    -1,    -1,   148,   149,     9,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+     130,   131,   132,   133,   134,   135,   136,   137,   138,    -1,
+     140,   141,   142,   143,    -1,    -1,    -1,    -1,   148,   149,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    52,
+      53,    -1,    55,    -1,    57,    58,    59,    60,    61,    62,
+      63,    64,    65,    66,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    79,    84,    85,    86,
+      87,    88,    89,    90,    91,    92,    93,    94,    95,    96,
+      97,    98,    99,   100,   101,   102,   103,   104,   105,   106,
+     107,   108,   109,   110,   111,   112,   113,   114,   115,   116,
+     117,   118,   119,   120,   121,   122,   123,   124,   125,   126,
+     127,   128,   129,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    52,    53,    -1,    55,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,   150,   151,   152,   153,    67,    68,    69,
+      70,    71,    72,    73,    -1,    75,    76,    77,    78,    -1,
+      80
 };
 
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_uint8 yystos[] =
+{
+       0,    10,   159,   160,     5,     6,   235,     0,    11,   161,
+     162,   165,   166,   235,   161,    12,   165,   163,    14,    15,
+      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      30,    31,    32,    35,    37,    38,    39,    40,    41,    50,
+      81,    82,    83,   130,   131,   132,   133,   134,   135,   136,
+     137,   138,   140,   141,   142,   143,   148,   149,   164,   166,
+     167,   168,   169,   170,   171,   180,   188,   194,   197,   235,
+     235,     7,     8,     3,     4,   234,   144,   145,   146,   230,
+     235,   234,   234,     7,     8,     7,     8,   234,   235,   235,
+     235,   235,   235,     9,    73,   228,   229,   234,   228,   228,
+     200,    52,    53,    55,    57,    58,    59,    60,    61,    62,
+      63,    64,    65,    66,    79,   214,   219,   154,   189,   190,
+     191,   214,   214,    52,    53,    55,    67,    68,    69,    70,
+      71,    72,    73,    75,    76,    77,    78,    80,   221,   226,
+     221,   214,   221,   214,   228,   228,   139,   186,   235,   221,
+     221,   221,   221,   214,   214,    13,   154,   169,   167,   169,
+     195,   196,   154,   154,   234,   234,   234,   234,   154,   154,
+     154,   154,   154,   154,   154,   154,   172,   173,   174,   198,
+     203,   214,   228,   154,   154,   234,   154,   228,   229,   209,
+     210,   234,   214,   214,   214,   235,   235,   234,   234,   221,
+     228,   214,   235,   175,    84,    85,    86,    87,    88,    89,
+      90,    91,    92,    93,    94,    95,    96,    97,    98,    99,
+     100,   101,   102,   103,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,   114,   115,   116,   117,   118,   119,
+     120,   121,   122,   123,   124,   125,   126,   127,   128,   129,
+     150,   151,   152,   153,   192,   193,   154,   154,   154,   214,
+     154,   214,   221,   221,   221,     3,   235,   233,   234,   235,
+     235,   235,   214,   235,   235,   154,   154,   154,   154,   235,
+     235,   183,   154,   187,   154,   154,   154,   154,   154,   154,
+     154,   154,   234,   234,   234,    29,   176,   235,   154,   214,
+      33,   204,    36,   213,   229,    74,   234,   234,   234,   201,
+     209,   211,    54,   155,   215,    56,   155,   217,   220,   234,
+     234,   234,   234,    42,   178,   214,   214,   234,   234,   234,
+       7,     8,   144,   145,   234,   234,   230,   234,   234,     7,
+       8,   234,     7,     8,     7,     8,   235,   228,     7,     8,
+     234,   234,   228,   230,   234,   234,   230,   234,   234,     7,
+       8,   230,   230,     7,     8,   221,     3,   234,   234,   234,
+     234,     3,   230,   234,   234,   234,   234,   234,   234,   234,
+     234,     3,   234,   154,   155,   154,   154,    54,   155,   222,
+      56,   155,   224,   227,   182,   181,    74,   184,   154,   234,
+     234,   234,   154,   177,   154,   235,    34,   205,   206,   228,
+     154,   234,   228,   154,   154,   156,   212,   212,   214,   214,
+     214,   214,   235,    43,    44,    45,    51,   179,   154,    62,
+     230,   234,    62,    73,   147,   230,   231,   192,   221,   221,
+     221,   221,    74,   154,   154,   228,   154,   154,   154,   235,
+     199,   205,   234,   157,   180,   188,   194,   207,   208,   202,
+     216,   218,   228,   228,    46,    47,    48,    49,   234,   178,
+     234,   234,   230,   223,   225,   233,   185,   156,   157,   207,
+     154,   215,   217,   234,   234,   234,   234,   234,   234,   234,
+     232,   222,   224,   184,   207,   234,   234,   231,   231,    74,
+     157,   234,   234,   230,   154,   234,   234,   234,   234,   234,
+     234
+};
 
-#define	YYLAST		786
-
-
-static const short yytable[] = {    71,
-   300,    77,    78,   371,   303,    83,   374,    94,    95,     3,
-     4,   182,   417,     1,     5,   113,     3,     4,   324,    11,
-     6,   140,   141,   290,     3,     4,     3,     4,   463,    65,
-    66,   341,     3,     4,   344,     3,     4,    13,   349,   350,
-    84,    85,    86,    87,    88,   149,   438,   478,   360,   439,
-   158,   159,   160,   161,     6,   -11,   283,    69,    70,   136,
-    90,   138,   144,    89,   176,   145,   146,   147,   148,   181,
-   440,   150,   179,   413,   151,   185,   156,   153,   157,   407,
-   408,   409,   194,   416,   191,   192,   418,   410,   162,   438,
-   292,   163,   439,   164,   417,   301,    10,   304,   372,   375,
-    69,    70,    10,   165,    10,   166,    89,   258,   438,    67,
-    68,   439,   167,   440,    69,    70,   189,   190,    69,    70,
-     3,     4,   193,   196,   414,    79,    80,    90,    81,    82,
-   318,   319,   440,   168,   252,   253,   254,   280,   281,   282,
-   256,   259,   260,   261,   169,   263,   264,   177,    72,    73,
-    74,   255,   269,   270,   178,    72,    73,    74,   294,   288,
-   295,   296,   180,   185,   419,    72,    73,    74,   418,   142,
-   307,   308,   246,   309,   310,   320,   321,   327,   328,   315,
-   316,   317,   247,   285,   322,   323,   265,   325,   326,   335,
-   329,    69,    70,   340,   330,   331,   338,   339,   481,   482,
-   342,   343,     6,   345,   346,    16,    17,   332,   333,   336,
-   337,   355,   356,   357,   358,   347,   348,   361,   362,   363,
-   364,   365,   366,   351,   352,   266,   267,   334,   456,   268,
-   272,   274,   275,   276,   448,   449,   450,   451,   277,   278,
-   117,   118,   293,   279,   137,   353,   139,    18,    19,    20,
-    21,    22,    23,    24,    25,    26,   286,   311,   354,   383,
-   384,   385,   359,   368,   393,   367,   380,   396,   369,   390,
-   370,   395,    38,    39,    40,   382,   386,   388,   394,   397,
-   398,   426,   412,   399,   427,   428,   430,     6,   175,   431,
-    16,    17,   432,   415,   487,   -76,   186,   187,   188,   461,
-   464,   389,   462,   483,   484,   488,   496,   497,   195,    12,
-    14,   152,   453,   477,   435,   421,   249,   251,   465,   406,
-   466,    41,    42,    43,    44,    45,    46,    47,    48,    49,
-   262,    50,    51,    52,    53,   475,   401,   476,    97,    98,
-   298,    99,   437,   100,   101,   102,   103,   104,   105,   106,
-   107,   108,   109,   459,   429,     0,     0,    38,    39,    40,
-     0,     0,     0,     0,     0,   110,     0,     0,     0,     0,
-     0,   287,   436,     0,     0,     0,     0,     0,     0,     0,
-     0,   446,   447,     0,     0,     0,   422,   423,   452,   424,
-   425,     0,   454,     0,     0,   455,     0,   313,   314,     0,
-     0,     0,     0,   433,     0,   258,    41,    42,    43,    44,
-    45,    46,    47,    48,    49,     0,    50,    51,    52,    53,
-     0,     0,     0,     0,     0,     0,     0,   467,   468,   469,
-   470,   471,     0,   472,   473,     0,     0,     0,     0,   259,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,   479,
-   480,     0,     0,     0,     0,     0,     0,     0,   485,   486,
-     0,     0,     0,     0,   489,   490,     0,     0,     0,   491,
-   492,   493,   494,     0,     0,     0,     0,     0,     0,    97,
-    98,     0,    99,     0,   100,   101,   102,   103,   104,   105,
-   106,   107,   108,   109,     0,     0,     0,     0,     0,   402,
-   403,     6,   404,   405,    16,    17,   110,     0,     0,    18,
-    19,    20,    21,    22,    23,    24,    25,    26,    27,     0,
-    28,    29,    30,     0,     0,    31,     0,    32,    33,    34,
-    35,    36,     0,     0,     0,     6,     0,     0,    16,    17,
-    37,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,    27,     0,    28,    29,    30,     0,     0,    31,
-     0,    32,    33,    34,    35,    36,     0,     0,     0,     0,
-     0,    38,    39,    40,    37,   248,     0,    97,    98,     0,
-    99,     0,   100,   101,   102,   103,   104,   105,   106,   107,
-   108,   109,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,   110,    38,    39,    40,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-    41,    42,    43,    44,    45,    46,    47,    48,    49,     0,
-    50,    51,    52,    53,    69,    70,     0,     0,     0,     0,
-    89,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,     0,    41,    42,    43,    44,    45,    46,
-    47,    48,    49,     0,    50,    51,    52,    53,     0,     0,
-     0,     0,     0,   250,     0,     0,     0,     0,     0,     0,
-     0,     0,     0,    97,    98,     0,    99,     0,   100,   101,
-   102,   103,   104,   105,   106,   107,   108,   109,     0,     0,
-     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-   110,   198,   199,   200,   201,   202,   203,   204,   205,   206,
-   207,   208,   209,   210,   211,   212,   213,   214,   215,   216,
-   217,   218,   219,   220,   221,   222,   223,   224,   225,   226,
-   227,   228,   229,   230,   231,   232,   233,   234,   235,   236,
-   237,   238,   239,   240,   241,   242,   243,   119,   120,     0,
-   121,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     0,     0,   122,   123,   124,   125,   126,   127,   128,     0,
-   129,   130,   131,   132,     0,   133
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_uint8 yyr1[] =
+{
+       0,   158,   159,   160,   160,   161,   161,   163,   162,   164,
+     164,   165,   165,   166,   167,   167,   168,   168,   168,   168,
+     168,   168,   168,   168,   168,   168,   168,   168,   169,   169,
+     170,   170,   170,   170,   170,   172,   171,   173,   171,   174,
+     171,   175,   171,   171,   177,   176,   176,   178,   178,   179,
+     179,   179,   179,   179,   179,   179,   179,   180,   180,   180,
+     180,   180,   180,   180,   180,   180,   180,   181,   180,   182,
+     180,   183,   180,   180,   180,   180,   180,   180,   184,   185,
+     184,   186,   187,   186,   189,   188,   190,   188,   191,   188,
+     192,   192,   193,   193,   193,   193,   193,   193,   193,   193,
+     193,   193,   193,   193,   193,   193,   193,   193,   193,   193,
+     193,   193,   193,   193,   193,   193,   193,   193,   193,   193,
+     193,   193,   193,   193,   193,   193,   193,   193,   193,   193,
+     193,   193,   193,   193,   193,   193,   193,   193,   193,   193,
+     193,   193,   193,   193,   193,   193,   193,   193,   193,   193,
+     193,   193,   193,   195,   194,   196,   194,   194,   198,   199,
+     197,   200,   201,   202,   197,   203,   197,   197,   197,   197,
+     197,   197,   204,   204,   205,   205,   206,   207,   207,   208,
+     208,   208,   209,   209,   211,   210,   212,   212,   213,   213,
+     213,   214,   214,   214,   214,   215,   216,   215,   217,   218,
+     217,   219,   220,   219,   219,   219,   219,   219,   219,   219,
+     219,   219,   219,   221,   221,   221,   221,   222,   223,   222,
+     224,   225,   224,   226,   226,   227,   226,   226,   226,   226,
+     226,   226,   226,   226,   226,   226,   228,   228,   229,   230,
+     230,   230,   230,   232,   231,   231,   233,   233,   234,   234,
+     235,   235
 };
 
-static const short yycheck[] = {    20,
-    54,    22,    23,    54,    56,    26,    56,    33,    34,     5,
-     6,    95,    73,    10,     1,   148,     5,     6,   207,     6,
-    11,    47,    48,    36,     5,     6,     5,     6,   442,    16,
-    17,   220,     5,     6,   223,     5,     6,    12,   227,   228,
-    27,    28,    29,    30,    31,    13,   399,   461,   237,   399,
-    71,    72,    73,    74,    11,    12,    29,     3,     4,    44,
-    73,    46,    49,     9,    90,    50,    51,    52,    53,    95,
-   399,   148,    93,    62,    56,    96,   148,    59,   148,    43,
-    44,    45,   108,    62,   105,   106,   147,    51,   148,   442,
-   174,   148,   442,   148,    73,   149,     2,   149,   149,   149,
-     3,     4,     8,   148,    10,   148,     9,   128,   461,     7,
-     8,   461,   148,   442,     3,     4,   103,   104,     3,     4,
-     5,     6,   107,   110,   313,     7,     8,    73,     7,     8,
-     7,     8,   461,   148,   119,   120,   121,   158,   159,   160,
-   127,   128,   129,   130,   148,   132,   133,   148,   144,   145,
-   146,     3,   139,   140,   148,   144,   145,   146,   179,    33,
-   181,   182,   148,   184,   353,   144,   145,   146,   147,   139,
-   191,   192,   148,   194,   195,   144,   145,     7,     8,   200,
-   201,   202,   148,   170,   205,   206,   148,   208,   209,   215,
-   211,     3,     4,   219,     7,     8,   217,   218,   472,   473,
-   221,   222,    11,   224,   225,    14,    15,     7,     8,     7,
-     8,   232,   233,   234,   235,     7,     8,   238,   239,   240,
-   241,   242,   243,     7,     8,   148,   148,   214,   417,   148,
-   148,   148,   148,   148,    46,    47,    48,    49,   148,   148,
-    41,    42,    74,   148,    45,   230,    47,    19,    20,    21,
-    22,    23,    24,    25,    26,    27,   148,    42,     3,   280,
-   281,   282,     3,   149,   290,   148,    74,   293,   148,    34,
-   148,   292,    81,    82,    83,   148,   148,   148,   148,   148,
-   148,    74,   148,   150,   148,   148,   148,    11,    89,   148,
-    14,    15,   148,   314,   483,    74,    97,    98,    99,   150,
-   148,   288,   151,    74,   151,   148,     0,     0,   109,     8,
-    10,    57,   411,   460,   392,   368,   117,   118,   444,   306,
-   445,   130,   131,   132,   133,   134,   135,   136,   137,   138,
-   131,   140,   141,   142,   143,   457,   299,   458,    52,    53,
-   184,    55,   151,    57,    58,    59,    60,    61,    62,    63,
-    64,    65,    66,   426,   380,    -1,    -1,    81,    82,    83,
-    -1,    -1,    -1,    -1,    -1,    79,    -1,    -1,    -1,    -1,
-    -1,   172,   393,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-    -1,   407,   408,    -1,    -1,    -1,   371,   372,   409,   374,
-   375,    -1,   413,    -1,    -1,   416,    -1,   198,   199,    -1,
-    -1,    -1,    -1,   390,    -1,   426,   130,   131,   132,   133,
-   134,   135,   136,   137,   138,    -1,   140,   141,   142,   143,
-    -1,    -1,    -1,    -1,    -1,    -1,    -1,   448,   449,   450,
-   451,   452,    -1,   454,   455,    -1,    -1,    -1,    -1,   426,
-    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,   470,
-   471,    -1,    -1,    -1,    -1,    -1,    -1,    -1,   479,   480,
-    -1,    -1,    -1,    -1,   485,   486,    -1,    -1,    -1,   490,
-   491,   492,   493,    -1,    -1,    -1,    -1,    -1,    -1,    52,
-    53,    -1,    55,    -1,    57,    58,    59,    60,    61,    62,
-    63,    64,    65,    66,    -1,    -1,    -1,    -1,    -1,   300,
-   301,    11,   303,   304,    14,    15,    79,    -1,    -1,    19,
-    20,    21,    22,    23,    24,    25,    26,    27,    28,    -1,
-    30,    31,    32,    -1,    -1,    35,    -1,    37,    38,    39,
-    40,    41,    -1,    -1,    -1,    11,    -1,    -1,    14,    15,
-    50,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-    -1,    -1,    28,    -1,    30,    31,    32,    -1,    -1,    35,
-    -1,    37,    38,    39,    40,    41,    -1,    -1,    -1,    -1,
-    -1,    81,    82,    83,    50,   148,    -1,    52,    53,    -1,
-    55,    -1,    57,    58,    59,    60,    61,    62,    63,    64,
-    65,    66,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-    -1,    -1,    -1,    -1,    79,    81,    82,    83,    -1,    -1,
-    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-   130,   131,   132,   133,   134,   135,   136,   137,   138,    -1,
-   140,   141,   142,   143,     3,     4,    -1,    -1,    -1,    -1,
-     9,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-    -1,    -1,    -1,    -1,   130,   131,   132,   133,   134,   135,
-   136,   137,   138,    -1,   140,   141,   142,   143,    -1,    -1,
-    -1,    -1,    -1,   148,    -1,    -1,    -1,    -1,    -1,    -1,
-    -1,    -1,    -1,    52,    53,    -1,    55,    -1,    57,    58,
-    59,    60,    61,    62,    63,    64,    65,    66,    -1,    -1,
-    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-    79,    84,    85,    86,    87,    88,    89,    90,    91,    92,
-    93,    94,    95,    96,    97,    98,    99,   100,   101,   102,
-   103,   104,   105,   106,   107,   108,   109,   110,   111,   112,
-   113,   114,   115,   116,   117,   118,   119,   120,   121,   122,
-   123,   124,   125,   126,   127,   128,   129,    52,    53,    -1,
-    55,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-    -1,    -1,    67,    68,    69,    70,    71,    72,    73,    -1,
-    75,    76,    77,    78,    -1,    80
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     2,     0,     1,     2,     0,     5,     2,
+       1,     2,     0,     2,     1,     2,     1,     3,     3,     6,
+       3,     3,     3,     3,     3,     3,     3,     3,     1,     2,
+       1,     1,     1,     1,     1,     0,     4,     0,     4,     0,
+       5,     0,     5,     2,     0,     3,     2,     2,     3,     2,
+       2,     3,     3,     3,     6,    10,     1,     3,     3,     4,
+       3,     4,     3,     3,     3,     3,     3,     0,     5,     0,
+       5,     0,     5,     3,     2,     3,     3,     3,     2,     0,
+       4,     2,     0,     3,     0,     4,     0,     3,     0,     3,
+       1,     3,     2,     3,     6,     3,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     3,     6,     3,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     0,     4,     0,     4,     2,     0,     0,
+      10,     0,     0,     0,     7,     0,     5,     3,     3,     3,
+       5,     5,     2,     0,     2,     0,     2,     1,     2,     1,
+       1,     1,     1,     2,     0,     3,     2,     3,     1,     2,
+       3,     2,     3,     3,     1,     2,     0,     4,     2,     0,
+       4,     2,     0,     4,     3,     3,     2,     3,     3,     1,
+       1,     1,     2,     2,     3,     3,     1,     2,     0,     4,
+       2,     0,     4,     2,     2,     0,     5,     2,     2,     2,
+       2,     1,     1,     1,     1,     2,     2,     3,     4,     4,
+       4,     2,     1,     0,     5,     1,     1,     1,     1,     1,
+       1,     1
 };
-/* -*-C-*-  Note some compilers choke on comments on `#line' lines.  */
-#line 3 "/usr/freeware/share/bison.simple"
 
-/* Skeleton output parser for bison,
-   Copyright (C) 1984, 1989, 1990 Free Software Foundation, Inc.
 
-   This program is free software; you can redistribute it and/or modify
-   it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-   This program is distributed in the hope that it will be useful,
-   but WITHOUT ANY WARRANTY; without even the implied warranty of
-   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-   GNU General Public License for more details.
 
-   You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.  */
-
-/* As a special exception, when this file is copied by Bison into a
-   Bison output file, you may use that output file without restriction.
-   This special exception was added by the Free Software Foundation
-   in version 1.24 of Bison.  */
-
-#ifndef alloca
-#ifdef __GNUC__
-#define alloca __builtin_alloca
-#else /* not GNU C.  */
-#if (!defined (__STDC__) && defined (sparc)) || defined (__sparc__) || defined (__sparc) || defined (__sgi)
-#include <alloca.h>
-#else /* not sparc */
-#if defined (MSDOS) && !defined (__TURBOC__)
-#include <malloc.h>
-#else /* not MSDOS, or __TURBOC__ */
-#if defined(_AIX)
-#include <malloc.h>
- #pragma alloca
-#else /* not MSDOS, __TURBOC__, or _AIX */
-#ifdef __hpux
-#ifdef __cplusplus
-extern "C" {
-void *alloca (unsigned int);
-};
-#else /* not __cplusplus */
-void *alloca ();
-#endif /* not __cplusplus */
-#endif /* __hpux */
-#endif /* not _AIX */
-#endif /* not MSDOS, or __TURBOC__ */
-#endif /* not sparc.  */
-#endif /* not GNU C.  */
-#endif /* alloca not defined.  */
-
-/* This is the parser code that is written into each bison parser
-  when the %semantic_parser declaration is not specified in the grammar.
-  It was written by Richard Stallman by simplifying the hairy parser
-  used when %semantic_parser is specified.  */
-
-/* Note: there must be only one dollar sign in this file.
-   It is replaced by the list of actions, each action
-   as one case of the switch.  */
-
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		-2
-#define YYEOF		0
-#define YYACCEPT	return(0)
-#define YYABORT 	return(1)
-#define YYERROR		goto yyerrlab1
-/* Like YYERROR except do call yyerror.
-   This remains here temporarily to ease the
-   transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
-#define YYFAIL		goto yyerrlab
 #define YYRECOVERING()  (!!yyerrstatus)
-#define YYBACKUP(token, value) \
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    { yychar = (token), yylval = (value);			\
-      yychar1 = YYTRANSLATE (yychar);				\
-      YYPOPSTACK;						\
-      goto yybackup;						\
-    }								\
-  else								\
-    { yyerror ("syntax error: cannot back up"); YYERROR; }	\
-while (0)
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
-#ifndef YYPURE
-#define YYLEX		yylex()
-#endif
 
-#ifdef YYPURE
-#ifdef YYLSP_NEEDED
-#ifdef YYLEX_PARAM
-#define YYLEX		yylex(&yylval, &yylloc, YYLEX_PARAM)
-#else
-#define YYLEX		yylex(&yylval, &yylloc)
-#endif
-#else /* not YYLSP_NEEDED */
-#ifdef YYLEX_PARAM
-#define YYLEX		yylex(&yylval, YYLEX_PARAM)
-#else
-#define YYLEX		yylex(&yylval)
-#endif
-#endif /* not YYLSP_NEEDED */
-#endif
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
 
-/* If nonreentrant, generate the variables here */
 
-#ifndef YYPURE
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-int	yychar;			/*  the lookahead symbol		*/
-YYSTYPE	yylval;			/*  the semantic value of the		*/
-				/*  lookahead symbol			*/
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-#ifdef YYLSP_NEEDED
-YYLTYPE yylloc;			/*  location data for the lookahead	*/
-				/*  symbol				*/
-#endif
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
 
-int yynerrs;			/*  number of parse errors so far       */
-#endif  /* not YYPURE */
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
 
-#if YYDEBUG != 0
-int yydebug;			/*  nonzero means print parse trace	*/
-/* Since this is uninitialized, it does not stop multiple parsers
-   from coexisting.  */
-#endif
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
 
-/*  YYINITDEPTH indicates the initial size of the parser's stacks	*/
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
-#ifndef	YYINITDEPTH
-#define YYINITDEPTH 200
-#endif
 
-/*  YYMAXDEPTH is the maximum size the stacks can grow to
-    (effective only if the built-in stack extension method is used).  */
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
 
-#if YYMAXDEPTH == 0
-#undef YYMAXDEPTH
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
 #endif
 
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
 #ifndef YYMAXDEPTH
-#define YYMAXDEPTH 10000
+# define YYMAXDEPTH 10000
 #endif
 
-/* Prevent warning if -Wstrict-prototypes.  */
-#ifdef __GNUC__
-int yyparse (void);
-#endif
-
-#if __GNUC__ > 1		/* GNU C and GNU C++ define this.  */
-#define __yy_memcpy(FROM,TO,COUNT)	__builtin_memcpy(TO,FROM,COUNT)
-#else				/* not GNU C or C++ */
-#ifndef __cplusplus
-
-/* This is the most reliable way to avoid incompatibilities
-   in available built-in functions on various systems.  */
-static void
-__yy_memcpy (from, to, count)
-     char *from;
-     char *to;
-     int count;
-{
-  register char *f = from;
-  register char *t = to;
-  register int i = count;
 
-  while (i-- > 0)
-    *t++ = *f++;
-}
 
-#else /* __cplusplus */
 
-/* This is the most reliable way to avoid incompatibilities
-   in available built-in functions on various systems.  */
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
 static void
-__yy_memcpy (char *from, char *to, int count)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  register char *f = from;
-  register char *t = to;
-  register int i = count;
-
-  while (i-- > 0)
-    *t++ = *f++;
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
-#endif
-#endif
-
-#line 192 "/usr/freeware/share/bison.simple"
 
-/* The user can define YYPARSE_PARAM as the name of an argument to be passed
-   into yyparse.  The argument should have type void *.
-   It should actually point to an object.
-   Grammar actions can access the variable by casting it
-   to the proper pointer type.  */
+/* Lookahead token kind.  */
+int yychar;
 
-#ifdef YYPARSE_PARAM
-#define YYPARSE_PARAM_DECL void *YYPARSE_PARAM;
-#else
-#define YYPARSE_PARAM
-#define YYPARSE_PARAM_DECL
-#endif
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
 
 int
-yyparse(YYPARSE_PARAM)
-     YYPARSE_PARAM_DECL
+yyparse (void)
 {
-  register int yystate;
-  register int yyn;
-  register short *yyssp;
-  register YYSTYPE *yyvsp;
-  int yyerrstatus;	/*  number of tokens to shift before error messages enabled */
-  int yychar1 = 0;		/*  lookahead token as an internal (translated) token number */
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-  short	yyssa[YYINITDEPTH];	/*  the state stack			*/
-  YYSTYPE yyvsa[YYINITDEPTH];	/*  the semantic value stack		*/
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
-  short *yyss = yyssa;		/*  refer to the stacks thru separate pointers */
-  YYSTYPE *yyvs = yyvsa;	/*  to allow yyoverflow to reallocate them elsewhere */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-#ifdef YYLSP_NEEDED
-  YYLTYPE yylsa[YYINITDEPTH];	/*  the location stack			*/
-  YYLTYPE *yyls = yylsa;
-  YYLTYPE *yylsp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-#define YYPOPSTACK   (yyvsp--, yyssp--, yylsp--)
-#else
-#define YYPOPSTACK   (yyvsp--, yyssp--)
-#endif
-
-  int yystacksize = YYINITDEPTH;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-#ifdef YYPURE
-  int yychar;
-  YYSTYPE yylval;
-  int yynerrs;
-#ifdef YYLSP_NEEDED
-  YYLTYPE yylloc;
-#endif
-#endif
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
 
-  YYSTYPE yyval;		/*  the variable used to return		*/
-				/*  semantic values from the action	*/
-				/*  routines				*/
 
-  int yylen;
 
-#if YYDEBUG != 0
-  if (yydebug)
-    fprintf(stderr, "Starting parse\n");
-#endif
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY;		/* Cause a token to be read.  */
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
 
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
+  YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yyssp = yyss - 1;
-  yyvsp = yyvs;
-#ifdef YYLSP_NEEDED
-  yylsp = yyls;
-#endif
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
-/* Push a new state, which is found in  yystate  .  */
-/* In all cases, when you get here, the value and location stacks
-   have just been pushed. so pushing a state here evens the stacks.  */
-yynewstate:
+  goto yysetstate;
 
-  *++yyssp = yystate;
 
-  if (yyssp >= yyss + yystacksize - 1)
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
-      /* Give user a chance to reallocate the stack */
-      /* Use copies of these so that the &'s don't force the real ones into memory. */
-      YYSTYPE *yyvs1 = yyvs;
-      short *yyss1 = yyss;
-#ifdef YYLSP_NEEDED
-      YYLTYPE *yyls1 = yyls;
-#endif
-
       /* Get the current used size of the three stacks, in elements.  */
-      int size = yyssp - yyss + 1;
-
-#ifdef yyoverflow
-      /* Each stack pointer address is followed by the size of
-	 the data in use in that stack, in bytes.  */
-#ifdef YYLSP_NEEDED
-      /* This used to be a conditional around just the two extra args,
-	 but that might be undefined if yyoverflow is a macro.  */
-      yyoverflow("parser stack overflow",
-		 &yyss1, size * sizeof (*yyssp),
-		 &yyvs1, size * sizeof (*yyvsp),
-		 &yyls1, size * sizeof (*yylsp),
-		 &yystacksize);
-#else
-      yyoverflow("parser stack overflow",
-		 &yyss1, size * sizeof (*yyssp),
-		 &yyvs1, size * sizeof (*yyvsp),
-		 &yystacksize);
-#endif
-
-      yyss = yyss1; yyvs = yyvs1;
-#ifdef YYLSP_NEEDED
-      yyls = yyls1;
-#endif
-#else /* no yyoverflow */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
-      if (yystacksize >= YYMAXDEPTH)
-	{
-	  yyerror("parser stack overflow");
-	  return 2;
-	}
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
       yystacksize *= 2;
-      if (yystacksize > YYMAXDEPTH)
-	yystacksize = YYMAXDEPTH;
-      yyss = (short *) alloca (yystacksize * sizeof (*yyssp));
-      __yy_memcpy ((char *)yyss1, (char *)yyss, size * sizeof (*yyssp));
-      yyvs = (YYSTYPE *) alloca (yystacksize * sizeof (*yyvsp));
-      __yy_memcpy ((char *)yyvs1, (char *)yyvs, size * sizeof (*yyvsp));
-#ifdef YYLSP_NEEDED
-      yyls = (YYLTYPE *) alloca (yystacksize * sizeof (*yylsp));
-      __yy_memcpy ((char *)yyls1, (char *)yyls, size * sizeof (*yylsp));
-#endif
-#endif /* no yyoverflow */
-
-      yyssp = yyss + size - 1;
-      yyvsp = yyvs + size - 1;
-#ifdef YYLSP_NEEDED
-      yylsp = yyls + size - 1;
-#endif
-
-#if YYDEBUG != 0
-      if (yydebug)
-	fprintf(stderr, "Stack size increased to %d\n", yystacksize);
-#endif
-
-      if (yyssp >= yyss + yystacksize - 1)
-	YYABORT;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-#if YYDEBUG != 0
-  if (yydebug)
-    fprintf(stderr, "Entering state %d\n", yystate);
-#endif
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
   goto yybackup;
- yybackup:
 
-/* Do appropriate processing given the current state.  */
-/* Read a lookahead token if we need one and don't already have one.  */
-/* yyresume: */
 
-  /* First try to decide what to do without reference to lookahead token.  */
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
 
+  /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYFLAG)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* yychar is either YYEMPTY or YYEOF
-     or a valid token in external form.  */
-
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-#if YYDEBUG != 0
-      if (yydebug)
-	fprintf(stderr, "Reading a token: ");
-#endif
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
     }
 
-  /* Convert token to internal form (in yychar1) for indexing tables with */
-
-  if (yychar <= 0)		/* This means end of input. */
+  if (yychar <= YYEOF)
     {
-      yychar1 = 0;
-      yychar = YYEOF;		/* Don't call YYLEX any more */
-
-#if YYDEBUG != 0
-      if (yydebug)
-	fprintf(stderr, "Now at end of input.\n");
-#endif
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
     }
   else
     {
-      yychar1 = YYTRANSLATE(yychar);
-
-#if YYDEBUG != 0
-      if (yydebug)
-	{
-	  fprintf (stderr, "Next token is %d (%s", yychar, yytname[yychar1]);
-	  /* Give the individual parser a way to print the precise meaning
-	     of a token, for further debugging info.  */
-#ifdef YYPRINT
-	  YYPRINT (stderr, yychar, yylval);
-#endif
-	  fprintf (stderr, ")\n");
-	}
-#endif
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
     }
 
-  yyn += yychar1;
-  if (yyn < 0 || yyn > YYLAST || yycheck[yyn] != yychar1)
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
     goto yydefault;
-
   yyn = yytable[yyn];
-
-  /* yyn is what to do for this token type in this state.
-     Negative => reduce, -yyn is rule number.
-     Positive => shift, yyn is new state.
-       New state is final state => don't bother to shift,
-       just return success.
-     0, or most negative number => error.  */
-
-  if (yyn < 0)
+  if (yyn <= 0)
     {
-      if (yyn == YYFLAG)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
-  else if (yyn == 0)
-    goto yyerrlab;
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
 
   /* Shift the lookahead token.  */
-
-#if YYDEBUG != 0
-  if (yydebug)
-    fprintf(stderr, "Shifting token %d (%s), ", yychar, yytname[yychar1]);
-#endif
-
-  /* Discard the token being shifted unless it is eof.  */
-  if (yychar != YYEOF)
-    yychar = YYEMPTY;
-
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
-#ifdef YYLSP_NEEDED
-  *++yylsp = yylloc;
-#endif
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
-  /* count tokens shifted since error; after three, turn off error status.  */
-  if (yyerrstatus) yyerrstatus--;
-
-  yystate = yyn;
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
-/* Do the default action for the current state.  */
-yydefault:
 
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
   yyn = yydefact[yystate];
   if (yyn == 0)
     goto yyerrlab;
+  goto yyreduce;
+
 
-/* Do a reduction.  yyn is the number of a rule to reduce with.  */
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
 yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
-  if (yylen > 0)
-    yyval = yyvsp[1-yylen]; /* implement default value of the action */
-
-#if YYDEBUG != 0
-  if (yydebug)
-    {
-      int i;
 
-      fprintf (stderr, "Reducing via rule %d (line %d), ",
-	       yyn, yyrline[yyn]);
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
 
-      /* Print the symbols being reduced, and their result.  */
-      for (i = yyprhs[yyn]; yyrhs[i] > 0; i++)
-	fprintf (stderr, "%s ", yytname[yyrhs[i]]);
-      fprintf (stderr, " -> %s\n", yytname[yyr1[yyn]]);
-    }
-#endif
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
 
 
-  switch (yyn) {
-
-case 2:
-#line 66 "molscript.y"
-{ set_title (yytext) ;
-    break;}
-case 6:
-#line 74 "molscript.y"
-{ start_plot() ;
-    break;}
-case 7:
-#line 75 "molscript.y"
-{ output_finish_plot() ;
-    break;}
-case 12:
-#line 85 "molscript.y"
-{ lex_define_macro (yytext) ;
-    break;}
-case 15:
-#line 91 "molscript.y"
-{ frame = FALSE ;
-    break;}
-case 16:
-#line 92 "molscript.y"
-{ frame = FALSE ;
-    break;}
-case 17:
-#line 93 "molscript.y"
-{ frame = TRUE ;
-    break;}
-case 18:
-#line 94 "molscript.y"
-{ set_area() ;
-    break;}
-case 19:
-#line 95 "molscript.y"
-{ set_background() ;
-    break;}
-case 20:
-#line 96 "molscript.y"
-{ set_window() ;
-    break;}
-case 21:
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 3: /* title: TITLE id  */
+#line 78 "molscript.y"
+                 { set_title (yytext); }
+#line 1788 "molscript.tab.c"
+    break;
+
+  case 7: /* $@1: %empty  */
+#line 86 "molscript.y"
+                       { start_plot(); }
+#line 1794 "molscript.tab.c"
+    break;
+
+  case 8: /* plot: macro_defs PLOT $@1 plot_contents END_PLOT  */
+#line 87 "molscript.y"
+                                { output_finish_plot(); }
+#line 1800 "molscript.tab.c"
+    break;
+
+  case 13: /* macro_def: MACRO id  */
 #line 97 "molscript.y"
-{ set_slab() ;
-    break;}
-case 22:
-#line 98 "molscript.y"
-{ headlight = TRUE ;
-    break;}
-case 23:
-#line 99 "molscript.y"
-{ headlight = FALSE ;
-    break;}
-case 24:
-#line 100 "molscript.y"
-{ shadows = TRUE ;
-    break;}
-case 25:
-#line 101 "molscript.y"
-{ shadows = FALSE ;
-    break;}
-case 26:
-#line 102 "molscript.y"
-{ set_fog() ;
-    break;}
-case 34:
-#line 116 "molscript.y"
-{ store_molname (yytext) ;
-    break;}
-case 36:
-#line 117 "molscript.y"
-{ delete_molecule (yytext) ;
-    break;}
-case 38:
-#line 118 "molscript.y"
-{ lex_yytext_push() ;
-    break;}
-case 39:
-#line 119 "molscript.y"
-{ lex_yytext_pop(); copy_molecule (yytext) ;
-    break;}
-case 40:
-#line 120 "molscript.y"
-{ xform_init() ;
-    break;}
-case 41:
-#line 121 "molscript.y"
-{ xform_atoms() ;
-    break;}
-case 42:
-#line 122 "molscript.y"
-{ xform_store() ;
-    break;}
-case 43:
-#line 125 "molscript.y"
-{ read_coordinate_file (yytext) ;
-    break;}
-case 45:
-#line 126 "molscript.y"
-{ read_coordinate_file (NULL) ;
-    break;}
-case 48:
+                     { lex_define_macro (yytext); }
+#line 1806 "molscript.tab.c"
+    break;
+
+  case 16: /* header_command: NOFRAME  */
+#line 103 "molscript.y"
+                                       { frame = FALSE; }
+#line 1812 "molscript.tab.c"
+    break;
+
+  case 17: /* header_command: FRAME OFF ';'  */
+#line 104 "molscript.y"
+                                       { frame = FALSE; }
+#line 1818 "molscript.tab.c"
+    break;
+
+  case 18: /* header_command: FRAME ON ';'  */
+#line 105 "molscript.y"
+                                       { frame = TRUE; }
+#line 1824 "molscript.tab.c"
+    break;
+
+  case 19: /* header_command: AREA number number number number ';'  */
+#line 106 "molscript.y"
+                                                      { set_area(); }
+#line 1830 "molscript.tab.c"
+    break;
+
+  case 20: /* header_command: BACKGROUND colour ';'  */
+#line 107 "molscript.y"
+                                       { set_background(); }
+#line 1836 "molscript.tab.c"
+    break;
+
+  case 21: /* header_command: WINDOW number ';'  */
+#line 108 "molscript.y"
+                                       { set_window(); }
+#line 1842 "molscript.tab.c"
+    break;
+
+  case 22: /* header_command: SLAB number ';'  */
+#line 109 "molscript.y"
+                                       { set_slab(); }
+#line 1848 "molscript.tab.c"
+    break;
+
+  case 23: /* header_command: HEADLIGHT ON ';'  */
+#line 110 "molscript.y"
+                                       { headlight = TRUE; }
+#line 1854 "molscript.tab.c"
+    break;
+
+  case 24: /* header_command: HEADLIGHT OFF ';'  */
+#line 111 "molscript.y"
+                                       { headlight = FALSE; }
+#line 1860 "molscript.tab.c"
+    break;
+
+  case 25: /* header_command: SHADOWS ON ';'  */
+#line 112 "molscript.y"
+                                       { shadows = TRUE; }
+#line 1866 "molscript.tab.c"
+    break;
+
+  case 26: /* header_command: SHADOWS OFF ';'  */
+#line 113 "molscript.y"
+                                       { shadows = FALSE; }
+#line 1872 "molscript.tab.c"
+    break;
+
+  case 27: /* header_command: FOG number ';'  */
+#line 114 "molscript.y"
+                                       { set_fog(); }
+#line 1878 "molscript.tab.c"
+    break;
+
+  case 35: /* $@2: %empty  */
+#line 128 "molscript.y"
+                                 { store_molname (yytext); }
+#line 1884 "molscript.tab.c"
+    break;
+
+  case 37: /* $@3: %empty  */
+#line 129 "molscript.y"
+                                 { delete_molecule (yytext); }
+#line 1890 "molscript.tab.c"
+    break;
+
+  case 39: /* $@4: %empty  */
+#line 130 "molscript.y"
+                        { lex_yytext_push(); }
+#line 1896 "molscript.tab.c"
+    break;
+
+  case 40: /* coord_command: COPY id $@4 atom_selection ';'  */
+#line 131 "molscript.y"
+                  { lex_yytext_pop(); copy_molecule (yytext); }
+#line 1902 "molscript.tab.c"
+    break;
+
+  case 41: /* $@5: %empty  */
+#line 132 "molscript.y"
+                                         { xform_init(); }
+#line 1908 "molscript.tab.c"
+    break;
+
+  case 42: /* coord_command: TRANSFORM atom_selection $@5 xforms ';'  */
 #line 133 "molscript.y"
-{ xform_centre() ;
-    break;}
-case 49:
+                             { xform_atoms(); }
+#line 1914 "molscript.tab.c"
+    break;
+
+  case 43: /* coord_command: STORE_MATRIX ';'  */
 #line 134 "molscript.y"
-{ xform_translation() ;
-    break;}
-case 50:
-#line 135 "molscript.y"
-{ xform_rotation_x() ;
-    break;}
-case 51:
-#line 136 "molscript.y"
-{ xform_rotation_y() ;
-    break;}
-case 52:
+                                 { xform_store(); }
+#line 1920 "molscript.tab.c"
+    break;
+
+  case 44: /* $@6: %empty  */
 #line 137 "molscript.y"
-{ xform_rotation_z() ;
-    break;}
-case 53:
+                 { read_coordinate_file (yytext); }
+#line 1926 "molscript.tab.c"
+    break;
+
+  case 46: /* coordinates: INLINE_PDB ';'  */
 #line 138 "molscript.y"
-{ xform_rotation_axis() ;
-    break;}
-case 54:
-#line 141 "molscript.y"
-{ xform_rotation_matrix() ;
-    break;}
-case 55:
-#line 142 "molscript.y"
-{ xform_recall_matrix() ;
-    break;}
-case 56:
+                             { read_coordinate_file (NULL); }
+#line 1932 "molscript.tab.c"
+    break;
+
+  case 49: /* xform: CENTRE vector  */
 #line 145 "molscript.y"
-{ ball_and_stick (TRUE) ;
-    break;}
-case 57:
+                                      { xform_centre(); }
+#line 1938 "molscript.tab.c"
+    break;
+
+  case 50: /* xform: TRANSLATION vector  */
+#line 146 "molscript.y"
+                                      { xform_translation(); }
+#line 1944 "molscript.tab.c"
+    break;
+
+  case 51: /* xform: ROTATION XAXIS number  */
 #line 147 "molscript.y"
-{ ball_and_stick (FALSE) ;
-    break;}
-case 58:
+                                      { xform_rotation_x(); }
+#line 1950 "molscript.tab.c"
+    break;
+
+  case 52: /* xform: ROTATION YAXIS number  */
 #line 148 "molscript.y"
-{ bonds (TRUE) ;
-    break;}
-case 59:
+                                      { xform_rotation_y(); }
+#line 1956 "molscript.tab.c"
+    break;
+
+  case 53: /* xform: ROTATION ZAXIS number  */
 #line 149 "molscript.y"
-{ bonds (FALSE) ;
-    break;}
-case 60:
+                                      { xform_rotation_z(); }
+#line 1962 "molscript.tab.c"
+    break;
+
+  case 54: /* xform: ROTATION AXIS number number number number  */
 #line 150 "molscript.y"
-{ coil (TRUE, TRUE) ;
-    break;}
-case 61:
-#line 151 "molscript.y"
-{ cylinder() ;
-    break;}
-case 62:
-#line 152 "molscript.y"
-{ cpk() ;
-    break;}
-case 63:
+                                                  { xform_rotation_axis(); }
+#line 1968 "molscript.tab.c"
+    break;
+
+  case 55: /* xform: ROTATION number number number number number number number number number  */
 #line 153 "molscript.y"
-{ coil (FALSE, FALSE) ;
-    break;}
-case 64:
+                                      { xform_rotation_matrix(); }
+#line 1974 "molscript.tab.c"
+    break;
+
+  case 56: /* xform: RECALL_MATRIX  */
 #line 154 "molscript.y"
-{ helix() ;
-    break;}
-case 65:
-#line 155 "molscript.y"
-{ label_position (yytext) ;
-    break;}
-case 67:
-#line 156 "molscript.y"
-{ label_atoms (yytext) ;
-    break;}
-case 69:
-#line 157 "molscript.y"
-{ line_start() ;
-    break;}
-case 70:
+                                      { xform_recall_matrix(); }
+#line 1980 "molscript.tab.c"
+    break;
+
+  case 57: /* geom_command: ACCESSIBLE_SURFACE atom_selection ';'  */
 #line 157 "molscript.y"
-{ output_line (TRUE) ;
-    break;}
-case 72:
-#line 159 "molscript.y"
-{ strand() ;
-    break;}
-case 73:
+                                                     { surface (TRUE); }
+#line 1986 "molscript.tab.c"
+    break;
+
+  case 58: /* geom_command: BALL_AND_STICK atom_selection ';'  */
+#line 158 "molscript.y"
+                                                   { ball_and_stick (TRUE); }
+#line 1992 "molscript.tab.c"
+    break;
+
+  case 59: /* geom_command: BALL_AND_STICK atom_selection atom_selection ';'  */
 #line 160 "molscript.y"
-{ trace() ;
-    break;}
-case 74:
+                                                   { ball_and_stick (FALSE); }
+#line 1998 "molscript.tab.c"
+    break;
+
+  case 60: /* geom_command: BONDS atom_selection ';'  */
 #line 161 "molscript.y"
-{ coil (TRUE, FALSE) ;
-    break;}
-case 75:
+                                                   { bonds (TRUE); }
+#line 2004 "molscript.tab.c"
+    break;
+
+  case 61: /* geom_command: BONDS atom_selection atom_selection ';'  */
+#line 162 "molscript.y"
+                                                       { bonds (FALSE); }
+#line 2010 "molscript.tab.c"
+    break;
+
+  case 62: /* geom_command: COIL residue_selection ';'  */
+#line 163 "molscript.y"
+                                                   { coil (TRUE, TRUE); }
+#line 2016 "molscript.tab.c"
+    break;
+
+  case 63: /* geom_command: CYLINDER residue_selection ';'  */
 #line 164 "molscript.y"
-{ line_next() ;
-    break;}
-case 76:
+                                                   { cylinder(); }
+#line 2022 "molscript.tab.c"
+    break;
+
+  case 64: /* geom_command: CPK atom_selection ';'  */
 #line 165 "molscript.y"
-{ line_next() ;
-    break;}
-case 78:
+                                                   { cpk(); }
+#line 2028 "molscript.tab.c"
+    break;
+
+  case 65: /* geom_command: DOUBLE_HELIX residue_selection ';'  */
+#line 166 "molscript.y"
+                                                   { coil (FALSE, FALSE); }
+#line 2034 "molscript.tab.c"
+    break;
+
+  case 66: /* geom_command: HELIX residue_selection ';'  */
+#line 167 "molscript.y"
+                                                   { helix(); }
+#line 2040 "molscript.tab.c"
+    break;
+
+  case 67: /* $@7: %empty  */
 #line 168 "molscript.y"
-{ object (NULL) ;
-    break;}
-case 79:
-#line 169 "molscript.y"
-{ lex_yytext_push() ;
-    break;}
-case 80:
+                               { label_position (yytext); }
+#line 2046 "molscript.tab.c"
+    break;
+
+  case 69: /* $@8: %empty  */
 #line 169 "molscript.y"
-{ lex_yytext_pop(); object (yytext) ;
-    break;}
-case 81:
-#line 172 "molscript.y"
-{ new_state() ;
-    break;}
-case 83:
+                                       { label_atoms (yytext); }
+#line 2052 "molscript.tab.c"
+    break;
+
+  case 71: /* $@9: %empty  */
+#line 170 "molscript.y"
+                           { line_start(); }
+#line 2058 "molscript.tab.c"
+    break;
+
+  case 72: /* geom_command: LINE vector $@9 lines ';'  */
+#line 170 "molscript.y"
+                                                       { output_line (TRUE); }
+#line 2064 "molscript.tab.c"
+    break;
+
+  case 73: /* geom_command: MOLECULAR_SURFACE atom_selection ';'  */
+#line 171 "molscript.y"
+                                                    { surface (FALSE); }
+#line 2070 "molscript.tab.c"
+    break;
+
+  case 75: /* geom_command: STRAND residue_selection ';'  */
 #line 173 "molscript.y"
-{ push_state() ;
-    break;}
-case 85:
+                                                   { strand(); }
+#line 2076 "molscript.tab.c"
+    break;
+
+  case 76: /* geom_command: TRACE residue_selection ';'  */
 #line 174 "molscript.y"
-{ pop_state() ;
-    break;}
-case 89:
-#line 181 "molscript.y"
-{ set_atomcolour() ;
-    break;}
-case 90:
+                                                   { trace(); }
+#line 2082 "molscript.tab.c"
+    break;
+
+  case 77: /* geom_command: TURN residue_selection ';'  */
+#line 175 "molscript.y"
+                                                   { coil (TRUE, FALSE); }
+#line 2088 "molscript.tab.c"
+    break;
+
+  case 78: /* lines: TO vector  */
+#line 178 "molscript.y"
+                  { line_next(); }
+#line 2094 "molscript.tab.c"
+    break;
+
+  case 79: /* $@10: %empty  */
+#line 179 "molscript.y"
+                  { line_next(); }
+#line 2100 "molscript.tab.c"
+    break;
+
+  case 81: /* object: INLINE ';'  */
+#line 182 "molscript.y"
+                                    { object (NULL); }
+#line 2106 "molscript.tab.c"
+    break;
+
+  case 82: /* $@11: %empty  */
 #line 183 "molscript.y"
-{ set_atomcolour_bfactor() ;
-    break;}
-case 91:
-#line 184 "molscript.y"
-{ set_atomradius() ;
-    break;}
-case 92:
-#line 185 "molscript.y"
-{ set_bonddistance() ;
-    break;}
-case 93:
+            { lex_yytext_push(); }
+#line 2112 "molscript.tab.c"
+    break;
+
+  case 83: /* object: id $@11 ';'  */
+#line 183 "molscript.y"
+                                       { lex_yytext_pop(); object (yytext); }
+#line 2118 "molscript.tab.c"
+    break;
+
+  case 84: /* $@12: %empty  */
 #line 186 "molscript.y"
-{ set_bondcross() ;
-    break;}
-case 94:
+                      { new_state(); }
+#line 2124 "molscript.tab.c"
+    break;
+
+  case 86: /* $@13: %empty  */
 #line 187 "molscript.y"
-{ set_coilradius() ;
-    break;}
-case 95:
+                      { push_state(); }
+#line 2130 "molscript.tab.c"
+    break;
+
+  case 88: /* $@14: %empty  */
 #line 188 "molscript.y"
-{ set_colourparts (TRUE) ;
-    break;}
-case 96:
-#line 189 "molscript.y"
-{ set_colourparts (FALSE) ;
-    break;}
-case 97:
-#line 190 "molscript.y"
-{ set_colourramphsb (TRUE) ;
-    break;}
-case 98:
-#line 191 "molscript.y"
-{ set_colourramphsb (FALSE) ;
-    break;}
-case 99:
-#line 192 "molscript.y"
-{ set_cylinderradius() ;
-    break;}
-case 100:
-#line 193 "molscript.y"
-{ set_depthcue() ;
-    break;}
-case 101:
-#line 194 "molscript.y"
-{ set_emissivecolour() ;
-    break;}
-case 102:
+                      { pop_state(); }
+#line 2136 "molscript.tab.c"
+    break;
+
+  case 92: /* state_change: ADAPTIVESEGMENTS number  */
 #line 195 "molscript.y"
-{ set_helixthickness() ;
-    break;}
-case 103:
+                                                { set_adaptivesegments(); }
+#line 2142 "molscript.tab.c"
+    break;
+
+  case 93: /* state_change: ATOMCOLOUR atom_selection colour  */
 #line 196 "molscript.y"
-{ set_helixwidth() ;
-    break;}
-case 104:
-#line 197 "molscript.y"
-{ set_hsbrampreverse (TRUE) ;
-    break;}
-case 105:
+                                                { set_atomcolour(); }
+#line 2148 "molscript.tab.c"
+    break;
+
+  case 94: /* state_change: ATOMCOLOUR atom_selection B_FACTOR number number ramp  */
 #line 198 "molscript.y"
-{ set_hsbrampreverse (FALSE) ;
-    break;}
-case 106:
+                                                { set_atomcolour_bfactor(); }
+#line 2154 "molscript.tab.c"
+    break;
+
+  case 95: /* state_change: ATOMRADIUS atom_selection number  */
 #line 199 "molscript.y"
-{ set_labelbackground() ;
-    break;}
-case 107:
+                                                { set_atomradius(); }
+#line 2160 "molscript.tab.c"
+    break;
+
+  case 96: /* state_change: BONDDISTANCE number  */
 #line 200 "molscript.y"
-{ set_labelcentre (TRUE) ;
-    break;}
-case 108:
+                                                { set_bonddistance(); }
+#line 2166 "molscript.tab.c"
+    break;
+
+  case 97: /* state_change: BONDCROSS number  */
 #line 201 "molscript.y"
-{ set_labelcentre (FALSE) ;
-    break;}
-case 109:
+                                                { set_bondcross(); }
+#line 2172 "molscript.tab.c"
+    break;
+
+  case 98: /* state_change: COILRADIUS number  */
 #line 202 "molscript.y"
-{ set_labelclip (TRUE) ;
-    break;}
-case 110:
+                                                { set_coilradius(); }
+#line 2178 "molscript.tab.c"
+    break;
+
+  case 99: /* state_change: COLOURPARTS ON  */
 #line 203 "molscript.y"
-{ set_labelclip (FALSE) ;
-    break;}
-case 111:
+                                                { set_colourparts (TRUE); }
+#line 2184 "molscript.tab.c"
+    break;
+
+  case 100: /* state_change: COLOURPARTS OFF  */
 #line 204 "molscript.y"
-{ set_labelmask (yytext) ;
-    break;}
-case 112:
+                                                { set_colourparts (FALSE); }
+#line 2190 "molscript.tab.c"
+    break;
+
+  case 101: /* state_change: COLOURRAMP HSB  */
 #line 205 "molscript.y"
-{ set_labeloffset() ;
-    break;}
-case 113:
+                                                { set_colourramphsb (TRUE); }
+#line 2196 "molscript.tab.c"
+    break;
+
+  case 102: /* state_change: COLOURRAMP RGB  */
 #line 206 "molscript.y"
-{ set_labelrotation (TRUE) ;
-    break;}
-case 114:
+                                                { set_colourramphsb (FALSE); }
+#line 2202 "molscript.tab.c"
+    break;
+
+  case 103: /* state_change: CYLINDERRADIUS number  */
 #line 207 "molscript.y"
-{ set_labelrotation (FALSE) ;
-    break;}
-case 115:
+                                                { set_cylinderradius(); }
+#line 2208 "molscript.tab.c"
+    break;
+
+  case 104: /* state_change: DEPTHCUE number  */
 #line 208 "molscript.y"
-{ set_labelsize() ;
-    break;}
-case 116:
+                                                { set_depthcue(); }
+#line 2214 "molscript.tab.c"
+    break;
+
+  case 105: /* state_change: DETAILLEVELS INTEGER  */
 #line 209 "molscript.y"
-{ set_lightambientintensity () ;
-    break;}
-case 117:
+                                                { set_detaillevels(); }
+#line 2220 "molscript.tab.c"
+    break;
+
+  case 106: /* state_change: EMISSIVECOLOUR colour  */
 #line 210 "molscript.y"
-{ set_lightattenuation() ;
-    break;}
-case 118:
+                                                { set_emissivecolour(); }
+#line 2226 "molscript.tab.c"
+    break;
+
+  case 107: /* state_change: HELIXTHICKNESS number  */
 #line 211 "molscript.y"
-{ set_lightcolour() ;
-    break;}
-case 119:
+                                                { set_helixthickness(); }
+#line 2232 "molscript.tab.c"
+    break;
+
+  case 108: /* state_change: HELIXWIDTH number  */
 #line 212 "molscript.y"
-{ set_lightintensity () ;
-    break;}
-case 120:
+                                                { set_helixwidth(); }
+#line 2238 "molscript.tab.c"
+    break;
+
+  case 109: /* state_change: HSBRAMPREVERSE ON  */
 #line 213 "molscript.y"
-{ set_lightradius () ;
-    break;}
-case 121:
+                                                { set_hsbrampreverse (TRUE); }
+#line 2244 "molscript.tab.c"
+    break;
+
+  case 110: /* state_change: HSBRAMPREVERSE OFF  */
 #line 214 "molscript.y"
-{ set_linecolour() ;
-    break;}
-case 122:
+                                                { set_hsbrampreverse (FALSE); }
+#line 2250 "molscript.tab.c"
+    break;
+
+  case 111: /* state_change: LABELBACKGROUND number  */
 #line 215 "molscript.y"
-{ set_linedash() ;
-    break;}
-case 123:
+                                                { set_labelbackground(); }
+#line 2256 "molscript.tab.c"
+    break;
+
+  case 112: /* state_change: LABELCENTRE ON  */
 #line 216 "molscript.y"
-{ set_linewidth() ;
-    break;}
-case 124:
+                                                { set_labelcentre (TRUE); }
+#line 2262 "molscript.tab.c"
+    break;
+
+  case 113: /* state_change: LABELCENTRE OFF  */
 #line 217 "molscript.y"
-{ set_objecttransform (TRUE) ;
-    break;}
-case 125:
+                                                { set_labelcentre (FALSE); }
+#line 2268 "molscript.tab.c"
+    break;
+
+  case 114: /* state_change: LABELCLIP ON  */
 #line 218 "molscript.y"
-{ set_objecttransform (FALSE) ;
-    break;}
-case 126:
+                                                { set_labelclip (TRUE); }
+#line 2274 "molscript.tab.c"
+    break;
+
+  case 115: /* state_change: LABELCLIP OFF  */
 #line 219 "molscript.y"
-{ set_planecolour() ;
-    break;}
-case 127:
+                                                { set_labelclip (FALSE); }
+#line 2280 "molscript.tab.c"
+    break;
+
+  case 116: /* state_change: LABELMASK id  */
 #line 220 "molscript.y"
-{ set_plane2colour() ;
-    break;}
-case 128:
+                                                { set_labelmask (yytext); }
+#line 2286 "molscript.tab.c"
+    break;
+
+  case 117: /* state_change: LABELOFFSET vector  */
 #line 221 "molscript.y"
-{ set_regularexpression (TRUE) ;
-    break;}
-case 129:
+                                                { set_labeloffset(); }
+#line 2292 "molscript.tab.c"
+    break;
+
+  case 118: /* state_change: LABELROTATION ON  */
 #line 222 "molscript.y"
-{ set_regularexpression (FALSE) ;
-    break;}
-case 130:
+                                                { set_labelrotation (TRUE); }
+#line 2298 "molscript.tab.c"
+    break;
+
+  case 119: /* state_change: LABELROTATION OFF  */
 #line 223 "molscript.y"
-{ set_residuecolour() ;
-    break;}
-case 131:
+                                                { set_labelrotation (FALSE); }
+#line 2304 "molscript.tab.c"
+    break;
+
+  case 120: /* state_change: LABELSIZE number  */
+#line 224 "molscript.y"
+                                                { set_labelsize(); }
+#line 2310 "molscript.tab.c"
+    break;
+
+  case 121: /* state_change: LIGHTAMBIENTINTENSITY number  */
 #line 225 "molscript.y"
-{ set_residuecolour_bfactor() ;
-    break;}
-case 132:
+                                                { set_lightambientintensity (); }
+#line 2316 "molscript.tab.c"
+    break;
+
+  case 122: /* state_change: LIGHTATTENUATION vector  */
 #line 226 "molscript.y"
-{ set_residuecolour_seq() ;
-    break;}
-case 133:
+                                                { set_lightattenuation(); }
+#line 2322 "molscript.tab.c"
+    break;
+
+  case 123: /* state_change: LIGHTCOLOUR colour  */
 #line 227 "molscript.y"
-{ set_segments() ;
-    break;}
-case 134:
+                                                { set_lightcolour(); }
+#line 2328 "molscript.tab.c"
+    break;
+
+  case 124: /* state_change: LIGHTINTENSITY number  */
 #line 228 "molscript.y"
-{ set_segmentsize() ;
-    break;}
-case 135:
+                                                { set_lightintensity (); }
+#line 2334 "molscript.tab.c"
+    break;
+
+  case 125: /* state_change: LIGHTRADIUS number  */
 #line 229 "molscript.y"
-{ set_shading() ;
-    break;}
-case 136:
+                                                { set_lightradius (); }
+#line 2340 "molscript.tab.c"
+    break;
+
+  case 126: /* state_change: LINECOLOUR colour  */
 #line 230 "molscript.y"
-{ set_shadingexponent() ;
-    break;}
-case 137:
+                                                { set_linecolour(); }
+#line 2346 "molscript.tab.c"
+    break;
+
+  case 127: /* state_change: LINEDASH number  */
 #line 231 "molscript.y"
-{ set_shininess() ;
-    break;}
-case 138:
+                                                { set_linedash(); }
+#line 2352 "molscript.tab.c"
+    break;
+
+  case 128: /* state_change: LINEWIDTH number  */
 #line 232 "molscript.y"
-{ set_smoothsteps() ;
-    break;}
-case 139:
+                                                { set_linewidth(); }
+#line 2358 "molscript.tab.c"
+    break;
+
+  case 129: /* state_change: OBJECTTRANSFORM ON  */
 #line 233 "molscript.y"
-{ set_specularcolour() ;
-    break;}
-case 140:
+                                                { set_objecttransform (TRUE); }
+#line 2364 "molscript.tab.c"
+    break;
+
+  case 130: /* state_change: OBJECTTRANSFORM OFF  */
 #line 234 "molscript.y"
-{ set_splinefactor() ;
-    break;}
-case 141:
+                                                { set_objecttransform (FALSE); }
+#line 2370 "molscript.tab.c"
+    break;
+
+  case 131: /* state_change: PLANECOLOUR colour  */
 #line 235 "molscript.y"
-{ set_stickradius() ;
-    break;}
-case 142:
+                                                { set_planecolour(); }
+#line 2376 "molscript.tab.c"
+    break;
+
+  case 132: /* state_change: PLANE2COLOUR colour  */
 #line 236 "molscript.y"
-{ set_sticktaper() ;
-    break;}
-case 143:
+                                                { set_plane2colour(); }
+#line 2382 "molscript.tab.c"
+    break;
+
+  case 133: /* state_change: REGULAREXPRESSION ON  */
 #line 237 "molscript.y"
-{ set_strandthickness() ;
-    break;}
-case 144:
+                                                { set_regularexpression (TRUE); }
+#line 2388 "molscript.tab.c"
+    break;
+
+  case 134: /* state_change: REGULAREXPRESSION OFF  */
 #line 238 "molscript.y"
-{ set_strandwidth() ;
-    break;}
-case 145:
+                                                { set_regularexpression (FALSE); }
+#line 2394 "molscript.tab.c"
+    break;
+
+  case 135: /* state_change: RESIDUECOLOUR residue_selection colour  */
 #line 239 "molscript.y"
-{ set_transparency() ;
-    break;}
-case 146:
+                                                      { set_residuecolour(); }
+#line 2400 "molscript.tab.c"
+    break;
+
+  case 136: /* state_change: RESIDUECOLOUR residue_selection B_FACTOR number number ramp  */
+#line 241 "molscript.y"
+                                                { set_residuecolour_bfactor(); }
+#line 2406 "molscript.tab.c"
+    break;
+
+  case 137: /* state_change: RESIDUECOLOUR residue_selection ramp  */
 #line 242 "molscript.y"
-{ output_comment (yytext) ;
-    break;}
-case 148:
+                                                    { set_residuecolour_seq(); }
+#line 2412 "molscript.tab.c"
+    break;
+
+  case 138: /* state_change: SEGMENTS INTEGER  */
 #line 243 "molscript.y"
-{ debug (yytext) ;
-    break;}
-case 151:
+                                                { set_segments(); }
+#line 2418 "molscript.tab.c"
+    break;
+
+  case 139: /* state_change: SEGMENTSIZE number  */
+#line 244 "molscript.y"
+                                                { set_segmentsize(); }
+#line 2424 "molscript.tab.c"
+    break;
+
+  case 140: /* state_change: SHADING number  */
+#line 245 "molscript.y"
+                                                { set_shading(); }
+#line 2430 "molscript.tab.c"
+    break;
+
+  case 141: /* state_change: SHADINGEXPONENT number  */
+#line 246 "molscript.y"
+                                                { set_shadingexponent(); }
+#line 2436 "molscript.tab.c"
+    break;
+
+  case 142: /* state_change: SHININESS number  */
 #line 247 "molscript.y"
-{ anchor_start (yytext) ;
-    break;}
-case 152:
+                                                { set_shininess(); }
+#line 2442 "molscript.tab.c"
+    break;
+
+  case 143: /* state_change: SMOOTHSTEPS INTEGER  */
 #line 248 "molscript.y"
-{ anchor_start_geometry() ;
-    break;}
-case 153:
+                                                { set_smoothsteps(); }
+#line 2448 "molscript.tab.c"
+    break;
+
+  case 144: /* state_change: SPECULARCOLOUR colour  */
 #line 249 "molscript.y"
-{ anchor_finish() ;
-    break;}
-case 154:
-#line 250 "molscript.y"
-{ lod_start() ;
-    break;}
-case 155:
+                                                { set_specularcolour(); }
+#line 2454 "molscript.tab.c"
+    break;
+
+  case 145: /* state_change: SPLINEFACTOR number  */
 #line 250 "molscript.y"
-{ lod_start_group() ;
-    break;}
-case 156:
-#line 251 "molscript.y"
-{ lod_finish_group() ;
-    break;}
-case 157:
+                                                { set_splinefactor(); }
+#line 2460 "molscript.tab.c"
+    break;
+
+  case 146: /* state_change: STICKRADIUS number  */
 #line 251 "molscript.y"
-{ lod_finish() ;
-    break;}
-case 158:
+                                                { set_stickradius(); }
+#line 2466 "molscript.tab.c"
+    break;
+
+  case 147: /* state_change: STICKTAPER number  */
 #line 252 "molscript.y"
-{ viewpoint_start (yytext) ;
-    break;}
-case 160:
+                                                { set_sticktaper(); }
+#line 2472 "molscript.tab.c"
+    break;
+
+  case 148: /* state_change: STRANDTHICKNESS number  */
 #line 253 "molscript.y"
-{ output_directionallight() ;
-    break;}
-case 161:
+                                                { set_strandthickness(); }
+#line 2478 "molscript.tab.c"
+    break;
+
+  case 149: /* state_change: STRANDWIDTH number  */
 #line 254 "molscript.y"
-{ output_directionallight() ;
-    break;}
-case 162:
+                                                { set_strandwidth(); }
+#line 2484 "molscript.tab.c"
+    break;
+
+  case 150: /* state_change: SURFACEGRID number  */
 #line 255 "molscript.y"
-{ output_pointlight() ;
-    break;}
-case 163:
+                                                { set_surfacegrid(); }
+#line 2490 "molscript.tab.c"
+    break;
+
+  case 151: /* state_change: SURFACEPROBE number  */
 #line 256 "molscript.y"
-{ output_spotlight() ;
-    break;}
-case 164:
+                                                { set_surfaceprobe(); }
+#line 2496 "molscript.tab.c"
+    break;
+
+  case 152: /* state_change: TRANSPARENCY number  */
 #line 257 "molscript.y"
-{ output_spotlight() ;
-    break;}
-case 165:
+                                                { set_transparency(); }
+#line 2502 "molscript.tab.c"
+    break;
+
+  case 153: /* $@15: %empty  */
 #line 260 "molscript.y"
-{ anchor_description (yytext) ;
-    break;}
-case 169:
+                                { output_comment (yytext); }
+#line 2508 "molscript.tab.c"
+    break;
+
+  case 155: /* $@16: %empty  */
+#line 261 "molscript.y"
+                                { debug (yytext); }
+#line 2514 "molscript.tab.c"
+    break;
+
+  case 158: /* $@17: %empty  */
+#line 265 "molscript.y"
+                         { anchor_start (yytext); }
+#line 2520 "molscript.tab.c"
+    break;
+
+  case 159: /* $@18: %empty  */
+#line 266 "molscript.y"
+                                   { anchor_start_geometry(); }
+#line 2526 "molscript.tab.c"
+    break;
+
+  case 160: /* ctrl_command: ANCHOR id $@17 anchor_description anchor_parameters $@18 '{' basic_commands '}' ';'  */
+#line 267 "molscript.y"
+                                            { anchor_finish(); }
+#line 2532 "molscript.tab.c"
+    break;
+
+  case 161: /* $@19: %empty  */
 #line 268 "molscript.y"
-{ anchor_parameter (yytext) ;
-    break;}
-case 177:
-#line 283 "molscript.y"
-{ lod_start_group() ;
-    break;}
-case 178:
-#line 283 "molscript.y"
-{ lod_finish_group() ;
-    break;}
-case 181:
-#line 289 "molscript.y"
-{ viewpoint_output() ;
-    break;}
-case 182:
-#line 290 "molscript.y"
-{ viewpoint_output() ;
-    break;}
-case 183:
-#line 291 "molscript.y"
-{ viewpoint_output() ;
-    break;}
-case 184:
-#line 294 "molscript.y"
-{ select_atom_not() ;
-    break;}
-case 188:
-#line 300 "molscript.y"
-{ select_atom_and() ;
-    break;}
-case 189:
+                               { lod_start(); }
+#line 2538 "molscript.tab.c"
+    break;
+
+  case 162: /* $@20: %empty  */
+#line 268 "molscript.y"
+                                                           { lod_start_group(); }
+#line 2544 "molscript.tab.c"
+    break;
+
+  case 163: /* $@21: %empty  */
+#line 269 "molscript.y"
+                           { lod_finish_group(); }
+#line 2550 "molscript.tab.c"
+    break;
+
+  case 164: /* ctrl_command: LEVEL_OF_DETAIL $@19 lod_blocks $@20 lod_group $@21 ';'  */
+#line 269 "molscript.y"
+                                                       { lod_finish(); }
+#line 2556 "molscript.tab.c"
+    break;
+
+  case 165: /* $@22: %empty  */
+#line 270 "molscript.y"
+                            { viewpoint_start (yytext); }
+#line 2562 "molscript.tab.c"
+    break;
+
+  case 167: /* ctrl_command: DIRECTIONALLIGHT vector ';'  */
+#line 271 "molscript.y"
+                                           { output_directionallight(); }
+#line 2568 "molscript.tab.c"
+    break;
+
+  case 168: /* ctrl_command: DIRECTIONALLIGHT direction ';'  */
+#line 272 "molscript.y"
+                                              { output_directionallight(); }
+#line 2574 "molscript.tab.c"
+    break;
+
+  case 169: /* ctrl_command: POINTLIGHT vector ';'  */
+#line 273 "molscript.y"
+                                     { output_pointlight(); }
+#line 2580 "molscript.tab.c"
+    break;
+
+  case 170: /* ctrl_command: SPOTLIGHT vector vector number ';'  */
+#line 274 "molscript.y"
+                                                  { output_spotlight(); }
+#line 2586 "molscript.tab.c"
+    break;
+
+  case 171: /* ctrl_command: SPOTLIGHT vector direction number ';'  */
+#line 275 "molscript.y"
+                                                     { output_spotlight(); }
+#line 2592 "molscript.tab.c"
+    break;
+
+  case 172: /* anchor_description: DESCRIPTION id  */
+#line 278 "molscript.y"
+                                    { anchor_description (yytext); }
+#line 2598 "molscript.tab.c"
+    break;
+
+  case 176: /* anchor_parameter: PARAMETER id  */
+#line 286 "molscript.y"
+                                { anchor_parameter (yytext); }
+#line 2604 "molscript.tab.c"
+    break;
+
+  case 184: /* $@23: %empty  */
+#line 301 "molscript.y"
+                   { lod_start_group(); }
+#line 2610 "molscript.tab.c"
+    break;
+
+  case 185: /* lod_block: number $@23 lod_group  */
 #line 301 "molscript.y"
-{ select_atom_and() ;
-    break;}
-case 191:
-#line 304 "molscript.y"
-{ select_atom_or() ;
-    break;}
-case 192:
-#line 305 "molscript.y"
-{ select_atom_or() ;
-    break;}
-case 194:
+                                                    { lod_finish_group(); }
+#line 2616 "molscript.tab.c"
+    break;
+
+  case 188: /* view_definition: direction  */
+#line 307 "molscript.y"
+                            { viewpoint_output(); }
+#line 2622 "molscript.tab.c"
+    break;
+
+  case 189: /* view_definition: direction number  */
 #line 308 "molscript.y"
-{ select_atom_id (yytext) ;
-    break;}
-case 195:
+                                   { viewpoint_output(); }
+#line 2628 "molscript.tab.c"
+    break;
+
+  case 190: /* view_definition: ORIGIN vector number  */
 #line 309 "molscript.y"
-{ lex_yytext_push() ;
-    break;}
-case 196:
-#line 310 "molscript.y"
-{ select_atom_res_id (yytext) ;
-    break;}
-case 197:
-#line 311 "molscript.y"
-{ select_atom_occupancy() ;
-    break;}
-case 198:
+                                       { viewpoint_output(); }
+#line 2634 "molscript.tab.c"
+    break;
+
+  case 191: /* atom_selection: NOT atom_selection  */
 #line 312 "molscript.y"
-{ select_atom_b_factor() ;
-    break;}
-case 199:
-#line 313 "molscript.y"
-{ select_atom_in() ;
-    break;}
-case 200:
-#line 314 "molscript.y"
-{ select_atom_sphere() ;
-    break;}
-case 201:
-#line 315 "molscript.y"
-{ select_atom_close() ;
-    break;}
-case 202:
-#line 316 "molscript.y"
-{ select_atom_peptide() ;
-    break;}
-case 203:
-#line 317 "molscript.y"
-{ select_atom_backbone() ;
-    break;}
-case 204:
+                                    { select_atom_not(); }
+#line 2640 "molscript.tab.c"
+    break;
+
+  case 195: /* atom_and: AND atom_selection  */
 #line 318 "molscript.y"
-{ select_atom_hydrogens() ;
-    break;}
-case 205:
+                              { select_atom_and(); }
+#line 2646 "molscript.tab.c"
+    break;
+
+  case 196: /* $@24: %empty  */
 #line 319 "molscript.y"
-{ select_atom_element (yytext) ;
-    break;}
-case 206:
+                              { select_atom_and(); }
+#line 2652 "molscript.tab.c"
+    break;
+
+  case 198: /* atom_or: OR atom_selection  */
 #line 322 "molscript.y"
-{ select_residue_not() ;
-    break;}
-case 210:
+                            { select_atom_or(); }
+#line 2658 "molscript.tab.c"
+    break;
+
+  case 199: /* $@25: %empty  */
+#line 323 "molscript.y"
+                             { select_atom_or(); }
+#line 2664 "molscript.tab.c"
+    break;
+
+  case 201: /* atom_specification: ATOM id  */
+#line 326 "molscript.y"
+                                                 { select_atom_id (yytext); }
+#line 2670 "molscript.tab.c"
+    break;
+
+  case 202: /* $@26: %empty  */
+#line 327 "molscript.y"
+                                 { lex_yytext_push(); }
+#line 2676 "molscript.tab.c"
+    break;
+
+  case 203: /* atom_specification: RES_ATOM id $@26 id  */
 #line 328 "molscript.y"
-{ select_residue_and() ;
-    break;}
-case 211:
+                                 { select_atom_res_id (yytext); }
+#line 2682 "molscript.tab.c"
+    break;
+
+  case 204: /* atom_specification: OCCUPANCY number number  */
 #line 329 "molscript.y"
-{ select_residue_and() ;
-    break;}
-case 213:
+                                                 { select_atom_occupancy(); }
+#line 2688 "molscript.tab.c"
+    break;
+
+  case 205: /* atom_specification: B_FACTOR number number  */
+#line 330 "molscript.y"
+                                                 { select_atom_b_factor(); }
+#line 2694 "molscript.tab.c"
+    break;
+
+  case 206: /* atom_specification: IN residue_selection  */
+#line 331 "molscript.y"
+                                                 { select_atom_in(); }
+#line 2700 "molscript.tab.c"
+    break;
+
+  case 207: /* atom_specification: SPHERE vector number  */
 #line 332 "molscript.y"
-{ select_residue_or() ;
-    break;}
-case 214:
+                                                 { select_atom_sphere(); }
+#line 2706 "molscript.tab.c"
+    break;
+
+  case 208: /* atom_specification: CLOSE atom_selection number  */
 #line 333 "molscript.y"
-{ select_residue_or() ;
-    break;}
-case 216:
+                                                 { select_atom_close(); }
+#line 2712 "molscript.tab.c"
+    break;
+
+  case 209: /* atom_specification: PEPTIDE  */
+#line 334 "molscript.y"
+                                                 { select_atom_peptide(); }
+#line 2718 "molscript.tab.c"
+    break;
+
+  case 210: /* atom_specification: BACKBONE  */
+#line 335 "molscript.y"
+                                                 { select_atom_backbone(); }
+#line 2724 "molscript.tab.c"
+    break;
+
+  case 211: /* atom_specification: HYDROGENS  */
 #line 336 "molscript.y"
-{ select_residue_molecule (yytext) ;
-    break;}
-case 217:
+                                                 { select_atom_hydrogens(); }
+#line 2730 "molscript.tab.c"
+    break;
+
+  case 212: /* atom_specification: ELEMENT id  */
 #line 337 "molscript.y"
-{ select_residue_model() ;
-    break;}
-case 218:
-#line 338 "molscript.y"
-{ lex_yytext_push() ;
-    break;}
-case 219:
-#line 339 "molscript.y"
-{ select_residue_from_to
-					      (lex_yytext_str(), yytext);
-			                    lex_yytext_pop() ;
-    break;}
-case 220:
-#line 342 "molscript.y"
-{ select_residue_id (yytext) ;
-    break;}
-case 221:
-#line 343 "molscript.y"
-{ select_residue_type (yytext) ;
-    break;}
-case 222:
-#line 344 "molscript.y"
-{ select_residue_chain (yytext) ;
-    break;}
-case 223:
-#line 345 "molscript.y"
-{ select_residue_contains() ;
-    break;}
-case 224:
+                                                 { select_atom_element (yytext); }
+#line 2736 "molscript.tab.c"
+    break;
+
+  case 213: /* residue_selection: NOT residue_selection  */
+#line 340 "molscript.y"
+                                          { select_residue_not(); }
+#line 2742 "molscript.tab.c"
+    break;
+
+  case 217: /* residue_and: AND residue_selection  */
 #line 346 "molscript.y"
-{ select_residue_amino_acids() ;
-    break;}
-case 225:
+                                    { select_residue_and(); }
+#line 2748 "molscript.tab.c"
+    break;
+
+  case 218: /* $@27: %empty  */
 #line 347 "molscript.y"
-{ select_residue_waters() ;
-    break;}
-case 226:
-#line 348 "molscript.y"
-{ select_residue_nucleotides() ;
-    break;}
-case 227:
-#line 349 "molscript.y"
-{ select_residue_ligands() ;
-    break;}
-case 228:
+                                    { select_residue_and(); }
+#line 2754 "molscript.tab.c"
+    break;
+
+  case 220: /* residue_or: OR residue_selection  */
 #line 350 "molscript.y"
-{ select_residue_segid (yytext) ;
-    break;}
-case 229:
-#line 353 "molscript.y"
-{ position() ;
-    break;}
-case 232:
-#line 359 "molscript.y"
-{ set_rgb() ;
-    break;}
-case 233:
+                                  { select_residue_or(); }
+#line 2760 "molscript.tab.c"
+    break;
+
+  case 221: /* $@28: %empty  */
+#line 351 "molscript.y"
+                                   { select_residue_or(); }
+#line 2766 "molscript.tab.c"
+    break;
+
+  case 223: /* residue_specification: MOLECULE id  */
+#line 354 "molscript.y"
+                                          { select_residue_molecule (yytext); }
+#line 2772 "molscript.tab.c"
+    break;
+
+  case 224: /* residue_specification: MODEL INTEGER  */
+#line 355 "molscript.y"
+                                          { select_residue_model(); }
+#line 2778 "molscript.tab.c"
+    break;
+
+  case 225: /* $@29: %empty  */
+#line 356 "molscript.y"
+                                          { lex_yytext_push(); }
+#line 2784 "molscript.tab.c"
+    break;
+
+  case 226: /* residue_specification: FROM number_as_id $@29 TO number_as_id  */
+#line 357 "molscript.y"
+                                          { select_residue_from_to
+					      (lex_yytext_str(), yytext);
+			                    lex_yytext_pop(); }
+#line 2792 "molscript.tab.c"
+    break;
+
+  case 227: /* residue_specification: RESIDUE id  */
 #line 360 "molscript.y"
-{ set_hsb() ;
-    break;}
-case 234:
+                                          { select_residue_id (yytext); }
+#line 2798 "molscript.tab.c"
+    break;
+
+  case 228: /* residue_specification: TYPE id  */
 #line 361 "molscript.y"
-{ set_grey() ;
-    break;}
-case 235:
+                                          { select_residue_type (yytext); }
+#line 2804 "molscript.tab.c"
+    break;
+
+  case 229: /* residue_specification: CHAIN id  */
 #line 362 "molscript.y"
-{ set_colour (yytext) ;
-    break;}
-case 236:
+                                          { select_residue_chain (yytext); }
+#line 2810 "molscript.tab.c"
+    break;
+
+  case 230: /* residue_specification: CONTAINS atom_selection  */
+#line 363 "molscript.y"
+                                                { select_residue_contains(); }
+#line 2816 "molscript.tab.c"
+    break;
+
+  case 231: /* residue_specification: AMINO_ACIDS  */
+#line 364 "molscript.y"
+                                          { select_residue_amino_acids(); }
+#line 2822 "molscript.tab.c"
+    break;
+
+  case 232: /* residue_specification: WATERS  */
 #line 365 "molscript.y"
-{ ramp_from_colour = given_colour ;
-    break;}
-case 237:
+                                          { select_residue_waters(); }
+#line 2828 "molscript.tab.c"
+    break;
+
+  case 233: /* residue_specification: NUCLEOTIDES  */
 #line 366 "molscript.y"
-{ set_colour_ramp (&given_colour) ;
-    break;}
-case 238:
-#line 367 "molscript.y"
-{ set_rainbow_ramp() ;
-    break;}
-case 239:
-#line 370 "molscript.y"
-{ pop_dstack (1) ;
-    break;}
-}
-   /* the action file gets copied in in place of this dollarsign */
-#line 487 "/usr/freeware/share/bison.simple"
-
-  yyvsp -= yylen;
-  yyssp -= yylen;
-#ifdef YYLSP_NEEDED
-  yylsp -= yylen;
-#endif
+                                          { select_residue_nucleotides(); }
+#line 2834 "molscript.tab.c"
+    break;
 
-#if YYDEBUG != 0
-  if (yydebug)
-    {
-      short *ssp1 = yyss - 1;
-      fprintf (stderr, "state stack now");
-      while (ssp1 != yyssp)
-	fprintf (stderr, " %d", *++ssp1);
-      fprintf (stderr, "\n");
+  case 234: /* residue_specification: LIGANDS  */
+#line 367 "molscript.y"
+                                          { select_residue_ligands(); }
+#line 2840 "molscript.tab.c"
+    break;
+
+  case 235: /* residue_specification: SEGID id  */
+#line 368 "molscript.y"
+                                          { select_residue_segid (yytext); }
+#line 2846 "molscript.tab.c"
+    break;
+
+  case 236: /* vector: POSITION atom_selection  */
+#line 371 "molscript.y"
+                                 { position(); }
+#line 2852 "molscript.tab.c"
+    break;
+
+  case 239: /* colour: RGB number number number  */
+#line 377 "molscript.y"
+                                  { set_rgb(); }
+#line 2858 "molscript.tab.c"
+    break;
+
+  case 240: /* colour: HSB number number number  */
+#line 378 "molscript.y"
+                                  { set_hsb(); }
+#line 2864 "molscript.tab.c"
+    break;
+
+  case 241: /* colour: GREY number  */
+#line 379 "molscript.y"
+                                  { set_grey(); }
+#line 2870 "molscript.tab.c"
+    break;
+
+  case 242: /* colour: id  */
+#line 380 "molscript.y"
+                                  { set_colour (yytext); }
+#line 2876 "molscript.tab.c"
+    break;
+
+  case 243: /* $@30: %empty  */
+#line 383 "molscript.y"
+                   { ramp_from_colour = given_colour; }
+#line 2882 "molscript.tab.c"
+    break;
+
+  case 244: /* ramp: FROM colour $@30 TO colour  */
+#line 384 "molscript.y"
+                   { set_colour_ramp (&given_colour); }
+#line 2888 "molscript.tab.c"
+    break;
+
+  case 245: /* ramp: RAINBOW  */
+#line 385 "molscript.y"
+                   { set_rainbow_ramp(); }
+#line 2894 "molscript.tab.c"
+    break;
+
+  case 246: /* number_as_id: number  */
+#line 388 "molscript.y"
+                      { pop_dstack (1); }
+#line 2900 "molscript.tab.c"
+    break;
+
+
+#line 2904 "molscript.tab.c"
+
+      default: break;
     }
-#endif
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
 
   *++yyvsp = yyval;
 
-#ifdef YYLSP_NEEDED
-  yylsp++;
-  if (yylen == 0)
-    {
-      yylsp->first_line = yylloc.first_line;
-      yylsp->first_column = yylloc.first_column;
-      yylsp->last_line = (yylsp-1)->last_line;
-      yylsp->last_column = (yylsp-1)->last_column;
-      yylsp->text = 0;
-    }
-  else
-    {
-      yylsp->last_line = (yylsp+yylen-1)->last_line;
-      yylsp->last_column = (yylsp+yylen-1)->last_column;
-    }
-#endif
-
-  /* Now "shift" the result of the reduction.
-     Determine what state that goes to,
-     based on the state we popped back to
-     and the rule number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTBASE] + *yyssp;
-  if (yystate >= 0 && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTBASE];
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
-yyerrlab:   /* here on detecting error */
 
-  if (! yyerrstatus)
-    /* If not already recovering from an error, report this error.  */
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
     {
       ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
 
-#ifdef YYERROR_VERBOSE
-      yyn = yypact[yystate];
-
-      if (yyn > YYFLAG && yyn < YYLAST)
-	{
-	  int size = 0;
-	  char *msg;
-	  int x, count;
-
-	  count = 0;
-	  /* Start X at -yyn if nec to avoid negative indexes in yycheck.  */
-	  for (x = (yyn < 0 ? -yyn : 0);
-	       x < (sizeof(yytname) / sizeof(char *)); x++)
-	    if (yycheck[x + yyn] == x)
-	      size += strlen(yytname[x]) + 15, count++;
-	  msg = (char *) malloc(size + 15);
-	  if (msg != 0)
-	    {
-	      strcpy(msg, "parse error");
-
-	      if (count < 5)
-		{
-		  count = 0;
-		  for (x = (yyn < 0 ? -yyn : 0);
-		       x < (sizeof(yytname) / sizeof(char *)); x++)
-		    if (yycheck[x + yyn] == x)
-		      {
-			strcat(msg, count == 0 ? ", expecting `" : " or `");
-			strcat(msg, yytname[x]);
-			strcat(msg, "'");
-			count++;
-		      }
-		}
-	      yyerror(msg);
-	      free(msg);
-	    }
-	  else
-	    yyerror ("parse error; also virtual memory exceeded");
-	}
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-#endif /* YYERROR_VERBOSE */
-	yyerror("parse error");
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
     }
 
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
   goto yyerrlab1;
-yyerrlab1:   /* here on error raised explicitly by an action */
 
-  if (yyerrstatus == 3)
-    {
-      /* if just tried and failed to reuse lookahead token after an error, discard it.  */
 
-      /* return failure if at end of input */
-      if (yychar == YYEOF)
-	YYABORT;
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
 
-#if YYDEBUG != 0
-      if (yydebug)
-	fprintf(stderr, "Discarding token %d (%s).\n", yychar, yytname[yychar1]);
-#endif
 
-      yychar = YYEMPTY;
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
     }
 
-  /* Else will try to reuse lookahead token
-     after shifting the error token.  */
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
-  yyerrstatus = 3;		/* Each real token shifted decrements this */
 
-  goto yyerrhandle;
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
-yyerrdefault:  /* current state does not do anything special for the error token. */
+  yystate = yyn;
+  goto yynewstate;
 
-#if 0
-  /* This is wrong; only states that explicitly want error tokens
-     should shift them.  */
-  yyn = yydefact[yystate];  /* If its default is to accept any token, ok.  Otherwise pop it.*/
-  if (yyn) goto yydefault;
-#endif
 
-yyerrpop:   /* pop the current state because it cannot handle the error token */
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
 
-  if (yyssp == yyss) YYABORT;
-  yyvsp--;
-  yystate = *--yyssp;
-#ifdef YYLSP_NEEDED
-  yylsp--;
-#endif
 
-#if YYDEBUG != 0
-  if (yydebug)
-    {
-      short *ssp1 = yyss - 1;
-      fprintf (stderr, "Error: state stack now");
-      while (ssp1 != yyssp)
-	fprintf (stderr, " %d", *++ssp1);
-      fprintf (stderr, "\n");
-    }
-#endif
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
 
-yyerrhandle:
 
-  yyn = yypact[yystate];
-  if (yyn == YYFLAG)
-    goto yyerrdefault;
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
 
-  yyn += YYTERROR;
-  if (yyn < 0 || yyn > YYLAST || yycheck[yyn] != YYTERROR)
-    goto yyerrdefault;
 
-  yyn = yytable[yyn];
-  if (yyn < 0)
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
     {
-      if (yyn == YYFLAG)
-	goto yyerrpop;
-      yyn = -yyn;
-      goto yyreduce;
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
     }
-  else if (yyn == 0)
-    goto yyerrpop;
-
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
-#if YYDEBUG != 0
-  if (yydebug)
-    fprintf(stderr, "Shifting error token, ");
-#endif
-
-  *++yyvsp = yylval;
-#ifdef YYLSP_NEEDED
-  *++yylsp = yylloc;
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
 #endif
 
-  yystate = yyn;
-  goto yynewstate;
+  return yyresult;
 }
-#line 382 "molscript.y"
+
+#line 400 "molscript.y"
 
 
 
@@ -2219,7 +3107,13 @@ yyerror (char *s)
     fprintf (stderr, "Error\n");
   }
   lex_info();
-  if (exit_on_error) exit (1);
+  if (exit_on_error) {
+    if (error_return) longjmp (*error_return, 1);
+#ifdef IMAGE_SUPPORT
+    image_wait_plots();		/* no plot process may outlive the error */
+#endif
+    exit (1);
+  }
   lex_cleanup();
   clear_dstack();
   return 0;
@@ -2243,12 +3137,24 @@ yywarning (char *s)
 int
 main (int argc, char *argv[])
 {
+  int failed = 0;
+
   global_init();
   lex_init();
   process_arguments (&argc, argv);
   banner();
-  yyparse();
-  output_finish_output();
+  if (batch_filename) {
+    failed = process_batch();
+  } else if (server_filename) {
+    failed = server_run();
+  } else if (watch_mode) {
+    failed = watch_run();
+  } else if (trajectory_mode) {
+    failed = trajectory_run();
+  } else {
+    yyparse();
+    output_finish_output();
+  }
   banner();
-  return 0;
+  return failed ? 1 : 0;
 }
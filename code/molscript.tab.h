@@ -1,151 +1,226 @@
-#ifndef YYSTYPE
-#define YYSTYPE int
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_MOLSCRIPT_TAB_H_INCLUDED
+# define YY_YY_MOLSCRIPT_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    INTEGER = 258,                 /* INTEGER  */
+    REAL = 259,                    /* REAL  */
+    STRING = 260,                  /* STRING  */
+    ITEM = 261,                    /* ITEM  */
+    ON = 262,                      /* ON  */
+    OFF = 263,                     /* OFF  */
+    POSITION = 264,                /* POSITION  */
+    TITLE = 265,                   /* TITLE  */
+    MACRO = 266,                   /* MACRO  */
+    PLOT = 267,                    /* PLOT  */
+    END_PLOT = 268,                /* END_PLOT  */
+    COMMENT = 269,                 /* COMMENT  */
+    DEBUG = 270,                   /* DEBUG  */
+    POSTSCRIPT = 271,              /* POSTSCRIPT  */
+    RASTER3D = 272,                /* RASTER3D  */
+    VRML = 273,                    /* VRML  */
+    NOFRAME = 274,                 /* NOFRAME  */
+    FRAME = 275,                   /* FRAME  */
+    AREA = 276,                    /* AREA  */
+    BACKGROUND = 277,              /* BACKGROUND  */
+    WINDOW = 278,                  /* WINDOW  */
+    SLAB = 279,                    /* SLAB  */
+    HEADLIGHT = 280,               /* HEADLIGHT  */
+    SHADOWS = 281,                 /* SHADOWS  */
+    FOG = 282,                     /* FOG  */
+    READ = 283,                    /* READ  */
+    INLINE_PDB = 284,              /* INLINE_PDB  */
+    DELETE = 285,                  /* DELETE  */
+    COPY = 286,                    /* COPY  */
+    ANCHOR = 287,                  /* ANCHOR  */
+    DESCRIPTION = 288,             /* DESCRIPTION  */
+    PARAMETER = 289,               /* PARAMETER  */
+    VIEWPOINT = 290,               /* VIEWPOINT  */
+    ORIGIN = 291,                  /* ORIGIN  */
+    DIRECTIONALLIGHT = 292,        /* DIRECTIONALLIGHT  */
+    POINTLIGHT = 293,              /* POINTLIGHT  */
+    SPOTLIGHT = 294,               /* SPOTLIGHT  */
+    LEVEL_OF_DETAIL = 295,         /* LEVEL_OF_DETAIL  */
+    TRANSFORM = 296,               /* TRANSFORM  */
+    BY = 297,                      /* BY  */
+    CENTRE = 298,                  /* CENTRE  */
+    TRANSLATION = 299,             /* TRANSLATION  */
+    ROTATION = 300,                /* ROTATION  */
+    XAXIS = 301,                   /* XAXIS  */
+    YAXIS = 302,                   /* YAXIS  */
+    ZAXIS = 303,                   /* ZAXIS  */
+    AXIS = 304,                    /* AXIS  */
+    STORE_MATRIX = 305,            /* STORE_MATRIX  */
+    RECALL_MATRIX = 306,           /* RECALL_MATRIX  */
+    NOT = 307,                     /* NOT  */
+    REQUIRE = 308,                 /* REQUIRE  */
+    AND = 309,                     /* AND  */
+    EITHER = 310,                  /* EITHER  */
+    OR = 311,                      /* OR  */
+    BACKBONE = 312,                /* BACKBONE  */
+    PEPTIDE = 313,                 /* PEPTIDE  */
+    HYDROGENS = 314,               /* HYDROGENS  */
+    ATOM = 315,                    /* ATOM  */
+    RES_ATOM = 316,                /* RES_ATOM  */
+    B_FACTOR = 317,                /* B_FACTOR  */
+    OCCUPANCY = 318,               /* OCCUPANCY  */
+    IN = 319,                      /* IN  */
+    SPHERE = 320,                  /* SPHERE  */
+    CLOSE = 321,                   /* CLOSE  */
+    MODEL = 322,                   /* MODEL  */
+    AMINO_ACIDS = 323,             /* AMINO_ACIDS  */
+    WATERS = 324,                  /* WATERS  */
+    NUCLEOTIDES = 325,             /* NUCLEOTIDES  */
+    LIGANDS = 326,                 /* LIGANDS  */
+    MOLECULE = 327,                /* MOLECULE  */
+    FROM = 328,                    /* FROM  */
+    TO = 329,                      /* TO  */
+    RESIDUE = 330,                 /* RESIDUE  */
+    TYPE = 331,                    /* TYPE  */
+    CONTAINS = 332,                /* CONTAINS  */
+    CHAIN = 333,                   /* CHAIN  */
+    ELEMENT = 334,                 /* ELEMENT  */
+    SEGID = 335,                   /* SEGID  */
+    SET = 336,                     /* SET  */
+    PUSH = 337,                    /* PUSH  */
+    POP = 338,                     /* POP  */
+    ATOMCOLOUR = 339,              /* ATOMCOLOUR  */
+    ATOMRADIUS = 340,              /* ATOMRADIUS  */
+    BONDDISTANCE = 341,            /* BONDDISTANCE  */
+    BONDCROSS = 342,               /* BONDCROSS  */
+    COILRADIUS = 343,              /* COILRADIUS  */
+    COLOURPARTS = 344,             /* COLOURPARTS  */
+    COLOURRAMP = 345,              /* COLOURRAMP  */
+    CYLINDERRADIUS = 346,          /* CYLINDERRADIUS  */
+    DEPTHCUE = 347,                /* DEPTHCUE  */
+    EMISSIVECOLOUR = 348,          /* EMISSIVECOLOUR  */
+    HELIXTHICKNESS = 349,          /* HELIXTHICKNESS  */
+    HELIXWIDTH = 350,              /* HELIXWIDTH  */
+    HSBRAMPREVERSE = 351,          /* HSBRAMPREVERSE  */
+    LABELBACKGROUND = 352,         /* LABELBACKGROUND  */
+    LABELCENTRE = 353,             /* LABELCENTRE  */
+    LABELCLIP = 354,               /* LABELCLIP  */
+    LABELMASK = 355,               /* LABELMASK  */
+    LABELOFFSET = 356,             /* LABELOFFSET  */
+    LABELROTATION = 357,           /* LABELROTATION  */
+    LABELSIZE = 358,               /* LABELSIZE  */
+    LIGHTAMBIENTINTENSITY = 359,   /* LIGHTAMBIENTINTENSITY  */
+    LIGHTATTENUATION = 360,        /* LIGHTATTENUATION  */
+    LIGHTCOLOUR = 361,             /* LIGHTCOLOUR  */
+    LIGHTINTENSITY = 362,          /* LIGHTINTENSITY  */
+    LIGHTRADIUS = 363,             /* LIGHTRADIUS  */
+    LINECOLOUR = 364,              /* LINECOLOUR  */
+    LINEDASH = 365,                /* LINEDASH  */
+    LINEWIDTH = 366,               /* LINEWIDTH  */
+    OBJECTTRANSFORM = 367,         /* OBJECTTRANSFORM  */
+    PLANECOLOUR = 368,             /* PLANECOLOUR  */
+    PLANE2COLOUR = 369,            /* PLANE2COLOUR  */
+    REGULAREXPRESSION = 370,       /* REGULAREXPRESSION  */
+    RESIDUECOLOUR = 371,           /* RESIDUECOLOUR  */
+    SEGMENTS = 372,                /* SEGMENTS  */
+    SEGMENTSIZE = 373,             /* SEGMENTSIZE  */
+    SHADING = 374,                 /* SHADING  */
+    SHADINGEXPONENT = 375,         /* SHADINGEXPONENT  */
+    SHININESS = 376,               /* SHININESS  */
+    SMOOTHSTEPS = 377,             /* SMOOTHSTEPS  */
+    SPECULARCOLOUR = 378,          /* SPECULARCOLOUR  */
+    SPLINEFACTOR = 379,            /* SPLINEFACTOR  */
+    STICKRADIUS = 380,             /* STICKRADIUS  */
+    STICKTAPER = 381,              /* STICKTAPER  */
+    STRANDTHICKNESS = 382,         /* STRANDTHICKNESS  */
+    STRANDWIDTH = 383,             /* STRANDWIDTH  */
+    TRANSPARENCY = 384,            /* TRANSPARENCY  */
+    BALL_AND_STICK = 385,          /* BALL_AND_STICK  */
+    BONDS = 386,                   /* BONDS  */
+    COIL = 387,                    /* COIL  */
+    CYLINDER = 388,                /* CYLINDER  */
+    CPK = 389,                     /* CPK  */
+    HELIX = 390,                   /* HELIX  */
+    LABEL = 391,                   /* LABEL  */
+    LINE = 392,                    /* LINE  */
+    OBJECT = 393,                  /* OBJECT  */
+    INLINE = 394,                  /* INLINE  */
+    STRAND = 395,                  /* STRAND  */
+    TRACE = 396,                   /* TRACE  */
+    TURN = 397,                    /* TURN  */
+    DOUBLE_HELIX = 398,            /* DOUBLE_HELIX  */
+    RGB = 399,                     /* RGB  */
+    HSB = 400,                     /* HSB  */
+    GREY = 401,                    /* GREY  */
+    RAINBOW = 402,                 /* RAINBOW  */
+    ACCESSIBLE_SURFACE = 403,      /* ACCESSIBLE_SURFACE  */
+    MOLECULAR_SURFACE = 404,       /* MOLECULAR_SURFACE  */
+    SURFACEGRID = 405,             /* SURFACEGRID  */
+    SURFACEPROBE = 406,            /* SURFACEPROBE  */
+    DETAILLEVELS = 407,            /* DETAILLEVELS  */
+    ADAPTIVESEGMENTS = 408         /* ADAPTIVESEGMENTS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+typedef int YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
-#define	INTEGER	258
-#define	REAL	259
-#define	STRING	260
-#define	ITEM	261
-#define	ON	262
-#define	OFF	263
-#define	POSITION	264
-#define	TITLE	265
-#define	MACRO	266
-#define	PLOT	267
-#define	END_PLOT	268
-#define	COMMENT	269
-#define	DEBUG	270
-#define	POSTSCRIPT	271
-#define	RASTER3D	272
-#define	VRML	273
-#define	NOFRAME	274
-#define	FRAME	275
-#define	AREA	276
-#define	BACKGROUND	277
-#define	WINDOW	278
-#define	SLAB	279
-#define	HEADLIGHT	280
-#define	SHADOWS	281
-#define	FOG	282
-#define	READ	283
-#define	INLINE_PDB	284
-#define	DELETE	285
-#define	COPY	286
-#define	ANCHOR	287
-#define	DESCRIPTION	288
-#define	PARAMETER	289
-#define	VIEWPOINT	290
-#define	ORIGIN	291
-#define	DIRECTIONALLIGHT	292
-#define	POINTLIGHT	293
-#define	SPOTLIGHT	294
-#define	LEVEL_OF_DETAIL	295
-#define	TRANSFORM	296
-#define	BY	297
-#define	CENTRE	298
-#define	TRANSLATION	299
-#define	ROTATION	300
-#define	XAXIS	301
-#define	YAXIS	302
-#define	ZAXIS	303
-#define	AXIS	304
-#define	STORE_MATRIX	305
-#define	RECALL_MATRIX	306
-#define	NOT	307
-#define	REQUIRE	308
-#define	AND	309
-#define	EITHER	310
-#define	OR	311
-#define	BACKBONE	312
-#define	PEPTIDE	313
-#define	HYDROGENS	314
-#define	ATOM	315
-#define	RES_ATOM	316
-#define	B_FACTOR	317
-#define	OCCUPANCY	318
-#define	IN	319
-#define	SPHERE	320
-#define	CLOSE	321
-#define	MODEL	322
-#define	AMINO_ACIDS	323
-#define	WATERS	324
-#define	NUCLEOTIDES	325
-#define	LIGANDS	326
-#define	MOLECULE	327
-#define	FROM	328
-#define	TO	329
-#define	RESIDUE	330
-#define	TYPE	331
-#define	CONTAINS	332
-#define	CHAIN	333
-#define	ELEMENT	334
-#define	SEGID	335
-#define	SET	336
-#define	PUSH	337
-#define	POP	338
-#define	ATOMCOLOUR	339
-#define	ATOMRADIUS	340
-#define	BONDDISTANCE	341
-#define	BONDCROSS	342
-#define	COILRADIUS	343
-#define	COLOURPARTS	344
-#define	COLOURRAMP	345
-#define	CYLINDERRADIUS	346
-#define	DEPTHCUE	347
-#define	EMISSIVECOLOUR	348
-#define	HELIXTHICKNESS	349
-#define	HELIXWIDTH	350
-#define	HSBRAMPREVERSE	351
-#define	LABELBACKGROUND	352
-#define	LABELCENTRE	353
-#define	LABELCLIP	354
-#define	LABELMASK	355
-#define	LABELOFFSET	356
-#define	LABELROTATION	357
-#define	LABELSIZE	358
-#define	LIGHTAMBIENTINTENSITY	359
-#define	LIGHTATTENUATION	360
-#define	LIGHTCOLOUR	361
-#define	LIGHTINTENSITY	362
-#define	LIGHTRADIUS	363
-#define	LINECOLOUR	364
-#define	LINEDASH	365
-#define	LINEWIDTH	366
-#define	OBJECTTRANSFORM	367
-#define	PLANECOLOUR	368
-#define	PLANE2COLOUR	369
-#define	REGULAREXPRESSION	370
-#define	RESIDUECOLOUR	371
-#define	SEGMENTS	372
-#define	SEGMENTSIZE	373
-#define	SHADING	374
-#define	SHADINGEXPONENT	375
-#define	SHININESS	376
-#define	SMOOTHSTEPS	377
-#define	SPECULARCOLOUR	378
-#define	SPLINEFACTOR	379
-#define	STICKRADIUS	380
-#define	STICKTAPER	381
-#define	STRANDTHICKNESS	382
-#define	STRANDWIDTH	383
-#define	TRANSPARENCY	384
-#define	BALL_AND_STICK	385
-#define	BONDS	386
-#define	COIL	387
-#define	CYLINDER	388
-#define	CPK	389
-#define	HELIX	390
-#define	LABEL	391
-#define	LINE	392
-#define	OBJECT	393
-#define	INLINE	394
-#define	STRAND	395
-#define	TRACE	396
-#define	TURN	397
-#define	DOUBLE_HELIX	398
-#define	RGB	399
-#define	HSB	400
-#define	GREY	401
-#define	RAINBOW	402
 
 
 extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_MOLSCRIPT_TAB_H_INCLUDED  */
@@ -0,0 +1,458 @@
+/* objfile.c
+
+   MolScript v2.1.2
+
+   Object files: the text format, and the binary format for mapping
+   into memory.
+
+   The text format is a sequence of blocks, each of which is a code
+   (P, PC, L, LC, T, TC, TN, TNC, S, SC, SN or SNC), the number of
+   vertices and the coordinate triplets, ended by Q or end-of-file.
+
+   The binary format has the same blocks, in little-endian byte order:
+     header   8 bytes   "MSOBJECT"
+              4 bytes   format version, 1
+              4 bytes   number of blocks
+     block    4 bytes   code, as in the text format, padded by NUL
+              4 bytes   number of vertices
+              8 bytes   IEEE double for each coordinate of each triplet
+   Each block starts at a multiple of 8 bytes, so that on a
+   little-endian host the triplets are used in place in the mapped
+   file, without reading or copying.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "clib/str_utils.h"
+
+#include "objfile.h"
+#include "global.h"
+#include "graphics.h"
+
+
+/*============================================================*/
+#define MAGIC "MSOBJECT"
+#define MAGIC_LENGTH 8
+#define VERSION 1
+#define HEADER_SIZE 16
+#define BLOCK_HEADER_SIZE 8
+
+static const char *code_names[] = {"P", "PC", "L", "LC",
+				   "T", "TC", "TN", "TNC",
+				   "S", "SC", "SN", "SNC"};
+
+
+/*------------------------------------------------------------*/
+static boolean
+little_endian (void)
+{
+  unsigned int one = 1;
+
+  return *((unsigned char *) &one) == 1;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+native_triplets (void)
+     /* Can the triplets in a binary file be used in place? */
+{
+  return little_endian() && (sizeof (vector3) == 3 * 8) &&
+    (sizeof (double) == 8);
+}
+
+
+/*------------------------------------------------------------*/
+static unsigned long
+get_uint32 (const unsigned char *b)
+{
+  return (unsigned long) b[0] | ((unsigned long) b[1] << 8) |
+    ((unsigned long) b[2] << 16) | ((unsigned long) b[3] << 24);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+put_uint32 (unsigned char *b, unsigned long value)
+{
+  b[0] = value & 0xff;
+  b[1] = (value >> 8) & 0xff;
+  b[2] = (value >> 16) & 0xff;
+  b[3] = (value >> 24) & 0xff;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+get_double (const unsigned char *b)
+{
+  unsigned char host[8];
+  double value;
+  int slot;
+
+  if (little_endian()) {
+    memcpy (host, b, 8);
+  } else {
+    for (slot = 0; slot < 8; slot++) host[slot] = b[7 - slot];
+  }
+  memcpy (&value, host, 8);
+  return value;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+put_double (unsigned char *b, double value)
+{
+  unsigned char host[8];
+  int slot;
+
+  memcpy (host, &value, 8);
+  if (little_endian()) {
+    memcpy (b, host, 8);
+  } else {
+    for (slot = 0; slot < 8; slot++) b[slot] = host[7 - slot];
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static int
+code_from_name (const char *name)
+{
+  int code;
+
+  assert (name);
+
+  for (code = OBJ_POINTS; code <= OBJ_STRIP_NORMALS_COLOURS; code++) {
+    if (str_eq (name, (char *) code_names[code])) return code;
+  }
+  return -1;
+}
+
+
+/*------------------------------------------------------------*/
+int
+objfile_triplets (int code)
+     /* The number of triplets for each vertex in the object block. */
+{
+  switch (code) {
+  case OBJ_POINTS:
+  case OBJ_LINES:
+  case OBJ_TRIANGLES:
+  case OBJ_STRIP:
+    return 1;
+  case OBJ_POINTS_COLOURS:
+  case OBJ_LINES_COLOURS:
+  case OBJ_TRIANGLES_COLOURS:
+  case OBJ_TRIANGLES_NORMALS:
+  case OBJ_STRIP_COLOURS:
+  case OBJ_STRIP_NORMALS:
+    return 2;
+  case OBJ_TRIANGLES_NORMALS_COLOURS:
+  case OBJ_STRIP_NORMALS_COLOURS:
+    return 3;
+  }
+  return 0;
+}
+
+
+/*------------------------------------------------------------*/
+boolean
+objfile_valid_count (int code, int count)
+     /* Is the number of vertices valid for the object block? */
+{
+  switch (code) {
+  case OBJ_POINTS:
+  case OBJ_POINTS_COLOURS:
+    return count >= 1;
+  case OBJ_LINES:
+  case OBJ_LINES_COLOURS:
+    return count >= 2;
+  case OBJ_TRIANGLES:
+  case OBJ_TRIANGLES_COLOURS:
+  case OBJ_TRIANGLES_NORMALS:
+  case OBJ_TRIANGLES_NORMALS_COLOURS:
+    return (count >= 3) && (count % 3 == 0);
+  case OBJ_STRIP:
+  case OBJ_STRIP_COLOURS:
+  case OBJ_STRIP_NORMALS:
+  case OBJ_STRIP_NORMALS_COLOURS:
+    return count >= 3;
+  }
+  return FALSE;
+}
+
+
+/*------------------------------------------------------------*/
+int
+objfile_text_block (FILE *file, int *code, vector3 **triplets, int *alloc)
+     /*
+       Read the next block of the text format. Return the number of
+       triplets, 0 at the end, or -1 if the format or content is
+       invalid. The triplets array is enlarged when needed.
+     */
+{
+  char name[4];
+  int count, slot;
+
+  assert (file);
+  assert (code);
+  assert (triplets);
+  assert (alloc);
+
+  if (fscanf (file, "%3s", name) == EOF) return 0;
+  if (str_eq (name, "Q")) return 0;
+  *code = code_from_name (name);
+  if (*code < 0) return -1;
+
+  if (fscanf (file, "%i", &count) != 1) return -1;
+  if (! objfile_valid_count (*code, count)) return -1;
+  if (count > INT_MAX / 3) return -1;
+  count *= objfile_triplets (*code);
+
+  if (count > *alloc) {
+    *alloc = count;
+    *triplets = realloc (*triplets, count * sizeof (vector3));
+  }
+
+  for (slot = 0; slot < count; slot++) {
+    if (fscanf (file, "%lg %lg %lg",
+		&((*triplets)[slot].x),
+		&((*triplets)[slot].y),
+		&((*triplets)[slot].z)) != 3) return -1;
+  }
+
+  return count;
+}
+
+
+/*------------------------------------------------------------*/
+boolean
+objfile_is_binary (const char *filename)
+     /* Is the file in the binary object format? */
+{
+  FILE *file;
+  char magic[MAGIC_LENGTH];
+  boolean binary;
+
+  assert (filename);
+
+  file = fopen (filename, "rb");
+  if (file == NULL) return FALSE;
+  binary = (fread (magic, 1, MAGIC_LENGTH, file) == MAGIC_LENGTH) &&
+    (memcmp (magic, MAGIC, MAGIC_LENGTH) == 0);
+  fclose (file);
+  return binary;
+}
+
+
+/*------------------------------------------------------------*/
+boolean
+objfile_binary_open (objfile_binary *ob, const char *filename)
+     /*
+       Map the binary object file into memory. The mapping is private,
+       so that the triplets may be changed in place without changing
+       the file.
+     */
+{
+  struct stat st;
+  int fd;
+  void *data;
+
+  assert (ob);
+  assert (filename);
+
+  ob->data = NULL;
+  ob->swapped = NULL;
+  ob->swapped_alloc = 0;
+
+  fd = open (filename, O_RDONLY);
+  if (fd < 0) return FALSE;
+  if ((fstat (fd, &st) != 0) || (st.st_size < HEADER_SIZE)) {
+    close (fd);
+    return FALSE;
+  }
+  data = mmap (NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE,
+	       MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED) return FALSE;
+
+  ob->data = data;
+  ob->length = (size_t) st.st_size;
+  if ((memcmp (ob->data, MAGIC, MAGIC_LENGTH) != 0) ||
+      (get_uint32 ((unsigned char *) ob->data + 8) != VERSION)) {
+    objfile_binary_close (ob);
+    return FALSE;
+  }
+  ob->blocks = (int) get_uint32 ((unsigned char *) ob->data + 12);
+  ob->pos = HEADER_SIZE;
+
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+int
+objfile_binary_block (objfile_binary *ob, int *code, vector3 **triplets)
+     /*
+       Get the next block of the mapped binary object file. Return the
+       number of triplets, 0 at the end, or -1 if the content is
+       invalid. The triplets are in the mapped file, or in a copy in
+       the opposite byte order, and are valid until the next call.
+     */
+{
+  char name[BLOCK_HEADER_SIZE / 2 + 1];
+  unsigned char *b;
+  unsigned long vertices;
+  size_t size;
+  int count, slot;
+
+  assert (ob);
+  assert (ob->data);
+  assert (code);
+  assert (triplets);
+
+  if (ob->blocks <= 0) return 0;
+  if (ob->length - ob->pos < BLOCK_HEADER_SIZE) return -1;
+
+  b = (unsigned char *) ob->data + ob->pos;
+  memcpy (name, b, BLOCK_HEADER_SIZE / 2);
+  name[BLOCK_HEADER_SIZE / 2] = '\0';
+  *code = code_from_name (name);
+  if (*code < 0) return -1;
+
+  vertices = get_uint32 (b + BLOCK_HEADER_SIZE / 2);
+  if (vertices > INT_MAX / 3) return -1;
+  if (! objfile_valid_count (*code, (int) vertices)) return -1;
+  count = (int) vertices * objfile_triplets (*code);
+  size = (size_t) count * 3 * 8;
+  if (ob->length - ob->pos - BLOCK_HEADER_SIZE < size) return -1;
+
+  b += BLOCK_HEADER_SIZE;
+  ob->pos += BLOCK_HEADER_SIZE + size;
+  ob->blocks--;
+
+  if (native_triplets()) {
+    *triplets = (vector3 *) b;
+  } else {
+    if (count > ob->swapped_alloc) {
+      ob->swapped_alloc = count;
+      ob->swapped = realloc (ob->swapped, count * sizeof (vector3));
+    }
+    for (slot = 0; slot < count; slot++, b += 24) {
+      ob->swapped[slot].x = get_double (b);
+      ob->swapped[slot].y = get_double (b + 8);
+      ob->swapped[slot].z = get_double (b + 16);
+    }
+    *triplets = ob->swapped;
+  }
+
+  return count;
+}
+
+
+/*------------------------------------------------------------*/
+void
+objfile_binary_close (objfile_binary *ob)
+{
+  assert (ob);
+
+  if (ob->data) munmap (ob->data, ob->length);
+  ob->data = NULL;
+  if (ob->swapped) free (ob->swapped);
+  ob->swapped = NULL;
+  ob->swapped_alloc = 0;
+}
+
+
+/*------------------------------------------------------------*/
+boolean
+objfile_convert (const char *text_filename, const char *binary_filename)
+     /* Convert the text object file into the binary format. */
+{
+  FILE *in, *out;
+  unsigned char b[HEADER_SIZE];
+  vector3 *triplets;
+  int code, count, slot, alloc = 1024;
+  unsigned long blocks = 0;
+  boolean failed = FALSE;
+
+  assert (text_filename);
+  assert (binary_filename);
+
+  in = fopen (text_filename, "r");
+  if (in == NULL) {
+    fprintf (stderr, "Error: could not open the object file %s\n",
+	     text_filename);
+    return FALSE;
+  }
+  out = fopen (binary_filename, "wb");
+  if (out == NULL) {
+    fprintf (stderr, "Error: could not create the file %s\n",
+	     binary_filename);
+    fclose (in);
+    return FALSE;
+  }
+
+  memcpy (b, MAGIC, MAGIC_LENGTH);
+  put_uint32 (b + 8, VERSION);
+  put_uint32 (b + 12, 0);
+  fwrite (b, 1, HEADER_SIZE, out);
+
+  triplets = malloc (alloc * sizeof (vector3));
+  while ((count = objfile_text_block (in, &code, &triplets, &alloc)) > 0) {
+    memset (b, 0, BLOCK_HEADER_SIZE);
+    strcpy ((char *) b, code_names[code]);
+    put_uint32 (b + BLOCK_HEADER_SIZE / 2,
+		(unsigned long) (count / objfile_triplets (code)));
+    fwrite (b, 1, BLOCK_HEADER_SIZE, out);
+    if (native_triplets()) {
+      fwrite (triplets, sizeof (vector3), count, out);
+    } else {
+      for (slot = 0; slot < count; slot++) {
+	put_double (b, triplets[slot].x);
+	put_double (b + 8, triplets[slot].y);
+	fwrite (b, 1, 16, out);
+	put_double (b, triplets[slot].z);
+	fwrite (b, 1, 8, out);
+      }
+    }
+    blocks++;
+  }
+  free (triplets);
+  fclose (in);
+
+  if (count < 0) {
+    fprintf (stderr, "Error: invalid format or content in object file %s\n",
+	     text_filename);
+    failed = TRUE;
+  }
+
+  put_uint32 (b, blocks);
+  if ((fseek (out, 12, SEEK_SET) != 0) || (fwrite (b, 1, 4, out) != 4))
+    failed = TRUE;
+  if (fclose (out) != 0) failed = TRUE;
+  if (failed) {
+    remove (binary_filename);
+    fprintf (stderr, "Error: could not convert to the file %s\n",
+	     binary_filename);
+    return FALSE;
+  }
+
+  if (message_mode)
+    fprintf (stderr, "%lu object blocks converted to %s\n", blocks,
+	     binary_filename);
+  return TRUE;
+}
@@ -0,0 +1,43 @@
+/* objfile.h
+
+   MolScript v2.1.2
+
+   Object files: the text format, and the binary format for mapping
+   into memory.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#ifndef OBJFILE_H
+#define OBJFILE_H 1
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "clib/boolean.h"
+#include "clib/vector3.h"
+
+typedef struct {
+  char *data;			/* the mapped file */
+  size_t length;
+  size_t pos;			/* of the next block */
+  int blocks;			/* remaining */
+  vector3 *swapped;		/* copy of a block, if big-endian host */
+  int swapped_alloc;
+} objfile_binary;
+
+int objfile_triplets (int code);
+boolean objfile_valid_count (int code, int count);
+
+int objfile_text_block (FILE *file, int *code, vector3 **triplets, int *alloc);
+
+boolean objfile_is_binary (const char *filename);
+boolean objfile_binary_open (objfile_binary *ob, const char *filename);
+int objfile_binary_block (objfile_binary *ob, int *code, vector3 **triplets);
+void objfile_binary_close (objfile_binary *ob);
+
+boolean objfile_convert (const char *text_filename,
+			 const char *binary_filename);
+
+#endif
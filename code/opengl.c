@@ -13,6 +13,9 @@
      25-Jan-1998  face culling now default; object output param's optimized
       6-Feb-1998  use faster bitmap character routine
      21-Jul-1998  fixed strand arrow geometry bug
+     18-Oct-2026  tile projection for tiled image output
+     18-Oct-2026  display lists reset for each image plot
+     18-Oct-2026  view transform for animation frames
 */
 
 #include <assert.h>
@@ -84,6 +87,11 @@ static double current_shininess;
 static int accum = 0;
 static jitter_point *jitter_points;
 
+static int tile_x, tile_y, tile_width = 0, tile_height;
+
+static GLdouble view_matrix[16];
+static boolean view_set = FALSE;
+
 typedef struct {
   vector3 xyz;
   char *molname;
@@ -757,6 +765,9 @@ ogl_start_plot_general (void)
 {
   window_scale = 1.0;
 
+  display_list_count = 0;	/* each image plot has a new context */
+  label_display_list_count = 0;
+  alpha_display_list_count = 0;
   line_point_count = 0;
   polygon_count = 0;
   label_count = 0;
@@ -803,9 +814,20 @@ ogl_render_init (void)
   glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   glMatrixMode (GL_PROJECTION);
   glLoadIdentity();
-  glOrtho (- aspect_window_x * window_scale, aspect_window_x * window_scale,
-	   - aspect_window_y * window_scale, aspect_window_y * window_scale,
-	   0.0, 2.0 * slab);
+  if (tile_width > 0) {		/* part of the image only */
+    double xpix = 2.0 * aspect_window_x * window_scale / (double) output_width;
+    double ypix = 2.0 * aspect_window_y * window_scale / (double) output_height;
+    double left = - aspect_window_x * window_scale + xpix * tile_x;
+    double bottom = - aspect_window_y * window_scale + ypix * tile_y;
+    glViewport (0, 0, (GLsizei) tile_width, (GLsizei) tile_height);
+    glOrtho (left, left + xpix * tile_width,
+	     bottom, bottom + ypix * tile_height,
+	     0.0, 2.0 * slab);
+  } else {
+    glOrtho (- aspect_window_x * window_scale, aspect_window_x * window_scale,
+	     - aspect_window_y * window_scale, aspect_window_y * window_scale,
+	     0.0, 2.0 * slab);
+  }
 
   glMatrixMode (GL_MODELVIEW);
   glLoadIdentity();
@@ -847,6 +869,14 @@ ogl_render_lights (void)
 }
 
 
+/*------------------------------------------------------------*/
+static void
+view_transform (void)
+{
+  if (view_set) glMultMatrixd (view_matrix);
+}
+
+
 /*------------------------------------------------------------*/
 void
 ogl_render_lists (void)
@@ -865,6 +895,7 @@ ogl_render_lists (void)
       glPushMatrix();
       glTranslatef (xpix * jitter_points[point].x,
 		    ypix * jitter_points[point].y, 0.0);
+      view_transform();
 
       for (slot = 0; slot < display_list_count; slot++) {
 	glCallList (display_list[slot]);
@@ -872,14 +903,18 @@ ogl_render_lists (void)
 
       if (label_display_list_count > 0) {
 	glPopMatrix();		/* labels must not be jittered */
+	glPushMatrix();
+	view_transform();
 	glDisable (GL_LIGHTING);
 	for (slot = 0; slot < label_display_list_count; slot++) {
 	  glCallList (label_display_list[slot]);
 	}
 	glEnable (GL_LIGHTING);
+	glPopMatrix();
 	glPushMatrix();
 	glTranslatef (xpix * jitter_points[point].x,
 		      ypix * jitter_points[point].y, 0.0);
+	view_transform();
       }
 
       if (alpha_display_list_count > 0) {
@@ -904,6 +939,9 @@ ogl_render_lists (void)
 
   } else {
 
+    glPushMatrix();
+    view_transform();
+
     for (slot = 0; slot < display_list_count; slot++) {
       glCallList (display_list[slot]);
     }
@@ -924,6 +962,8 @@ ogl_render_lists (void)
       }
       glDisable (GL_BLEND);
     }
+
+    glPopMatrix();
   }
 
 #ifndef NDEBUG
@@ -932,6 +972,43 @@ ogl_render_lists (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+ogl_set_tile (int x, int y, int width, int height)
+     /*
+       Render only the given rectangle of the output image, in pixels
+       counted from the lower left corner; a width of zero resets.
+       Labels starting outside the tile are clipped away entirely.
+     */
+{
+  assert (width >= 0);
+  assert (height >= 0);
+
+  tile_x = x;
+  tile_y = y;
+  tile_width = width;
+  tile_height = height;
+}
+
+
+/*------------------------------------------------------------*/
+void
+ogl_set_view (double matrix[4][4])
+     /*
+       Transform the display lists by the matrix when rendering; the
+       lights stay fixed to the viewer. Both have the translation in
+       the last row, so the layout in memory is the same.
+     */
+{
+  int row, col;
+
+  for (row = 0; row < 4; row++) {
+    for (col = 0; col < 4; col++) view_matrix[4 * row + col] = matrix[row][col];
+  }
+  view_set = TRUE;
+}
+
+
 /*------------------------------------------------------------*/
 int
 ogl_accum (void)
@@ -9,6 +9,8 @@
    Copyright (C) 1997-1998 Per Kraulis
      25-Jun-1997
      11-Sep-1997  fairly finished
+     18-Oct-2026  tile projection
+     18-Oct-2026  view transform for animation frames
 */
 
 #ifndef OPENGL_H
@@ -26,6 +28,8 @@ void ogl_start_plot_general (void);
 void ogl_render_init (void);
 void ogl_render_lights (void);
 void ogl_render_lists (void);
+void ogl_set_tile (int x, int y, int width, int height);
+void ogl_set_view (double matrix[4][4]);
 
 int ogl_accum (void);
 void ogl_set_accum (int number);
@@ -5,51 +5,87 @@
    PNG image.
 
    This implementation is based on the PNG Reference Library 1.0
-   version 0.96 and zlib v1.0.4. It relies on the 'image.c' code,
-   and therefore implicitly on OpenGL and GLX.
+   version 0.96 and zlib v1.0.4. It relies on the 'image.c' code
+   for rendering.
+
+   The library is used for the header and text chunks only. The image
+   data is filtered and deflated here, in bands of rows that are
+   compressed independently, each primed with the tail of the band
+   before it as dictionary, and stitched into a single zlib stream
+   (in the manner of 'pigz'). If THREAD_SUPPORT is defined, the bands
+   are processed in parallel by POSIX threads, one per processor.
 
    Copyright (C) 1997-1998 Per Kraulis
     12-Sep-1997  started
     21-Dec-1997  identified minor memory leak in PNG library; not fixed
+    18-Oct-2026  use image_read_row; no direct OpenGL calls
+    18-Oct-2026  parallel filtering and deflation of the image data
+    18-Oct-2026  one image file per plot
+    18-Oct-2026  options reset for each output (batch mode)
+    18-Oct-2026  bands run by the shared thread jobs
 */
 
 #include <assert.h>
 #include <stdlib.h>
-
-#include <GL/gl.h>
+#include <string.h>
 
 #include <png.h>
+#include <zlib.h>
 
 #include "clib/str_utils.h"
 #include "clib/dynstring.h"
+#include "clib/thread_jobs.h"
 
 #include "png_img.h"
 #include "global.h"
 #include "graphics.h"
 #include "image.h"
-#include "opengl.h"
 
 
 /*============================================================*/
+#define GROUP_ROWS 1024		/* rows read from the image at a time */
+#define BAND_BYTES 131072	/* filtered bytes per deflate band */
+#define WINDOW_SIZE 32768	/* deflate dictionary */
+
+#define OUT_BYTES(n) ((n) + (n) / 1000 + 64) /* deflate worst case */
+
+#define FILTER_ADAPTIVE PNG_FILTER_VALUE_LAST
+
+typedef struct {
+  int first, rows;		/* scanlines of the group */
+  unsigned char *raw;		/* filtered scanlines */
+  unsigned long raw_length;
+  unsigned char *out;		/* zlib header, deflated data, trailer */
+  unsigned long out_length;
+  boolean last;
+} band;
+
 static int compression_level = Z_DEFAULT_COMPRESSION;
+static int filter_type = FILTER_ADAPTIVE;
 static png_structp png_ptr;
 static png_infop info_ptr;
 static png_text text_ptr[4];
 
+static int row_bytes;
+static unsigned char *scanlines = NULL;	/* previous, then the group */
+static band *bands = NULL;
+static int band_count;
+static unsigned char dictionary[WINDOW_SIZE];
+static int dictionary_length;
+
 
 /*------------------------------------------------------------*/
 void
 pngi_set (void)
 {
-  ogl_set();
-
-  output_first_plot = pngi_first_plot;
-  output_finish_output = pngi_finish_output;
-  output_start_plot = ogl_start_plot_general;
+  image_set (pngi_first_plot, pngi_finish_output);
 
   output_pickable = NULL;
 
   output_mode = PNG_MODE;
+
+  compression_level = Z_DEFAULT_COMPRESSION;
+  filter_type = FILTER_ADAPTIVE;
 }
 
 
@@ -60,7 +96,6 @@ pngi_first_plot (void)
   int count = 0;
   dynstring *software_info;
 
-  image_first_plot();
   set_outfile ("wb");
 
   png_ptr = png_create_write_struct (PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
@@ -100,25 +135,240 @@ pngi_first_plot (void)
 }
 
 
+/*------------------------------------------------------------*/
+static int
+filter_row (int type, unsigned char *row, unsigned char *prev,
+	    unsigned char *dest)
+     /*
+       Filter the scanline by the given type, 3 bytes per pixel.
+       Return the sum of absolute values, as the adaptive heuristic.
+     */
+{
+  int slot, a, b, c, p, pa, pb, pc, value;
+  int sum = 0;
+
+  *dest++ = (unsigned char) type;
+  for (slot = 0; slot < row_bytes; slot++) {
+    a = (slot >= 3) ? row[slot - 3] : 0;
+    b = prev[slot];
+    c = (slot >= 3) ? prev[slot - 3] : 0;
+    switch (type) {
+    case PNG_FILTER_VALUE_NONE:
+      value = row[slot];
+      break;
+    case PNG_FILTER_VALUE_SUB:
+      value = row[slot] - a;
+      break;
+    case PNG_FILTER_VALUE_UP:
+      value = row[slot] - b;
+      break;
+    case PNG_FILTER_VALUE_AVG:
+      value = row[slot] - ((a + b) >> 1);
+      break;
+    default:			/* Paeth predictor */
+      p = a + b - c;
+      pa = abs (p - a);
+      pb = abs (p - b);
+      pc = abs (p - c);
+      if ((pa <= pb) && (pa <= pc)) {
+	value = row[slot] - a;
+      } else if (pb <= pc) {
+	value = row[slot] - b;
+      } else {
+	value = row[slot] - c;
+      }
+      break;
+    }
+    dest[slot] = (unsigned char) value;
+    value &= 0xff;
+    sum += (value < 128) ? value : 256 - value;
+  }
+
+  return sum;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+filter_bands (thread_jobs *tj)
+{
+  int slot, row, type, sum, best_sum;
+  unsigned char *trial, *dest, *line;
+  band *b;
+
+  trial = malloc ((row_bytes + 1) * sizeof (unsigned char));
+
+  while ((slot = thread_jobs_take (tj)) >= 0) {
+    b = bands + slot;
+    dest = b->raw;
+    for (row = b->first; row < b->first + b->rows; row++) {
+      line = scanlines + (row + 1) * row_bytes;
+      if (filter_type == FILTER_ADAPTIVE) {
+	best_sum = filter_row (PNG_FILTER_VALUE_NONE, line,
+			       line - row_bytes, dest);
+	for (type = PNG_FILTER_VALUE_SUB; type < FILTER_ADAPTIVE; type++) {
+	  sum = filter_row (type, line, line - row_bytes, trial);
+	  if (sum < best_sum) {
+	    best_sum = sum;
+	    memcpy (dest, trial, row_bytes + 1);
+	  }
+	}
+      } else {
+	filter_row (filter_type, line, line - row_bytes, dest);
+      }
+      dest += row_bytes + 1;
+    }
+  }
+
+  free (trial);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+deflate_bands (thread_jobs *tj)
+{
+  int slot, length;
+  z_stream stream;
+  band *b;
+  unsigned char *window;
+
+  while ((slot = thread_jobs_take (tj)) >= 0) {
+    b = bands + slot;
+
+    memset (&stream, 0, sizeof (z_stream));
+    if (deflateInit2 (&stream, compression_level, Z_DEFLATED, -15, 8,
+		      (filter_type == PNG_FILTER_VALUE_NONE) ?
+		      Z_DEFAULT_STRATEGY : Z_FILTERED) != Z_OK)
+      yyerror ("png_img: could not initialize deflate");
+
+    if (slot > 0) {		/* tail of the band before as dictionary */
+      length = (b[-1].raw_length < WINDOW_SIZE) ?
+	       (int) b[-1].raw_length : WINDOW_SIZE;
+      window = b[-1].raw + b[-1].raw_length - length;
+    } else {
+      length = dictionary_length;
+      window = dictionary;
+    }
+    if (length > 0) deflateSetDictionary (&stream, window, length);
+
+    stream.next_in = b->raw;
+    stream.avail_in = b->raw_length;
+    stream.next_out = b->out + 2;
+    stream.avail_out = OUT_BYTES (b->raw_length);
+    if ((deflate (&stream, b->last ? Z_FINISH : Z_SYNC_FLUSH) !=
+	 (b->last ? Z_STREAM_END : Z_OK)) || (stream.avail_out == 0))
+      yyerror ("png_img: could not deflate image data");
+    b->out_length = stream.total_out;
+    deflateEnd (&stream);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+run_bands (void (*function) (thread_jobs *tj))
+{
+  thread_jobs tj;
+
+  thread_jobs_run (&tj, band_count, function, NULL);
+}
+
+
 /*------------------------------------------------------------*/
 void
 pngi_finish_output (void)
 {
-  int row;
-  unsigned char *buffer;	/* this ought to be png_bytep? */
+  int first, rows, row, slot, band_rows, flags;
+  unsigned long adler, length;
+  unsigned char *data;
+  band *b;
 
   image_render();
 
-  buffer = malloc (output_width * 3 * sizeof (unsigned char));
-
-  for (row = output_height - 1; row >= 0; row--) {
-    glReadPixels (0, row, output_width, 1, GL_RGB, GL_UNSIGNED_BYTE, buffer);
-    png_write_row (png_ptr, (png_bytep) buffer);
+  row_bytes = 3 * output_width;
+  band_rows = BAND_BYTES / (row_bytes + 1);
+  if (band_rows < 1) band_rows = 1;
+  if (band_rows > GROUP_ROWS) band_rows = GROUP_ROWS;
+
+  scanlines = calloc ((GROUP_ROWS + 1) * row_bytes, sizeof (unsigned char));
+  band_count = (GROUP_ROWS + band_rows - 1) / band_rows;
+  bands = malloc (band_count * sizeof (band));
+  for (slot = 0; slot < band_count; slot++) {
+    bands[slot].raw = malloc (band_rows * (row_bytes + 1));
+    bands[slot].out = malloc (OUT_BYTES (band_rows * (row_bytes + 1)) + 6);
+  }
+  dictionary_length = 0;
+  adler = adler32 (0L, Z_NULL, 0);
+
+  for (first = 0; first < output_height; first += GROUP_ROWS) {
+    rows = output_height - first;
+    if (rows > GROUP_ROWS) rows = GROUP_ROWS;
+
+    for (row = 0; row < rows; row++) /* image rows count from the bottom */
+      image_read_row (output_height - 1 - first - row, IMAGE_RGB,
+		      scanlines + (row + 1) * row_bytes);
+
+    band_count = (rows + band_rows - 1) / band_rows;
+    for (slot = 0; slot < band_count; slot++) {
+      b = bands + slot;
+      b->first = slot * band_rows;
+      b->rows = (rows - b->first < band_rows) ? rows - b->first : band_rows;
+      b->raw_length = b->rows * (row_bytes + 1);
+      b->last = (first + rows == output_height) && (slot == band_count - 1);
+    }
+
+    run_bands (filter_bands);
+    run_bands (deflate_bands);
+
+    for (slot = 0; slot < band_count; slot++) {
+      b = bands + slot;
+      adler = adler32 (adler, b->raw, b->raw_length);
+      data = b->out + 2;
+      length = b->out_length;
+      if ((first == 0) && (slot == 0)) { /* zlib header */
+	data = b->out;
+	length += 2;
+	b->out[0] = 0x78;
+	if ((compression_level >= 0) && (compression_level < 2)) {
+	  flags = 0;
+	} else if ((compression_level >= 2) && (compression_level < 6)) {
+	  flags = 1 << 6;
+	} else if (compression_level > 6) {
+	  flags = 3 << 6;
+	} else {
+	  flags = 2 << 6;
+	}
+	b->out[1] = flags + 31 - (0x7800 + flags) % 31;
+      }
+      if (b->last) {		/* zlib trailer */
+	data[length++] = (unsigned char) (adler >> 24);
+	data[length++] = (unsigned char) (adler >> 16);
+	data[length++] = (unsigned char) (adler >> 8);
+	data[length++] = (unsigned char) adler;
+      }
+      png_write_chunk (png_ptr, (png_bytep) "IDAT", data, length);
+    }
+
+    b = bands + band_count - 1;	/* dictionary for the next group */
+    dictionary_length = (b->raw_length < WINDOW_SIZE) ?
+			(int) b->raw_length : WINDOW_SIZE;
+    memcpy (dictionary, b->raw + b->raw_length - dictionary_length,
+	    dictionary_length);
+    memcpy (scanlines, scanlines + rows * row_bytes, row_bytes);
   }
 
-  free (buffer);
+  band_count = (GROUP_ROWS + band_rows - 1) / band_rows;
+  for (slot = 0; slot < band_count; slot++) {
+    free (bands[slot].raw);
+    free (bands[slot].out);
+  }
+  free (bands);
+  bands = NULL;
+  free (scanlines);
+  scanlines = NULL;
 
-  png_write_end (png_ptr, NULL);
+  png_write_chunk (png_ptr, (png_bytep) "IEND", NULL, 0);
   png_destroy_write_struct (&png_ptr, &info_ptr);
 
   image_close();
@@ -145,3 +395,29 @@ pngi_set_compression (char *level)
   }
   return TRUE;
 }
+
+
+/*------------------------------------------------------------*/
+int
+pngi_set_filter (char *filter)
+{
+  assert (filter);
+  assert (*filter);
+
+  if (str_eq (filter, "adaptive")) {
+    filter_type = FILTER_ADAPTIVE;
+  } else if (str_eq (filter, "none")) {
+    filter_type = PNG_FILTER_VALUE_NONE;
+  } else if (str_eq (filter, "sub")) {
+    filter_type = PNG_FILTER_VALUE_SUB;
+  } else if (str_eq (filter, "up")) {
+    filter_type = PNG_FILTER_VALUE_UP;
+  } else if (str_eq (filter, "average")) {
+    filter_type = PNG_FILTER_VALUE_AVG;
+  } else if (str_eq (filter, "paeth")) {
+    filter_type = PNG_FILTER_VALUE_PAETH;
+  } else {
+    return FALSE;
+  }
+  return TRUE;
+}
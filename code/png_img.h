@@ -10,6 +10,7 @@
 
    Copyright (C) 1997-1998 Per Kraulis
     12-Sep-1997  started
+    18-Oct-2026  filter selection
 */
 
 #ifndef PNG_IMG_H
@@ -19,5 +20,6 @@ void pngi_set (void);
 void pngi_first_plot (void);
 void pngi_finish_output (void);
 int pngi_set_compression (char *level);
+int pngi_set_filter (char *filter);
 
 #endif
@@ -8,6 +8,12 @@
      4-Dec-1996  first attempts
      5-Oct-1997  began again
      7-Jan-1998  fixed assert bug in db_line
+    18-Oct-2026  colours inline in db entries; state index in depth db
+    18-Oct-2026  reset for each output (batch mode)
+    18-Oct-2026  fixed PC object stepping past the end of its triplets
+    18-Oct-2026  db transformed as strided arrays
+    18-Oct-2026  single-precision db, if FLOAT_GEOMETRY is defined
+    18-Oct-2026  no limit on the number of states in the depth db
 */
 
 #include <assert.h>
@@ -27,48 +33,67 @@
 #include "state.h"
 
 
+/* The primitives are held until the whole scene has been depth
+   sorted, and are then output with two decimals; single precision
+   is enough, and halves the memory, if FLOAT_GEOMETRY is defined.
+   The depth values are kept in double precision, to retain the
+   sort order. */
+#ifdef FLOAT_GEOMETRY
+typedef struct {
+  float x, y, z;
+} db_vector;
+typedef float db_real;
+#else
+typedef vector3 db_vector;
+typedef double db_real;
+#endif
+
+#define DB_CHUNK 256
+
 typedef struct {
-  int code;
-  int slot;
   double depth;
-  state *st;
+  int slot;
+  int st;			/* index into state_array */
+  unsigned short code;
 } depth_db_entry;
 
 typedef struct {
-  vector3 v1;
-  vector3 v2;
-  colour *c;
+  db_vector v1;
+  db_vector v2;
+  colour col;
+  boolean own_colour;		/* else use linecolour of state */
 } line_db_entry;
 
 typedef struct {
-  vector3 v;
-  colour *c;
+  db_vector v;
+  colour col;
+  boolean own_colour;		/* else use linecolour of state */
 } point_db_entry;
 
 typedef struct {
-  vector3 v;
-  double rad;
+  db_vector v;
+  db_real rad;
   colour col;
   int donald_duck;
 } sphere_db_entry;
 
 typedef struct {
-  vector3 p1, p2, p3, p4;
+  db_vector p1, p2, p3, p4;
   colour col;
-  double znorm;
+  db_real znorm;
 } plane_db_entry;
 
 typedef struct {
-  vector3 pos;
+  db_vector pos;
   char *str;
   colour col;
 } label_db_entry;
 
 typedef struct {
-  vector3 p1, p2;
-  vector3 dir, perp;
+  db_vector p1, p2;
+  db_vector dir, perp;
   colour col;
-  double taper;
+  db_real taper;
 } stick_db_entry;
 
 enum db_codes { LINE_CODE, POINT_CODE, SPHERE_CODE,
@@ -82,6 +107,10 @@ static depth_db_entry *depth_array = NULL;
 static int depth_alloc = 0;
 static int depth_count = 0;
 
+static state **state_array = NULL;
+static int state_alloc = 0;
+static int state_count = 0;
+
 static line_db_entry *line_array = NULL;
 static int line_alloc = 0;
 static int line_count = 0;
@@ -243,24 +272,22 @@ db_init (void)
 {
   int slot;
 				/* deallocate previous data */
-  for (slot = 0; slot < line_count; slot++) {
-    if (line_array[slot].c) free (line_array[slot].c);
-  }
-
   for (slot = 0; slot < label_count; slot++) {
     free (label_array[slot].str);
   }
 
-  for (slot = 0; slot < point_count; slot++) {
-    if (point_array[slot].c) free (point_array[slot].c);
-  }
-
   if (depth_alloc == 0) {	/* allocate arrays */
     depth_alloc = 16384;
     depth_array = malloc (depth_alloc * sizeof (depth_db_entry));
   }
   depth_count = 0;
 
+  if (state_alloc == 0) {
+    state_alloc = 64;
+    state_array = malloc (state_alloc * sizeof (state *));
+  }
+  state_count = 0;
+
   if (line_alloc == 0) {
     line_alloc = 2048;
     line_array = malloc (line_alloc * sizeof (line_db_entry));
@@ -299,6 +326,46 @@ db_init (void)
 }
 
 
+/*------------------------------------------------------------*/
+static int
+state_index (void)
+{
+  assert (state_array);
+  assert (current_state);
+				/* states are kept until the next plot */
+  if ((state_count > 0) && (state_array[state_count - 1] == current_state))
+    return state_count - 1;
+
+  if (state_count >= state_alloc) {
+    state_alloc *= 2;
+    state_array = realloc (state_array, state_alloc * sizeof (state *));
+  }
+  state_array[state_count] = current_state;
+
+  return state_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+db_store (db_vector *dv, vector3 *v)
+{
+  dv->x = v->x;
+  dv->y = v->y;
+  dv->z = v->z;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+db_load (vector3 *v, db_vector *dv)
+{
+  v->x = dv->x;
+  v->y = dv->y;
+  v->z = dv->z;
+}
+
+
 /*------------------------------------------------------------*/
 static void
 enter_depth (int code, int slot, double depth)
@@ -316,7 +383,7 @@ enter_depth (int code, int slot, double depth)
   de->code = code;
   de->slot = slot;
   de->depth = depth;
-  de->st = current_state;
+  de->st = state_index();
 
   depth_count++;
 }
@@ -351,12 +418,13 @@ db_line (vector3 *v1, vector3 *v2, colour *c)
     }
 
     le = line_array + line_count;
-    le->v1 = *v1;
-    le->v2 = *v2;
+    db_store (&(le->v1), v1);
+    db_store (&(le->v2), v2);
     if (c) {
-      le->c = colour_clone (c);
+      le->col = *c;
+      le->own_colour = TRUE;
     } else {
-      le->c = NULL;
+      le->own_colour = FALSE;
     }
 
     enter_depth (LINE_CODE, line_count++, (v1->z + v2->z) / 2.0);
@@ -381,11 +449,12 @@ db_point (vector3 *v, colour *c)
   }
 
   pte = point_array + point_count;
-  pte->v = *v;
+  db_store (&(pte->v), v);
   if (c) {
-    pte->c = colour_clone (c);
+    pte->col = *c;
+    pte->own_colour = TRUE;
   } else {
-    pte->c = NULL;
+    pte->own_colour = FALSE;
   }
 
   enter_depth (POINT_CODE, point_count++, v->z);
@@ -418,12 +487,12 @@ db_plane (vector3 *p1, vector3 *p2, vector3 *p3, vector3 *p4,
   pe = plane_array + plane_count;
   pe->col = *c;
   pe->znorm = znorm;
-  pe->p1 = *p1;
-  pe->p2 = *p2;
+  db_store (&(pe->p1), p1);
+  db_store (&(pe->p2), p2);
 
   if ((code == T_CODE) || (code == T1_CODE)) {
-    pe->p3 = *p3;
-    v3_initialize (&(pe->p4), 0.0, 0.0, 0.0);
+    db_store (&(pe->p3), p3);
+    pe->p4.x = pe->p4.y = pe->p4.z = 0.0;
 
   } else {
     vector3 vec;
@@ -444,11 +513,11 @@ db_plane (vector3 *p1, vector3 *p2, vector3 *p3, vector3 *p4,
     len2 += v3_length (&vec);
 
     if (len1 < len2) {		/* plane is not twisted in the xy-plane */
-      pe->p3 = *p3;
-      pe->p4 = *p4;
+      db_store (&(pe->p3), p3);
+      db_store (&(pe->p4), p4);
     } else {			/* plane is twisted; correct it */
-      pe->p3 = *p4;
-      pe->p4 = *p3;
+      db_store (&(pe->p3), p4);
+      db_store (&(pe->p4), p3);
     }
   }
 
@@ -554,12 +623,12 @@ db_sphere (vector3 *v, double r, colour *c, int donald_duck)
   }
 
   se = sphere_array + sphere_count;
-  se->v = *v;
+  db_store (&(se->v), v);
   se->rad = r;
   se->col = *c;
   se->donald_duck = donald_duck;
 
-  enter_depth (SPHERE_CODE, sphere_count++, se->v.z + 0.5 * se->rad);
+  enter_depth (SPHERE_CODE, sphere_count++, v->z + 0.5 * r);
 }
 
 
@@ -585,53 +654,84 @@ db_depth_sort (void)
 }
 
 
+/*------------------------------------------------------------*/
+static void
+db_transform_array (db_vector *first, int count, size_t stride,
+		    double matrix[4][4])
+{
+#ifdef FLOAT_GEOMETRY
+  vector3 chunk[DB_CHUNK];
+  char *pos = (char *) first;
+  int number, slot;
+
+  while (count > 0) {		/* via double, one chunk at a time */
+    number = (count > DB_CHUNK) ? DB_CHUNK : count;
+    for (slot = 0; slot < number; slot++)
+      db_load (chunk + slot, (db_vector *) (pos + slot * stride));
+    matrix3_transform_array (chunk, number, sizeof (vector3), matrix);
+    for (slot = 0; slot < number; slot++)
+      db_store ((db_vector *) (pos + slot * stride), chunk + slot);
+    pos += number * stride;
+    count -= number;
+  }
+#else
+  matrix3_transform_array (first, count, stride, matrix);
+#endif
+}
+
+
 /*------------------------------------------------------------*/
 static void
 db_transform (double matrix[4][4], double scale)
 {
   int slot;
-  line_db_entry *le;
-  point_db_entry *pte;
   sphere_db_entry *se;
-  plane_db_entry *pe;
-  label_db_entry *lae;
   stick_db_entry *ste;
 
-  le = line_array;
-  for (slot = 0; slot < line_count; slot++, le++) {
-    matrix3_transform (&(le->v1), matrix);
-    matrix3_transform (&(le->v2), matrix);
-  }
-
-  pte = point_array;
-  for (slot = 0; slot < point_count; slot++, pte++) {
-    matrix3_transform (&(pte->v), matrix);
+  if (line_count > 0) {
+    db_transform_array (&(line_array->v1), line_count,
+			sizeof (line_db_entry), matrix);
+    db_transform_array (&(line_array->v2), line_count,
+			sizeof (line_db_entry), matrix);
   }
 
-  se = sphere_array;
-  for (slot = 0; slot < sphere_count; slot++, se++) {
-    matrix3_transform (&(se->v), matrix);
-    se->rad *= scale;
-  }
+  if (point_count > 0)
+    db_transform_array (&(point_array->v), point_count,
+			sizeof (point_db_entry), matrix);
 
-  pe = plane_array;
-  for (slot = 0; slot < plane_count; slot++, pe++) {
-    matrix3_transform (&(pe->p1), matrix);
-    matrix3_transform (&(pe->p2), matrix);
-    matrix3_transform (&(pe->p3), matrix);
-    matrix3_transform (&(pe->p4), matrix);
+  if (sphere_count > 0) {
+    db_transform_array (&(sphere_array->v), sphere_count,
+			sizeof (sphere_db_entry), matrix);
+    se = sphere_array;
+    for (slot = 0; slot < sphere_count; slot++, se++) se->rad *= scale;
   }
 
-  lae = label_array;
-  for (slot = 0; slot < label_count; slot++, lae++) {
-    matrix3_transform (&(lae->pos), matrix);
+  if (plane_count > 0) {
+    db_transform_array (&(plane_array->p1), plane_count,
+			sizeof (plane_db_entry), matrix);
+    db_transform_array (&(plane_array->p2), plane_count,
+			sizeof (plane_db_entry), matrix);
+    db_transform_array (&(plane_array->p3), plane_count,
+			sizeof (plane_db_entry), matrix);
+    db_transform_array (&(plane_array->p4), plane_count,
+			sizeof (plane_db_entry), matrix);
   }
 
-  ste = stick_array;
-  for (slot = 0; slot < stick_count; slot++, ste++) {
-    matrix3_transform (&(ste->p1), matrix);
-    matrix3_transform (&(ste->p2), matrix);
-    v3_scale (&(ste->perp), scale);
+  if (label_count > 0)
+    db_transform_array (&(label_array->pos), label_count,
+			sizeof (label_db_entry), matrix);
+
+  if (stick_count > 0) {
+    db_transform_array (&(stick_array->p1), stick_count,
+			sizeof (stick_db_entry), matrix);
+    db_transform_array (&(stick_array->p2), stick_count,
+			sizeof (stick_db_entry), matrix);
+    ste = stick_array;
+    for (slot = 0; slot < stick_count; slot++, ste++) {
+      ste->perp.x *= scale;
+      ste->perp.y *= scale;
+      ste->perp.z *= scale;
+    }
   }
 }
 
@@ -640,12 +740,15 @@ db_transform (double matrix[4][4], double scale)
 static double
 shade_factor (double znorm, depth_db_entry *de)
 {
+  state *st;
+
   assert (znorm >= 0.0);
   assert (znorm <= 1.0);
   assert (de);
 
-  return (de->st->shading * pow (znorm, de->st->shadingexponent) +
-	  1.0 - de->st->shading);
+  st = state_array[de->st];
+  return (st->shading * pow (znorm, st->shadingexponent) +
+	  1.0 - st->shading);
 }
 
 
@@ -654,18 +757,20 @@ static void
 db_plane_output (depth_db_entry *de, char *plane_type)
 {
   plane_db_entry *pe;
+  state *st;
 
   assert (de);
   assert (plane_type);
   assert (*plane_type);
 
   pe = plane_array + de->slot;
+  st = state_array[de->st];
   colour_darker (&(pe->col), shade_factor (pe->znorm, de), &(pe->col));
 
   if (! str_eq ("P", plane_type)) {
-    output_linecolour (&(de->st->linecolour));
-    output_linewidth (depthcue (de->depth, de->st) * de->st->linewidth);
-    output_linedash (de->st->linedash);
+    output_linecolour (&(st->linecolour));
+    output_linewidth (depthcue (de->depth, st) * st->linewidth);
+    output_linedash (st->linedash);
   }
   output_colour (&(pe->col), TRUE);
   fprintf (outfile, " %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %s\n",
@@ -681,6 +786,7 @@ static void
 db_tri_output (depth_db_entry *de, char *tri_type)
 {
   plane_db_entry *pe;
+  state *st;
   double factor;
 
   assert (de);
@@ -688,14 +794,15 @@ db_tri_output (depth_db_entry *de, char *tri_type)
   assert (*tri_type);
 
   pe = plane_array + de->slot;
-  factor = de->st->shading * pow (pe->znorm, de->st->shadingexponent) +
-           1.0 - de->st->shading;
+  st = state_array[de->st];
+  factor = st->shading * pow (pe->znorm, st->shadingexponent) +
+           1.0 - st->shading;
   colour_darker (&(pe->col), factor, &(pe->col));
 
   if (! str_eq ("T", tri_type)) {
-    output_linecolour (&(de->st->linecolour));
-    output_linewidth (depthcue (de->depth, de->st) * de->st->linewidth);
-    output_linedash (de->st->linedash);
+    output_linecolour (&(st->linecolour));
+    output_linewidth (depthcue (de->depth, st) * st->linewidth);
+    output_linedash (st->linedash);
   }
   output_colour (&(pe->col), TRUE);
   fprintf (outfile, " %.2f %.2f %.2f %.2f %.2f %.2f %s\n",
@@ -710,11 +817,15 @@ db_tri_output (depth_db_entry *de, char *tri_type)
 static void
 db_string_output (char *str, int length, int greek, depth_db_entry *de)
 {
+  state *st;
+
   assert (str);
   assert (*str);
   assert (length > 0);
   assert (de);
 
+  st = state_array[de->st];
+
   output_string (str, length);
   if (greek) {
     PRINT (" FG");
@@ -722,9 +833,9 @@ db_string_output (char *str, int length, int greek, depth_db_entry *de)
     PRINT (" FR");
   }
   fprintf (outfile, " %.2f",
-	            depthcue (de->depth, de->st) * de->st->labelsize);
-  if (de->st->labelbackground != 0.0)
-    fprintf (outfile, " %.2f PRB", de->st->labelbackground);
+	            depthcue (de->depth, st) * st->labelsize);
+  if (st->labelbackground != 0.0)
+    fprintf (outfile, " %.2f PRB", st->labelbackground);
   fprintf (outfile, " PR\n");
 }
 
@@ -734,23 +845,25 @@ static void
 db_label_output (depth_db_entry *de)
 {
   label_db_entry *lae;
+  state *st;
   int len, slot, prev_greek, greek, first;
   int *labelmask;
 
   assert (de);
 
   lae = label_array + de->slot;
+  st = state_array[de->st];
   len = strlen (lae->str);
 
   output_linecolour (&(lae->col));
 
   fprintf (outfile, "%.2f %.2f M", lae->pos.x, lae->pos.y);
-  if (de->st->labelcentre) {
+  if (st->labelcentre) {
     fputc (' ', outfile);
     output_string (lae->str, len);
     fprintf (outfile, " %.2f FR",
-	              depthcue (de->depth, de->st) * de->st->labelsize);
-    if (de->st->labelrotation) {
+	              depthcue (de->depth, st) * st->labelsize);
+    if (st->labelrotation) {
       fprintf (outfile, " CR90\n");
     } else {
       fprintf (outfile, " C\n");
@@ -759,16 +872,16 @@ db_label_output (depth_db_entry *de)
     fputc ('\n', outfile);
   }
 
-  if (de->st->labelrotation) fprintf (outfile, "R90\n");
+  if (st->labelrotation) fprintf (outfile, "R90\n");
 
-  if (de->st->labelmasklength > 0) {
+  if (st->labelmasklength > 0) {
     labelmask = calloc (len, sizeof (int));
-    memcpy (labelmask, de->st->labelmask, de->st->labelmasklength);
+    memcpy (labelmask, st->labelmask, st->labelmasklength);
 
     first = 0;
-    prev_greek = (de->st->labelmask[0] / 3) == 1;
+    prev_greek = (st->labelmask[0] / 3) == 1;
     for (slot = 1; slot < len; slot++) {
-      greek = (de->st->labelmask[slot] / 3) == 1;
+      greek = (st->labelmask[slot] / 3) == 1;
       if (greek != prev_greek) {
 	db_string_output (lae->str + first, slot - first, prev_greek, de);
 	first = slot;
@@ -783,7 +896,7 @@ db_label_output (depth_db_entry *de)
     db_string_output (lae->str, len, FALSE, de);
   }
 
-  if (de->st->labelrotation) fprintf (outfile, "grestore\n");
+  if (st->labelrotation) fprintf (outfile, "grestore\n");
 
   label_output_count++;
 }
@@ -795,7 +908,9 @@ db_output (void)
 {
   int slot;
   double rval;
+  vector3 vec;
   depth_db_entry *de;
+  state *st;
   line_db_entry *le;
   point_db_entry *pte;
   sphere_db_entry *se;
@@ -810,18 +925,19 @@ db_output (void)
 
   for (slot = 0; slot < depth_count; slot++) {
     de = depth_array + slot;
+    st = state_array[de->st];
 
     switch (de->code) {
 
     case LINE_CODE:
       le = line_array + de->slot;
-      if (le->c) {
-	output_linecolour (le->c);
+      if (le->own_colour) {
+	output_linecolour (&(le->col));
       } else {
-	output_linecolour (&(de->st->linecolour));
+	output_linecolour (&(st->linecolour));
       }
-      output_linewidth (depthcue (de->depth, de->st) * de->st->linewidth);
-      output_linedash (de->st->linedash);
+      output_linewidth (depthcue (de->depth, st) * st->linewidth);
+      output_linedash (st->linedash);
       fprintf (outfile, "%.2f %.2f %.2f %.2f L\n",
 		       le->v1.x, le->v1.y, le->v2.x, le->v2.y);
       line_output_count++;
@@ -829,12 +945,12 @@ db_output (void)
 
     case POINT_CODE:
       pte = point_array + de->slot;
-      if (pte->c) {
-	output_linecolour (pte->c);
+      if (pte->own_colour) {
+	output_linecolour (&(pte->col));
       } else {
-	output_linecolour (&(de->st->linecolour));
+	output_linecolour (&(st->linecolour));
       }
-      output_linewidth (depthcue (de->depth, de->st) * de->st->linewidth);
+      output_linewidth (depthcue (de->depth, st) * st->linewidth);
       output_linedash (0.0);
       fprintf (outfile, "%.2f %.2f PT\n", pte->v.x, pte->v.y);
       point_output_count++;
@@ -842,9 +958,9 @@ db_output (void)
 
     case SPHERE_CODE:
       se = sphere_array + de->slot;
-      output_linecolour (&(de->st->linecolour));
-      output_linewidth (depthcue (de->depth, de->st) * de->st->linewidth);
-      output_linedash (de->st->linedash);
+      output_linecolour (&(st->linecolour));
+      output_linewidth (depthcue (de->depth, st) * st->linewidth);
+      output_linedash (st->linedash);
       output_spherecolour (&(se->col));
       fprintf (outfile, "%.2f %.2f %.2f %s\n",
 	       se->v.x, se->v.y, se->rad, se->donald_duck ? "SD" : "SS");
@@ -913,17 +1029,18 @@ db_output (void)
       break;
 
     case LABEL_CODE:
-      if (de->st->labelclip) db_label_output (de); /* clipped labels */
+      if (st->labelclip) db_label_output (de); /* clipped labels */
       break;
 
     case STICK_CODE:
       ste = stick_array + de->slot;
-      output_linecolour (&(de->st->linecolour));
-      output_linewidth (depthcue (de->depth, de->st) * de->st->linewidth);
-      output_linedash (de->st->linedash);
+      output_linecolour (&(st->linecolour));
+      output_linewidth (depthcue (de->depth, st) * st->linewidth);
+      output_linedash (st->linedash);
 				/* elliptical arc part of stick */
+      db_load (&vec, &(ste->perp));
       fprintf (outfile, "%.2f %.2f %.2f",
-	       ste->p2.x, ste->p2.y, v3_length (&(ste->perp)) * ste->taper);
+	       ste->p2.x, ste->p2.y, v3_length (&vec) * ste->taper);
       rval = ste->dir.x / sqrt (ste->dir.x * ste->dir.x +
 				ste->dir.y * ste->dir.y);
       rval = (ste->dir.y >= 0.0) ?
@@ -943,7 +1060,7 @@ db_output (void)
   for (slot = 0; slot < depth_count; slot++) {	/* unclipped labels */
     de = depth_array + slot;
     if ((de->code == LABEL_CODE) &&
-	(! de->st->labelclip)) db_label_output (de);
+	(! state_array[de->st]->labelclip)) db_label_output (de);
   }
 }
 
@@ -1001,6 +1118,7 @@ ps_first_plot (void)
   if (!first_plot) return;
 
   set_outfile ("w");
+  bounding_box[0] = bounding_box[1] = bounding_box[2] = bounding_box[3] = -1.0;
 
   if (fprintf (outfile, "%%!PS-Adobe-3.0\n") < 0)
     yyerror ("could not write to the output PostScript file");
@@ -1455,6 +1573,7 @@ void
 ps_label (vector3 *p, char *label, colour *c)
 {
   label_db_entry *lae;
+  vector3 pos;
 
   assert (p);
   assert (label);
@@ -1467,7 +1586,8 @@ ps_label (vector3 *p, char *label, colour *c)
   }
   lae = label_array + label_count;
 
-  v3_sum (&(lae->pos), p, &(current_state->labeloffset));
+  v3_sum (&pos, p, &(current_state->labeloffset));
+  db_store (&(lae->pos), &pos);
   lae->str = str_clone (label);
   if (c) {
     lae->col = *c;
@@ -1475,7 +1595,7 @@ ps_label (vector3 *p, char *label, colour *c)
     lae->col = current_state->linecolour;
   }
 
-  enter_depth (LABEL_CODE, label_count, lae->pos.z);
+  enter_depth (LABEL_CODE, label_count, pos.z);
 
   label_count++;
 }
@@ -1616,6 +1736,8 @@ ps_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c)
   } else {			/* out of xy plane: output as proper stick */
 
     stick_db_entry *ste;
+    vector3 p1, p2, dir;
+    double taper;
 
     radius = current_state->stickradius;
 				/* shorten stick by sphere radii */
@@ -1631,20 +1753,20 @@ ps_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c)
     ste = stick_array + stick_count;
 
     if (v1->z > v2->z) {	/* closest point first */
-      ste->p1 = *v1;
+      p1 = *v1;
       v3_scale (&vec, shorten2);
-      v3_difference (&(ste->p2), v2, &vec);
+      v3_difference (&p2, v2, &vec);
     } else {
-      ste->p1 = *v2;
+      p1 = *v2;
       v3_scale (&vec, shorten1);
-      v3_sum (&(ste->p2), v1, &vec);
+      v3_sum (&p2, v1, &vec);
     }
 				/* direction vector, and perpendicular */
-    v3_difference (&(ste->dir), &(ste->p2), &(ste->p1));
-    v3_normalize (&(ste->dir));
-    v3_cross_product (&(ste->perp), &zaxis, &(ste->dir));
-    v3_normalize (&(ste->perp));
-    v3_scale (&(ste->perp), current_state->stickradius);
+    v3_difference (&dir, &p2, &p1);
+    v3_normalize (&dir);
+    v3_cross_product (&perp, &zaxis, &dir);
+    v3_normalize (&perp);
+    v3_scale (&perp, current_state->stickradius);
 
     if (c) {
       ste->col = *c;
@@ -1652,22 +1774,22 @@ ps_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c)
       ste->col = current_state->planecolour;
     }
 
-    ste->taper = (1.0 - current_state->sticktaper) +
-	         current_state->sticktaper *
-	         acos (fabs (ste->dir.z)) / to_radians (90.0);
+    taper = (1.0 - current_state->sticktaper) +
+	    current_state->sticktaper *
+	    acos (fabs (dir.z)) / to_radians (90.0);
 
     if (r1 < 0.0) {		/* colourparts; split stick */
-      ste->taper = 0.5 + 0.5 * ste->taper;
+      taper = 0.5 + 0.5 * taper;
       if (v1->z > v2->z) {
-	v3_scale (&(ste->perp), ste->taper);
+	v3_scale (&perp, taper);
 	depth = v2->z + 0.5 * r2 + 0.001;
       } else {
 	depth = v2->z + 0.5 * r2 - 0.001;
       }
     } else if (r2 < 0.0) {
-      ste->taper = 0.5 + 0.5 * ste->taper;
+      taper = 0.5 + 0.5 * taper;
       if (v1->z < v2->z) {
-	v3_scale (&(ste->perp), ste->taper);
+	v3_scale (&perp, taper);
 	depth = v1->z + 0.5 * r1 + 0.001;
       } else {
 	depth = v1->z + 0.5 * r1 - 0.001;
@@ -1676,6 +1798,12 @@ ps_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c)
       depth = 0.5 * (v1->z + 0.5 * r1 + v2->z + 0.5 * r2);
     }
 
+    db_store (&(ste->p1), &p1);
+    db_store (&(ste->p2), &p2);
+    db_store (&(ste->dir), &dir);
+    db_store (&(ste->perp), &perp);
+    ste->taper = taper;
+
     enter_depth (STICK_CODE, stick_count, depth);
 
     stick_count++;
@@ -1938,7 +2066,7 @@ ps_object (int code, vector3 *triplets, int count)
     break;
 
   case OBJ_POINTS_COLOURS:
-    for (slot = 0; slot < count; slot++) {
+    for (slot = 0; slot < count; slot += 2) {
       v = triplets + slot + 1;
       rgb.x = v->x;
       rgb.y = v->y;
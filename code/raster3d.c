@@ -8,6 +8,8 @@
      4-Dec-1996  first attempts
     16-Sep-1997  label output using GLUT stroke character def's
     17-Sep-1997  fairly finished
+    18-Oct-2026  in-process ray tracing of the scene
+    18-Oct-2026  options reset for each output (batch mode)
 */
 
 #include <assert.h>
@@ -17,6 +19,7 @@
 #include "raster3d.h"
 #include "global.h"
 #include "graphics.h"
+#include "raytrace.h"
 #include "segment.h"
 #include "state.h"
 
@@ -38,6 +41,7 @@ extern StrokeFontRec glutStrokeRoman;
 static FILE *proper_outfile;
 static FILE *header_file;
 
+static boolean raytrace = FALSE;	/* scene to 'raytrace.c', not a file */
 static int antialiasing = 3;
 static int ntx, nty, npx, npy;
 static vector3 lightdirection;
@@ -61,6 +65,7 @@ convert_colour (colour *c)
   assert (c);
 
   colour_copy_to_rgb (&rgb, c);
+  if (raytrace) return;
   rgb.x *= rgb.x;		/* Raster3D has a weird concept of RGB */
   rgb.y *= rgb.y;
   rgb.z *= rgb.z;
@@ -79,6 +84,12 @@ write_triangle (vector3 *p1, vector3 *p2, vector3 *p3)
       (((p1->z < -slab) && (p2->z < -slab) && (p3->z < -slab)) ||
        ((p1->z > slab) && (p2->z > slab) && (p3->z > slab)))) return FALSE;
 
+  if (raytrace) {
+    rt_triangle (p1, p2, p3, &rgb);
+    triangle_count++;
+    return TRUE;
+  }
+
   fprintf (outfile,
 	   "1\n%.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %g %g %g\n",
 	   p1->x, p1->y, p1->z,
@@ -100,6 +111,11 @@ write_normals (vector3 *n1, vector3 *n2, vector3 *n3)
   assert (n2);
   assert (n3);
 
+  if (raytrace) {
+    rt_normals (n1, n2, n3);
+    return;
+  }
+
   fprintf (outfile,
 	   "7\n%.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f\n",
 	   n1->x, n1->y, n1->z,
@@ -116,6 +132,11 @@ write_vertex_colours (vector3 *c1, vector3 *c2, vector3 *c3)
   assert (c2);
   assert (c3);
 
+  if (raytrace) {
+    rt_vertex_colours (c1, c2, c3);
+    return;
+  }
+
   fprintf (outfile,
 	   "17\n%g %g %g %g %g %g %g %g %g\n",
 	   c1->x * c1->x, c1->y * c1->y, c1->z * c1->z,
@@ -134,6 +155,12 @@ write_sphere (vector3 *p, double radius)
   if ((slab > 0.0) &&
       ((p->z - radius < -slab) || (p->z + radius > slab))) return;
 
+  if (raytrace) {
+    rt_sphere (p, radius, &rgb);
+    sphere_count++;
+    return;
+  }
+
   fprintf (outfile,
 	   "2\n%.2f %.2f %.2f %.2f %.3g %.3g %.3g\n",
 	   p->x, p->y, p->z, radius, rgb.x, rgb.y, rgb.z);
@@ -154,6 +181,12 @@ write_cylinder_round (vector3 *p1, vector3 *p2, double radius)
       (((p1->z - radius < -slab) && (p2->z - radius < -slab)) ||
        (((p1->z + radius > slab) && (p2->z + radius > slab))))) return;
 
+  if (raytrace) {
+    rt_cylinder (p1, p2, radius, TRUE, &rgb);
+    cylinder_count++;
+    return;
+  }
+
   fprintf (outfile,
 	   "3\n%.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %g %g %g\n",
 	   p1->x, p1->y, p1->z, radius,
@@ -176,6 +209,12 @@ write_cylinder_flat (vector3 *p1, vector3 *p2, double radius)
       (((p1->z - radius < -slab) && (p2->z - radius < -slab)) ||
        (((p1->z + radius > slab) && (p2->z + radius > slab))))) return;
 
+  if (raytrace) {
+    rt_cylinder (p1, p2, radius, FALSE, &rgb);
+    cylinder_count++;
+    return;
+  }
+
   fprintf (outfile,
 	   "5\n%.2f %.2f %.2f %.2f %.2f %.2f %.2f %.2f %g %g %g\n",
 	   p1->x, p1->y, p1->z, radius,
@@ -195,13 +234,20 @@ write_material (void)
       ! colour_unequal (&(current_state->specularcolour),
 			&(material_specularcolour))) return;
 
-  if (special_material) fprintf (outfile, "9\n");
-
   material_shininess = current_state->shininess;
   material_transparency = current_state->transparency;
   material_specularcolour = current_state->specularcolour;
 
   convert_colour (&(material_specularcolour));
+
+  if (raytrace) {
+    rt_material (material_shininess * 128.0,
+		 (material_transparency == 0.0) ? 0.25 : 0.6,
+		 &rgb, material_transparency);
+    return;
+  }
+
+  if (special_material) fprintf (outfile, "9\n");
   fprintf (outfile, "8\n%.2g %.3g %.3g %.3g %.3g %.3g 1 0 0 0\n",
 	   material_shininess * 128.0,
 	   (material_transparency == 0.0) ? 0.25 : 0.6,
@@ -300,10 +346,30 @@ r3d_set (void)
 
   constant_colours_to_rgb();
 
+  raytrace = FALSE;
+  antialiasing = 3;
+
   output_mode = RASTER3D_MODE;
 }
 
 
+/*------------------------------------------------------------*/
+void
+r3d_set_raytrace (void)
+     /*
+       The scene is given to the ray tracer instead of being written
+       to file. The output file and output mode are then left to the
+       image file format.
+     */
+{
+  r3d_set();
+
+  output_comment = do_nothing_str;
+
+  raytrace = TRUE;
+}
+
+
 /*------------------------------------------------------------*/
 void
 r3d_first_plot (void)
@@ -442,7 +508,19 @@ r3d_start_plot (void)
   sphere_count = 0;
   cylinder_count = 0;
 
-  set_area_values (-0.5, -0.5, 0.5, 0.5);
+  material_shininess = 0.2;
+  material_transparency = 0.0;
+  colour_copy_to_rgb (&material_specularcolour, &white_colour);
+  special_material = FALSE;
+
+  if (raytrace) {		/* one scene per plot */
+    rt_start_plot();
+    set_area_values (0.0, 0.0,
+		     (double) (output_width - 1),
+		     (double) (output_height - 1));
+  } else {
+    set_area_values (-0.5, -0.5, 0.5, 0.5);
+  }
   background_colour = black_colour;
 }
 
@@ -493,6 +571,8 @@ r3d_directionallight (void)
   }
   v3_normalize (&lightdirection);
   clear_dstack();
+
+  if (raytrace) rt_directionallight (&lightdirection);
 }
 
 
@@ -503,6 +583,15 @@ r3d_pointlight (void)
   assert (dstack_size == 3);
 
   convert_colour (&(current_state->lightcolour));
+
+  if (raytrace) {
+    vector3 p;
+    v3_initialize (&p, dstack[0], dstack[1], dstack[2]);
+    rt_pointlight (&p, &rgb);
+    clear_dstack();
+    return;
+  }
+
   fprintf (outfile, "13\n%.2f %.2f %.2f %.2f 0.25 1 25.6 %g %g %g\n",
 	   dstack[0], dstack[1], dstack[2], current_state->lightradius,
 	   rgb.x, rgb.y, rgb.z);
@@ -933,6 +1022,13 @@ convert_vector_colour (vector3 *v)
 {
   assert (v);
 
+  if (raytrace) {
+    rgb.x = v->x;
+    rgb.y = v->y;
+    rgb.z = v->z;
+    return;
+  }
+
   rgb.x = v->x * v->x;		/* Raster3D has a weird concept of RGB */
   rgb.y = v->y * v->y;
   rgb.z = v->z * v->z;
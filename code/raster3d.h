@@ -8,6 +8,7 @@
      4-Dec-1996  first attempts
     16-Sep-1997  label output using GLUT stroke character def's
     17-Sep-1997  fairly finished
+    18-Oct-2026  in-process ray tracing of the scene
 */
 
 #ifndef RASTER3D_H
@@ -16,6 +17,7 @@
 #include "coord.h"
 
 void r3d_set (void);
+void r3d_set_raytrace (void);
 
 void r3d_first_plot (void);
 void r3d_finish_output (void);
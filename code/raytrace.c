@@ -0,0 +1,1176 @@
+/* raytrace.c
+
+   MolScript v2.1.2
+
+   Ray tracing of the Raster3D scene for image file output.
+
+   The geometry is that of the Raster3D output in 'raster3d.c':
+   spheres, cylinders and triangles with optional vertex normals and
+   colours. Instead of being written as text for the 'render' program,
+   it is kept in memory, a bounding volume hierarchy (BVH) is built
+   over it using the surface area heuristic (SAH), and the image is
+   traced with an orthographic camera.
+
+   The shading follows the Raster3D defaults: a main light source, a
+   secondary light from the viewer, ambient light and Phong specular
+   highlights. Shadows are cast if 'shadows' is on. Optionally, the
+   ambient and secondary light are modulated by ambient occlusion.
+
+   The image is traced in tiles. If THREAD_SUPPORT is defined, the
+   tiles are traced in parallel by POSIX threads, one per processor.
+   Only the rows requested by 'rt_render_rows' are kept.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  render a range of rows at a time
+    18-Oct-2026  transform of the geometry for animation frames
+    18-Oct-2026  tiles run by the shared thread jobs
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "clib/angle.h"
+#include "clib/matrix3.h"
+#include "clib/thread_jobs.h"
+
+#include "raytrace.h"
+#include "global.h"
+#include "graphics.h"
+
+
+/*============================================================*/
+#define TILE_SIZE 16
+#define MAX_POINTLIGHTS 8
+
+#define LEAF_SIZE 4
+#define SAH_BINS 12
+#define STACK_SIZE 64
+
+#define MAX_LAYERS 8		/* transparent surfaces along a ray */
+#define EPSILON 1.0e-3		/* ray offset from surfaces */
+#define AO_DISTANCE 8.0		/* reach of ambient occlusion rays */
+
+#define PHONG 25.6		/* the Raster3D defaults */
+#define PRIMARY 0.75
+#define SECONDARY 0.25
+#define AMBIENT 0.05
+#define SPECULAR 0.25
+
+enum primitive_types {RT_SPHERE, RT_CYLINDER_ROUND, RT_CYLINDER_FLAT,
+		      RT_TRIANGLE};
+
+typedef struct {
+  double phong;
+  double specular;
+  double specularcolour[3];
+  double transparency;
+} material;
+
+typedef struct {
+  int type;
+  int material;
+  boolean normals;		/* triangle vertex normals given */
+  boolean colours;		/* triangle vertex colours given */
+  float p[3][3];		/* centre, cylinder ends or triangle vertices */
+  float radius;
+  float n[3][3];
+  float c[3][3];
+} primitive;
+
+typedef struct {
+  float lo[3], hi[3];
+  int first;			/* first primitive, or left child if interior */
+  int count;			/* number of primitives; 0 if interior */
+} bvh_node;
+
+typedef struct {
+  double t;
+  int prim;
+  double u, v;			/* barycentric coordinates for triangles */
+  int part;			/* cylinder: 0 body, 1 first end, 2 second end */
+} hit;
+
+static primitive *prims = NULL;
+static int prim_count, prim_alloc;
+
+static material *materials = NULL;
+static int material_count, material_alloc;
+
+static bvh_node *nodes = NULL;
+static int node_count;
+static int *prim_index = NULL;
+static float *centroids = NULL;
+
+static double lightdirection[3] = {0.57735027, 0.57735027, 0.57735027};
+static double pointlights[MAX_POINTLIGHTS][6]; /* position and colour */
+static int pointlight_count;
+
+static int accum = 0;
+static int occlusion = 0;
+
+static double bg[3];
+static double scene_top;
+static unsigned char *pixels = NULL;
+static int pixels_first, pixels_rows;
+
+static int tiles_x;
+
+
+/*------------------------------------------------------------*/
+static void
+copy3 (float *dest, const vector3 *v)
+{
+  dest[0] = (float) v->x;
+  dest[1] = (float) v->y;
+  dest[2] = (float) v->z;
+}
+
+
+/*------------------------------------------------------------*/
+static primitive *
+new_primitive (int type, colour *rgb)
+{
+  primitive *pr;
+
+  assert (rgb);
+
+  if (prim_count >= prim_alloc) {
+    prim_alloc *= 2;
+    prims = realloc (prims, prim_alloc * sizeof (primitive));
+  }
+  pr = prims + prim_count++;
+
+  pr->type = type;
+  pr->material = material_count - 1;
+  pr->normals = FALSE;
+  pr->colours = FALSE;
+  pr->radius = 0.0;
+  copy3 (pr->c[0], (vector3 *) &(rgb->x));
+
+  return pr;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_set_accum (int number)
+{
+  assert (number > 0);
+
+  accum = number;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_set_occlusion (int samples)
+{
+  assert (samples >= 0);
+
+  occlusion = samples;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_start_plot (void)
+{
+  colour white = {COLOUR_RGB, 1.0, 1.0, 1.0};
+
+  if (prims == NULL) {
+    prim_alloc = 4096;
+    prims = malloc (prim_alloc * sizeof (primitive));
+    material_alloc = 16;
+    materials = malloc (material_alloc * sizeof (material));
+  }
+  prim_count = 0;
+  material_count = 0;
+  pointlight_count = 0;
+  lightdirection[0] = lightdirection[1] = lightdirection[2] = 0.57735027;
+
+  rt_material (PHONG, SPECULAR, &white, 0.0);
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_directionallight (vector3 *direction)
+{
+  double length;
+
+  assert (direction);
+
+  length = v3_length (direction);
+  if (length <= 0.0) return;
+
+  lightdirection[0] = direction->x / length;
+  lightdirection[1] = direction->y / length;
+  lightdirection[2] = direction->z / length;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_pointlight (vector3 *p, colour *rgb)
+{
+  double *pl;
+
+  assert (p);
+  assert (rgb);
+
+  if (pointlight_count >= MAX_POINTLIGHTS) {
+    if (message_mode)
+      fprintf (stderr, "ignoring 'pointlight'; maximum number reached\n");
+    return;
+  }
+
+  pl = pointlights[pointlight_count++];
+  pl[0] = p->x;
+  pl[1] = p->y;
+  pl[2] = p->z;
+  pl[3] = rgb->x;
+  pl[4] = rgb->y;
+  pl[5] = rgb->z;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_material (double phong, double specular, colour *specularcolour,
+	     double transparency)
+{
+  material *m;
+
+  assert (specularcolour);
+
+  if (material_count >= material_alloc) {
+    material_alloc *= 2;
+    materials = realloc (materials, material_alloc * sizeof (material));
+  }
+  m = materials + material_count++;
+
+  m->phong = phong;
+  m->specular = specular;
+  m->specularcolour[0] = specularcolour->x;
+  m->specularcolour[1] = specularcolour->y;
+  m->specularcolour[2] = specularcolour->z;
+  m->transparency = transparency;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_triangle (vector3 *p1, vector3 *p2, vector3 *p3, colour *rgb)
+{
+  primitive *pr;
+
+  assert (p1);
+  assert (p2);
+  assert (p3);
+
+  pr = new_primitive (RT_TRIANGLE, rgb);
+  copy3 (pr->p[0], p1);
+  copy3 (pr->p[1], p2);
+  copy3 (pr->p[2], p3);
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_normals (vector3 *n1, vector3 *n2, vector3 *n3)
+     /* Vertex normals for the last triangle. */
+{
+  primitive *pr;
+
+  assert (n1);
+  assert (n2);
+  assert (n3);
+  assert (prim_count > 0);
+
+  pr = prims + prim_count - 1;
+  assert (pr->type == RT_TRIANGLE);
+
+  copy3 (pr->n[0], n1);
+  copy3 (pr->n[1], n2);
+  copy3 (pr->n[2], n3);
+  pr->normals = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_vertex_colours (vector3 *c1, vector3 *c2, vector3 *c3)
+     /* Vertex colours for the last triangle. */
+{
+  primitive *pr;
+
+  assert (c1);
+  assert (c2);
+  assert (c3);
+  assert (prim_count > 0);
+
+  pr = prims + prim_count - 1;
+  assert (pr->type == RT_TRIANGLE);
+
+  copy3 (pr->c[0], c1);
+  copy3 (pr->c[1], c2);
+  copy3 (pr->c[2], c3);
+  pr->colours = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_sphere (vector3 *p, double radius, colour *rgb)
+{
+  primitive *pr;
+
+  assert (p);
+  assert (radius > 0.0);
+
+  pr = new_primitive (RT_SPHERE, rgb);
+  copy3 (pr->p[0], p);
+  pr->radius = radius;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_cylinder (vector3 *p1, vector3 *p2, double radius, boolean round,
+	     colour *rgb)
+{
+  primitive *pr;
+
+  assert (p1);
+  assert (p2);
+  assert (radius > 0.0);
+
+  if (v3_distance (p1, p2) <= 0.0) {
+    if (round) rt_sphere (p1, radius, rgb);
+    return;
+  }
+
+  pr = new_primitive (round ? RT_CYLINDER_ROUND : RT_CYLINDER_FLAT, rgb);
+  copy3 (pr->p[0], p1);
+  copy3 (pr->p[1], p2);
+  pr->radius = radius;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+primitive_bounds (primitive *pr, float *lo, float *hi)
+{
+  int axis, slot;
+  float r;
+
+  switch (pr->type) {
+
+  case RT_SPHERE:
+    for (axis = 0; axis < 3; axis++) {
+      lo[axis] = pr->p[0][axis] - pr->radius;
+      hi[axis] = pr->p[0][axis] + pr->radius;
+    }
+    break;
+
+  case RT_CYLINDER_ROUND:
+  case RT_CYLINDER_FLAT:
+    r = pr->radius;
+    for (axis = 0; axis < 3; axis++) {
+      lo[axis] = ((pr->p[0][axis] < pr->p[1][axis]) ?
+		  pr->p[0][axis] : pr->p[1][axis]) - r;
+      hi[axis] = ((pr->p[0][axis] > pr->p[1][axis]) ?
+		  pr->p[0][axis] : pr->p[1][axis]) + r;
+    }
+    break;
+
+  case RT_TRIANGLE:
+    for (axis = 0; axis < 3; axis++) {
+      lo[axis] = hi[axis] = pr->p[0][axis];
+      for (slot = 1; slot < 3; slot++) {
+	if (pr->p[slot][axis] < lo[axis]) lo[axis] = pr->p[slot][axis];
+	if (pr->p[slot][axis] > hi[axis]) hi[axis] = pr->p[slot][axis];
+      }
+    }
+    break;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static float
+half_area (float *lo, float *hi)
+{
+  float dx = hi[0] - lo[0], dy = hi[1] - lo[1], dz = hi[2] - lo[2];
+
+  return dx * dy + dy * dz + dz * dx;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+grow_bounds (float *lo, float *hi, float *plo, float *phi)
+{
+  int axis;
+
+  for (axis = 0; axis < 3; axis++) {
+    if (plo[axis] < lo[axis]) lo[axis] = plo[axis];
+    if (phi[axis] > hi[axis]) hi[axis] = phi[axis];
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+build_node (int node, int first, int count, float *bounds, int level)
+     /*
+       Binned SAH split over all three axes; a leaf is made when no
+       split is cheaper than testing all primitives, or when the tree
+       would become too deep for the traversal stack.
+     */
+{
+  bvh_node *bn = nodes + node;
+  float clo[3], chi[3], blo[SAH_BINS][3], bhi[SAH_BINS][3];
+  float llo[3], lhi[3], rlo[3], rhi[3];
+  float *c, scale, cost, best_cost, area_left[SAH_BINS];
+  int bcount[SAH_BINS], left_count[SAH_BINS];
+  int axis, slot, bin, best_axis, best_bin, total, left, right, tmp;
+
+  bn->lo[0] = bn->lo[1] = bn->lo[2] = 1.0e30;
+  bn->hi[0] = bn->hi[1] = bn->hi[2] = -1.0e30;
+  clo[0] = clo[1] = clo[2] = 1.0e30;
+  chi[0] = chi[1] = chi[2] = -1.0e30;
+  for (slot = first; slot < first + count; slot++) {
+    tmp = prim_index[slot];
+    grow_bounds (bn->lo, bn->hi, bounds + 6 * tmp, bounds + 6 * tmp + 3);
+    c = centroids + 3 * tmp;
+    grow_bounds (clo, chi, c, c);
+  }
+
+  bn->first = first;
+  bn->count = count;
+  if ((count <= LEAF_SIZE) || (level >= STACK_SIZE - 2)) return;
+
+  best_cost = (float) count * half_area (bn->lo, bn->hi);
+  best_axis = -1;
+  best_bin = 0;
+
+  for (axis = 0; axis < 3; axis++) {
+    if (chi[axis] - clo[axis] <= 0.0) continue;
+    scale = (float) SAH_BINS / (chi[axis] - clo[axis]);
+
+    for (bin = 0; bin < SAH_BINS; bin++) {
+      bcount[bin] = 0;
+      blo[bin][0] = blo[bin][1] = blo[bin][2] = 1.0e30;
+      bhi[bin][0] = bhi[bin][1] = bhi[bin][2] = -1.0e30;
+    }
+    for (slot = first; slot < first + count; slot++) {
+      tmp = prim_index[slot];
+      bin = (int) ((centroids[3 * tmp + axis] - clo[axis]) * scale);
+      if (bin >= SAH_BINS) bin = SAH_BINS - 1;
+      bcount[bin]++;
+      grow_bounds (blo[bin], bhi[bin], bounds + 6 * tmp, bounds + 6 * tmp + 3);
+    }
+
+    llo[0] = llo[1] = llo[2] = 1.0e30;
+    lhi[0] = lhi[1] = lhi[2] = -1.0e30;
+    total = 0;
+    for (bin = 0; bin < SAH_BINS - 1; bin++) { /* sweep from the left */
+      total += bcount[bin];
+      if (bcount[bin]) grow_bounds (llo, lhi, blo[bin], bhi[bin]);
+      left_count[bin] = total;
+      area_left[bin] = total ? half_area (llo, lhi) : 0.0;
+    }
+
+    rlo[0] = rlo[1] = rlo[2] = 1.0e30;
+    rhi[0] = rhi[1] = rhi[2] = -1.0e30;
+    total = 0;
+    for (bin = SAH_BINS - 1; bin > 0; bin--) { /* sweep from the right */
+      total += bcount[bin];
+      if (bcount[bin]) grow_bounds (rlo, rhi, blo[bin], bhi[bin]);
+      if ((left_count[bin - 1] == 0) || (total == 0)) continue;
+      cost = 0.125 * half_area (bn->lo, bn->hi) + /* traversal step */
+	     area_left[bin - 1] * left_count[bin - 1] +
+	     half_area (rlo, rhi) * total;
+      if (cost < best_cost) {
+	best_cost = cost;
+	best_axis = axis;
+	best_bin = bin;
+      }
+    }
+  }
+
+  if (best_axis < 0) return;	/* leaf */
+
+  scale = (float) SAH_BINS / (chi[best_axis] - clo[best_axis]);
+  left = first;
+  right = first + count - 1;
+  while (left <= right) {
+    tmp = prim_index[left];
+    bin = (int) ((centroids[3 * tmp + best_axis] - clo[best_axis]) * scale);
+    if (bin >= SAH_BINS) bin = SAH_BINS - 1;
+    if (bin < best_bin) {
+      left++;
+    } else {
+      prim_index[left] = prim_index[right];
+      prim_index[right--] = tmp;
+    }
+  }
+
+  bn->first = node_count;
+  bn->count = 0;
+  node_count += 2;
+  build_node (bn->first, first, left - first, bounds, level + 1);
+  build_node (nodes[node].first + 1, left, first + count - left, bounds,
+	      level + 1);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+build_bvh (void)
+{
+  int slot, axis;
+  float *bounds;
+
+  nodes = malloc ((2 * prim_count + 1) * sizeof (bvh_node));
+  prim_index = malloc ((prim_count + 1) * sizeof (int));
+  centroids = malloc ((3 * prim_count + 1) * sizeof (float));
+  bounds = malloc ((6 * prim_count + 1) * sizeof (float));
+
+  for (slot = 0; slot < prim_count; slot++) {
+    prim_index[slot] = slot;
+    primitive_bounds (prims + slot, bounds + 6 * slot, bounds + 6 * slot + 3);
+    for (axis = 0; axis < 3; axis++) {
+      centroids[3 * slot + axis] = 0.5 * (bounds[6 * slot + axis] +
+					  bounds[6 * slot + axis + 3]);
+    }
+  }
+
+  node_count = 1;
+  build_node (0, 0, prim_count, bounds, 0);
+
+  free (bounds);
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+box_hit (bvh_node *bn, double *o, double *inv, double tmax)
+{
+  int axis;
+  double t1, t2, tnear = 0.0, tfar = tmax;
+
+  for (axis = 0; axis < 3; axis++) {
+    t1 = (bn->lo[axis] - o[axis]) * inv[axis];
+    t2 = (bn->hi[axis] - o[axis]) * inv[axis];
+    if (t1 > t2) {
+      double tmp = t1;
+      t1 = t2;
+      t2 = tmp;
+    }
+    if (t1 > tnear) tnear = t1;
+    if (t2 < tfar) tfar = t2;
+    if (tnear > tfar) return FALSE;
+  }
+
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+sphere_hit (float *centre, double radius, double *o, double *d, double tmax)
+     /* Returns the distance along the ray, or -1.0 if none. */
+{
+  double oc[3], b, cc, disc, s, t;
+
+  oc[0] = o[0] - centre[0];
+  oc[1] = o[1] - centre[1];
+  oc[2] = o[2] - centre[2];
+  b = oc[0] * d[0] + oc[1] * d[1] + oc[2] * d[2];
+  cc = oc[0] * oc[0] + oc[1] * oc[1] + oc[2] * oc[2] - radius * radius;
+  disc = b * b - cc;
+  if (disc < 0.0) return -1.0;
+
+  s = sqrt (disc);
+  t = -b - s;
+  if (t <= 0.0) t = -b + s;
+  if ((t <= 0.0) || (t >= tmax)) return -1.0;
+  return t;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+cylinder_hit (primitive *pr, double *o, double *d, double tmax, int *part)
+{
+  double ax[3], oc[3], dd[3], oo[3], length, du, ou, a, b, c, disc, s;
+  double t, tbest = -1.0, denom, along, q[3];
+  int axis, end;
+
+  for (axis = 0; axis < 3; axis++) {
+    ax[axis] = pr->p[1][axis] - pr->p[0][axis];
+    oc[axis] = o[axis] - pr->p[0][axis];
+  }
+  length = sqrt (ax[0] * ax[0] + ax[1] * ax[1] + ax[2] * ax[2]);
+  for (axis = 0; axis < 3; axis++) ax[axis] /= length;
+
+  du = d[0] * ax[0] + d[1] * ax[1] + d[2] * ax[2];
+  ou = oc[0] * ax[0] + oc[1] * ax[1] + oc[2] * ax[2];
+  for (axis = 0; axis < 3; axis++) {
+    dd[axis] = d[axis] - du * ax[axis];
+    oo[axis] = oc[axis] - ou * ax[axis];
+  }
+
+  a = dd[0] * dd[0] + dd[1] * dd[1] + dd[2] * dd[2];
+  b = dd[0] * oo[0] + dd[1] * oo[1] + dd[2] * oo[2];
+  c = oo[0] * oo[0] + oo[1] * oo[1] + oo[2] * oo[2] - pr->radius * pr->radius;
+
+  if (a > 1.0e-12) {		/* body */
+    disc = b * b - a * c;
+    if (disc >= 0.0) {
+      s = sqrt (disc);
+      for (end = -1; end <= 1; end += 2) {
+	t = (-b + end * s) / a;
+	if ((t <= 0.0) || (t >= tmax)) continue;
+	along = ou + t * du;
+	if ((along >= 0.0) && (along <= length)) {
+	  tbest = t;
+	  *part = 0;
+	  break;
+	}
+      }
+    }
+  }
+
+  for (end = 0; end < 2; end++) {
+    if (tbest > 0.0) tmax = tbest;
+    if (pr->type == RT_CYLINDER_ROUND) {
+      t = sphere_hit (pr->p[end], pr->radius, o, d, tmax);
+    } else {
+      if (fabs (du) < 1.0e-12) continue;
+      denom = ((pr->p[end][0] - o[0]) * ax[0] +
+	       (pr->p[end][1] - o[1]) * ax[1] +
+	       (pr->p[end][2] - o[2]) * ax[2]);
+      t = denom / du;
+      if ((t <= 0.0) || (t >= tmax)) continue;
+      for (axis = 0; axis < 3; axis++)
+	q[axis] = o[axis] + t * d[axis] - pr->p[end][axis];
+      if (q[0] * q[0] + q[1] * q[1] + q[2] * q[2] >
+	  pr->radius * pr->radius) continue;
+    }
+    if (t > 0.0) {
+      tbest = t;
+      *part = end + 1;
+    }
+  }
+
+  return tbest;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+triangle_hit (primitive *pr, double *o, double *d, double tmax,
+	      double *u, double *v)
+     /* Moller-Trumbore; both sides. */
+{
+  double e1[3], e2[3], pv[3], tv[3], qv[3], det, t;
+  int axis;
+
+  for (axis = 0; axis < 3; axis++) {
+    e1[axis] = pr->p[1][axis] - pr->p[0][axis];
+    e2[axis] = pr->p[2][axis] - pr->p[0][axis];
+  }
+  pv[0] = d[1] * e2[2] - d[2] * e2[1];
+  pv[1] = d[2] * e2[0] - d[0] * e2[2];
+  pv[2] = d[0] * e2[1] - d[1] * e2[0];
+  det = e1[0] * pv[0] + e1[1] * pv[1] + e1[2] * pv[2];
+  if (fabs (det) < 1.0e-14) return -1.0;
+
+  for (axis = 0; axis < 3; axis++) tv[axis] = o[axis] - pr->p[0][axis];
+  *u = (tv[0] * pv[0] + tv[1] * pv[1] + tv[2] * pv[2]) / det;
+  if ((*u < 0.0) || (*u > 1.0)) return -1.0;
+
+  qv[0] = tv[1] * e1[2] - tv[2] * e1[1];
+  qv[1] = tv[2] * e1[0] - tv[0] * e1[2];
+  qv[2] = tv[0] * e1[1] - tv[1] * e1[0];
+  *v = (d[0] * qv[0] + d[1] * qv[1] + d[2] * qv[2]) / det;
+  if ((*v < 0.0) || (*u + *v > 1.0)) return -1.0;
+
+  t = (e2[0] * qv[0] + e2[1] * qv[1] + e2[2] * qv[2]) / det;
+  if ((t <= 0.0) || (t >= tmax)) return -1.0;
+  return t;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+cast (double *o, double *d, double tmax, boolean shadow, hit *h)
+     /*
+       Find the closest intersection along the ray within 'tmax'.
+       For a shadow ray, any opaque intersection will do.
+     */
+{
+  int stack[STACK_SIZE];
+  int top = 0, slot, part = 0;
+  double inv[3], t, u = 0.0, v = 0.0;
+  bvh_node *bn;
+  primitive *pr;
+  boolean found = FALSE;
+
+  if (prim_count == 0) return FALSE;
+
+  inv[0] = (d[0] != 0.0) ? 1.0 / d[0] : 1.0e30;
+  inv[1] = (d[1] != 0.0) ? 1.0 / d[1] : 1.0e30;
+  inv[2] = (d[2] != 0.0) ? 1.0 / d[2] : 1.0e30;
+
+  stack[top++] = 0;
+  while (top > 0) {
+    bn = nodes + stack[--top];
+    if (! box_hit (bn, o, inv, tmax)) continue;
+
+    if (bn->count == 0) {
+      assert (top + 2 <= STACK_SIZE);
+      stack[top++] = bn->first + 1;
+      stack[top++] = bn->first;
+      continue;
+    }
+
+    for (slot = bn->first; slot < bn->first + bn->count; slot++) {
+      pr = prims + prim_index[slot];
+      if (shadow && (materials[pr->material].transparency > 0.0)) continue;
+      switch (pr->type) {
+      case RT_SPHERE:
+	t = sphere_hit (pr->p[0], pr->radius, o, d, tmax);
+	break;
+      case RT_CYLINDER_ROUND:
+      case RT_CYLINDER_FLAT:
+	t = cylinder_hit (pr, o, d, tmax, &part);
+	break;
+      case RT_TRIANGLE:
+	t = triangle_hit (pr, o, d, tmax, &u, &v);
+	break;
+      default:
+	t = -1.0;
+      }
+      if (t <= 0.0) continue;
+      if (shadow) return TRUE;
+      tmax = t;
+      h->t = t;
+      h->prim = prim_index[slot];
+      h->u = u;
+      h->v = v;
+      h->part = part;
+      found = TRUE;
+    }
+  }
+
+  return found;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+surface (hit *h, double *p, double *d, double *n, double *c)
+     /* Normal, facing the ray, and colour at the intersection. */
+{
+  primitive *pr = prims + h->prim;
+  double ax[3], s, w, length;
+  int axis;
+
+  switch (pr->type) {
+
+  case RT_SPHERE:
+    for (axis = 0; axis < 3; axis++) n[axis] = p[axis] - pr->p[0][axis];
+    break;
+
+  case RT_CYLINDER_ROUND:
+  case RT_CYLINDER_FLAT:
+    for (axis = 0; axis < 3; axis++)
+      ax[axis] = pr->p[1][axis] - pr->p[0][axis];
+    length = sqrt (ax[0] * ax[0] + ax[1] * ax[1] + ax[2] * ax[2]);
+    for (axis = 0; axis < 3; axis++) ax[axis] /= length;
+    if (h->part == 0) {
+      s = ((p[0] - pr->p[0][0]) * ax[0] + (p[1] - pr->p[0][1]) * ax[1] +
+	   (p[2] - pr->p[0][2]) * ax[2]);
+      for (axis = 0; axis < 3; axis++)
+	n[axis] = p[axis] - pr->p[0][axis] - s * ax[axis];
+    } else if (pr->type == RT_CYLINDER_ROUND) {
+      for (axis = 0; axis < 3; axis++)
+	n[axis] = p[axis] - pr->p[h->part - 1][axis];
+    } else {
+      for (axis = 0; axis < 3; axis++)
+	n[axis] = (h->part == 1) ? - ax[axis] : ax[axis];
+    }
+    break;
+
+  case RT_TRIANGLE:
+    w = 1.0 - h->u - h->v;
+    if (pr->normals) {
+      for (axis = 0; axis < 3; axis++)
+	n[axis] = w * pr->n[0][axis] + h->u * pr->n[1][axis] +
+	          h->v * pr->n[2][axis];
+    } else {
+      double e1[3], e2[3];
+      for (axis = 0; axis < 3; axis++) {
+	e1[axis] = pr->p[1][axis] - pr->p[0][axis];
+	e2[axis] = pr->p[2][axis] - pr->p[0][axis];
+      }
+      n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+      n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+      n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+    if (pr->colours) {
+      for (axis = 0; axis < 3; axis++)
+	c[axis] = w * pr->c[0][axis] + h->u * pr->c[1][axis] +
+	          h->v * pr->c[2][axis];
+    } else {
+      for (axis = 0; axis < 3; axis++) c[axis] = pr->c[0][axis];
+    }
+    break;
+  }
+
+  if (pr->type != RT_TRIANGLE) {
+    for (axis = 0; axis < 3; axis++) c[axis] = pr->c[0][axis];
+  }
+
+  length = sqrt (n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  if (length > 0.0) {
+    for (axis = 0; axis < 3; axis++) n[axis] /= length;
+  }
+  if (n[0] * d[0] + n[1] * d[1] + n[2] * d[2] > 0.0) {
+    for (axis = 0; axis < 3; axis++) n[axis] = - n[axis];
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static double
+random_number (unsigned int *seed)
+     /* Xorshift; uniform in [0,1). */
+{
+  *seed ^= *seed << 13;
+  *seed ^= *seed >> 17;
+  *seed ^= *seed << 5;
+  return (double) (*seed & 0xffffff) / (double) 0x1000000;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+ambient_occlusion (double *p, double *n, unsigned int *seed)
+     /* Fraction of cosine-weighted hemisphere rays that escape. */
+{
+  double t1[3], t2[3], dir[3], phi, r, z, length;
+  int sample, escaped = 0, axis;
+  hit h;
+
+  if (fabs (n[0]) < 0.9) {	/* tangent frame */
+    t1[0] = 0.0; t1[1] = n[2]; t1[2] = - n[1];
+  } else {
+    t1[0] = - n[2]; t1[1] = 0.0; t1[2] = n[0];
+  }
+  length = sqrt (t1[0] * t1[0] + t1[1] * t1[1] + t1[2] * t1[2]);
+  for (axis = 0; axis < 3; axis++) t1[axis] /= length;
+  t2[0] = n[1] * t1[2] - n[2] * t1[1];
+  t2[1] = n[2] * t1[0] - n[0] * t1[2];
+  t2[2] = n[0] * t1[1] - n[1] * t1[0];
+
+  for (sample = 0; sample < occlusion; sample++) {
+    phi = 2.0 * ANGLE_PI * random_number (seed);
+    r = random_number (seed);
+    z = sqrt (1.0 - r);
+    r = sqrt (r);
+    for (axis = 0; axis < 3; axis++)
+      dir[axis] = r * cos (phi) * t1[axis] + r * sin (phi) * t2[axis] +
+	          z * n[axis];
+    if (! cast (p, dir, AO_DISTANCE, TRUE, &h)) escaped++;
+  }
+
+  return (double) escaped / (double) occlusion;
+}
+
+
+/*------------------------------------------------------------*/
+static double
+highlight (double *n, double *l, double *v, double phong)
+{
+  double h[3], length, ndoth;
+
+  h[0] = l[0] + v[0];
+  h[1] = l[1] + v[1];
+  h[2] = l[2] + v[2];
+  length = sqrt (h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+  if (length <= 0.0) return 0.0;
+  ndoth = (n[0] * h[0] + n[1] * h[1] + n[2] * h[2]) / length;
+  return (ndoth > 0.0) ? pow (ndoth, phong) : 0.0;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+shade (double *o, double *d, int layer, unsigned int *seed,
+       double *result, double *depth)
+     /* Colour seen along the ray; 'depth' is set for the first hit. */
+{
+  hit h;
+  material *m;
+  double p[3], n[3], c[3], v[3], l[3], start[3], behind[3];
+  double fill, ndotl, spec, distance, z;
+  int axis, slot;
+
+  if (! cast (o, d, 1.0e30, FALSE, &h)) {
+    for (axis = 0; axis < 3; axis++) result[axis] = bg[axis];
+    if (depth) *depth = -1.0;
+    return;
+  }
+
+  for (axis = 0; axis < 3; axis++) {
+    p[axis] = o[axis] + h.t * d[axis];
+    v[axis] = - d[axis];
+  }
+  if (depth) *depth = slab - p[2];
+  surface (&h, p, d, n, c);
+  m = materials + prims[h.prim].material;
+  for (axis = 0; axis < 3; axis++) start[axis] = p[axis] + EPSILON * n[axis];
+
+  fill = (occlusion > 0) ? ambient_occlusion (start, n, seed) : 1.0;
+  z = n[0] * v[0] + n[1] * v[1] + n[2] * v[2];
+  fill *= AMBIENT + (headlight ? SECONDARY * ((z > 0.0) ? z : 0.0) : 0.0);
+  for (axis = 0; axis < 3; axis++) result[axis] = fill * c[axis];
+
+  ndotl = n[0] * lightdirection[0] + n[1] * lightdirection[1] +
+          n[2] * lightdirection[2];
+  if ((ndotl > 0.0) &&
+      ! (shadows && cast (start, lightdirection, 1.0e30, TRUE, &h))) {
+    spec = m->specular * highlight (n, lightdirection, v, m->phong);
+    for (axis = 0; axis < 3; axis++)
+      result[axis] += PRIMARY * ndotl * c[axis] +
+	              spec * m->specularcolour[axis];
+  }
+
+  for (slot = 0; slot < pointlight_count; slot++) {
+    for (axis = 0; axis < 3; axis++) l[axis] = pointlights[slot][axis] - p[axis];
+    distance = sqrt (l[0] * l[0] + l[1] * l[1] + l[2] * l[2]);
+    if (distance <= 0.0) continue;
+    for (axis = 0; axis < 3; axis++) l[axis] /= distance;
+    ndotl = n[0] * l[0] + n[1] * l[1] + n[2] * l[2];
+    if (ndotl <= 0.0) continue;
+    if (shadows && cast (start, l, distance, TRUE, &h)) continue;
+    spec = m->specular * highlight (n, l, v, m->phong);
+    for (axis = 0; axis < 3; axis++)
+      result[axis] += pointlights[slot][axis + 3] *
+	              (PRIMARY * ndotl * c[axis] + spec * m->specularcolour[axis]);
+  }
+
+  if ((m->transparency > 0.0) && (layer < MAX_LAYERS)) {
+    for (axis = 0; axis < 3; axis++) start[axis] = p[axis] + EPSILON * d[axis];
+    shade (start, d, layer + 1, seed, behind, NULL);
+    for (axis = 0; axis < 3; axis++)
+      result[axis] = (1.0 - m->transparency) * result[axis] +
+	             m->transparency * behind[axis];
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+jitter (int sample, int samples, double *jx, double *jy)
+     /* Halton sequence in bases 2 and 3, centred on the pixel. */
+{
+  int i;
+  double f;
+
+  if (samples <= 1) {
+    *jx = *jy = 0.0;
+    return;
+  }
+
+  *jx = 0.0;
+  for (i = sample + 1, f = 0.5; i > 0; i /= 2, f /= 2.0) *jx += f * (i % 2);
+  *jy = 0.0;
+  for (i = sample + 1, f = 1.0/3.0; i > 0; i /= 3, f /= 3.0) *jy += f * (i % 3);
+  *jx -= 0.5;
+  *jy -= 0.5;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+trace_tile (int tile)
+{
+  int x0, y0, x1, y1, ix, iy, axis, sample, samples;
+  double o[3], d[3] = {0.0, 0.0, -1.0};
+  double colour[3], sum[3], jx, jy, depth, f;
+  unsigned char *dest;
+  unsigned int seed;
+
+  x0 = (tile % tiles_x) * TILE_SIZE;
+  y0 = pixels_first + (tile / tiles_x) * TILE_SIZE;
+  x1 = (x0 + TILE_SIZE < output_width) ? x0 + TILE_SIZE : output_width;
+  y1 = pixels_first + pixels_rows;
+  if (y0 + TILE_SIZE < y1) y1 = y0 + TILE_SIZE;
+  samples = (accum > 1) ? accum : 1;
+
+  for (iy = y0; iy < y1; iy++) {
+    for (ix = x0; ix < x1; ix++) {
+      seed = 2654435761U * (unsigned int) (iy * output_width + ix + 1);
+      if (seed == 0) seed = 1;
+      sum[0] = sum[1] = sum[2] = 0.0;
+
+      for (sample = 0; sample < samples; sample++) {
+	jitter (sample, samples, &jx, &jy);
+	o[0] = -aspect_window_x +
+	       2.0 * aspect_window_x * (ix + 0.5 + jx) / output_width;
+	o[1] = -aspect_window_y +
+	       2.0 * aspect_window_y * (iy + 0.5 + jy) / output_height;
+	o[2] = scene_top;
+	shade (o, d, 0, &seed, colour, &depth);
+
+	if ((fog != 0.0) && (depth >= 0.0)) {
+	  f = (fog - depth) / fog;
+	  if (f < 0.0) f = 0.0;
+	  if (f > 1.0) f = 1.0;
+	  for (axis = 0; axis < 3; axis++)
+	    colour[axis] = f * colour[axis] + (1.0 - f) * bg[axis];
+	}
+	for (axis = 0; axis < 3; axis++) sum[axis] += colour[axis];
+      }
+
+      dest = pixels + 3 * ((iy - pixels_first) * output_width + ix);
+      for (axis = 0; axis < 3; axis++) {
+	f = sum[axis] / samples;
+	if (f > 1.0) f = 1.0;
+	if (f < 0.0) f = 0.0;
+	dest[axis] = (unsigned char) floor (255.0 * f + 0.5);
+      }
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+trace_tiles (thread_jobs *tj)
+{
+  int tile;
+
+  while ((tile = thread_jobs_take (tj)) >= 0) trace_tile (tile);
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_transform (double matrix[4][4])
+     /*
+       Transform the geometry of the plot, before rendering it. The
+       lights are not transformed; they stay fixed to the viewer.
+     */
+{
+  int slot, vslot;
+  primitive *pr;
+
+  for (slot = 0; slot < prim_count; slot++) {
+    pr = prims + slot;
+    switch (pr->type) {
+    case RT_SPHERE:
+      matrix3_transform_float (pr->p[0], matrix);
+      break;
+    case RT_CYLINDER_ROUND:
+    case RT_CYLINDER_FLAT:
+      matrix3_transform_float (pr->p[0], matrix);
+      matrix3_transform_float (pr->p[1], matrix);
+      break;
+    case RT_TRIANGLE:
+      for (vslot = 0; vslot < 3; vslot++) {
+	matrix3_transform_float (pr->p[vslot], matrix);
+	if (pr->normals) matrix3_rotate_float (pr->n[vslot], matrix);
+      }
+      break;
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_render (void)
+{
+  assert (aspect_window_x > 0.0);
+  assert (aspect_window_y > 0.0);
+
+  colour_to_rgb (&background_colour);
+  bg[0] = background_colour.x;
+  bg[1] = background_colour.y;
+  bg[2] = background_colour.z;
+
+  build_bvh();
+  scene_top = (prim_count > 0) ? nodes[0].hi[2] + 1.0 : 1.0;
+
+  if (message_mode)
+    fprintf (stderr, "%i primitives ray traced, %i BVH nodes.\n",
+	     prim_count, node_count);
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_render_rows (int first, int rows)
+{
+  thread_jobs tj;
+
+  assert (first >= 0);
+  assert (rows > 0);
+  assert (first + rows <= output_height);
+
+  if (pixels && (rows > pixels_rows)) {
+    free (pixels);
+    pixels = NULL;
+  }
+  if (pixels == NULL)
+    pixels = malloc (3 * output_width * rows * sizeof (unsigned char));
+  pixels_first = first;
+  pixels_rows = rows;
+
+  tiles_x = (output_width + TILE_SIZE - 1) / TILE_SIZE;
+  thread_jobs_run (&tj, tiles_x * ((rows + TILE_SIZE - 1) / TILE_SIZE),
+		   trace_tiles, NULL);
+}
+
+
+/*------------------------------------------------------------*/
+unsigned char *
+rt_row (int row)
+     /* Rows are counted from the bottom, as for glReadPixels. */
+{
+  assert (row >= pixels_first);
+  assert (row < pixels_first + pixels_rows);
+  assert (pixels);
+
+  return pixels + 3 * (row - pixels_first) * output_width;
+}
+
+
+/*------------------------------------------------------------*/
+void
+rt_close (void)
+{
+  free (pixels);
+  pixels = NULL;
+  free (nodes);
+  nodes = NULL;
+  free (prim_index);
+  prim_index = NULL;
+  free (centroids);
+  centroids = NULL;
+
+  free (prims);
+  prims = NULL;
+  free (materials);
+  materials = NULL;
+}
@@ -0,0 +1,40 @@
+/* raytrace.h
+
+   MolScript v2.1.2
+
+   Ray tracing of the Raster3D scene for image file output.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  transform of the geometry for animation frames
+*/
+
+#ifndef RAYTRACE_H
+#define RAYTRACE_H 1
+
+#include "col.h"
+#include "coord.h"
+
+void rt_set_accum (int number);
+void rt_set_occlusion (int samples);
+
+void rt_start_plot (void);
+void rt_transform (double matrix[4][4]);
+void rt_render (void);
+void rt_render_rows (int first, int rows);
+unsigned char *rt_row (int row);
+void rt_close (void);
+
+void rt_directionallight (vector3 *direction);
+void rt_pointlight (vector3 *p, colour *rgb);
+void rt_material (double phong, double specular, colour *specularcolour,
+		  double transparency);
+
+void rt_triangle (vector3 *p1, vector3 *p2, vector3 *p3, colour *rgb);
+void rt_normals (vector3 *n1, vector3 *n2, vector3 *n3);
+void rt_vertex_colours (vector3 *c1, vector3 *c2, vector3 *c3);
+void rt_sphere (vector3 *p, double radius, colour *rgb);
+void rt_cylinder (vector3 *p1, vector3 *p2, double radius, boolean round,
+		  colour *rgb);
+
+#endif
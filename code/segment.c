@@ -4,10 +4,18 @@
 
    Segment data structure and routines.
 
+   The segments of a chain are collected in a segment buffer. Each
+   chain may have its own buffer, so that chains can be computed
+   concurrently. The buffer is selected before the output routine is
+   called; the output routines use the global segment arrays, which
+   refer to the selected buffer.
+
    Copyright (C) 1997-1998 Per Kraulis
     18-Aug-1997  split out of vrml.c; generalized
+    18-Oct-2026  segment buffers, one per chain
 */
 
+#include <assert.h>
 #include <stdlib.h>
 
 #include "segment.h"
@@ -16,59 +24,178 @@
 /*------------------------------------------------------------*/
 line_segment *line_segments = NULL;
 int line_segment_count;
-static int line_segment_alloc;
 
 strand_segment *strand_segments = NULL;
 int strand_segment_count;
-static int strand_segment_alloc;
 
 helix_segment *helix_segments = NULL;
 int helix_segment_count;
-static int helix_segment_alloc;
 
 coil_segment *coil_segments = NULL;
 int coil_segment_count;
-static int coil_segment_alloc;
+
+static segment_buffer global_buffer;
 
 
 /*------------------------------------------------------------*/
 void
-line_segment_init (void)
+segment_buffer_init (segment_buffer *sb)
 {
-  if (line_segments == NULL) {
-    line_segment_alloc = 512;
-    line_segments = malloc (line_segment_alloc * sizeof (line_segment));
-  }
-  line_segment_count = 0;
+  assert (sb);
+
+  sb->lines = NULL;
+  sb->line_count = 0;
+  sb->line_alloc = 0;
+  sb->strands = NULL;
+  sb->strand_count = 0;
+  sb->strand_alloc = 0;
+  sb->helices = NULL;
+  sb->helix_count = 0;
+  sb->helix_alloc = 0;
+  sb->coils = NULL;
+  sb->coil_count = 0;
+  sb->coil_alloc = 0;
+}
+
+
+/*------------------------------------------------------------*/
+void
+segment_buffer_free (segment_buffer *sb)
+{
+  assert (sb);
+  assert (sb != &global_buffer);
+
+  if (sb->lines) free (sb->lines);
+  if (sb->strands) free (sb->strands);
+  if (sb->helices) free (sb->helices);
+  if (sb->coils) free (sb->coils);
+  segment_buffer_init (sb);
+}
+
+
+/*------------------------------------------------------------*/
+void
+segment_buffer_select (segment_buffer *sb)
+     /* Let the global segment arrays refer to the buffer. */
+{
+  assert (sb);
+
+  line_segments = sb->lines;
+  line_segment_count = sb->line_count;
+  strand_segments = sb->strands;
+  strand_segment_count = sb->strand_count;
+  helix_segments = sb->helices;
+  helix_segment_count = sb->helix_count;
+  coil_segments = sb->coils;
+  coil_segment_count = sb->coil_count;
 }
 
 
 /*------------------------------------------------------------*/
 line_segment *
-line_segment_next (void)
+segment_buffer_line (segment_buffer *sb)
 {
   line_segment *new;
 
-  if (line_segment_count >= line_segment_alloc) {
-    line_segment_alloc *= 2;
-    line_segments = realloc (line_segments,
-			     line_segment_alloc * sizeof (line_segment));
+  assert (sb);
+
+  if (sb->line_count >= sb->line_alloc) {
+    if (sb->line_alloc == 0) {
+      sb->line_alloc = 512;
+    } else {
+      sb->line_alloc *= 2;
+    }
+    sb->lines = realloc (sb->lines, sb->line_alloc * sizeof (line_segment));
   }
-  new = &(line_segments[line_segment_count++]);
+  new = &(sb->lines[sb->line_count++]);
   new->new = FALSE;
   return new;
 }
 
 
+/*------------------------------------------------------------*/
+strand_segment *
+segment_buffer_strand (segment_buffer *sb)
+{
+  assert (sb);
+
+  if (sb->strand_count >= sb->strand_alloc) {
+    if (sb->strand_alloc == 0) {
+      sb->strand_alloc = 256;
+    } else {
+      sb->strand_alloc *= 2;
+    }
+    sb->strands = realloc (sb->strands,
+			   sb->strand_alloc * sizeof (strand_segment));
+  }
+  return &(sb->strands[sb->strand_count++]);
+}
+
+
+/*------------------------------------------------------------*/
+helix_segment *
+segment_buffer_helix (segment_buffer *sb)
+{
+  assert (sb);
+
+  if (sb->helix_count >= sb->helix_alloc) {
+    if (sb->helix_alloc == 0) {
+      sb->helix_alloc = 512;
+    } else {
+      sb->helix_alloc *= 2;
+    }
+    sb->helices = realloc (sb->helices,
+			   sb->helix_alloc * sizeof (helix_segment));
+  }
+  return &(sb->helices[sb->helix_count++]);
+}
+
+
+/*------------------------------------------------------------*/
+coil_segment *
+segment_buffer_coil (segment_buffer *sb)
+{
+  assert (sb);
+
+  if (sb->coil_count >= sb->coil_alloc) {
+    if (sb->coil_alloc == 0) {
+      sb->coil_alloc = 512;
+    } else {
+      sb->coil_alloc *= 2;
+    }
+    sb->coils = realloc (sb->coils, sb->coil_alloc * sizeof (coil_segment));
+  }
+  return &(sb->coils[sb->coil_count++]);
+}
+
+
+/*------------------------------------------------------------*/
+void
+line_segment_init (void)
+{
+  global_buffer.line_count = 0;
+  segment_buffer_select (&global_buffer);
+}
+
+
+/*------------------------------------------------------------*/
+line_segment *
+line_segment_next (void)
+{
+  line_segment *new = segment_buffer_line (&global_buffer);
+
+  line_segments = global_buffer.lines;
+  line_segment_count = global_buffer.line_count;
+  return new;
+}
+
+
 /*------------------------------------------------------------*/
 void
 strand_segment_init (void)
 {
-  if (strand_segments == NULL) {
-    strand_segment_alloc = 256;
-    strand_segments = malloc (strand_segment_alloc * sizeof (strand_segment));
-  }
-  strand_segment_count = 0;
+  global_buffer.strand_count = 0;
+  segment_buffer_select (&global_buffer);
 }
 
 
@@ -76,12 +203,11 @@ strand_segment_init (void)
 strand_segment *
 strand_segment_next (void)
 {
-  if (strand_segment_count >= strand_segment_alloc) {
-    strand_segment_alloc *= 2;
-    strand_segments = realloc (strand_segments,
-			       strand_segment_alloc * sizeof (strand_segment));
-  }
-  return &(strand_segments[strand_segment_count++]);
+  strand_segment *new = segment_buffer_strand (&global_buffer);
+
+  strand_segments = global_buffer.strands;
+  strand_segment_count = global_buffer.strand_count;
+  return new;
 }
 
 
@@ -89,11 +215,8 @@ strand_segment_next (void)
 void
 helix_segment_init (void)
 {
-  if (helix_segments == NULL) {
-    helix_segment_alloc = 512;
-    helix_segments = malloc (helix_segment_alloc * sizeof (helix_segment));
-  }
-  helix_segment_count = 0;
+  global_buffer.helix_count = 0;
+  segment_buffer_select (&global_buffer);
 }
 
 
@@ -101,12 +224,11 @@ helix_segment_init (void)
 helix_segment *
 helix_segment_next (void)
 {
-  if (helix_segment_count >= helix_segment_alloc) {
-    helix_segment_alloc *= 2;
-    helix_segments = realloc (helix_segments,
-			      helix_segment_alloc * sizeof (helix_segment));
-  }
-  return &(helix_segments[helix_segment_count++]);
+  helix_segment *new = segment_buffer_helix (&global_buffer);
+
+  helix_segments = global_buffer.helices;
+  helix_segment_count = global_buffer.helix_count;
+  return new;
 }
 
 
@@ -114,11 +236,8 @@ helix_segment_next (void)
 void
 coil_segment_init (void)
 {
-  if (coil_segments == NULL) {
-    coil_segment_alloc = 512;
-    coil_segments = malloc (coil_segment_alloc * sizeof (coil_segment));
-  }
-  coil_segment_count = 0;
+  global_buffer.coil_count = 0;
+  segment_buffer_select (&global_buffer);
 }
 
 
@@ -126,10 +245,9 @@ coil_segment_init (void)
 coil_segment *
 coil_segment_next (void)
 {
-  if (coil_segment_count >= coil_segment_alloc) {
-    coil_segment_alloc *= 2;
-    coil_segments = realloc (coil_segments,
-			     coil_segment_alloc * sizeof (coil_segment));
-  }
-  return &(coil_segments[coil_segment_count++]);
+  coil_segment *new = segment_buffer_coil (&global_buffer);
+
+  coil_segments = global_buffer.coils;
+  coil_segment_count = global_buffer.coil_count;
+  return new;
 }
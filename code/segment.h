@@ -6,6 +6,7 @@
 
    Copyright (C) 1997-1998 Per Kraulis
     18-Aug-1997  split out of vrml.c; generalized
+    18-Oct-2026  segment buffers, one per chain
 */
 
 #ifndef SEGMENT_H
@@ -62,4 +63,23 @@ extern int coil_segment_count;
 void coil_segment_init (void);
 coil_segment *coil_segment_next (void);
 
+typedef struct {
+  line_segment *lines;
+  int line_count, line_alloc;
+  strand_segment *strands;
+  int strand_count, strand_alloc;
+  helix_segment *helices;
+  int helix_count, helix_alloc;
+  coil_segment *coils;
+  int coil_count, coil_alloc;
+} segment_buffer;
+
+void segment_buffer_init (segment_buffer *sb);
+void segment_buffer_free (segment_buffer *sb);
+void segment_buffer_select (segment_buffer *sb);
+line_segment *segment_buffer_line (segment_buffer *sb);
+strand_segment *segment_buffer_strand (segment_buffer *sb);
+helix_segment *segment_buffer_helix (segment_buffer *sb);
+coil_segment *segment_buffer_coil (segment_buffer *sb);
+
 #endif
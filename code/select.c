@@ -7,10 +7,13 @@
    Copyright (C) 1997-1998 Per Kraulis
      4-Dec-1996  first attempts
      2-Jan-1997  largely finished
+    18-Oct-2026  clear_selections
+    18-Oct-2026  saved selections, for use more than once
 */
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "other/regex.h"
 
@@ -220,6 +223,72 @@ pop_residue_selection (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+clear_selections (void)
+     /* Selections left over after an error. */
+{
+  while (current_atom_sel) pop_atom_selection();
+  while (current_residue_sel) pop_residue_selection();
+}
+
+
+/*------------------------------------------------------------*/
+int *
+save_atom_selection (void)
+     /* A copy of the current selection, for 'restore_atom_selection'. */
+{
+  int *flags;
+
+  assert (current_atom_sel);
+
+  flags = malloc (total_atoms * sizeof (int));
+  memcpy (flags, current_atom_sel->flags, total_atoms * sizeof (int));
+  return flags;
+}
+
+
+/*------------------------------------------------------------*/
+int *
+save_residue_selection (void)
+     /* A copy of the current selection, for 'restore_residue_selection'. */
+{
+  int *flags;
+
+  assert (current_residue_sel);
+
+  flags = malloc (total_residues * sizeof (int));
+  memcpy (flags, current_residue_sel->flags, total_residues * sizeof (int));
+  return flags;
+}
+
+
+/*------------------------------------------------------------*/
+void
+restore_atom_selection (int *flags)
+     /* Push the saved selection again. The copy is taken over. */
+{
+  assert (flags);
+
+  push_atom_selection();
+  free (current_atom_sel->flags);
+  current_atom_sel->flags = flags;
+}
+
+
+/*------------------------------------------------------------*/
+void
+restore_residue_selection (int *flags)
+     /* Push the saved selection again. The copy is taken over. */
+{
+  assert (flags);
+
+  push_residue_selection();
+  free (current_residue_sel->flags);
+  current_residue_sel->flags = flags;
+}
+
+
 /*------------------------------------------------------------*/
 int
 count_atom_selections (void)
@@ -7,6 +7,8 @@
    Copyright (C) 1997-1998 Per Kraulis
      7-Dec-1996  first attempts
      2-Jan-1997  largely finished
+    18-Oct-2026  clear_selections
+    18-Oct-2026  saved selections, for use more than once
 */
 
 #include "coord.h"
@@ -22,6 +24,11 @@ void push_atom_selection (void);
 void push_residue_selection (void);
 void pop_atom_selection (void);
 void pop_residue_selection (void);
+void clear_selections (void);
+int *save_atom_selection (void);
+int *save_residue_selection (void);
+void restore_atom_selection (int *flags);
+void restore_residue_selection (int *flags);
 
 int count_atom_selections (void);
 int count_residue_selections (void);
@@ -0,0 +1,334 @@
+/* server.c
+
+   MolScript v2.1.2
+
+   Render server on a Unix domain socket.
+
+   Each connection is one request: a first line giving the output and
+   the format options, as for a batch job, followed by the input script
+   up to the end of the sending side of the connection. The output is
+   either '-', in which case the contents of the output file are sent
+   back, or a file name, which is sent back once the file is written.
+   The reply is a line 'OK length' or 'ERROR length', followed by that
+   many bytes: the output, the file name or the error messages.
+
+   Each request is handled by a child process, which has its own copy
+   of the interpreter state, so that requests are rendered concurrently,
+   at most one per processor. The worker reports the molecule files it
+   has read, and the server then reads them into its own cache, so that
+   later requests get copies of the molecules instead of reading files.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  declarations of mkstemp and fdopen under -ansi
+    18-Oct-2026  only an old socket is removed, no other file
+*/
+
+#define _XOPEN_SOURCE 500	/* mkstemp and fdopen, also under -ansi */
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "clib/str_utils.h"
+
+#include "server.h"
+#include "global.h"
+#include "lex.h"
+#include "coord.h"
+#include "graphics.h"
+
+
+/*============================================================*/
+#define MAX_WORKERS 64
+#define MAX_REQUEST_ARGS 32
+#define LINE_SIZE 4096
+
+typedef struct {
+  pid_t pid;
+  int report;			/* pipe of molecule file names read */
+} worker;
+
+static worker workers [MAX_WORKERS];
+static int worker_count = 0;
+
+
+/*------------------------------------------------------------*/
+static int
+temp_file (void)
+     /* An anonymous temporary file; removed when closed. */
+{
+  char name[] = "/tmp/molscriptXXXXXX";
+  int fd;
+
+  fd = mkstemp (name);
+  if (fd >= 0) unlink (name);
+  return fd;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+send_bytes (int sock, const char *buf, size_t length)
+{
+  ssize_t count;
+
+  assert (buf);
+
+  while (length > 0) {
+    count = write (sock, buf, length);
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      return;			/* client has gone; nothing to do */
+    }
+    buf += count;
+    length -= count;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+send_reply (int sock, const char *status, const char *str)
+{
+  char header[64];
+
+  assert (status);
+  assert (str);
+
+  sprintf (header, "%s %lu\n", status, (unsigned long) strlen (str));
+  send_bytes (sock, header, strlen (header));
+  send_bytes (sock, str, strlen (str));
+}
+
+
+/*------------------------------------------------------------*/
+static void
+send_file_reply (int sock, const char *status, int fd)
+     /* Reply with the contents of the file. */
+{
+  char buf[LINE_SIZE];
+  off_t length;
+  ssize_t count;
+
+  assert (status);
+
+  length = lseek (fd, 0, SEEK_END);
+  lseek (fd, 0, SEEK_SET);
+  sprintf (buf, "%s %lu\n", status, (unsigned long) length);
+  send_bytes (sock, buf, strlen (buf));
+
+  while ((count = read (fd, buf, LINE_SIZE)) > 0) send_bytes (sock, buf, count);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+request_error (const char *msg)
+{
+  assert (msg);
+
+  fprintf (stderr, "Error: %s\n", msg);
+  longjmp (*error_return, 1);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+serve_request (int sock, int report)
+     /*
+       In the worker process: the script is read from the socket as
+       standard input, and the output and the messages go to temporary
+       files as standard output and standard error.
+     */
+{
+  jmp_buf env;
+  char line [LINE_SIZE];
+  char *argv [MAX_REQUEST_ARGS];
+  char *str;
+  int argc, out, msg;
+
+  signal (SIGPIPE, SIG_IGN);
+
+  out = temp_file();
+  msg = temp_file();
+  if ((out < 0) || (msg < 0)) {
+    send_reply (sock, "ERROR", "could not create the temporary files\n");
+    exit (1);
+  }
+  dup2 (sock, 0);
+  dup2 (out, 1);
+  dup2 (msg, 2);
+  clearerr (stdin);
+
+  fcntl (report, F_SETFL, O_NONBLOCK); /* never wait for the server */
+  cache_molecules_report (report);
+
+  if (setjmp (env)) {
+    fflush (stderr);
+    send_file_reply (sock, "ERROR", msg);
+    exit (1);
+  }
+  error_return = &env;
+
+  if (fgets (line, LINE_SIZE, stdin) == NULL)
+    request_error ("no request line given");
+  argc = 0;
+  argv[argc++] = "molscript";
+  for (str = strtok (line, " \t\r\n"); str; str = strtok (NULL, " \t\r\n")) {
+    if (argc == MAX_REQUEST_ARGS)
+      request_error ("too many options in the request line");
+    argv[argc++] = str;
+  }
+  if (argc < 2) request_error ("no output given in the request line");
+
+  job_format (argc, argv, 1);
+
+  global_init();
+  lex_init();
+  if (! str_eq (argv[1], "-")) output_filename = argv[1];
+
+  yyparse();
+  output_finish_output();
+
+  if (outfile != stdout) {
+    if (fclose (outfile) != 0) yyerror ("could not write the output file");
+    outfile = stdout;
+  }
+  if (fflush (stdout) != 0) yyerror ("could not write the output");
+  error_return = NULL;
+
+  if (str_eq (argv[1], "-")) {
+    send_file_reply (sock, "OK", out);
+  } else {
+    send_reply (sock, "OK", argv[1]);
+  }
+  exit (0);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+reap_workers (boolean block)
+     /* Read the molecule files reported by finished workers. */
+{
+  char line [LINE_SIZE];
+  FILE *file;
+  pid_t pid;
+  int slot, status;
+
+  while ((pid = waitpid (-1, &status, block ? 0 : WNOHANG)) > 0) {
+    block = FALSE;
+
+    for (slot = 0; slot < worker_count; slot++) {
+      if (workers[slot].pid == pid) break;
+    }
+    if (slot == worker_count) continue;
+
+    file = fdopen (workers[slot].report, "r");
+    if (file) {
+      while (fgets (line, LINE_SIZE, file)) {
+	line[strcspn (line, "\n")] = '\0';
+	if (*line) cache_molecule_file (line);
+      }
+      fclose (file);
+    } else {
+      close (workers[slot].report);
+    }
+
+    workers[slot] = workers[--worker_count];
+  }
+}
+
+
+/*------------------------------------------------------------*/
+int
+server_run (void)
+     /* Serve requests until the process is killed, or a failure. */
+{
+  struct sockaddr_un address;
+  struct stat file_stat;
+  int listener, sock, max_workers;
+  int report[2];
+  pid_t pid;
+
+  assert (server_filename);
+
+  if (strlen (server_filename) >= sizeof (address.sun_path)) {
+    fprintf (stderr, "Error: socket filename too long: %s\n", server_filename);
+    return 1;
+  }
+  memset (&address, 0, sizeof (address));
+  address.sun_family = AF_UNIX;
+  strcpy (address.sun_path, server_filename);
+
+  if (lstat (server_filename, &file_stat) == 0) {
+    if (! S_ISSOCK (file_stat.st_mode)) {
+      fprintf (stderr, "Error: file exists and is not a socket: %s\n",
+	       server_filename);
+      return 1;
+    }
+    unlink (server_filename);	/* left by an earlier server */
+  }
+  listener = socket (AF_UNIX, SOCK_STREAM, 0);
+  if ((listener < 0) ||
+      (bind (listener, (struct sockaddr *) &address, sizeof (address)) != 0) ||
+      (listen (listener, 16) != 0)) {
+    fprintf (stderr, "Error: could not create the socket: %s\n",
+	     server_filename);
+    return 1;
+  }
+
+  max_workers = (int) sysconf (_SC_NPROCESSORS_ONLN);
+  if (max_workers < 1) max_workers = 1;
+  if (max_workers > MAX_WORKERS) max_workers = MAX_WORKERS;
+
+  cache_molecules();
+  signal (SIGPIPE, SIG_IGN);
+  if (message_mode) fprintf (stderr, "serving on %s\n", server_filename);
+
+  for (;;) {
+    reap_workers (FALSE);
+    while (worker_count >= max_workers) reap_workers (TRUE);
+
+    sock = accept (listener, NULL, NULL);
+    if (sock < 0) {
+      if (errno == EINTR) continue;
+      fprintf (stderr, "Error: could not accept a connection\n");
+      break;
+    }
+    if (pipe (report) != 0) {
+      close (sock);
+      continue;
+    }
+
+    fflush (NULL);
+    pid = fork();
+    if (pid == 0) {
+      close (listener);
+      close (report[0]);
+      serve_request (sock, report[1]);
+    }
+    close (sock);
+    close (report[1]);
+    if (pid < 0) {
+      close (report[0]);
+      continue;
+    }
+    workers[worker_count].pid = pid;
+    workers[worker_count].report = report[0];
+    worker_count++;
+  }
+
+  close (listener);
+  return 1;
+}
@@ -0,0 +1,16 @@
+/* server.h
+
+   MolScript v2.1.2
+
+   Render server on a Unix domain socket.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#ifndef SERVER_H
+#define SERVER_H 1
+
+int server_run (void);
+
+#endif
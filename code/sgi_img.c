@@ -4,26 +4,24 @@
 
    SGI image file.
 
-   This implementation relies on the 'image.c' code, and therefore
-   implicitly on OpenGL and GLX.
+   This implementation relies on the 'image.c' code for rendering.
 
    Copyright (C) 1997-1998 Per Kraulis
      9-Sep-1997  started
     11-Sep-1997  working
     26-Sep-1997  use my own SGI image file interface
+    18-Oct-2026  use image_read_row; no direct OpenGL calls
+    18-Oct-2026  one image file per plot
 */
 
 #include <stdlib.h>
 
-#include <GL/gl.h>
-
 #include "clib/sgi_image.h"
 
 #include "sgi_img.h"
 #include "global.h"
 #include "graphics.h"
 #include "image.h"
-#include "opengl.h"
 
 
 /*============================================================*/
@@ -34,11 +32,7 @@ static sgi_image *image;
 void
 sgii_set (void)
 {
-  ogl_set();
-
-  output_first_plot = sgii_first_plot;
-  output_finish_output = sgii_finish_output;
-  output_start_plot = ogl_start_plot_general;
+  image_set (sgii_first_plot, sgii_finish_output);
 
   output_pickable = NULL;
 
@@ -50,7 +44,6 @@ sgii_set (void)
 void
 sgii_first_plot (void)
 {
-  image_first_plot();
   set_outfile ("wb");
 
   image = sgiimg_create();
@@ -76,23 +69,24 @@ sgii_finish_output (void)
   row = malloc (output_width * sizeof (unsigned char));
 
   for (rownum = 0; rownum < output_height; rownum++) {
-    glReadPixels (0, rownum, output_width, 1, GL_RED, GL_UNSIGNED_BYTE, row);
+    image_read_row (rownum, IMAGE_RED, row);
     sgiimg_write_next_char_row (image, row);
   }
 
   for (rownum = 0; rownum < output_height; rownum++) {
-    glReadPixels (0, rownum, output_width, 1, GL_GREEN, GL_UNSIGNED_BYTE, row);
+    image_read_row (rownum, IMAGE_GREEN, row);
     sgiimg_write_next_char_row (image, row);
   }
 
   for (rownum = 0; rownum < output_height; rownum++) {
-    glReadPixels (0, rownum, output_width, 1, GL_BLUE, GL_UNSIGNED_BYTE, row);
+    image_read_row (rownum, IMAGE_BLUE, row);
     sgiimg_write_next_char_row (image, row);
   }
 
   free (row);
 
   sgiimg_file_close (image);
+  outfile = NULL;		/* closed by sgiimg_file_close */
 
   image_close();
 }
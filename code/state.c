@@ -8,6 +8,9 @@
      4-Dec-1996  first attempts
      2-Jan-1997  basically finished
     26-Apr-1998  push and pop implemented
+    18-Oct-2026  surface parameters
+    18-Oct-2026  detaillevels
+    18-Oct-2026  adaptivesegments
 */
 
 #include <assert.h>
@@ -50,12 +53,14 @@ state_init (void)
   current_state = malloc (sizeof (state));
   current_state->prev = NULL;
 
+  current_state->adaptivesegments = 0.0;
   current_state->bonddistance = 1.9;
   current_state->bondcross = 0.4;
   current_state->coilradius = 0.2;
   current_state->colourparts = FALSE;
   current_state->cylinderradius = 2.3;
   current_state->depthcue = 0.75;
+  current_state->detaillevels = 1;
   current_state->emissivecolour = black_colour;
   current_state->helixthickness = 0.3;
   current_state->helixwidth = 2.4;
@@ -105,6 +110,8 @@ state_init (void)
   current_state->sticktaper = 0.75;
   current_state->strandthickness = 0.6;
   current_state->strandwidth = 2.0;
+  current_state->surfacegrid = 0.5;
+  current_state->surfaceprobe = 1.4;
   current_state->transparency = 0.0;
 }
 
@@ -169,6 +176,26 @@ pop_state (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+set_adaptivesegments (void)
+     /*
+       The largest deviation of the spline segments from the curve, in
+       pixels; fewer segments are made where the curve is straighter.
+       Zero for the fixed number of segments.
+     */
+{
+  assert (dstack_size == 1);
+
+  if (dstack[0] < 0.0) {
+    yyerror ("invalid adaptivesegments value");
+  } else {
+    current_state->adaptivesegments = dstack[0];
+  }
+  clear_dstack();
+}
+
+
 /*------------------------------------------------------------*/
 void
 set_atomcolour (void)
@@ -387,6 +414,21 @@ set_depthcue (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+set_detaillevels (void)
+{
+  assert (dstack_size == 1);
+
+  if ((ival < 1) || (ival > MAX_DETAIL_LEVELS)) {
+    yyerror ("invalid detaillevels value");
+  } else {
+    current_state->detaillevels = ival;
+  }
+  clear_dstack();
+}
+
+
 /*------------------------------------------------------------*/
 void
 set_emissivecolour (void)
@@ -988,6 +1030,36 @@ set_strandwidth (void)
 }
 
 
+/*------------------------------------------------------------*/
+void
+set_surfacegrid (void)
+{
+  assert (dstack_size == 1);
+
+  if (dstack[0] <= 0.0) {
+    yyerror ("invalid surfacegrid value");
+  } else {
+    current_state->surfacegrid = dstack[0];
+  }
+  clear_dstack();
+}
+
+
+/*------------------------------------------------------------*/
+void
+set_surfaceprobe (void)
+{
+  assert (dstack_size == 1);
+
+  if (dstack[0] < 0.0) {
+    yyerror ("invalid surfaceprobe value");
+  } else {
+    current_state->surfaceprobe = dstack[0];
+  }
+  clear_dstack();
+}
+
+
 /*------------------------------------------------------------*/
 void
 set_transparency (void)
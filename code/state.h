@@ -8,6 +8,9 @@
      4-Dec-1996  first attempts
      2-Jan-1997  largely finished
     26-Apr-1998  push and pop implemented
+    18-Oct-2026  surface parameters
+    18-Oct-2026  detaillevels
+    18-Oct-2026  adaptivesegments
 */
 
 #ifndef STATE_H
@@ -17,16 +20,20 @@
 
 #include "col.h"
 
+#define MAX_DETAIL_LEVELS 4
+
 typedef struct s_state state;
 
 struct s_state {
   state   *prev;
+  double  adaptivesegments;
   double  bonddistance;
   double  bondcross;
   double  coilradius;
   boolean colourparts;
   double  cylinderradius;
   double  depthcue;
+  int     detaillevels;
   colour  emissivecolour;
   double  helixthickness;
   double  helixwidth;
@@ -64,6 +71,8 @@ struct s_state {
   double  sticktaper;
   double  strandthickness;
   double  strandwidth;
+  double  surfacegrid;
+  double  surfaceprobe;
   double  transparency;
 };
 
@@ -74,6 +83,7 @@ void new_state (void);
 void push_state (void);
 void pop_state (void);
 
+void set_adaptivesegments (void);
 void set_atomcolour (void);
 void set_atomcolour_bfactor (void);
 void set_atomradius (void);
@@ -84,6 +94,7 @@ void set_colourparts (boolean on);
 void set_colourramphsb (boolean hsb);
 void set_cylinderradius (void);
 void set_depthcue (void);
+void set_detaillevels (void);
 void set_emissivecolour (void);
 void set_helixthickness (void);
 void set_helixwidth (void);
@@ -122,6 +133,8 @@ void set_stickradius (void);
 void set_sticktaper (void);
 void set_strandthickness (void);
 void set_strandwidth (void);
+void set_surfacegrid (void);
+void set_surfaceprobe (void);
 void set_transparency (void);
 
 #endif
@@ -0,0 +1,891 @@
+/* surface.c
+
+   MolScript v2.1.2
+
+   Molecular (solvent-excluded) and solvent-accessible surfaces.
+
+   The surfaces are computed on a grid of spacing 'surfacegrid' from
+   the coordinates and radii of the selected atoms. The accessible
+   surface is the zero level of the distance to the atom spheres
+   expanded by the probe radius 'surfaceprobe'. The molecular surface
+   is the zero level of the probe radius less the distance to the
+   accessible surface, inside the accessible surface. The triangles
+   are made by marching cubes, and each vertex is given the colour of
+   the atom nearest to it.
+
+   The grid is processed in slabs of layers, concurrently if
+   THREAD_SUPPORT is defined. The output does not depend on the
+   number of threads.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  decimation of the surface triangles
+    18-Oct-2026  detail levels
+    18-Oct-2026  slabs run by the shared thread jobs
+    18-Oct-2026  triangles kept for watch mode
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "clib/extent3d.h"
+#include "clib/thread_jobs.h"
+
+#include "surface.h"
+#include "decimate.h"
+#include "global.h"
+#include "graphics.h"
+#include "select.h"
+#include "state.h"
+#include "watch.h"
+
+
+/*============================================================*/
+#define SLAB_LAYERS 4
+#define MAX_GRID_POINTS 100000000
+#define MAX_CUBE_TRIANGLES 10
+
+#define INDEX(i,j,k) ((((k) * ny) + (j)) * nx + (i))
+
+typedef struct {
+  vector3 *triplets;
+  int count, alloc;
+} triplet_buffer;
+
+static int mc_edges [12][2];
+static signed char mc_triangles [256][3 * MAX_CUBE_TRIANGLES + 1];
+static boolean mc_ready = FALSE;
+
+static int atom_count;
+static vector3 *centres;
+static double *radii;		/* atom radius */
+static double *reaches;		/* atom radius plus probe radius */
+static vector3 *colours;
+
+static double cell_size;
+static int cx, cy, cz;
+static int *cell_first, *cell_next;
+
+static int nx, ny, nz;
+static double spacing, probe;
+static vector3 origin;
+static float *accessible;	/* distance field of the accessible surface */
+static float *excluded;		/* field of the molecular surface */
+static float *field;		/* field for the triangles */
+
+static boolean surface_accessible;
+static vector3 *level_triplets = NULL; /* kept for the coarser levels */
+static int level_count;
+
+static vector3 *samples;	/* points of the accessible surface */
+static int *layer_samples;	/* count of the samples in each layer */
+static int *layer_first;	/* first sample of each layer */
+
+static triplet_buffer *slab_buffers;
+static triplet_buffer decimated;	/* coarser level, kept for watch mode */
+static void (*object_output) (int code, vector3 *triplets, int count);
+static int slab_count;
+static void (*slab_compute) (int slab);
+
+
+/*------------------------------------------------------------*/
+static void
+build_tables (void)
+     /*
+       The marching cubes triangles for each of the 256 cases of
+       inside corners. On each face of the cube, the edge points are
+       joined so that the inside corners are kept apart; this resolves
+       the ambiguous faces in the same way for neighbour cubes. The
+       directed segments are joined into loops around the cube, and
+       each loop is split into a fan of triangles facing outwards.
+     */
+{
+  static const int face_bits[3][2] = {{2, 4}, {4, 1}, {1, 2}};
+  int edge_of[8][8];
+  int next[12], loop[12], corners[4];
+  int index, axis, side, bit, u, v, base, slot, edge, count, length, k, a;
+  signed char *tri;
+
+  count = 0;
+  for (slot = 0; slot < 8; slot++) {
+    for (bit = 1; bit < 8; bit *= 2) {
+      if (slot & bit) continue;
+      mc_edges[count][0] = slot;
+      mc_edges[count][1] = slot | bit;
+      edge_of[slot][slot | bit] = count;
+      edge_of[slot | bit][slot] = count;
+      count++;
+    }
+  }
+  assert (count == 12);
+
+#define INSIDE(c) (index & (1 << (c)))
+
+  for (index = 0; index < 256; index++) {
+    for (edge = 0; edge < 12; edge++) next[edge] = -1;
+
+    for (axis = 0; axis < 3; axis++) {
+      bit = 1 << axis;
+      u = face_bits[axis][0];
+      v = face_bits[axis][1];
+      for (side = 0; side < 2; side++) { /* corners anticlockwise from out */
+	base = side ? bit : 0;
+	corners[0] = base;
+	corners[1] = side ? base | u : base | v;
+	corners[2] = base | u | v;
+	corners[3] = side ? base | v : base | u;
+	for (k = 0; k < 4; k++) {
+	  if (! INSIDE (corners[k]) || INSIDE (corners[(k+1) % 4])) continue;
+	  a = k;
+	  while (INSIDE (corners[(a+3) % 4])) a = (a + 3) % 4;
+	  next[edge_of[corners[k]][corners[(k+1) % 4]]] =
+	    edge_of[corners[(a+3) % 4]][corners[a]];
+	}
+      }
+    }
+
+    tri = mc_triangles[index];
+    count = 0;
+    for (edge = 0; edge < 12; edge++) {
+      if (next[edge] < 0) continue;
+      length = 0;
+      slot = edge;
+      do {
+	loop[length++] = slot;
+	a = next[slot];
+	next[slot] = -1;
+	slot = a;
+	assert (slot >= 0);
+      } while (slot != edge);
+      assert (length >= 3);
+      for (k = 1; k < length - 1; k++) {
+	*tri++ = loop[0];
+	*tri++ = loop[k+1];
+	*tri++ = loop[k];
+	count++;
+      }
+    }
+    assert (count <= MAX_CUBE_TRIANGLES);
+    *tri = -1;
+  }
+
+#undef INSIDE
+
+  mc_ready = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+buffer_add (triplet_buffer *buf, vector3 *v)
+{
+  assert (buf);
+  assert (v);
+
+  if (buf->count >= buf->alloc) {
+    buf->alloc = buf->alloc ? 2 * buf->alloc : 1024;
+    buf->triplets = realloc (buf->triplets, buf->alloc * sizeof (vector3));
+  }
+  buf->triplets[buf->count++] = *v;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+grid_point (vector3 *p, int i, int j, int k)
+{
+  p->x = origin.x + (double) i * spacing;
+  p->y = origin.y + (double) j * spacing;
+  p->z = origin.z + (double) k * spacing;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+grid_range (double low, double high, double start, int count,
+	    int *first, int *last)
+     /* The grid points within the interval, clipped to the grid. */
+{
+  *first = (int) ceil ((low - start) / spacing);
+  *last = (int) floor ((high - start) / spacing);
+  if (*first < 0) *first = 0;
+  if (*last > count - 1) *last = count - 1;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+slab_layers (int slab, int layers, int *first, int *last)
+{
+  *first = slab * SLAB_LAYERS;
+  *last = *first + SLAB_LAYERS - 1;
+  if (*last > layers - 1) *last = layers - 1;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+compute_slabs (thread_jobs *tj)
+{
+  int slot;
+
+  while ((slot = thread_jobs_take (tj)) >= 0) slab_compute (slot);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+run_slabs (int layers, void (*compute) (int slab))
+     /*
+       Compute the slabs of the layers, concurrently if THREAD_SUPPORT
+       is defined. A slab job may write only to its own layers and
+       its own buffer.
+     */
+{
+  thread_jobs tj;
+
+  assert (layers > 0);
+  assert (compute);
+
+  slab_count = (layers + SLAB_LAYERS - 1) / SLAB_LAYERS;
+  slab_buffers = calloc (slab_count, sizeof (triplet_buffer));
+  slab_compute = compute;
+
+  thread_jobs_run (&tj, slab_count, compute_slabs, NULL);
+}
+
+
+/*------------------------------------------------------------*/
+static vector3 *
+join_slabs (int *count)
+     /* Concatenate the slab buffers in order, and free them. */
+{
+  vector3 *triplets, *t;
+  int slot;
+
+  assert (count);
+
+  *count = 0;
+  for (slot = 0; slot < slab_count; slot++) *count += slab_buffers[slot].count;
+  t = triplets = malloc ((*count + 1) * sizeof (vector3));
+  for (slot = 0; slot < slab_count; slot++) {
+    if (slab_buffers[slot].count > 0) {
+      memcpy (t, slab_buffers[slot].triplets,
+	      slab_buffers[slot].count * sizeof (vector3));
+      t += slab_buffers[slot].count;
+    }
+    free (slab_buffers[slot].triplets);
+  }
+  free (slab_buffers);
+  slab_buffers = NULL;
+
+  return triplets;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+accessible_slab (int slab)
+     /* The distance to the expanded atom spheres, up to two grid steps. */
+{
+  int i, j, k, k0, k1, i0, i1, j0, j1, kk0, kk1, slot;
+  double reach, dx, dy, dz, dyz, d;
+  float *f;
+  vector3 *c;
+
+  slab_layers (slab, nz, &k0, &k1);
+
+  for (f = accessible + INDEX (0, 0, k0); f < accessible + INDEX (0, 0, k1+1); f++)
+    *f = (float) (2.0 * spacing);
+
+  for (slot = 0; slot < atom_count; slot++) {
+    c = centres + slot;
+    reach = reaches[slot] + 2.0 * spacing;
+    grid_range (c->z - reach, c->z + reach, origin.z, nz, &kk0, &kk1);
+    if (kk0 < k0) kk0 = k0;
+    if (kk1 > k1) kk1 = k1;
+    if (kk0 > kk1) continue;
+    grid_range (c->y - reach, c->y + reach, origin.y, ny, &j0, &j1);
+    grid_range (c->x - reach, c->x + reach, origin.x, nx, &i0, &i1);
+
+    for (k = kk0; k <= kk1; k++) {
+      dz = origin.z + (double) k * spacing - c->z;
+      for (j = j0; j <= j1; j++) {
+	dy = origin.y + (double) j * spacing - c->y;
+	dyz = dy * dy + dz * dz;
+	f = accessible + INDEX (i0, j, k);
+	for (i = i0; i <= i1; i++, f++) {
+	  dx = origin.x + (double) i * spacing - c->x;
+	  d = sqrt (dx * dx + dyz) - reaches[slot];
+	  if (d < *f) *f = (float) d;
+	}
+      }
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+edge_point (vector3 *p, int i, int j, int k, int axis, double f0, double f1)
+     /* The zero point on the grid edge from (i,j,k) along the axis. */
+{
+  double t = f0 / (f0 - f1);
+
+  grid_point (p, i, j, k);
+  switch (axis) {
+  case 0:
+    p->x += t * spacing;
+    break;
+  case 1:
+    p->y += t * spacing;
+    break;
+  case 2:
+    p->z += t * spacing;
+    break;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+sample_slab (int slab)
+     /* The points of the accessible surface on the grid edges. */
+{
+  int i, j, k, k0, k1, before;
+  float f0, f1;
+  vector3 p;
+  triplet_buffer *buf = slab_buffers + slab;
+
+  slab_layers (slab, nz, &k0, &k1);
+
+  for (k = k0; k <= k1; k++) {
+    before = buf->count;
+    for (j = 0; j < ny; j++) {
+      for (i = 0; i < nx; i++) {
+	f0 = accessible[INDEX (i, j, k)];
+	if (i + 1 < nx) {
+	  f1 = accessible[INDEX (i + 1, j, k)];
+	  if ((f0 < 0.0) != (f1 < 0.0)) {
+	    edge_point (&p, i, j, k, 0, f0, f1);
+	    buffer_add (buf, &p);
+	  }
+	}
+	if (j + 1 < ny) {
+	  f1 = accessible[INDEX (i, j + 1, k)];
+	  if ((f0 < 0.0) != (f1 < 0.0)) {
+	    edge_point (&p, i, j, k, 1, f0, f1);
+	    buffer_add (buf, &p);
+	  }
+	}
+	if (k + 1 < nz) {
+	  f1 = accessible[INDEX (i, j, k + 1)];
+	  if ((f0 < 0.0) != (f1 < 0.0)) {
+	    edge_point (&p, i, j, k, 2, f0, f1);
+	    buffer_add (buf, &p);
+	  }
+	}
+      }
+    }
+    layer_samples[k] = buf->count - before;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+excluded_slab (int slab)
+     /*
+       Inside the accessible surface, the probe radius less the distance
+       to the accessible surface, down to one grid step below zero.
+       Outside, the probe radius.
+     */
+{
+  int i, j, k, k0, k1, i0, i1, j0, j1, kk0, kk1, slot, first, last, layers;
+  double reach, dx, dy, dz, dyz, d;
+  float *f, *a;
+  vector3 *s;
+
+  slab_layers (slab, nz, &k0, &k1);
+  reach = probe + spacing;
+
+  for (f = excluded + INDEX (0, 0, k0); f < excluded + INDEX (0, 0, k1+1); f++)
+    *f = (float) reach;
+
+  layers = (int) ceil (reach / spacing) + 1;
+  first = k0 - layers;
+  if (first < 0) first = 0;
+  last = k1 + layers;
+  if (last > nz - 1) last = nz - 1;
+
+  for (slot = layer_first[first]; slot < layer_first[last + 1]; slot++) {
+    s = samples + slot;
+    grid_range (s->z - reach, s->z + reach, origin.z, nz, &kk0, &kk1);
+    if (kk0 < k0) kk0 = k0;
+    if (kk1 > k1) kk1 = k1;
+    if (kk0 > kk1) continue;
+    grid_range (s->y - reach, s->y + reach, origin.y, ny, &j0, &j1);
+    grid_range (s->x - reach, s->x + reach, origin.x, nx, &i0, &i1);
+
+    for (k = kk0; k <= kk1; k++) {
+      dz = origin.z + (double) k * spacing - s->z;
+      for (j = j0; j <= j1; j++) {
+	dy = origin.y + (double) j * spacing - s->y;
+	dyz = dy * dy + dz * dz;
+	a = accessible + INDEX (i0, j, k);
+	f = excluded + INDEX (i0, j, k);
+	for (i = i0; i <= i1; i++, a++, f++) {
+	  if (*a >= 0.0) continue;
+	  dx = origin.x + (double) i * spacing - s->x;
+	  d = sqrt (dx * dx + dyz);
+	  if (d < *f) *f = (float) d;
+	}
+      }
+    }
+  }
+
+  a = accessible + INDEX (0, 0, k0);
+  for (f = excluded + INDEX (0, 0, k0); f < excluded + INDEX (0, 0, k1+1);
+       f++, a++) {
+    if (*a >= 0.0) {
+      *f = (float) probe;
+    } else {
+      *f = (float) (probe - *f);
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static double
+difference (int index, int pos, int count, int stride)
+     /* Central difference of the field, one-sided at the grid border. */
+{
+  int low, high;
+
+  low = (pos > 0) ? index - stride : index;
+  high = (pos < count - 1) ? index + stride : index;
+  return (field[high] - field[low]) / (double) ((high - low) / stride);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+gradient (vector3 *g, int i, int j, int k)
+{
+  int index = INDEX (i, j, k);
+
+  g->x = difference (index, i, nx, 1);
+  g->y = difference (index, j, ny, nx);
+  g->z = difference (index, k, nz, nx * ny);
+}
+
+
+/*------------------------------------------------------------*/
+static int
+nearest_atom (vector3 *p)
+     /* The atom with its sphere nearest to the point. */
+{
+  int ci, cj, ck, i, j, k, slot, best = -1;
+  double d, dmin = 1.0e20;
+
+  assert (p);
+
+  ci = (int) floor ((p->x - origin.x) / cell_size);
+  cj = (int) floor ((p->y - origin.y) / cell_size);
+  ck = (int) floor ((p->z - origin.z) / cell_size);
+
+  for (k = ck - 1; k <= ck + 1; k++) {
+    if ((k < 0) || (k >= cz)) continue;
+    for (j = cj - 1; j <= cj + 1; j++) {
+      if ((j < 0) || (j >= cy)) continue;
+      for (i = ci - 1; i <= ci + 1; i++) {
+	if ((i < 0) || (i >= cx)) continue;
+	for (slot = cell_first[(k * cy + j) * cx + i];
+	     slot >= 0;
+	     slot = cell_next[slot]) {
+	  d = v3_distance (p, centres + slot) - radii[slot];
+	  if (d < dmin) {
+	    dmin = d;
+	    best = slot;
+	  }
+	}
+      }
+    }
+  }
+
+  if (best < 0) {		/* should not happen; just in case */
+    for (slot = 0; slot < atom_count; slot++) {
+      d = v3_distance (p, centres + slot) - radii[slot];
+      if (d < dmin) {
+	dmin = d;
+	best = slot;
+      }
+    }
+  }
+
+  return best;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+cube_slab (int slab)
+     /* The triangles of the cubes in the layers of the slab. */
+{
+  int i, j, k, k0, k1, c, index, edge, a, b, ia, ja, ka;
+  int done[12];
+  double t, value[8];
+  signed char *tri;
+  vector3 p[12], n[12], rgb[12], g;
+  triplet_buffer *buf = slab_buffers + slab;
+
+  slab_layers (slab, nz - 1, &k0, &k1);
+
+  for (k = k0; k <= k1; k++) {
+    for (j = 0; j < ny - 1; j++) {
+      for (i = 0; i < nx - 1; i++) {
+
+	index = 0;
+	for (c = 0; c < 8; c++) {
+	  value[c] = field[INDEX (i + (c & 1), j + ((c >> 1) & 1), k + (c >> 2))];
+	  if (value[c] < 0.0) index |= 1 << c;
+	}
+	if ((index == 0) || (index == 255)) continue;
+
+	for (edge = 0; edge < 12; edge++) done[edge] = FALSE;
+
+	for (tri = mc_triangles[index]; *tri >= 0; tri++) {
+	  edge = *tri;
+	  if (! done[edge]) {
+	    a = mc_edges[edge][0];
+	    b = mc_edges[edge][1];
+	    t = value[a] / (value[a] - value[b]);
+	    ia = i + (a & 1);
+	    ja = j + ((a >> 1) & 1);
+	    ka = k + (a >> 2);
+	    grid_point (p + edge, ia, ja, ka);
+	    gradient (n + edge, ia, ja, ka);
+	    gradient (&g, i + (b & 1), j + ((b >> 1) & 1), k + (b >> 2));
+	    switch (a ^ b) {
+	    case 1:
+	      p[edge].x += t * spacing;
+	      break;
+	    case 2:
+	      p[edge].y += t * spacing;
+	      break;
+	    case 4:
+	      p[edge].z += t * spacing;
+	      break;
+	    }
+	    v3_scale (n + edge, 1.0 - t);
+	    v3_add_scaled (n + edge, t, &g);
+	    if (v3_length (n + edge) > 0.0) {
+	      v3_normalize (n + edge);
+	    } else {
+	      n[edge] = zaxis;
+	    }
+	    rgb[edge] = colours[nearest_atom (p + edge)];
+	    done[edge] = TRUE;
+	  }
+	  buffer_add (buf, p + edge);
+	  buffer_add (buf, n + edge);
+	  buffer_add (buf, rgb + edge);
+	}
+      }
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+setup_cells (void)
+     /* Spatial cells of the atoms, for the nearest atom search. */
+{
+  int slot, i, j, k, cell;
+  double maxreach = 0.0;
+
+  for (slot = 0; slot < atom_count; slot++) {
+    if (reaches[slot] > maxreach) maxreach = reaches[slot];
+  }
+  cell_size = maxreach + spacing;
+  cx = (int) ((double) (nx - 1) * spacing / cell_size) + 1;
+  cy = (int) ((double) (ny - 1) * spacing / cell_size) + 1;
+  cz = (int) ((double) (nz - 1) * spacing / cell_size) + 1;
+
+  cell_first = malloc (cx * cy * cz * sizeof (int));
+  for (cell = 0; cell < cx * cy * cz; cell++) cell_first[cell] = -1;
+  cell_next = malloc (atom_count * sizeof (int));
+
+  for (slot = atom_count - 1; slot >= 0; slot--) {
+    i = (int) floor ((centres[slot].x - origin.x) / cell_size);
+    j = (int) floor ((centres[slot].y - origin.y) / cell_size);
+    k = (int) floor ((centres[slot].z - origin.z) / cell_size);
+    if (i > cx - 1) i = cx - 1;
+    if (j > cy - 1) j = cy - 1;
+    if (k > cz - 1) k = cz - 1;
+    cell = (k * cy + j) * cx + i;
+    cell_next[slot] = cell_first[cell];
+    cell_first[cell] = slot;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static vector3 *
+grid_triplets (boolean accessible_only, vector3 *low, vector3 *high,
+	       int *count)
+     /*
+       Compute the triangles of the surface on the grid within the box;
+       NULL if the grid is too large.
+     */
+{
+  vector3 *triplets;
+  int slot;
+
+  origin = *low;
+  nx = (int) ceil ((high->x - low->x) / spacing) + 1;
+  ny = (int) ceil ((high->y - low->y) / spacing) + 1;
+  nz = (int) ceil ((high->z - low->z) / spacing) + 1;
+  if ((double) nx * (double) ny * (double) nz > (double) MAX_GRID_POINTS) {
+    free (centres);
+    free (radii);
+    free (reaches);
+    free (colours);
+    yyerror ("too many surface grid points; increase surfacegrid");
+    return NULL;
+  }
+
+  if (! mc_ready) build_tables();
+  setup_cells();
+
+  accessible = malloc (nx * ny * nz * sizeof (float));
+  run_slabs (nz, accessible_slab);
+  free (join_slabs (count));
+
+  if (accessible_only) {
+    field = accessible;
+
+  } else {
+    layer_samples = malloc (nz * sizeof (int));
+    run_slabs (nz, sample_slab);
+    samples = join_slabs (count);
+    layer_first = malloc ((nz + 1) * sizeof (int));
+    layer_first[0] = 0;
+    for (slot = 0; slot < nz; slot++)
+      layer_first[slot + 1] = layer_first[slot] + layer_samples[slot];
+    assert (layer_first[nz] == *count);
+
+    excluded = malloc (nx * ny * nz * sizeof (float));
+    run_slabs (nz, excluded_slab);
+    free (join_slabs (count));
+    free (samples);
+    free (layer_samples);
+    free (layer_first);
+    free (accessible);
+    accessible = NULL;
+    field = excluded;
+  }
+
+  run_slabs (nz - 1, cube_slab);
+  triplets = join_slabs (count);
+
+  free (field);
+  field = accessible = excluded = NULL;
+  free (cell_first);
+  free (cell_next);
+
+  return triplets;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+keep_object (int code, vector3 *triplets, int count)
+     /* Output the decimated triangles, and keep a copy of them. */
+{
+  int slot;
+
+  for (slot = 0; slot < count; slot++) buffer_add (&decimated, triplets + slot);
+  object_output (code, triplets, count);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+decimated_level (void)
+     /*
+       Output the surface decimated for the coarser detail level. In
+       watch mode, the triangles of an unchanged command are taken from
+       the earlier run.
+     */
+{
+  vector3 *kept, *triplets;
+  size_t size;
+
+  if (watch_mode) {
+    kept = watch_recall (&size);
+    if (kept) {
+      if (size > 0) {
+	triplets = malloc (size);
+	memcpy (triplets, kept, size);
+	output_object (OBJ_TRIANGLES_NORMALS_COLOURS, triplets,
+		       size / sizeof (vector3));
+	free (triplets);
+      }
+      return;
+    }
+    decimated.triplets = NULL;
+    decimated.count = decimated.alloc = 0;
+    object_output = output_object;
+    output_object = keep_object;
+  }
+
+  decimate_add (OBJ_TRIANGLES_NORMALS_COLOURS, level_triplets, level_count);
+  decimate_output();
+
+  if (watch_mode) {
+    output_object = object_output;
+    if (decimated.triplets == NULL)
+      decimated.triplets = malloc (sizeof (vector3));
+    watch_store (decimated.triplets, decimated.count * sizeof (vector3));
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+surface_geometry (void)
+     /*
+       Output the accessible surface, or the molecular surface, of
+       the selected atoms as a triangle object.
+     */
+{
+  boolean accessible_only = surface_accessible;
+  at3d **atoms;
+  int slot, selected, count;
+  double margin;
+  vector3 low, high;
+  vector3 *triplets;
+  colour rgb;
+  void *kept;
+  size_t size;
+
+  assert (count_atom_selections() == 1);
+
+  atoms = select_atom_list (&selected);
+
+  assert (count_atom_selections() == 0);
+
+  if (detail_level > 0) {	/* same surface, decimated further */
+    if (atoms) free (atoms);
+    if (level_triplets) {
+      output_start_object();
+      decimated_level();
+      output_finish_object();
+      if (detail_level == detail_level_total - 1) {
+	free (level_triplets);
+	level_triplets = NULL;
+      }
+    }
+    return;
+  }
+
+  if (message_mode)
+    fprintf (stderr, "%i atoms selected for %s\n", selected,
+	     accessible_only ? "accessible-surface" : "molecular-surface");
+  if (atoms == NULL) return;
+
+  spacing = current_state->surfacegrid;
+  probe = current_state->surfaceprobe;
+  if (! accessible_only && (probe < 0.1 * spacing)) accessible_only = TRUE;
+
+  centres = malloc (selected * sizeof (vector3));
+  radii = malloc (selected * sizeof (double));
+  reaches = malloc (selected * sizeof (double));
+  colours = malloc (selected * sizeof (vector3));
+  atom_count = 0;
+  for (slot = 0; slot < selected; slot++) {
+    if (atoms[slot]->radius <= 0.0) continue;
+    centres[atom_count] = atoms[slot]->xyz;
+    radii[atom_count] = atoms[slot]->radius;
+    reaches[atom_count] = atoms[slot]->radius + probe;
+    colour_copy_to_rgb (&rgb, &(atoms[slot]->colour));
+    v3_initialize (colours + atom_count, rgb.x, rgb.y, rgb.z);
+    atom_count++;
+  }
+  free (atoms);
+  if (atom_count == 0) goto cleanup;
+
+  v3_initialize (&low, 1.0e20, 1.0e20, 1.0e20);
+  v3_initialize (&high, -1.0e20, -1.0e20, -1.0e20);
+  for (slot = 0; slot < atom_count; slot++) {
+    margin = reaches[slot] + 2.0 * spacing;
+    if (centres[slot].x - margin < low.x) low.x = centres[slot].x - margin;
+    if (centres[slot].y - margin < low.y) low.y = centres[slot].y - margin;
+    if (centres[slot].z - margin < low.z) low.z = centres[slot].z - margin;
+    if (centres[slot].x + margin > high.x) high.x = centres[slot].x + margin;
+    if (centres[slot].y + margin > high.y) high.y = centres[slot].y + margin;
+    if (centres[slot].z + margin > high.z) high.z = centres[slot].z + margin;
+    ext3d_update (centres + slot,
+		  accessible_only ? reaches[slot] : radii[slot]);
+  }
+  triplets = NULL;
+  if (watch_mode) {		/* unchanged command: same triangles */
+    kept = watch_recall (&size);
+    if (kept) {
+      count = size / sizeof (vector3);
+      triplets = malloc ((count + 1) * sizeof (vector3));
+      memcpy (triplets, kept, size);
+    }
+  }
+  if (triplets == NULL) {
+    triplets = grid_triplets (accessible_only, &low, &high, &count);
+    if (triplets == NULL) return;
+    if (watch_mode) {
+      kept = malloc ((count + 1) * sizeof (vector3));
+      memcpy (kept, triplets, count * sizeof (vector3));
+      watch_store (kept, count * sizeof (vector3));
+    }
+  }
+
+  if (message_mode) fprintf (stderr, "%i triangles in surface\n", count / 9);
+
+  if (count > 0) {
+    output_start_object();
+    if (decimate_code (OBJ_TRIANGLES_NORMALS_COLOURS)) {
+      decimate_add (OBJ_TRIANGLES_NORMALS_COLOURS, triplets, count);
+      decimate_output();
+    } else {
+      output_object (OBJ_TRIANGLES_NORMALS_COLOURS, triplets, count);
+    }
+    output_finish_object();
+  }
+
+  if (level_triplets) free (level_triplets);
+  level_triplets = NULL;
+  if ((count > 0) && (detail_level_total > 1)) {
+    level_triplets = triplets;
+    level_count = count;
+  } else {
+    free (triplets);
+  }
+
+cleanup:
+  free (centres);
+  free (radii);
+  free (reaches);
+  free (colours);
+}
+
+
+/*------------------------------------------------------------*/
+void
+surface (boolean accessible_only)
+{
+  surface_accessible = accessible_only;
+  detail_levels (surface_geometry, DETAIL_ATOM_SELECTION);
+}
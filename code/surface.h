@@ -0,0 +1,18 @@
+/* surface.h
+
+   MolScript v2.1.2
+
+   Molecular (solvent-excluded) and solvent-accessible surfaces.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#ifndef SURFACE_H
+#define SURFACE_H 1
+
+#include "clib/boolean.h"
+
+void surface (boolean accessible);
+
+#endif
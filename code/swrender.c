@@ -0,0 +1,2202 @@
+/* swrender.c
+
+   MolScript v2.1.2
+
+   Software rendering for image file output.
+
+   The geometry is recorded through a minimal immediate mode (begin,
+   normal, colour, vertex, end) in the same way as the OpenGL display
+   lists are built in 'opengl.c', so that the faces, their winding and
+   colours are the same. The image is rendered by a z-buffer scan
+   converter using the OpenGL fixed-function lighting model (per-vertex
+   lighting, Gouraud shading), linear fog and alpha blending.
+
+   The image is rendered in bands of rows. If THREAD_SUPPORT is
+   defined, the bands are rendered in parallel by POSIX threads, one
+   for each processor. Only the rows requested by 'swr_render_rows'
+   are kept, so that large images can be output piecewise.
+
+   Labels are not rendered.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  render a range of rows at a time
+    18-Oct-2026  transform of the geometry for animation frames
+    18-Oct-2026  spheres and cylinders from the shared unit meshes
+    18-Oct-2026  bands run by the shared thread jobs
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "clib/angle.h"
+#include "clib/body3d.h"
+#include "clib/matrix3.h"
+#include "clib/thread_jobs.h"
+
+#include "swrender.h"
+#include "global.h"
+#include "graphics.h"
+#include "segment.h"
+#include "state.h"
+
+
+/*============================================================*/
+#define BAND_ROWS 16
+#define MAX_LIGHTS 8
+
+enum imm_modes {IMM_POINTS, IMM_LINES, IMM_LINE_STRIP,
+		IMM_TRIANGLES, IMM_TRIANGLE_STRIP, IMM_TRIANGLE_FAN,
+		IMM_QUADS, IMM_QUAD_STRIP};
+
+typedef struct {
+  float p[3];
+  float n[3];
+  float c[3];
+} imm_vertex;
+
+typedef struct {
+  float specular[3];
+  float emission[3];
+  float shininess;
+  float back[3];		/* back face colour, if has_back */
+  int has_back;
+  int lighting;
+  int two_sided;		/* otherwise back faces are culled */
+} material;
+
+typedef struct {
+  float v[3][3];		/* world, then window coordinates and depth */
+  float n[3][3];		/* normals, then back face colours */
+  float c[3][3];		/* colours, then front face colours */
+  float alpha;
+  int material;
+} triangle;
+
+typedef struct {
+  float v[2][3];		/* world, then window coordinates and depth */
+  float c[2][3];
+  float alpha;
+  float width;
+  int stipple;			/* repeat factor for pattern, or 0 */
+  int point;
+} line;
+
+enum light_types {SWR_DIRECTIONALLIGHT, SWR_POINTLIGHT, SWR_SPOTLIGHT};
+
+typedef struct {
+  int type;
+  float position[3];		/* direction towards light if directional */
+  float direction[3];
+  float cutoff;			/* cosine of spot cutoff angle */
+  float diffuse[3];		/* also specular */
+  float ambient[3];
+  float attenuation[3];
+} light;
+
+typedef struct {
+  int first_row;
+  int rows;
+  float *colour;
+  float *depth;
+  float *accum;
+} band_buffer;
+
+static imm_vertex imm_buffer[3];
+static imm_vertex imm_first;
+static int imm_mode = -1;
+static int imm_count;
+static float imm_normal[3];
+static float imm_colour[3];
+static float imm_alpha;
+static float imm_width;
+static int imm_stipple;
+static boolean imm_flat;
+
+static material imm_material;
+static boolean imm_material_changed;
+static int imm_material_index;
+
+static material *materials = NULL;
+static int material_count, material_alloc;
+
+static triangle *triangles = NULL;
+static int triangle_count, triangle_alloc;
+
+static line *lines = NULL;
+static int line_count, line_alloc;
+
+static light lights[MAX_LIGHTS];
+static int light_count;
+
+static int label_count;
+
+static int accum = 0;
+
+static int band_count;
+static int *bin_start = NULL;	/* triangle indices for each band */
+static int *bin_triangles = NULL;
+static int first_band;		/* of the rows being rendered */
+
+static float background[3];
+static double far_depth;
+static unsigned char *pixels = NULL;
+static int pixels_first, pixels_rows;
+
+
+/*------------------------------------------------------------*/
+static void
+copy3 (float *dest, const vector3 *v)
+{
+  dest[0] = (float) v->x;
+  dest[1] = (float) v->y;
+  dest[2] = (float) v->z;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_colour_property (colour *c)
+{
+  colour rgb;
+
+  assert (c);
+
+  colour_copy_to_rgb (&rgb, c);
+  copy3 (imm_colour, (vector3 *) &(rgb.x));
+  imm_alpha = 1.0 - current_state->transparency;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_rgb_property (vector3 *rgb)
+{
+  assert (rgb);
+
+  copy3 (imm_colour, rgb);
+  imm_alpha = 1.0 - current_state->transparency;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_material_properties (void)
+{
+  colour rgb;
+
+  colour_copy_to_rgb (&rgb, &(current_state->specularcolour));
+  imm_material.specular[0] = rgb.x;
+  imm_material.specular[1] = rgb.y;
+  imm_material.specular[2] = rgb.z;
+  imm_material.shininess = 128.0 * current_state->shininess;
+
+  colour_copy_to_rgb (&rgb, &(current_state->emissivecolour));
+  imm_material.emission[0] = rgb.x;
+  imm_material.emission[1] = rgb.y;
+  imm_material.emission[2] = rgb.z;
+
+  imm_material_changed = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_render_state (boolean lighting, boolean two_sided, boolean flat)
+{
+  imm_material.lighting = lighting;
+  imm_material.two_sided = two_sided;
+  imm_flat = flat;
+  imm_material_changed = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+set_back_colour (colour *c)
+{
+  colour rgb;
+
+  if (c) {
+    colour_copy_to_rgb (&rgb, c);
+    imm_material.back[0] = rgb.x;
+    imm_material.back[1] = rgb.y;
+    imm_material.back[2] = rgb.z;
+    imm_material.has_back = TRUE;
+  } else {
+    imm_material.back[0] = imm_material.back[1] = imm_material.back[2] = 0.0;
+    imm_material.has_back = FALSE;
+  }
+  imm_material_changed = TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+current_material (void)
+{
+  if (! imm_material_changed) return imm_material_index;
+
+  if ((material_count == 0) ||
+      memcmp (materials + material_count - 1, &imm_material,
+	      sizeof (material))) {
+    if (material_count >= material_alloc) {
+      material_alloc *= 2;
+      materials = realloc (materials, material_alloc * sizeof (material));
+    }
+    materials[material_count++] = imm_material;
+  }
+
+  imm_material_index = material_count - 1;
+  imm_material_changed = FALSE;
+  return imm_material_index;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+emit_triangle (imm_vertex *v1, imm_vertex *v2, imm_vertex *v3)
+     /* The last vertex is the provoking vertex for flat shading. */
+{
+  triangle *t;
+
+  assert (v1);
+  assert (v2);
+  assert (v3);
+
+  if (triangle_count >= triangle_alloc) {
+    triangle_alloc *= 2;
+    triangles = realloc (triangles, triangle_alloc * sizeof (triangle));
+  }
+  t = triangles + triangle_count++;
+
+  memcpy (t->v[0], v1->p, 3 * sizeof (float));
+  memcpy (t->v[1], v2->p, 3 * sizeof (float));
+  memcpy (t->v[2], v3->p, 3 * sizeof (float));
+  if (imm_flat) v1 = v2 = v3;
+  memcpy (t->n[0], v1->n, 3 * sizeof (float));
+  memcpy (t->n[1], v2->n, 3 * sizeof (float));
+  memcpy (t->n[2], v3->n, 3 * sizeof (float));
+  memcpy (t->c[0], v1->c, 3 * sizeof (float));
+  memcpy (t->c[1], v2->c, 3 * sizeof (float));
+  memcpy (t->c[2], v3->c, 3 * sizeof (float));
+  t->alpha = imm_alpha;
+  t->material = current_material();
+}
+
+
+/*------------------------------------------------------------*/
+static void
+emit_line (imm_vertex *v1, imm_vertex *v2, boolean point)
+{
+  line *l;
+
+  assert (v1);
+  assert (v2);
+
+  if (line_count >= line_alloc) {
+    line_alloc *= 2;
+    lines = realloc (lines, line_alloc * sizeof (line));
+  }
+  l = lines + line_count++;
+
+  memcpy (l->v[0], v1->p, 3 * sizeof (float));
+  memcpy (l->v[1], v2->p, 3 * sizeof (float));
+  if (imm_flat) v1 = v2;
+  memcpy (l->c[0], v1->c, 3 * sizeof (float));
+  memcpy (l->c[1], v2->c, 3 * sizeof (float));
+  l->alpha = imm_alpha;
+  l->width = imm_width;
+  l->stipple = imm_stipple;
+  l->point = point;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+begin (int mode)
+{
+  assert (imm_mode < 0);
+
+  imm_mode = mode;
+  imm_count = 0;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+end (void)
+{
+  assert (imm_mode >= 0);
+
+  imm_mode = -1;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+normal (vector3 *n)
+{
+  assert (n);
+
+  copy3 (imm_normal, n);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+vertex (vector3 *p)
+     /* Primitives are assembled as for the corresponding OpenGL modes. */
+{
+  imm_vertex v;
+
+  assert (p);
+  assert (imm_mode >= 0);
+
+  copy3 (v.p, p);
+  memcpy (v.n, imm_normal, 3 * sizeof (float));
+  memcpy (v.c, imm_colour, 3 * sizeof (float));
+
+  switch (imm_mode) {
+
+  case IMM_POINTS:
+    emit_line (&v, &v, TRUE);
+    break;
+
+  case IMM_LINES:
+    if (imm_count % 2) {
+      emit_line (imm_buffer, &v, FALSE);
+    } else {
+      imm_buffer[0] = v;
+    }
+    break;
+
+  case IMM_LINE_STRIP:
+    if (imm_count > 0) emit_line (imm_buffer, &v, FALSE);
+    imm_buffer[0] = v;
+    break;
+
+  case IMM_TRIANGLES:
+    if (imm_count % 3 == 2) {
+      emit_triangle (imm_buffer, imm_buffer + 1, &v);
+    } else {
+      imm_buffer[imm_count % 3] = v;
+    }
+    break;
+
+  case IMM_TRIANGLE_STRIP:
+    if (imm_count >= 2) {
+      if (imm_count % 2) {
+	emit_triangle (imm_buffer + 1, imm_buffer, &v);
+      } else {
+	emit_triangle (imm_buffer, imm_buffer + 1, &v);
+      }
+    }
+    imm_buffer[0] = imm_buffer[1];
+    imm_buffer[1] = v;
+    break;
+
+  case IMM_TRIANGLE_FAN:
+    if (imm_count == 0) {
+      imm_first = v;
+    } else if (imm_count >= 2) {
+      emit_triangle (&imm_first, imm_buffer, &v);
+    }
+    imm_buffer[0] = v;
+    break;
+
+  case IMM_QUADS:
+    if (imm_count % 4 == 3) {
+      emit_triangle (imm_buffer, imm_buffer + 1, imm_buffer + 2);
+      emit_triangle (imm_buffer, imm_buffer + 2, &v);
+    } else {
+      imm_buffer[imm_count % 4] = v;
+    }
+    break;
+
+  case IMM_QUAD_STRIP:
+    if (imm_count < 3) {
+      imm_buffer[imm_count] = v;
+    } else {
+      if (imm_count % 2) {
+	emit_triangle (imm_buffer, imm_buffer + 1, &v);
+	emit_triangle (imm_buffer, &v, imm_buffer + 2);
+      }
+      imm_buffer[0] = imm_buffer[1];
+      imm_buffer[1] = imm_buffer[2];
+      imm_buffer[2] = v;
+    }
+    break;
+  }
+
+  imm_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+disk (vector3 *pos, vector3 *axis, vector3 *arad, vector3 *brad,
+      double radius, int segments)
+{
+  int slot;
+  const double *cs = circle_points_get (segments);
+  vector3 point;
+
+  begin (IMM_TRIANGLE_FAN);
+  normal (axis);
+  vertex (pos);
+  v3_sum_scaled (&point, pos, radius, arad);
+  vertex (&point);
+  for (slot = segments - 1; slot >= 1; slot--) {
+    v3_scaled (&point, cs[2 * slot], arad);
+    v3_add_scaled (&point, cs[2 * slot + 1], brad);
+    v3_sum_scaled (&point, pos, radius, &point);
+    vertex (&point);
+  }
+  v3_sum_scaled (&point, pos, radius, arad);
+  vertex (&point);
+  end();
+}
+
+
+/*------------------------------------------------------------*/
+static void
+cylinder_faces (vector3 *pos1, vector3 *pos2,
+		double radius, int segments, boolean capped)
+     /* Same faces as 'ogl_cylinder_faces' in clib. */
+{
+  int slot;
+  const double *cs;
+  vector3 point, axis, arad, brad, rad;
+  vector3 xdir = {1.0, 0.0, 0.0};
+  vector3 ydir = {0.0, 1.0, 0.0};
+
+  assert (pos1);
+  assert (pos2);
+  assert (radius > 0.0);
+  assert (segments >= 3);
+
+  v3_difference (&axis, pos2, pos1);
+  v3_cross_product (&brad, &axis, &xdir);
+  if (v3_length (&brad) < 1.0e-10) v3_cross_product (&brad, &axis, &ydir);
+  v3_cross_product (&arad, &brad, &axis);
+  v3_normalize (&arad);
+  v3_cross_product (&brad, &arad, &axis);
+  v3_normalize (&brad);
+  cs = circle_points_get (segments);
+
+  begin (IMM_QUAD_STRIP);
+  normal (&arad);
+  v3_sum_scaled (&point, pos1, radius, &arad);
+  vertex (&point);
+  v3_sum_scaled (&point, pos2, radius, &arad);
+  vertex (&point);
+  for (slot = 1; slot < segments; slot++) {
+    v3_scaled (&rad, cs[2 * slot], &arad);
+    v3_add_scaled (&rad, cs[2 * slot + 1], &brad);
+    normal (&rad);
+    v3_sum_scaled (&point, pos1, radius, &rad);
+    vertex (&point);
+    v3_sum_scaled (&point, pos2, radius, &rad);
+    vertex (&point);
+  }
+  normal (&arad);
+  v3_sum_scaled (&point, pos1, radius, &arad);
+  vertex (&point);
+  v3_sum_scaled (&point, pos2, radius, &arad);
+  vertex (&point);
+  end();
+
+  if (capped) {
+    v3_normalize (&axis);
+    disk (pos2, &axis, &arad, &brad, radius, segments);
+    v3_reverse (&axis);
+    v3_reverse (&brad);
+    disk (pos1, &axis, &arad, &brad, radius, segments);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+globe_vertex (vector3 *pos, double radius, const vector3 *n)
+{
+  vector3 point;
+
+  normal ((vector3 *) n);
+  v3_sum_scaled (&point, pos, radius, (vector3 *) n);
+  vertex (&point);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+sphere_faces_globe (vector3 *pos, double radius, int segments)
+     /* Same faces as 'ogl_sphere_faces_globe' in clib. */
+{
+  const vector3 *points, *ring1, *ring2;
+  int slices, stacks, slice, stack;
+
+  assert (pos);
+  assert (radius > 0.0);
+  assert (segments >= 2);
+
+  slices = 2 * segments;
+  stacks = segments;
+  points = sphere_globe_points_get (segments);
+
+  begin (IMM_TRIANGLE_FAN);
+  globe_vertex (pos, radius, points);
+  ring1 = points + 1;
+  for (slice = 0; slice < slices; slice++)
+    globe_vertex (pos, radius, ring1 + slice);
+  globe_vertex (pos, radius, ring1);
+  end();
+
+  for (stack = 1; stack < stacks - 1; stack++) {
+    ring1 = points + 1 + (stack - 1) * slices;
+    ring2 = ring1 + slices;
+    begin (IMM_QUAD_STRIP);
+    globe_vertex (pos, radius, ring2);
+    globe_vertex (pos, radius, ring1);
+    for (slice = slices - 1; slice >= 1; slice--) {
+      globe_vertex (pos, radius, ring2 + slice);
+      globe_vertex (pos, radius, ring1 + slice);
+    }
+    globe_vertex (pos, radius, ring2);
+    globe_vertex (pos, radius, ring1);
+    end();
+  }
+
+  begin (IMM_TRIANGLE_FAN);
+  ring1 = points + 1 + (stacks - 1) * slices;
+  globe_vertex (pos, radius, ring1 + slices);
+  globe_vertex (pos, radius, ring1);
+  for (slice = slices - 1; slice >= 1; slice--)
+    globe_vertex (pos, radius, ring1 + slice);
+  globe_vertex (pos, radius, ring1);
+  end();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_set (void)
+{
+  output_first_plot = do_nothing;
+  output_finish_output = do_nothing;
+  output_start_plot = swr_start_plot;
+  output_finish_plot = swr_finish_plot;
+
+  set_area = swr_set_area;
+  set_background = swr_set_background;
+  anchor_start = do_nothing_str;
+  anchor_description = do_nothing_str;
+  anchor_parameter = do_nothing_str;
+  anchor_start_geometry = do_nothing;
+  anchor_finish = do_nothing;
+  lod_start = do_nothing;
+  lod_finish = do_nothing;
+  lod_start_group = do_nothing;
+  lod_finish_group = do_nothing;
+  viewpoint_start = do_nothing_str;
+  viewpoint_output = do_nothing;
+  output_directionallight = swr_directionallight;
+  output_pointlight = swr_pointlight;
+  output_spotlight = swr_spotlight;
+  output_comment = do_nothing_str;
+
+  output_coil = swr_coil;
+  output_cylinder = swr_cylinder;
+  output_helix = swr_helix;
+  output_label = swr_label;
+  output_line = swr_line;
+  output_sphere = swr_sphere;
+  output_stick = swr_stick;
+  output_strand = swr_strand;
+
+  output_start_object = swr_start_object;
+  output_object = swr_object;
+  output_finish_object = swr_finish_object;
+
+  output_pickable = NULL;
+
+  constant_colours_to_rgb();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_set_accum (int number)
+{
+  assert (number > 0);
+
+  accum = number;
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_start_plot (void)
+{
+  if (materials == NULL) {
+    material_alloc = 64;
+    materials = malloc (material_alloc * sizeof (material));
+    triangle_alloc = 4096;
+    triangles = malloc (triangle_alloc * sizeof (triangle));
+    line_alloc = 1024;
+    lines = malloc (line_alloc * sizeof (line));
+  }
+  material_count = 0;
+  triangle_count = 0;
+  line_count = 0;
+  light_count = 0;
+  label_count = 0;
+
+  memset (&imm_material, 0, sizeof (material));
+  set_render_state (TRUE, FALSE, FALSE);
+  set_material_properties();
+  imm_width = 1.0;
+  imm_stipple = 0;
+
+  colour_copy_to_rgb (&background_colour, &black_colour);
+
+  set_area_values (0.0, 0.0,
+		   (double) (output_width - 1),
+		   (double) (output_height - 1));
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_finish_plot (void)
+{
+  set_extent();
+
+  if (message_mode) {
+    fprintf (stderr, "%i lines/points, %i triangles rendered in software.\n",
+	     line_count, triangle_count);
+    if (label_count > 0)
+      fprintf (stderr, "ignoring %i labels for software rendering\n",
+	       label_count);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+shade (float *result, float *p, float *n, float *c, material *mat, float sign)
+     /*
+       OpenGL lighting equation for an infinite viewer, with the
+       ambient and diffuse material colour given by the vertex colour.
+     */
+{
+  int slot, axis;
+  light *l;
+  double nv[3], lv[3], hv[3], length, distance, ndotl, ndoth, factor, spec;
+
+  nv[0] = sign * n[0];
+  nv[1] = sign * n[1];
+  nv[2] = sign * n[2];
+  length = sqrt (nv[0] * nv[0] + nv[1] * nv[1] + nv[2] * nv[2]);
+  if (length > 0.0) {
+    nv[0] /= length;
+    nv[1] /= length;
+    nv[2] /= length;
+  }
+
+  for (axis = 0; axis < 3; axis++) result[axis] = mat->emission[axis];
+
+  for (slot = 0; slot < light_count; slot++) {
+    l = lights + slot;
+    factor = 1.0;
+
+    if (l->type == SWR_DIRECTIONALLIGHT) {
+      for (axis = 0; axis < 3; axis++) lv[axis] = l->position[axis];
+      length = sqrt (lv[0] * lv[0] + lv[1] * lv[1] + lv[2] * lv[2]);
+    } else {
+      for (axis = 0; axis < 3; axis++) lv[axis] = l->position[axis] - p[axis];
+      length = distance = sqrt (lv[0] * lv[0] + lv[1] * lv[1] + lv[2] * lv[2]);
+      factor = l->attenuation[0] + l->attenuation[1] * distance +
+	       l->attenuation[2] * distance * distance;
+      factor = (factor > 0.0) ? 1.0 / factor : 1.0;
+    }
+    if (length <= 0.0) continue;
+    for (axis = 0; axis < 3; axis++) lv[axis] /= length;
+
+    if (l->type == SWR_SPOTLIGHT) {
+      if (- (lv[0] * l->direction[0] + lv[1] * l->direction[1] +
+	     lv[2] * l->direction[2]) < l->cutoff) continue;
+    }
+
+    ndotl = nv[0] * lv[0] + nv[1] * lv[1] + nv[2] * lv[2];
+    if (ndotl < 0.0) ndotl = 0.0;
+
+    spec = 0.0;
+    if (ndotl > 0.0) {
+      hv[0] = lv[0];
+      hv[1] = lv[1];
+      hv[2] = lv[2] + 1.0;
+      length = sqrt (hv[0] * hv[0] + hv[1] * hv[1] + hv[2] * hv[2]);
+      if (length > 0.0) {
+	ndoth = (nv[0] * hv[0] + nv[1] * hv[1] + nv[2] * hv[2]) / length;
+	if (ndoth > 0.0) spec = pow (ndoth, mat->shininess);
+      }
+    }
+
+    for (axis = 0; axis < 3; axis++) {
+      result[axis] += factor * (l->ambient[axis] * c[axis] +
+				ndotl * l->diffuse[axis] * c[axis] +
+				spec * l->diffuse[axis] * mat->specular[axis]);
+    }
+  }
+
+  for (axis = 0; axis < 3; axis++) {
+    if (result[axis] > 1.0) result[axis] = 1.0;
+    if (result[axis] < 0.0) result[axis] = 0.0;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+to_window (float *v)
+     /* Orthographic projection as in 'ogl_render_init'. */
+{
+  v[0] = (v[0] + aspect_window_x) * output_width / (2.0 * aspect_window_x);
+  v[1] = (v[1] + aspect_window_y) * output_height / (2.0 * aspect_window_y);
+  v[2] = slab - v[2];
+}
+
+
+/*------------------------------------------------------------*/
+static void
+prepare (void)
+     /*
+       Light the vertices, transform to window coordinates, and sort
+       the triangles into the bands they overlap.
+     */
+{
+  int slot, vslot, band, first, last, total;
+  triangle *t;
+  material *mat;
+  float front[3], back[3], ylo, yhi;
+  int *fill;
+
+  if (headlight) {		/* OpenGL light 0 defaults */
+    assert (light_count < MAX_LIGHTS);
+    memset (lights + light_count, 0, sizeof (light));
+    lights[light_count].type = SWR_DIRECTIONALLIGHT;
+    lights[light_count].position[2] = 1.0;
+    lights[light_count].diffuse[0] = 1.0;
+    lights[light_count].diffuse[1] = 1.0;
+    lights[light_count].diffuse[2] = 1.0;
+    lights[light_count].attenuation[0] = 1.0;
+    light_count++;
+  }
+
+  set_area_values (0.0, 0.0,
+		   (double) (output_width - 1),
+		   (double) (output_height - 1));
+  assert (aspect_window_x > 0.0);
+  assert (aspect_window_y > 0.0);
+  assert (slab > 0.0);
+  far_depth = 2.0 * slab;
+
+  colour_to_rgb (&background_colour);
+  background[0] = background_colour.x;
+  background[1] = background_colour.y;
+  background[2] = background_colour.z;
+
+  for (slot = 0; slot < triangle_count; slot++) {
+    t = triangles + slot;
+    mat = materials + t->material;
+    for (vslot = 0; vslot < 3; vslot++) {
+      if (mat->lighting) {
+	shade (front, t->v[vslot], t->n[vslot], t->c[vslot], mat, 1.0);
+	if (mat->two_sided) {
+	  shade (back, t->v[vslot], t->n[vslot],
+		 mat->has_back ? mat->back : t->c[vslot], mat, -1.0);
+	} else {
+	  memcpy (back, front, 3 * sizeof (float));
+	}
+      } else {
+	memcpy (front, t->c[vslot], 3 * sizeof (float));
+	memcpy (back, front, 3 * sizeof (float));
+      }
+      memcpy (t->c[vslot], front, 3 * sizeof (float));
+      memcpy (t->n[vslot], back, 3 * sizeof (float));
+      to_window (t->v[vslot]);
+    }
+  }
+
+  for (slot = 0; slot < line_count; slot++) {
+    to_window (lines[slot].v[0]);
+    to_window (lines[slot].v[1]);
+  }
+
+  band_count = (output_height + BAND_ROWS - 1) / BAND_ROWS;
+  bin_start = calloc (band_count + 1, sizeof (int));
+
+  for (slot = 0; slot < triangle_count; slot++) { /* count per band */
+    t = triangles + slot;
+    ylo = yhi = t->v[0][1];
+    for (vslot = 1; vslot < 3; vslot++) {
+      if (t->v[vslot][1] < ylo) ylo = t->v[vslot][1];
+      if (t->v[vslot][1] > yhi) yhi = t->v[vslot][1];
+    }
+    first = (int) floor ((ylo - 1.0) / BAND_ROWS);
+    last = (int) floor ((yhi + 1.0) / BAND_ROWS);
+    if (first < 0) first = 0;
+    if (last >= band_count) last = band_count - 1;
+    for (band = first; band <= last; band++) bin_start[band + 1]++;
+  }
+
+  for (band = 0; band < band_count; band++)
+    bin_start[band + 1] += bin_start[band];
+  total = bin_start[band_count];
+  bin_triangles = malloc ((total > 0 ? total : 1) * sizeof (int));
+  fill = malloc (band_count * sizeof (int));
+  memcpy (fill, bin_start, band_count * sizeof (int));
+
+  for (slot = 0; slot < triangle_count; slot++) { /* fill in order */
+    t = triangles + slot;
+    ylo = yhi = t->v[0][1];
+    for (vslot = 1; vslot < 3; vslot++) {
+      if (t->v[vslot][1] < ylo) ylo = t->v[vslot][1];
+      if (t->v[vslot][1] > yhi) yhi = t->v[vslot][1];
+    }
+    first = (int) floor ((ylo - 1.0) / BAND_ROWS);
+    last = (int) floor ((yhi + 1.0) / BAND_ROWS);
+    if (first < 0) first = 0;
+    if (last >= band_count) last = band_count - 1;
+    for (band = first; band <= last; band++) bin_triangles[fill[band]++] = slot;
+  }
+
+  free (fill);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+fragment (band_buffer *bb, int ix, int iy, double depth,
+	  double r, double g, double b, double alpha, boolean blend)
+{
+  int index;
+  float *dest;
+  double f;
+
+  if ((depth < 0.0) || (depth > far_depth)) return; /* near and far planes */
+
+  index = (iy - bb->first_row) * output_width + ix;
+  if (depth >= bb->depth[index]) return;
+  bb->depth[index] = depth;
+
+  if (fog != 0.0) {
+    f = (fog - depth) / fog;
+    if (f < 0.0) f = 0.0;
+    if (f > 1.0) f = 1.0;
+    r = f * r + (1.0 - f) * background[0];
+    g = f * g + (1.0 - f) * background[1];
+    b = f * b + (1.0 - f) * background[2];
+  }
+
+  dest = bb->colour + 3 * index;
+  if (blend) {
+    dest[0] = alpha * r + (1.0 - alpha) * dest[0];
+    dest[1] = alpha * g + (1.0 - alpha) * dest[1];
+    dest[2] = alpha * b + (1.0 - alpha) * dest[2];
+  } else {
+    dest[0] = r;
+    dest[1] = g;
+    dest[2] = b;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+raster_triangle (band_buffer *bb, triangle *t, double jx, double jy,
+		 boolean blend)
+     /*
+       Edge function scan conversion with pixel centre sampling and
+       the top-left fill rule, so that shared edges are drawn once.
+     */
+{
+  int vslot, e1, e2, ix, iy, xlo, xhi, ylo, yhi;
+  double x[3], y[3], area, sign, px, py;
+  double dx[3], dy[3], edge[3], start[3], w[3], depth;
+  boolean topleft[3];
+  float (*c)[3];
+
+  for (vslot = 0; vslot < 3; vslot++) {
+    x[vslot] = t->v[vslot][0] + jx;
+    y[vslot] = t->v[vslot][1] + jy;
+  }
+
+  area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+  if (area == 0.0) return;
+  if (area > 0.0) {		/* counter-clockwise is front */
+    c = t->c;
+    sign = 1.0;
+  } else {
+    if (! materials[t->material].two_sided) return; /* culled */
+    c = t->n;
+    sign = -1.0;
+  }
+
+  xlo = (int) floor (x[0]);
+  xhi = (int) ceil (x[0]);
+  ylo = (int) floor (y[0]);
+  yhi = (int) ceil (y[0]);
+  for (vslot = 1; vslot < 3; vslot++) {
+    if (x[vslot] < xlo) xlo = (int) floor (x[vslot]);
+    if (x[vslot] > xhi) xhi = (int) ceil (x[vslot]);
+    if (y[vslot] < ylo) ylo = (int) floor (y[vslot]);
+    if (y[vslot] > yhi) yhi = (int) ceil (y[vslot]);
+  }
+  if (xlo < 0) xlo = 0;
+  if (xhi > output_width) xhi = output_width;
+  if (ylo < bb->first_row) ylo = bb->first_row;
+  if (yhi > bb->first_row + bb->rows) yhi = bb->first_row + bb->rows;
+  if ((xlo >= xhi) || (ylo >= yhi)) return;
+
+  for (vslot = 0; vslot < 3; vslot++) { /* edge opposite each vertex */
+    e1 = (vslot + 1) % 3;
+    e2 = (vslot + 2) % 3;
+    dx[vslot] = sign * (x[e2] - x[e1]);
+    dy[vslot] = sign * (y[e2] - y[e1]);
+    topleft[vslot] = (dy[vslot] < 0.0) ||
+                     ((dy[vslot] == 0.0) && (dx[vslot] < 0.0));
+    start[vslot] = dx[vslot] * ((double) ylo + 0.5 - y[e1]) -
+                   dy[vslot] * ((double) xlo + 0.5 - x[e1]);
+  }
+  area *= sign;
+
+  for (iy = ylo; iy < yhi; iy++) {
+    py = (double) (iy - ylo);
+    for (vslot = 0; vslot < 3; vslot++)
+      edge[vslot] = start[vslot] + dx[vslot] * py;
+
+    for (ix = xlo; ix < xhi; ix++) {
+      px = (double) (ix - xlo);
+      for (vslot = 0; vslot < 3; vslot++) {
+	w[vslot] = edge[vslot] - dy[vslot] * px;
+	if ((w[vslot] < 0.0) || ((w[vslot] == 0.0) && ! topleft[vslot]))
+	  break;
+      }
+      if (vslot < 3) continue;
+
+      w[0] /= area;
+      w[1] /= area;
+      w[2] /= area;
+      depth = w[0] * t->v[0][2] + w[1] * t->v[1][2] + w[2] * t->v[2][2];
+      fragment (bb, ix, iy, depth,
+		w[0] * c[0][0] + w[1] * c[1][0] + w[2] * c[2][0],
+		w[0] * c[0][1] + w[1] * c[1][1] + w[2] * c[2][1],
+		w[0] * c[0][2] + w[1] * c[1][2] + w[2] * c[2][2],
+		t->alpha, blend);
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+raster_line (band_buffer *bb, line *l, double jx, double jy, boolean blend)
+     /*
+       Aliased wide lines and points as in OpenGL: a line is drawn as
+       a span of 'width' pixels across its major axis at each pixel
+       step, and a point as a square of 'width' pixels.
+     */
+{
+  int width, step, steps, ix, iy, slot, first, last, offset;
+  double x1, y1, x2, y2, t, x, y, z;
+  float *c1, *c2;
+  boolean xmajor;
+
+  width = (int) floor (l->width + 0.5);
+  if (width < 1) width = 1;
+  offset = (width - 1) / 2;
+
+  x1 = l->v[0][0] + jx;
+  y1 = l->v[0][1] + jy;
+  x2 = l->v[1][0] + jx;
+  y2 = l->v[1][1] + jy;
+  c1 = l->c[0];
+  c2 = l->c[1];
+
+  first = bb->first_row;
+  last = bb->first_row + bb->rows;
+  if ((y1 < first - width && y2 < first - width) ||
+      (y1 > last + width && y2 > last + width)) return;
+
+  if (l->point) {
+    ix = (int) floor (x1 - 0.5 * width + 0.5);
+    iy = (int) floor (y1 - 0.5 * width + 0.5);
+    for (y = iy; y < iy + width; y++) {
+      if ((y < first) || (y >= last)) continue;
+      for (x = ix; x < ix + width; x++) {
+	if ((x < 0) || (x >= output_width)) continue;
+	fragment (bb, (int) x, (int) y, l->v[0][2],
+		  c1[0], c1[1], c1[2], l->alpha, blend);
+      }
+    }
+    return;
+  }
+
+  xmajor = fabs (x2 - x1) >= fabs (y2 - y1);
+  if (xmajor) {
+    if (x2 == x1) return;
+    step = (int) ceil (x1 - 0.5);
+    steps = (int) ceil (x2 - 0.5);
+  } else {
+    step = (int) ceil (y1 - 0.5);
+    steps = (int) ceil (y2 - 0.5);
+  }
+  if (steps < step) {		/* walk either way; ends half-open */
+    slot = step;
+    step = steps + 1;
+    steps = slot + 1;
+  }
+
+  for (slot = 0; step < steps; step++, slot++) {
+    if (l->stipple && !((0xAAAA >> ((slot / l->stipple) % 16)) & 1)) continue;
+    if (xmajor) {
+      t = ((double) step + 0.5 - x1) / (x2 - x1);
+      x = step;
+      y = floor (y1 + t * (y2 - y1)) - offset;
+    } else {
+      t = ((double) step + 0.5 - y1) / (y2 - y1);
+      x = floor (x1 + t * (x2 - x1)) - offset;
+      y = step;
+    }
+    if (t < 0.0) t = 0.0;
+    if (t > 1.0) t = 1.0;
+    z = l->v[0][2] + t * (l->v[1][2] - l->v[0][2]);
+
+    for (ix = 0; ix < width; ix++) {
+      if (xmajor) {
+	iy = (int) y + ix;
+	if ((step < 0) || (step >= output_width)) break;
+	if ((iy < first) || (iy >= last)) continue;
+	fragment (bb, step, iy, z,
+		  c1[0] + t * (c2[0] - c1[0]),
+		  c1[1] + t * (c2[1] - c1[1]),
+		  c1[2] + t * (c2[2] - c1[2]), l->alpha, blend);
+      } else {
+	iy = step;
+	if ((iy < first) || (iy >= last)) break;
+	if (((int) x + ix < 0) || ((int) x + ix >= output_width)) continue;
+	fragment (bb, (int) x + ix, iy, z,
+		  c1[0] + t * (c2[0] - c1[0]),
+		  c1[1] + t * (c2[1] - c1[1]),
+		  c1[2] + t * (c2[2] - c1[2]), l->alpha, blend);
+      }
+    }
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+jitter (int sample, int samples, double *jx, double *jy)
+     /* Halton sequence in bases 2 and 3, centred on the pixel. */
+{
+  int i;
+  double f;
+
+  assert (jx);
+  assert (jy);
+
+  if (samples <= 1) {
+    *jx = *jy = 0.0;
+    return;
+  }
+
+  *jx = 0.0;
+  for (i = sample + 1, f = 0.5; i > 0; i /= 2, f /= 2.0) *jx += f * (i % 2);
+  *jy = 0.0;
+  for (i = sample + 1, f = 1.0/3.0; i > 0; i /= 3, f /= 3.0) *jy += f * (i % 3);
+  *jx -= 0.5;
+  *jy -= 0.5;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+render_band (band_buffer *bb, int band)
+{
+  int sample, samples, slot, pixel, count, pass;
+  double jx, jy;
+  triangle *t;
+  unsigned char *dest;
+  float *src;
+
+  bb->first_row = band * BAND_ROWS;
+  bb->rows = pixels_first + pixels_rows - bb->first_row;
+  if (bb->rows > BAND_ROWS) bb->rows = BAND_ROWS;
+  count = bb->rows * output_width;
+
+  samples = (accum > 1) ? accum : 1;
+  for (sample = 0; sample < samples; sample++) {
+    for (pixel = 0; pixel < count; pixel++) {
+      bb->colour[3 * pixel] = background[0];
+      bb->colour[3 * pixel + 1] = background[1];
+      bb->colour[3 * pixel + 2] = background[2];
+      bb->depth[pixel] = far_depth + 1.0;
+    }
+    jitter (sample, samples, &jx, &jy);
+
+    for (pass = 0; pass < 2; pass++) { /* opaque first, then transparent */
+      for (slot = bin_start[band]; slot < bin_start[band + 1]; slot++) {
+	t = triangles + bin_triangles[slot];
+	if ((t->alpha < 1.0) == pass) raster_triangle (bb, t, jx, jy, pass);
+      }
+      for (slot = 0; slot < line_count; slot++) {
+	if ((lines[slot].alpha < 1.0) == pass)
+	  raster_line (bb, lines + slot, jx, jy, pass);
+      }
+    }
+
+    if (samples > 1) {
+      if (sample == 0) {
+	for (pixel = 0; pixel < 3 * count; pixel++)
+	  bb->accum[pixel] = bb->colour[pixel] / samples;
+      } else {
+	for (pixel = 0; pixel < 3 * count; pixel++)
+	  bb->accum[pixel] += bb->colour[pixel] / samples;
+      }
+    }
+  }
+
+  src = (samples > 1) ? bb->accum : bb->colour;
+  dest = pixels + 3 * (bb->first_row - pixels_first) * output_width;
+  for (pixel = 0; pixel < 3 * count; pixel++) {
+    dest[pixel] = (unsigned char) floor (255.0 * src[pixel] + 0.5);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+render_bands (thread_jobs *tj)
+{
+  band_buffer bb;
+  int band;
+
+  bb.colour = malloc (3 * BAND_ROWS * output_width * sizeof (float));
+  bb.depth = malloc (BAND_ROWS * output_width * sizeof (float));
+  bb.accum = (accum > 1) ?
+             malloc (3 * BAND_ROWS * output_width * sizeof (float)) : NULL;
+
+  while ((band = thread_jobs_take (tj)) >= 0)
+    render_band (&bb, first_band + band);
+
+  free (bb.colour);
+  free (bb.depth);
+  if (bb.accum) free (bb.accum);
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_transform (double matrix[4][4])
+     /*
+       Transform the geometry of the plot, before rendering it. The
+       lights are not transformed; they stay fixed to the viewer.
+     */
+{
+  int slot, vslot;
+  triangle *t;
+
+  for (slot = 0; slot < triangle_count; slot++) {
+    t = triangles + slot;
+    for (vslot = 0; vslot < 3; vslot++) {
+      matrix3_transform_float (t->v[vslot], matrix);
+      matrix3_rotate_float (t->n[vslot], matrix);
+    }
+  }
+
+  for (slot = 0; slot < line_count; slot++) {
+    matrix3_transform_float (lines[slot].v[0], matrix);
+    matrix3_transform_float (lines[slot].v[1], matrix);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_render (void)
+{
+  prepare();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_render_rows (int first, int rows)
+     /* The first row must be at the start of a band. */
+{
+  thread_jobs tj;
+  int bands;
+
+  assert (first >= 0);
+  assert (first % BAND_ROWS == 0);
+  assert (rows > 0);
+  assert (first + rows <= output_height);
+  assert (bin_start);
+
+  if (pixels && (rows > pixels_rows)) {
+    free (pixels);
+    pixels = NULL;
+  }
+  if (pixels == NULL)
+    pixels = malloc (3 * output_width * rows * sizeof (unsigned char));
+  pixels_first = first;
+  pixels_rows = rows;
+
+  first_band = first / BAND_ROWS;
+  bands = (first + rows + BAND_ROWS - 1) / BAND_ROWS - first_band;
+  thread_jobs_run (&tj, bands, render_bands, NULL);
+}
+
+
+/*------------------------------------------------------------*/
+unsigned char *
+swr_row (int row)
+     /* Rows are counted from the bottom, as for glReadPixels. */
+{
+  assert (row >= pixels_first);
+  assert (row < pixels_first + pixels_rows);
+  assert (pixels);
+
+  return pixels + 3 * (row - pixels_first) * output_width;
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_close (void)
+{
+  free (pixels);
+  pixels = NULL;
+  free (bin_start);
+  bin_start = NULL;
+  free (bin_triangles);
+  bin_triangles = NULL;
+
+  free (materials);
+  materials = NULL;
+  free (triangles);
+  triangles = NULL;
+  free (lines);
+  lines = NULL;
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_set_area (void)
+{
+  if (message_mode) fprintf (stderr, "ignoring 'area' for image output\n");
+  clear_dstack();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_set_background (void)
+{
+  colour_copy_to_rgb (&background_colour, &given_colour);
+}
+
+
+/*------------------------------------------------------------*/
+static light *
+new_light (int type, char *name)
+{
+  light *l;
+  colour rgb;
+
+  assert (name);
+
+  if (light_count + 1 >= MAX_LIGHTS) {
+    if (message_mode)
+      fprintf (stderr,
+	       "ignoring '%s'; maximum number of lights reached\n", name);
+    clear_dstack();
+    return NULL;
+  }
+
+  l = lights + light_count++;
+  memset (l, 0, sizeof (light));
+  l->type = type;
+
+  colour_copy_to_rgb (&rgb, &(current_state->lightcolour));
+  l->diffuse[0] = current_state->lightintensity * rgb.x;
+  l->diffuse[1] = current_state->lightintensity * rgb.y;
+  l->diffuse[2] = current_state->lightintensity * rgb.z;
+  l->ambient[0] = current_state->lightambientintensity * rgb.x;
+  l->ambient[1] = current_state->lightambientintensity * rgb.y;
+  l->ambient[2] = current_state->lightambientintensity * rgb.z;
+  copy3 (l->attenuation, &(current_state->lightattenuation));
+
+  return l;
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_directionallight (void)
+{
+  light *l;
+
+  assert ((dstack_size == 3) || (dstack_size == 6));
+
+  l = new_light (SWR_DIRECTIONALLIGHT, "directionallight");
+  if (l == NULL) return;
+
+  if (dstack_size == 3) {
+    l->position[0] = - dstack[0];
+    l->position[1] = - dstack[1];
+    l->position[2] = - dstack[2];
+  } else {
+    l->position[0] = dstack[0] - dstack[3];
+    l->position[1] = dstack[1] - dstack[4];
+    l->position[2] = dstack[2] - dstack[5];
+  }
+  clear_dstack();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_pointlight (void)
+{
+  light *l;
+
+  assert (dstack_size == 3);
+
+  l = new_light (SWR_POINTLIGHT, "pointlight");
+  if (l == NULL) return;
+
+  l->position[0] = dstack[0];
+  l->position[1] = dstack[1];
+  l->position[2] = dstack[2];
+  clear_dstack();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_spotlight (void)
+{
+  light *l;
+  double length;
+
+  assert ((dstack_size == 7) || (dstack_size == 10));
+
+  l = new_light (SWR_SPOTLIGHT, "spotlight");
+  if (l == NULL) return;
+
+  l->position[0] = dstack[0];
+  l->position[1] = dstack[1];
+  l->position[2] = dstack[2];
+
+  if (dstack_size == 7) {
+    l->direction[0] = dstack[3];
+    l->direction[1] = dstack[4];
+    l->direction[2] = dstack[5];
+    l->cutoff = cos (to_radians (dstack[6] / 2.0));
+  } else {
+    l->direction[0] = dstack[6] - dstack[3];
+    l->direction[1] = dstack[7] - dstack[4];
+    l->direction[2] = dstack[8] - dstack[5];
+    l->cutoff = cos (to_radians (dstack[9] / 2.0));
+  }
+  clear_dstack();
+
+  length = sqrt (l->direction[0] * l->direction[0] +
+		 l->direction[1] * l->direction[1] +
+		 l->direction[2] * l->direction[2]);
+  if (length > 0.0) {
+    l->direction[0] /= length;
+    l->direction[1] /= length;
+    l->direction[2] /= length;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+coil_strip (int side, colour *rgb)
+     /* One of the four sides of the coil, between point 'side' and next. */
+{
+  int slot;
+  coil_segment *cs;
+  vector3 *p[4], *n[4];
+
+  assert ((side >= 0) && (side < 4));
+
+  for (slot = 0; slot < coil_segment_count; slot++) {
+    cs = coil_segments + slot;
+    p[0] = &(cs->p1); p[1] = &(cs->p2); p[2] = &(cs->p3); p[3] = &(cs->p4);
+    n[0] = &(cs->n1); n[1] = &(cs->n2); n[2] = &(cs->n3); n[3] = &(cs->n4);
+
+    if (slot == 0) begin (IMM_TRIANGLE_STRIP);
+    if (rgb && colour_unequal (rgb, &(cs->c))) {
+      normal (n[side]);
+      vertex (p[side]);
+      normal (n[(side + 1) % 4]);
+      vertex (p[(side + 1) % 4]);
+      end();
+      begin (IMM_TRIANGLE_STRIP);
+      *rgb = cs->c;
+      set_colour_property (rgb);
+    }
+    normal (n[side]);
+    vertex (p[side]);
+    normal (n[(side + 1) % 4]);
+    vertex (p[(side + 1) % 4]);
+  }
+  end();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_coil (void)
+{
+  int slot;
+  vector3 norm;
+  coil_segment *cs;
+  colour rgb;
+
+  set_render_state (TRUE, FALSE, FALSE);
+  set_material_properties();
+
+  if (current_state->colourparts) {
+    for (slot = 0; slot < coil_segment_count; slot++)
+      colour_to_rgb (&(coil_segments[slot].c));
+    rgb = coil_segments[0].c;
+    set_colour_property (&rgb);
+  } else {
+    set_colour_property (&(current_state->planecolour));
+  }
+
+  begin (IMM_QUADS);
+  v3_difference (&norm, &(coil_segments[0].p), &(coil_segments[1].p));
+  v3_normalize (&norm);
+  normal (&norm);
+  cs = coil_segments;
+  vertex (&(cs->p4));
+  vertex (&(cs->p3));
+  vertex (&(cs->p2));
+  vertex (&(cs->p1));
+  end();
+
+  for (slot = 0; slot < 4; slot++) {
+    if (current_state->colourparts) {
+      coil_strip (slot, &rgb);
+    } else {
+      coil_strip (slot, NULL);
+    }
+  }
+
+  begin (IMM_QUADS);
+  v3_difference (&norm, &(coil_segments[coil_segment_count-1].p),
+		        &(coil_segments[coil_segment_count-2].p));
+  v3_normalize (&norm);
+  normal (&norm);
+  cs = coil_segments + coil_segment_count - 1;
+  vertex (&(cs->p1));
+  vertex (&(cs->p2));
+  vertex (&(cs->p3));
+  vertex (&(cs->p4));
+  end();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_cylinder (vector3 *v1, vector3 *v2)
+{
+  assert (v1);
+  assert (v2);
+  assert (v3_distance (v1, v2) > 0.0);
+
+  set_render_state (TRUE, FALSE, FALSE);
+  set_colour_property (&(current_state->planecolour));
+  set_material_properties();
+  cylinder_faces (v1, v2, current_state->cylinderradius,
+		  3 * current_state->segments + 5, TRUE);
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_helix (void)
+{
+  int slot;
+  colour rgb;
+  helix_segment *hs;
+
+  set_render_state (TRUE, TRUE, FALSE);
+  set_material_properties();
+
+  if (current_state->colourparts) {
+
+    begin (IMM_TRIANGLE_STRIP);
+    colour_to_rgb (&(helix_segments[0].c));
+    rgb = helix_segments[0].c;
+    set_colour_property (&rgb);
+    for (slot = 0; slot < helix_segment_count; slot++) {
+      hs = helix_segments + slot;
+      colour_to_rgb (&(hs->c));
+      if (colour_unequal (&rgb, &(hs->c))) {
+	normal (&(hs->n));
+	vertex (&(hs->p1));
+	vertex (&(hs->p2));
+	end();
+	begin (IMM_TRIANGLE_STRIP);
+	rgb = hs->c;
+	set_colour_property (&rgb);
+      }
+      normal (&(hs->n));
+      vertex (&(hs->p1));
+      vertex (&(hs->p2));
+    }
+    end();
+
+  } else {			/* not colourparts */
+    set_colour_property (&(current_state->planecolour));
+    set_back_colour (&(current_state->plane2colour));
+
+    begin (IMM_TRIANGLE_STRIP);
+    for (slot = 0; slot < helix_segment_count; slot++) {
+      hs = helix_segments + slot;
+      normal (&(hs->n));
+      vertex (&(hs->p1));
+      vertex (&(hs->p2));
+    }
+    end();
+
+    set_back_colour (NULL);
+  }
+
+  set_render_state (TRUE, FALSE, FALSE);
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_label (vector3 *p, char *label, colour *c)
+{
+  assert (p);
+  assert (label);
+  (void) c;
+
+  label_count++;
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_line (boolean polylines)
+{
+  int slot;
+  line_segment *ls;
+
+  if (line_segment_count < 2) return;
+
+  set_render_state (FALSE, FALSE, TRUE);
+  imm_width = current_state->linewidth;
+  imm_stipple = (current_state->linedash > 0.5) ?
+                (int) (current_state->linedash + 0.5) : 0;
+
+  if (current_state->colourparts) {
+
+    if (polylines) {
+      begin (IMM_LINE_STRIP);
+      set_colour_property (&(line_segments[0].c));
+      vertex (&(line_segments->p));
+      for (slot = 1; slot < line_segment_count; slot++) {
+	ls = line_segments + slot;
+	if (ls->new) {
+	  end();
+	  begin (IMM_LINE_STRIP);
+	}
+	set_colour_property (&(ls->c));
+	vertex (&(ls->p));
+      }
+      end();
+
+    } else {			/* not polylines */
+      begin (IMM_LINES);
+      for (slot = 0; slot < line_segment_count; slot += 2) {
+	ls = line_segments + slot;
+	set_colour_property (&(ls->c));
+	vertex (&(ls->p));
+	ls++;
+	vertex (&(ls->p));
+      }
+      end();
+    }
+
+  } else {			/* not colourparts */
+
+    set_colour_property (&(line_segments[0].c));
+
+    if (polylines) {
+      begin (IMM_LINE_STRIP);
+      vertex (&(line_segments->p));
+      for (slot = 1; slot < line_segment_count; slot++) {
+	ls = line_segments + slot;
+	if (ls->new) {
+	  end();
+	  begin (IMM_LINE_STRIP);
+	}
+	vertex (&(ls->p));
+      }
+      end();
+
+    } else {			/* not polylines */
+      begin (IMM_LINES);
+      for (slot = 0; slot < line_segment_count; slot++) {
+	vertex (&(line_segments[slot].p));
+      }
+      end();
+    }
+  }
+
+  imm_stipple = 0;
+  set_render_state (TRUE, FALSE, FALSE);
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_sphere (at3d *at, double radius)
+{
+  assert (at);
+  assert (radius > 0.0);
+
+  set_render_state (TRUE, FALSE, FALSE);
+  set_colour_property (&(at->colour));
+  set_material_properties();
+  sphere_faces_globe (&(at->xyz), radius, 2 * current_state->segments);
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c)
+{
+  assert (v1);
+  assert (v2);
+  assert (v3_distance (v1, v2) > 0.0);
+  (void) r1;			/* the cylinder is drawn whole */
+  (void) r2;
+
+  set_render_state (TRUE, FALSE, FALSE);
+  if (c) {
+    set_colour_property (c);
+  } else {
+    set_colour_property (&(current_state->planecolour));
+  }
+  set_material_properties();
+  cylinder_faces (v1, v2, current_state->stickradius,
+		  current_state->segments + 5, FALSE);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+strand_face (int face, colour *rgb)
+     /*
+       Top (face 0: points 1 and 4, normal 1) or bottom (face 1:
+       points 3 and 2, normal 3) face of the strand body.
+     */
+{
+  int slot;
+  strand_segment *ss;
+  vector3 *pa, *pb;
+
+  begin (IMM_TRIANGLE_STRIP);
+  for (slot = 0; slot < strand_segment_count - 3; slot++) {
+    ss = strand_segments + slot;
+    if (face == 0) {
+      normal (&(ss->n1));
+      pa = &(ss->p1);
+      pb = &(ss->p4);
+    } else {
+      normal (&(ss->n3));
+      pa = &(ss->p3);
+      pb = &(ss->p2);
+    }
+    vertex (pa);
+    vertex (pb);
+    if (rgb) {
+      if (face == 0) colour_to_rgb (&(ss->c));
+      if (colour_unequal (rgb, &(ss->c))) {
+	end();
+	begin (IMM_TRIANGLE_STRIP);
+	*rgb = ss->c;
+	set_colour_property (rgb);
+	vertex (pa);
+	vertex (pb);
+      }
+    }
+  }
+  end();
+}
+
+
+/*------------------------------------------------------------*/
+static void
+strand_side (int side, colour *rgb)
+     /* Side 0: points 2 and 1, normal 2; side 1: points 4 and 3, normal 4. */
+{
+  int slot;
+  strand_segment *ss;
+  vector3 *pa, *pb;
+
+  begin (IMM_TRIANGLE_STRIP);
+  for (slot = 0; slot < strand_segment_count - 3; slot++) {
+    ss = strand_segments + slot;
+    if (side == 0) {
+      normal (&(ss->n2));
+      pa = &(ss->p2);
+      pb = &(ss->p1);
+    } else {
+      normal (&(ss->n4));
+      pa = &(ss->p4);
+      pb = &(ss->p3);
+    }
+    vertex (pa);
+    vertex (pb);
+    if (rgb && colour_unequal (rgb, &(ss->c))) {
+      end();
+      begin (IMM_TRIANGLE_STRIP);
+      *rgb = ss->c;
+      set_colour_property (rgb);
+      vertex (pa);
+      vertex (pb);
+    }
+  }
+  end();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_strand (void)
+     /* Same faces as 'ogl_strand'. */
+{
+  colour rgb;
+  strand_segment *ss, *ss2;
+  boolean thickness = current_state->strandthickness >= 0.01;
+  boolean colourparts = current_state->colourparts;
+  vector3 dir1, dir2, norm, norm2;
+
+  set_render_state (TRUE, !thickness, FALSE);
+  set_material_properties();
+
+  if (colourparts) {
+    colour_to_rgb (&(strand_segments[0].c));
+    rgb = strand_segments[0].c;
+    set_colour_property (&rgb);
+    strand_face (0, &rgb);
+    if (thickness) {
+      rgb = strand_segments[0].c;
+      set_colour_property (&rgb);
+      strand_face (1, &rgb);
+    }
+  } else {
+    set_colour_property (&(current_state->planecolour));
+    strand_face (0, NULL);
+    if (thickness) strand_face (1, NULL);
+  }
+
+  ss = strand_segments + strand_segment_count - 3; /* arrow face 1, high */
+  begin (IMM_TRIANGLE_STRIP);
+  normal (&(ss->n1));
+  vertex (&(ss->p1));
+  vertex (&(ss[-1].p1));
+  normal (&(ss[1].n1));
+  vertex (&(ss[1].p1));
+  normal (&(ss[-1].n1));
+  vertex (&(ss[-1].p4));
+  normal (&(ss[1].n1));
+  vertex (&(ss[1].p4));
+  normal (&(ss->n1));
+  vertex (&(ss->p4));
+  end();
+
+  if (thickness) {		/* arrow face 1, low */
+    begin (IMM_TRIANGLE_STRIP);
+    normal (&(ss->n3));
+    vertex (&(ss->p3));
+    vertex (&(ss[-1].p3));
+    normal (&(ss[1].n3));
+    vertex (&(ss[1].p3));
+    normal (&(ss[-1].n3));
+    vertex (&(ss[-1].p2));
+    normal (&(ss[1].n3));
+    vertex (&(ss[1].p2));
+    normal (&(ss->n3));
+    vertex (&(ss->p2));
+    end();
+  }
+
+  if (colourparts && colour_unequal (&rgb, &(ss->c))) {
+    rgb = ss->c;
+    set_colour_property (&rgb);
+  }
+
+  ss = strand_segments + strand_segment_count - 2; /* arrow face 2, high */
+  begin (IMM_TRIANGLES);
+  normal (&(ss->n1));
+  vertex (&(ss->p1));
+  vertex (&(ss->p4));
+  normal (&(ss[1].n1));
+  vertex (&(ss[1].p1));
+  end();
+
+  if (thickness) {		/* arrow face 2, low */
+    begin (IMM_TRIANGLES);
+    normal (&(ss->n3));
+    vertex (&(ss->p3));
+    vertex (&(ss->p2));
+    normal (&(ss[1].n2));
+    vertex (&(ss[1].p2));
+    end();
+  }
+
+  if (thickness) {
+    ss = strand_segments;	/* strand base normal */
+    v3_difference (&dir1, &(ss->p3), &(ss->p2));
+    v3_difference (&dir2, &(ss->p1), &(ss->p2));
+    v3_cross_product (&norm, &dir1, &dir2);
+    v3_normalize (&norm);
+
+    if (colourparts) {
+      rgb = strand_segments[0].c;
+      set_colour_property (&rgb);
+    } else {
+      set_colour_property (&(current_state->plane2colour));
+    }
+
+    begin (IMM_TRIANGLE_STRIP);	/* strand base */
+    normal (&norm);
+    vertex (&(ss->p1));
+    vertex (&(ss->p2));
+    vertex (&(ss->p4));
+    vertex (&(ss->p3));
+    end();
+
+    if (colourparts) {
+      strand_side (0, &rgb);
+      rgb = strand_segments[0].c;
+      set_colour_property (&rgb);
+      strand_side (1, &rgb);
+    } else {
+      strand_side (0, NULL);
+      strand_side (1, NULL);
+    }
+				/* arrow base */
+    ss = strand_segments + strand_segment_count - 3;
+    ss2 = strand_segments + strand_segment_count - 4;
+    v3_difference (&dir1, &(ss->p3), &(ss->p1));
+    v3_difference (&dir2, &(ss->p4), &(ss->p2));
+    v3_cross_product (&norm, &dir1, &dir2);
+    v3_normalize (&norm);
+
+    begin (IMM_TRIANGLES);
+    normal (&norm);
+    vertex (&(ss->p1));
+    vertex (&(ss->p2));
+    vertex (&(ss2->p1));
+    vertex (&(ss2->p1));
+    vertex (&(ss->p2));
+    vertex (&(ss2->p2));
+    vertex (&(ss->p3));
+    vertex (&(ss->p4));
+    vertex (&(ss2->p3));
+    vertex (&(ss2->p3));
+    vertex (&(ss->p4));
+    vertex (&(ss2->p4));
+    end();
+				/* arrow first part 1 */
+    ss = strand_segments + strand_segment_count - 2;
+    ss2 = ss + 1;
+    v3_difference (&dir1, &(ss2->p1), &(ss->p2));
+    v3_difference (&dir2, &(ss2->p2), &(ss->p1));
+    v3_cross_product (&norm2, &dir1, &dir2);
+    v3_normalize (&norm2);
+
+    ss = strand_segments + strand_segment_count - 3;
+    ss2 = ss + 1;
+    v3_difference (&dir1, &(ss2->p1), &(ss->p2));
+    v3_difference (&dir2, &(ss2->p2), &(ss->p1));
+    v3_cross_product (&norm, &dir1, &dir2);
+    v3_normalize (&norm);
+
+    begin (IMM_TRIANGLE_STRIP);
+    normal (&norm);
+    vertex (&(ss->p2));
+    vertex (&(ss->p1));
+    normal (&norm2);
+    vertex (&(ss2->p2));
+    vertex (&(ss2->p1));
+    end();
+				/* arrow last part 1 */
+    ss = strand_segments + strand_segment_count - 2;
+    ss2 = ss + 1;
+    if (colourparts && colour_unequal (&rgb, &(ss->c))) {
+      rgb = ss->c;
+      set_colour_property (&rgb);
+    }
+    begin (IMM_TRIANGLE_STRIP);
+    normal (&norm2);
+    vertex (&(ss->p2));
+    vertex (&(ss->p1));
+    vertex (&(ss2->p2));
+    vertex (&(ss2->p1));
+    end();
+				/* arrow first part 2 */
+    v3_difference (&dir1, &(ss2->p2), &(ss->p4));
+    v3_difference (&dir2, &(ss2->p1), &(ss->p3));
+    v3_cross_product (&norm2, &dir1, &dir2);
+    v3_normalize (&norm2);
+
+    ss = strand_segments + strand_segment_count - 3;
+    ss2 = ss + 1;
+    v3_difference (&dir1, &(ss2->p3), &(ss->p4));
+    v3_difference (&dir2, &(ss2->p4), &(ss->p3));
+    v3_cross_product (&norm, &dir1, &dir2);
+    v3_normalize (&norm);
+
+    if (colourparts && colour_unequal (&rgb, &(ss->c))) {
+      rgb = ss->c;
+      set_colour_property (&rgb);
+    }
+    begin (IMM_TRIANGLE_STRIP);
+    normal (&norm);
+    vertex (&(ss->p4));
+    vertex (&(ss->p3));
+    normal (&norm2);
+    vertex (&(ss2->p4));
+    vertex (&(ss2->p3));
+    end();
+				/* arrow last part 2 */
+    ss = strand_segments + strand_segment_count - 2;
+    ss2 = ss + 1;
+    if (colourparts && colour_unequal (&rgb, &(ss->c))) {
+      rgb = ss->c;
+      set_colour_property (&rgb);
+    }
+    begin (IMM_TRIANGLE_STRIP);
+    normal (&norm2);
+    vertex (&(ss->p4));
+    vertex (&(ss->p3));
+    vertex (&(ss2->p1));
+    vertex (&(ss2->p2));
+    end();
+  }
+
+  set_render_state (TRUE, FALSE, FALSE);
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_start_object (void)
+{
+  set_render_state (TRUE, TRUE, FALSE);
+  set_material_properties();
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_object (int code, vector3 *triplets, int count)
+     /* Same primitives as 'ogl_object'. */
+{
+  int slot;
+  vector3 *v;
+  vector3 norm;
+
+  assert (triplets);
+  assert (count > 0);
+
+  switch (code) {
+
+  case OBJ_POINTS:
+  case OBJ_POINTS_COLOURS:
+    set_render_state (FALSE, TRUE, TRUE);
+    imm_width = current_state->linewidth;
+    set_colour_property (&(current_state->linecolour));
+    begin (IMM_POINTS);
+    if (code == OBJ_POINTS) {
+      for (slot = 0; slot < count; slot++) vertex (triplets + slot);
+    } else {
+      for (slot = 0; slot < count; slot += 2) {
+	set_rgb_property (triplets + slot + 1);
+	vertex (triplets + slot);
+      }
+    }
+    end();
+    break;
+
+  case OBJ_LINES:
+  case OBJ_LINES_COLOURS:
+    set_render_state (FALSE, TRUE, code == OBJ_LINES);
+    imm_width = current_state->linewidth;
+    imm_stipple = (current_state->linedash > 0.5) ?
+                  (int) (current_state->linedash + 0.5) : 0;
+    set_colour_property (&(current_state->linecolour));
+    begin (IMM_LINE_STRIP);
+    if (code == OBJ_LINES) {
+      for (slot = 0; slot < count; slot++) vertex (triplets + slot);
+    } else {
+      for (slot = 0; slot < count; slot += 2) {
+	set_rgb_property (triplets + slot + 1);
+	vertex (triplets + slot);
+      }
+    }
+    end();
+    imm_stipple = 0;
+    break;
+
+  case OBJ_TRIANGLES:
+    set_render_state (TRUE, TRUE, TRUE);
+    set_colour_property (&(current_state->planecolour));
+    begin (IMM_TRIANGLES);
+    for (slot = 0; slot < count; slot += 3) {
+      v = triplets + slot;
+      v3_triangle_normal (&norm, v, v + 1, v + 2);
+      normal (&norm);
+      vertex (v);
+      vertex (v + 1);
+      vertex (v + 2);
+    }
+    end();
+    break;
+
+  case OBJ_TRIANGLES_COLOURS:
+    set_render_state (TRUE, TRUE, FALSE);
+    begin (IMM_TRIANGLES);
+    for (slot = 0; slot < count; slot += 6) {
+      v = triplets + slot;
+      v3_triangle_normal (&norm, v, v + 2, v + 4);
+      normal (&norm);
+      set_rgb_property (v + 1);
+      vertex (v);
+      set_rgb_property (v + 3);
+      vertex (v + 2);
+      set_rgb_property (v + 5);
+      vertex (v + 4);
+    }
+    end();
+    break;
+
+  case OBJ_TRIANGLES_NORMALS:
+    set_render_state (TRUE, TRUE, FALSE);
+    set_colour_property (&(current_state->planecolour));
+    begin (IMM_TRIANGLES);
+    for (slot = 0; slot < count; slot += 2) {
+      normal (triplets + slot + 1);
+      vertex (triplets + slot);
+    }
+    end();
+    break;
+
+  case OBJ_TRIANGLES_NORMALS_COLOURS:
+    set_render_state (TRUE, TRUE, FALSE);
+    begin (IMM_TRIANGLES);
+    for (slot = 0; slot < count; slot += 3) {
+      set_rgb_property (triplets + slot + 2);
+      normal (triplets + slot + 1);
+      vertex (triplets + slot);
+    }
+    end();
+    break;
+
+  case OBJ_STRIP:
+    set_render_state (TRUE, TRUE, TRUE);
+    set_colour_property (&(current_state->planecolour));
+    begin (IMM_TRIANGLE_STRIP);
+    v = triplets;
+    v3_triangle_normal (&norm, v, v + 1, v + 2);
+    normal (&norm);
+    vertex (v);
+    vertex (v + 1);
+    vertex (v + 2);
+    for (slot = 3; slot < count; slot++) {
+      v = triplets + slot;
+      v3_triangle_normal (&norm, v - 2, v - 1, v);
+      if (slot % 2) v3_reverse (&norm);
+      normal (&norm);
+      vertex (v);
+    }
+    end();
+    break;
+
+  case OBJ_STRIP_COLOURS:
+    set_render_state (TRUE, TRUE, FALSE);
+    begin (IMM_TRIANGLE_STRIP);
+    v = triplets;
+    v3_triangle_normal (&norm, v, v + 2, v + 4);
+    normal (&norm);
+    set_rgb_property (v + 1);
+    vertex (v);
+    set_rgb_property (v + 3);
+    vertex (v + 2);
+    set_rgb_property (v + 5);
+    vertex (v + 4);
+    for (slot = 6; slot < count; slot += 2) {
+      v = triplets + slot;
+      v3_triangle_normal (&norm, v - 4, v - 2, v);
+      if (slot % 4) v3_reverse (&norm);
+      normal (&norm);
+      set_rgb_property (v + 1);
+      vertex (v);
+    }
+    end();
+    break;
+
+  case OBJ_STRIP_NORMALS:
+    set_render_state (TRUE, TRUE, FALSE);
+    set_colour_property (&(current_state->planecolour));
+    begin (IMM_TRIANGLE_STRIP);
+    for (slot = 0; slot < count; slot += 2) {
+      normal (triplets + slot + 1);
+      vertex (triplets + slot);
+    }
+    end();
+    break;
+
+  case OBJ_STRIP_NORMALS_COLOURS:
+    set_render_state (TRUE, TRUE, FALSE);
+    begin (IMM_TRIANGLE_STRIP);
+    for (slot = 0; slot < count; slot += 3) {
+      set_rgb_property (triplets + slot + 2);
+      normal (triplets + slot + 1);
+      vertex (triplets + slot);
+    }
+    end();
+    break;
+  }
+}
+
+
+/*------------------------------------------------------------*/
+void
+swr_finish_object (void)
+{
+  set_render_state (TRUE, FALSE, FALSE);
+}
@@ -0,0 +1,49 @@
+/* swrender.h
+
+   MolScript v2.1.2
+
+   Software rendering for image file output; requires neither OpenGL
+   nor an X display.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  transform of the geometry for animation frames
+*/
+
+#ifndef SWRENDER_H
+#define SWRENDER_H 1
+
+#include "col.h"
+#include "coord.h"
+
+void swr_set (void);
+void swr_set_accum (int number);
+
+void swr_start_plot (void);
+void swr_finish_plot (void);
+void swr_transform (double matrix[4][4]);
+void swr_render (void);
+void swr_render_rows (int first, int rows);
+unsigned char *swr_row (int row);
+void swr_close (void);
+
+void swr_set_area (void);
+void swr_set_background (void);
+void swr_directionallight (void);
+void swr_pointlight (void);
+void swr_spotlight (void);
+
+void swr_coil (void);
+void swr_cylinder (vector3 *v1, vector3 *v2);
+void swr_helix (void);
+void swr_label (vector3 *p, char *label, colour *c);
+void swr_line (boolean polylines);
+void swr_sphere (at3d *at, double radius);
+void swr_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c);
+void swr_strand (void);
+
+void swr_start_object (void);
+void swr_object (int code, vector3 *triplets, int count);
+void swr_finish_object (void);
+
+#endif
@@ -0,0 +1,720 @@
+/* trajectory.c
+
+   MolScript v2.1.2
+
+   Trajectory input: DCD (CHARMM, NAMD, X-PLOR) and XTC (GROMACS) files.
+
+   A trajectory holds only coordinates; the atoms are given by a
+   topology, which is the molecule read earlier under the same name
+   from a PDB file. The frames are read once into a compact store, one
+   packed array of float coordinates per frame, and the current frame
+   is set into the atoms of the topology when the trajectory is read
+   by the input script. The store is kept for later frames, so that a
+   trajectory file is decoded only once, unless it is changed. Only
+   the frames to be rendered are decoded and stored; the others are
+   skipped over in the file, and the file is not read beyond the last.
+
+   With the option '-trajectory', the input script is rendered for
+   each frame in the given range, into an output file numbered for the
+   frame. Otherwise the first frame is used.
+
+   The XTC coordinate decompression follows the 'xdrfile' library of
+   the GROMACS distribution.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  frame file names numbered as for the image plots
+    18-Oct-2026  only the frames in the range decoded; sizes in size_t
+*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "clib/str_utils.h"
+
+#include "trajectory.h"
+#include "global.h"
+#include "coord.h"
+
+#ifdef IMAGE_SUPPORT
+#include "image.h"
+#endif
+
+
+/*============================================================*/
+#define XTC_MAGIC 1995
+#define XTC_FIRSTIDX 9
+#define NM_TO_ANGSTROM 10.0
+
+typedef struct s_trajectory trajectory;
+
+struct s_trajectory {
+  char *filename;
+  time_t mtime;
+  int atom_count;
+  int frame_count, frame_alloc;
+  float *xyz;			/* x, y, z of each atom, for each kept frame */
+  trajectory *next;
+};
+
+typedef struct {
+  unsigned char *data;
+  int length;
+  int count;
+  unsigned int lastbits;
+  unsigned int lastbyte;
+} bit_reader;
+
+static trajectory *trajectories = NULL;
+static int current_frame = 1;
+static int first_frame = 1, last_frame = 1, frame_step = 1;
+
+static const int magicints[] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 10, 12, 16, 20, 25, 32, 40, 50, 64,
+  80, 101, 128, 161, 203, 256, 322, 406, 512, 645, 812, 1024, 1290,
+  1625, 2048, 2580, 3250, 4096, 5060, 6501, 8192, 10321, 13003,
+  16384, 20642, 26007, 32768, 41285, 52015, 65536, 82570, 104031,
+  131072, 165140, 208063, 262144, 330280, 416127, 524287, 660561,
+  832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021,
+  4194304, 5284491, 6658042, 8388607, 10568983, 13316085, 16777216 };
+
+#define XTC_LASTIDX ((int) (sizeof (magicints) / sizeof (*magicints)))
+
+
+/*------------------------------------------------------------*/
+static int
+wanted_frame (int frame)
+     /*
+       Is the frame, counted from 1, one of those to be rendered? A
+       negative value once past the last of them.
+     */
+{
+  if (frame > last_frame) return -1;
+  return (frame >= first_frame) && ((frame - first_frame) % frame_step == 0);
+}
+
+
+/*------------------------------------------------------------*/
+static float *
+new_frame (trajectory *tr)
+{
+  size_t frame_size;
+
+  assert (tr);
+  assert (tr->atom_count > 0);
+
+  frame_size = 3 * (size_t) tr->atom_count;
+  if (tr->frame_count >= tr->frame_alloc) {
+    tr->frame_alloc = (tr->frame_alloc > 0) ? 2 * tr->frame_alloc : 16;
+    if ((size_t) tr->frame_alloc > ((size_t) -1) / sizeof (float) / frame_size)
+      yyerror ("too many trajectory frames for the memory");
+    tr->xyz = realloc (tr->xyz,
+		       frame_size * (size_t) tr->frame_alloc * sizeof (float));
+    if (tr->xyz == NULL) yyerror ("out of memory for the trajectory frames");
+  }
+
+  return tr->xyz + frame_size * (size_t) tr->frame_count++;
+}
+
+
+/*------------------------------------------------------------*/
+static unsigned int
+get_int (unsigned char *buf, boolean big_endian)
+{
+  if (big_endian) {
+    return ((unsigned int) buf[0] << 24) | ((unsigned int) buf[1] << 16) |
+           ((unsigned int) buf[2] << 8) | (unsigned int) buf[3];
+  } else {
+    return ((unsigned int) buf[3] << 24) | ((unsigned int) buf[2] << 16) |
+           ((unsigned int) buf[1] << 8) | (unsigned int) buf[0];
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static float
+get_float (unsigned char *buf, boolean big_endian)
+     /* IEEE single precision, as in both file formats. */
+{
+  union { unsigned int i; float f; } u;
+
+  u.i = get_int (buf, big_endian);
+  return u.f;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+dcd_record (FILE *file, boolean big_endian,
+	    unsigned char **buf, int *alloc, int *length)
+     /*
+       Read a Fortran unformatted record. Return FALSE at the end of
+       the file; a truncated record is an error.
+     */
+{
+  unsigned char marker[4];
+
+  assert (file);
+  assert (buf);
+  assert (alloc);
+  assert (length);
+
+  if (fread (marker, 1, 4, file) != 4) return FALSE;
+  *length = (int) get_int (marker, big_endian);
+  if (*length < 0) yyerror ("invalid record in the DCD file");
+
+  if (*length > *alloc) {
+    *alloc = *length;
+    *buf = realloc (*buf, *alloc);
+  }
+  if ((fread (*buf, 1, *length, file) != (size_t) *length) ||
+      (fread (marker, 1, 4, file) != 4) ||
+      ((int) get_int (marker, big_endian) != *length))
+    yyerror ("truncated or invalid record in the DCD file");
+
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+dcd_skip_record (FILE *file, boolean big_endian)
+     /* Skip a Fortran unformatted record. Return FALSE at the end of
+        the file. */
+{
+  unsigned char marker[4];
+  int length;
+
+  assert (file);
+
+  if (fread (marker, 1, 4, file) != 4) return FALSE;
+  length = (int) get_int (marker, big_endian);
+  if ((length < 0) ||
+      (fseek (file, (long) length, SEEK_CUR) != 0) ||
+      (fread (marker, 1, 4, file) != 4) ||
+      ((int) get_int (marker, big_endian) != length))
+    yyerror ("truncated or invalid record in the DCD file");
+
+  return TRUE;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+read_dcd (trajectory *tr, FILE *file)
+{
+  unsigned char *buf = NULL;
+  int alloc = 0;
+  int length, slot, axis, frame, wanted;
+  unsigned char marker[4];
+  boolean big_endian, extra_block, four_dims;
+  float *xyz = NULL;
+
+  assert (tr);
+  assert (file);
+
+  if (fread (marker, 1, 4, file) != 4)
+    yyerror ("could not read the DCD file");
+  big_endian = get_int (marker, FALSE) != 84; /* header record length */
+  if (get_int (marker, big_endian) != 84) yyerror ("not a DCD file");
+  rewind (file);
+
+  if (! dcd_record (file, big_endian, &buf, &alloc, &length) ||
+      (length != 84) || strncmp ((char *) buf, "CORD", 4))
+    yyerror ("invalid DCD file header");
+  if (get_int (buf + 4 + 4 * 8, big_endian) != 0)
+    yyerror ("DCD files with fixed atoms are not implemented");
+  if (get_int (buf + 4 + 4 * 19, big_endian) != 0) { /* CHARMM version */
+    extra_block = get_int (buf + 4 + 4 * 10, big_endian) != 0;
+    four_dims = get_int (buf + 4 + 4 * 11, big_endian) != 0;
+  } else {
+    extra_block = FALSE;
+    four_dims = FALSE;
+  }
+
+  if (! dcd_record (file, big_endian, &buf, &alloc, &length)) /* title */
+    yyerror ("invalid DCD file header");
+  if (! dcd_record (file, big_endian, &buf, &alloc, &length) ||
+      (length != 4))
+    yyerror ("invalid DCD file header");
+  tr->atom_count = (int) get_int (buf, big_endian);
+  if (tr->atom_count <= 0) yyerror ("no atoms in the DCD file");
+
+  for (frame = 1; (wanted = wanted_frame (frame)) >= 0; frame++) {
+    if (extra_block) {		/* unit cell */
+      if (! dcd_skip_record (file, big_endian)) break;
+    }
+    if (! wanted) {
+      for (axis = 0; axis < 3 + four_dims; axis++) {
+	if (! dcd_skip_record (file, big_endian)) {
+	  if (axis == 0 && ! extra_block) break;
+	  yyerror ("truncated frame in the DCD file");
+	}
+      }
+      if (axis == 0) break;
+      continue;
+    }
+    for (axis = 0; axis < 3; axis++) {
+      if (! dcd_record (file, big_endian, &buf, &alloc, &length)) {
+	if (axis == 0 && ! extra_block) break;
+	yyerror ("truncated frame in the DCD file");
+      }
+      if (length != 4 * tr->atom_count)
+	yyerror ("invalid coordinate record in the DCD file");
+      if (axis == 0) xyz = new_frame (tr);
+      for (slot = 0; slot < tr->atom_count; slot++) {
+	xyz[3 * slot + axis] = get_float (buf + 4 * slot, big_endian);
+      }
+    }
+    if (axis < 3) break;
+    if (four_dims) {
+      if (! dcd_skip_record (file, big_endian))
+	yyerror ("truncated frame in the DCD file");
+    }
+  }
+
+  free (buf);
+}
+
+
+/*------------------------------------------------------------*/
+static int
+sizeofint (int size)
+     /* Number of bits needed for an integer less than size. */
+{
+  unsigned int num = 1;
+  int bits = 0;
+
+  while ((size >= (int) num) && (bits < 32)) {
+    bits++;
+    num <<= 1;
+  }
+  return bits;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+sizeofints (int count, unsigned int sizes[])
+     /* Number of bits needed for the product of the sizes. */
+{
+  unsigned int bytes[32], num, tmp;
+  int slot, bytecount, byte_slot;
+  int bits = 0;
+
+  bytes[0] = 1;
+  bytecount = 1;
+  for (slot = 0; slot < count; slot++) {
+    tmp = 0;
+    for (byte_slot = 0; byte_slot < bytecount; byte_slot++) {
+      tmp = bytes[byte_slot] * sizes[slot] + tmp;
+      bytes[byte_slot] = tmp & 0xff;
+      tmp >>= 8;
+    }
+    while (tmp != 0) {
+      bytes[byte_slot++] = tmp & 0xff;
+      tmp >>= 8;
+    }
+    bytecount = byte_slot;
+  }
+
+  num = 1;
+  bytecount--;
+  while (bytes[bytecount] >= num) {
+    bits++;
+    num *= 2;
+  }
+  return bits + bytecount * 8;
+}
+
+
+/*------------------------------------------------------------*/
+static int
+receivebits (bit_reader *br, int bits)
+{
+  int mask = (bits < 32) ? (1 << bits) - 1 : -1;
+  int num = 0;
+
+  while (bits >= 8) {
+    br->lastbyte = (br->lastbyte << 8) | br->data[br->count++];
+    num |= (br->lastbyte >> br->lastbits) << (bits - 8);
+    bits -= 8;
+  }
+  if (bits > 0) {
+    if ((int) br->lastbits < bits) {
+      br->lastbits += 8;
+      br->lastbyte = (br->lastbyte << 8) | br->data[br->count++];
+    }
+    br->lastbits -= bits;
+    num |= (br->lastbyte >> br->lastbits) & ((1 << bits) - 1);
+  }
+
+  if (br->count > br->length) yyerror ("corrupt coordinate data in the XTC file");
+  return num & mask;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+receiveints (bit_reader *br, int bits, unsigned int sizes[], int nums[])
+     /* Three integers packed into the given number of bits. */
+{
+  int bytes[32];
+  int slot, byte_slot, bytecount = 0;
+  unsigned int num, p;
+
+  bytes[1] = bytes[2] = bytes[3] = 0;
+  while (bits > 8) {
+    bytes[bytecount++] = receivebits (br, 8);
+    bits -= 8;
+  }
+  if (bits > 0) bytes[bytecount++] = receivebits (br, bits);
+
+  for (slot = 2; slot > 0; slot--) {
+    num = 0;
+    for (byte_slot = bytecount - 1; byte_slot >= 0; byte_slot--) {
+      num = (num << 8) | bytes[byte_slot];
+      p = num / sizes[slot];
+      bytes[byte_slot] = p;
+      num = num - p * sizes[slot];
+    }
+    nums[slot] = num;
+  }
+  nums[0] = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
+}
+
+
+/*------------------------------------------------------------*/
+static void
+xtc_decompress (bit_reader *br, float *xyz, int atom_count, float precision,
+		int minint[3], int maxint[3], int smallidx)
+{
+  unsigned int sizeint[3], sizesmall[3], bitsizeint[3];
+  int thiscoord[3], prevcoord[3];
+  int bitsize, smaller, smallnum, is_smaller, run, flag, tmp, axis, k;
+  int atom = 0;
+  float scale = NM_TO_ANGSTROM / precision;
+
+  for (axis = 0; axis < 3; axis++) sizeint[axis] = maxint[axis] - minint[axis] + 1;
+  if ((sizeint[0] | sizeint[1] | sizeint[2]) > 0xffffff) {
+    for (axis = 0; axis < 3; axis++) bitsizeint[axis] = sizeofint (sizeint[axis]);
+    bitsize = 0;		/* flag: each integer separately */
+  } else {
+    bitsize = sizeofints (3, sizeint);
+  }
+
+  if ((smallidx < XTC_FIRSTIDX) || (smallidx >= XTC_LASTIDX))
+    yyerror ("corrupt coordinate data in the XTC file");
+  smaller = magicints[(smallidx - 1 > XTC_FIRSTIDX) ?
+		      smallidx - 1 : XTC_FIRSTIDX] / 2;
+  smallnum = magicints[smallidx] / 2;
+  sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
+
+  run = 0;
+  while (atom < atom_count) {
+    if (bitsize == 0) {
+      for (axis = 0; axis < 3; axis++)
+	thiscoord[axis] = receivebits (br, bitsizeint[axis]);
+    } else {
+      receiveints (br, bitsize, sizeint, thiscoord);
+    }
+    atom++;
+    for (axis = 0; axis < 3; axis++) {
+      thiscoord[axis] += minint[axis];
+      prevcoord[axis] = thiscoord[axis];
+    }
+
+    flag = receivebits (br, 1);
+    is_smaller = 0;
+    if (flag == 1) {
+      run = receivebits (br, 5);
+      is_smaller = run % 3;
+      run -= is_smaller;
+      is_smaller--;
+    }
+    if (atom + run / 3 > atom_count)
+      yyerror ("corrupt coordinate data in the XTC file");
+
+    if (run > 0) {
+      for (k = 0; k < run; k += 3) {
+	receiveints (br, smallidx, sizesmall, thiscoord);
+	atom++;
+	for (axis = 0; axis < 3; axis++) {
+	  thiscoord[axis] += prevcoord[axis] - smallnum;
+	}
+	if (k == 0) {		/* first two atoms interchanged (water) */
+	  for (axis = 0; axis < 3; axis++) {
+	    tmp = thiscoord[axis];
+	    thiscoord[axis] = prevcoord[axis];
+	    prevcoord[axis] = tmp;
+	  }
+	  for (axis = 0; axis < 3; axis++) *xyz++ = prevcoord[axis] * scale;
+	} else {
+	  for (axis = 0; axis < 3; axis++) prevcoord[axis] = thiscoord[axis];
+	}
+	for (axis = 0; axis < 3; axis++) *xyz++ = thiscoord[axis] * scale;
+      }
+    } else {
+      for (axis = 0; axis < 3; axis++) *xyz++ = thiscoord[axis] * scale;
+    }
+
+    smallidx += is_smaller;
+    if ((smallidx < XTC_FIRSTIDX) || (smallidx >= XTC_LASTIDX))
+      yyerror ("corrupt coordinate data in the XTC file");
+    if (is_smaller < 0) {
+      smallnum = smaller;
+      smaller = (smallidx > XTC_FIRSTIDX) ? magicints[smallidx - 1] / 2 : 0;
+    } else if (is_smaller > 0) {
+      smaller = smallnum;
+      smallnum = magicints[smallidx] / 2;
+    }
+    sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+read_xtc (trajectory *tr, FILE *file)
+{
+  unsigned char head[4 * 14], buf[4 * 3 * 9];
+  bit_reader br;
+  int minint[3], maxint[3];
+  int atom_count, slot, length, frame, wanted;
+  float precision, *xyz;
+
+  assert (tr);
+  assert (file);
+
+  br.data = NULL;
+
+  for (frame = 1; (wanted = wanted_frame (frame)) >= 0; frame++) {
+    if (fread (head, 1, 4, file) != 4) break; /* end of file */
+    if (get_int (head, TRUE) != XTC_MAGIC) yyerror ("not an XTC file");
+    if (fread (head + 4, 1, 4 * 13, file) != 4 * 13)
+      yyerror ("truncated frame in the XTC file");
+				/* natoms, step, time, box, natoms */
+    atom_count = (int) get_int (head + 4, TRUE);
+    if ((atom_count <= 0) || ((int) get_int (head + 4 * 13, TRUE) != atom_count))
+      yyerror ("invalid frame header in the XTC file");
+    if (tr->atom_count == 0) {
+      tr->atom_count = atom_count;
+    } else if (atom_count != tr->atom_count) {
+      yyerror ("the number of atoms changes in the XTC file");
+    }
+
+    if (! wanted) {		/* skip by the size of the frame data */
+      if (atom_count <= 9) {
+	length = 4 * 3 * atom_count;
+      } else {
+	if ((fseek (file, 4 * 8, SEEK_CUR) != 0) ||
+	    (fread (buf, 1, 4, file) != 4))
+	  yyerror ("truncated frame in the XTC file");
+	length = (int) get_int (buf, TRUE);
+	if (length < 0) yyerror ("invalid frame header in the XTC file");
+	length = (length + 3) & ~3;
+      }
+      if ((length > 0) &&	/* the last byte must be there */
+	  ((fseek (file, (long) length - 1, SEEK_CUR) != 0) ||
+	   (getc (file) == EOF)))
+	yyerror ("truncated frame in the XTC file");
+      continue;
+    }
+    xyz = new_frame (tr);
+
+    if (atom_count <= 9) {	/* uncompressed */
+      if (fread (buf, 4, 3 * atom_count, file) != (size_t) (3 * atom_count))
+	yyerror ("truncated frame in the XTC file");
+      for (slot = 0; slot < 3 * atom_count; slot++) {
+	xyz[slot] = NM_TO_ANGSTROM * get_float (buf + 4 * slot, TRUE);
+      }
+      continue;
+    }
+
+    if (fread (head, 4, 8, file) != 8)
+      yyerror ("truncated frame in the XTC file");
+    precision = get_float (head, TRUE);
+    for (slot = 0; slot < 3; slot++) {
+      minint[slot] = (int) get_int (head + 4 + 4 * slot, TRUE);
+      maxint[slot] = (int) get_int (head + 16 + 4 * slot, TRUE);
+    }
+    length = (int) get_int (head + 28, TRUE);     /* smallidx */
+    if (fread (buf, 1, 4, file) != 4)
+      yyerror ("truncated frame in the XTC file");
+    br.length = (int) get_int (buf, TRUE);
+    if ((precision <= 0.0) || (br.length < 0))
+      yyerror ("invalid frame header in the XTC file");
+
+    br.data = realloc (br.data, br.length + 8); /* padded to 4 bytes */
+    if (fread (br.data, 1, (br.length + 3) & ~3, file) !=
+	(size_t) ((br.length + 3) & ~3))
+      yyerror ("truncated frame in the XTC file");
+    br.count = 0;
+    br.lastbits = 0;
+    br.lastbyte = 0;
+
+    xtc_decompress (&br, xyz, atom_count, precision, minint, maxint, length);
+  }
+
+  if (br.data) free (br.data);
+}
+
+
+/*------------------------------------------------------------*/
+static trajectory *
+get_trajectory (char *filename, int type)
+     /* The trajectory as read earlier, unless the file has changed. */
+{
+  trajectory *tr, *prev;
+  struct stat st;
+  FILE *file;
+
+  assert (filename);
+
+  if (stat (filename, &st) != 0) yyerror ("could not open the trajectory file");
+
+  for (prev = NULL, tr = trajectories; tr; prev = tr, tr = tr->next) {
+    if (str_eq (tr->filename, filename)) break;
+  }
+  if (tr) {
+    if (tr->mtime == st.st_mtime) return tr;
+    if (prev) {
+      prev->next = tr->next;
+    } else {
+      trajectories = tr->next;
+    }
+    free (tr->filename);
+    free (tr->xyz);
+    free (tr);
+  }
+
+  file = fopen (filename, "rb");
+  if (file == NULL) yyerror ("could not open the trajectory file");
+
+  tr = malloc (sizeof (trajectory));
+  tr->filename = str_clone (filename);
+  tr->mtime = st.st_mtime;
+  tr->atom_count = 0;
+  tr->frame_count = 0;
+  tr->frame_alloc = 0;
+  tr->xyz = NULL;
+  tr->next = NULL;
+
+  if (message_mode) fprintf (stderr, "reading trajectory file...\n");
+  if (type == MOL3D_DCD_FILE) {
+    read_dcd (tr, file);
+  } else {
+    read_xtc (tr, file);
+  }
+  fclose (file);
+
+  if (tr->frame_count == 0) yyerror ("no frames in the trajectory file");
+  if (message_mode)
+    fprintf (stderr, "%i frames of %i atoms kept from %s\n",
+	     tr->frame_count, tr->atom_count, filename);
+
+  tr->next = trajectories;
+  trajectories = tr;
+  return tr;
+}
+
+
+/*------------------------------------------------------------*/
+float *
+trajectory_frame (char *filename, int type, int *atom_count)
+     /* The coordinates of the current frame in the trajectory file. */
+{
+  trajectory *tr;
+  int slot;
+
+  assert (filename);
+  assert ((type == MOL3D_DCD_FILE) || (type == MOL3D_XTC_FILE));
+  assert (atom_count);
+
+  tr = get_trajectory (filename, type);
+  slot = (current_frame - first_frame) / frame_step;
+  if (slot >= tr->frame_count)
+    yyerror ("no such frame in the trajectory file");
+  if (message_mode) fprintf (stderr, "frame %i\n", current_frame);
+
+  *atom_count = tr->atom_count;
+  return tr->xyz + 3 * (size_t) tr->atom_count * (size_t) slot;
+}
+
+
+/*------------------------------------------------------------*/
+void
+trajectory_set_range (int first, int last, int step)
+{
+  assert (first > 0);
+  assert (last >= first);
+  assert (step > 0);
+
+  first_frame = first;
+  last_frame = last;
+  frame_step = step;
+}
+
+
+/*------------------------------------------------------------*/
+int
+trajectory_run (void)
+     /*
+       Render the input script for each frame in the range. Return
+       the number of frames that failed.
+     */
+{
+  jmp_buf env;
+  char *input, *output;
+  char * volatile name = NULL;
+  volatile int frame;
+  volatile int failed = 0;
+
+  assert (input_filename);
+  assert (output_filename);
+
+  input = str_clone (input_filename);
+  output = str_clone (output_filename);
+
+  cache_molecules();
+#ifdef IMAGE_SUPPORT
+  image_detach_plots();
+#endif
+
+  for (frame = first_frame; frame <= last_frame; frame += frame_step) {
+    current_frame = frame;
+
+    if (setjmp (env)) {
+      fprintf (stderr, "Error: trajectory frame %i failed\n", frame);
+      if (outfile && (outfile != stdout)) fclose (outfile);
+      outfile = stdout;
+      failed++;
+      if (name == NULL) break;	/* invalid output file name template */
+      continue;
+    }
+    error_return = &env;
+
+    if (name) free (name);
+    name = NULL;
+    name = numbered_filename (output, frame,
+			      "invalid output file name template for trajectory frames");
+    if (message_mode) fprintf (stderr, "trajectory frame %i -> %s\n", frame, name);
+
+    render_input (input, name);
+  }
+
+  error_return = NULL;
+  input_filename = NULL;
+  output_filename = NULL;
+#ifdef IMAGE_SUPPORT
+  failed += image_wait_plots();
+#endif
+  if (name) free (name);
+  free (input);
+  free (output);
+
+  return failed;
+}
@@ -0,0 +1,18 @@
+/* trajectory.h
+
+   MolScript v2.1.2
+
+   Trajectory input: DCD (CHARMM, NAMD, X-PLOR) and XTC (GROMACS) files.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+*/
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H 1
+
+float *trajectory_frame (char *filename, int type, int *atom_count);
+void trajectory_set_range (int first, int last, int step);
+int trajectory_run (void);
+
+#endif
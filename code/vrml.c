@@ -12,6 +12,11 @@
     25-Jan-1998  prepare some proto's for dynamics
     20-Aug-1998  fixed level-of-detail bug
     28-Aug-1998  split out indent functions
+    18-Oct-2026  hashed colour cache without size limit
+    18-Oct-2026  welded vertices for triangle objects
+    18-Oct-2026  DEF/USE shared shapes for spheres, cylinders, sticks
+    18-Oct-2026  level-of-detail ranges from the extent, if not given
+    18-Oct-2026  level-of-detail nodes nested by a stack
 */
 
 #include <assert.h>
@@ -23,11 +28,13 @@
 #include "clib/extent3d.h"
 #include "clib/str_utils.h"
 #include "clib/dynstring.h"
+#include "clib/double_hash.h"
 #include "clib/vrml.h"
 
 #include "vrml.h"
 #include "global.h"
 #include "graphics.h"
+#include "mesh.h"
 #include "segment.h"
 #include "state.h"
 
@@ -58,18 +65,33 @@ static int def_count;
 
 #define STICK_SEGMENTS 8
 
-#define MAX_COLOUR_CACHE 16
-#define COLOUR_MAXDIFF 0.005
-static colour colour_cache[MAX_COLOUR_CACHE];
-static colour colour_cache_latest;
+static dhash_table *shape_defs = NULL; /* shared shape DEF name by key */
+static char *stick_geometry_def = NULL;
+
+#define COLOUR_QUANTUM 0.005
+
+typedef struct {
+  int r, g, b;			/* quantised rgb key */
+  int index;			/* position in output list; -1 if empty */
+} colour_cache_entry;
+
+static colour_cache_entry *colour_cache = NULL;
+static int colour_cache_size = 0;
 static int colour_cache_count;
-static int colour_cache_index_count;
 
 static int anchor_parameter_not_started = TRUE;
 
-static double *lod_ranges = NULL;
-static int lod_alloc;
-static int lod_count;
+typedef struct s_lod_node lod_node;
+
+struct s_lod_node {
+  double *ranges;
+  int alloc;
+  int count;
+  int groups;
+  lod_node *prev;
+};
+
+static lod_node *lod_current = NULL; /* innermost level-of-detail node */
 
 
 /*------------------------------------------------------------*/
@@ -205,46 +227,232 @@ output_appearance (int is_line, colour *c)
 }
 
 
+/*------------------------------------------------------------*/
+static char *
+shape_key (char kind, double size, colour *dc)
+     /*
+       The key is made from the values as they are written out, so
+       spheres or sticks that look the same share one Shape node.
+     */
+{
+  static char key[256];
+  colour dc_rgb, ec_rgb, sc_rgb;
+
+  assert (dc);
+
+  colour_copy_to_rgb (&dc_rgb, dc);
+  colour_copy_to_rgb (&ec_rgb, &(current_state->emissivecolour));
+  colour_copy_to_rgb (&sc_rgb, &(current_state->specularcolour));
+  sprintf (key,
+	   "%c %.3g %.2g %.2g %.2g %.2g %.2g %.2g %.2g %.2g %.2g %.2g %.2g",
+	   kind, size,
+	   dc_rgb.x, dc_rgb.y, dc_rgb.z,
+	   ec_rgb.x, ec_rgb.y, ec_rgb.z,
+	   sc_rgb.x, sc_rgb.y, sc_rgb.z,
+	   current_state->shininess, current_state->transparency);
+  return key;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+output_instance_shape (char *key, colour *dc)
+     /*
+       Output the shape of an Inst node. The first time a key is seen
+       the Shape node is DEF'ed, and TRUE is returned so that the
+       caller outputs its geometry. Otherwise the Shape is USE'd.
+     */
+{
+  char *def;
+  dynstring *def_name;
+
+  assert (key);
+  assert (dc);
+  assert (shape_defs);
+
+  def = dhash_object (shape_defs, key);
+  if (def) {
+    indent_string ("g USE");
+    indent_string (def);
+    vrml_finish_node();
+    return FALSE;
+  }
+
+  def_name = ds_create ("_");
+  ds_cat_int (def_name, def_count++);
+  def = str_clone (def_name->string);
+  ds_delete (def_name);
+  dhash_insert (shape_defs, str_clone (key), def);
+
+  indent_newline();
+  indent_string ("g");
+  vrml_def (def);
+  vrml_node ("Shape");
+  vrml_node ("appearance Appearance");
+  indent_string ("material");
+  vrml_material (dc, &(current_state->emissivecolour),
+		 &(current_state->specularcolour),
+		 0.2, current_state->shininess,
+		 current_state->transparency);
+  vrml_finish_node();
+  indent_newline();
+  return TRUE;
+}
+
+
 /*------------------------------------------------------------*/
 static void
-colour_cache_init (void)
+output_stick_geometry (void)
 {
-  colour_cache_count = 0;
+  int slot;
+  double angle;
+  dynstring *def_name;
+
+  if (stick_geometry_def) {
+    indent_string ("geometry USE");
+    indent_string (stick_geometry_def);
+    return;
+  }
+
+  def_name = ds_create ("_");
+  ds_cat_int (def_name, def_count++);
+  stick_geometry_def = str_clone (def_name->string);
+  ds_delete (def_name);
+
+  indent_string ("geometry");
+  vrml_def (stick_geometry_def);
+  vrml_node ("Extrusion");
+  vrml_s_newline ("spine [0 -1 0, 0 1 0]");
+  vrml_list ("crossSection");
+  vrml_g (1.0);
+  vrml_g (0.0);
+  for (slot = STICK_SEGMENTS - 1; slot > 0; slot--) {
+    angle = 2.0 * ANGLE_PI * (double) slot / (double) STICK_SEGMENTS;
+    vrml_g (cos (angle));
+    vrml_g (sin (angle));
+  }
+  vrml_g (1.0);
+  vrml_g (0.0);
+  vrml_finish_list();
+  indent_newline();
+  vrml_s_newline ("beginCap FALSE");
+  vrml_s_newline ("endCap FALSE");
+  indent_string ("creaseAngle 1.7");
+  vrml_finish_node();
 }
 
 
 /*------------------------------------------------------------*/
 static void
-colour_cache_add (colour *c)
+colour_cache_clear (int size)
 {
   int slot;
 
+  assert (size > 0);
+
+  if (size > colour_cache_size) {
+    if (colour_cache) free (colour_cache);
+    colour_cache = malloc (size * sizeof (colour_cache_entry));
+  }
+  colour_cache_size = size;
+  for (slot = 0; slot < colour_cache_size; slot++) {
+    colour_cache[slot].index = -1;
+  }
+  colour_cache_count = 0;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+colour_cache_init (void)
+{
+  colour_cache_clear (64);
+}
+
+
+/*------------------------------------------------------------*/
+static colour_cache_entry *
+colour_cache_lookup (colour *c)
+{
+  int r, g, b;
+  unsigned int slot;
+  colour_cache_entry *ce;
+
   assert (c);
+  assert (colour_cache);
 
   colour_to_rgb (c);
-
-  for (slot = colour_cache_count - 1; slot >= 0; slot--) {
-    if (colour_approx_equal (c, &(colour_cache[slot]), COLOUR_MAXDIFF)) return;
+  r = (int) floor (c->x / COLOUR_QUANTUM + 0.5);
+  g = (int) floor (c->y / COLOUR_QUANTUM + 0.5);
+  b = (int) floor (c->z / COLOUR_QUANTUM + 0.5);
+
+  slot = ((unsigned int) r * 73856093U) ^
+         ((unsigned int) g * 19349663U) ^
+         ((unsigned int) b * 83492791U);
+  slot %= (unsigned int) colour_cache_size;
+
+  for (;;) {			/* linear probing; never full */
+    ce = colour_cache + slot;
+    if (ce->index < 0) {
+      ce->r = r;
+      ce->g = g;
+      ce->b = b;
+      return ce;
+    }
+    if ((ce->r == r) && (ce->g == g) && (ce->b == b)) return ce;
+    if (++slot >= (unsigned int) colour_cache_size) slot = 0;
   }
+}
 
-  if (colour_cache_count < MAX_COLOUR_CACHE) {
-    colour_cache_index_count = colour_cache_count;
-    colour_cache[colour_cache_count++] = *c;
-  } else if (colour_approx_equal (c, &colour_cache_latest, COLOUR_MAXDIFF)) {
-    return;
+
+/*------------------------------------------------------------*/
+static void
+colour_cache_grow (void)
+{
+  colour_cache_entry *old;
+  colour_cache_entry *ce;
+  colour c;
+  int slot, size, count;
+
+  old = colour_cache;
+  size = colour_cache_size;
+  count = colour_cache_count;
+
+  colour_cache = NULL;
+  colour_cache_size = 0;
+  colour_cache_clear (2 * size);
+
+  for (slot = 0; slot < size; slot++) {
+    if (old[slot].index < 0) continue;
+    c.spec = COLOUR_RGB;
+    c.x = old[slot].r * COLOUR_QUANTUM;
+    c.y = old[slot].g * COLOUR_QUANTUM;
+    c.z = old[slot].b * COLOUR_QUANTUM;
+    ce = colour_cache_lookup (&c);
+    ce->index = old[slot].index;
   }
+  colour_cache_count = count;
 
-  vrml_rgb_colour (c);
-  colour_count++;
-  colour_cache_latest = *c;
+  free (old);
 }
 
 
 /*------------------------------------------------------------*/
 static void
-colour_cache_index_init (void)
+colour_cache_add (colour *c)
 {
-  colour_cache_latest.spec = -1;
+  colour_cache_entry *ce;
+
+  assert (c);
+
+  ce = colour_cache_lookup (c);
+  if (ce->index >= 0) return;
+
+  ce->index = colour_cache_count++;
+  vrml_rgb_colour (c);
+  colour_count++;
+				/* keep load factor below 2/3 */
+  if (3 * colour_cache_count >= 2 * colour_cache_size) colour_cache_grow();
 }
 
 
@@ -252,22 +460,14 @@ colour_cache_index_init (void)
 static int
 colour_cache_index (colour *c)
 {
-  int slot;
+  colour_cache_entry *ce;
 
   assert (c);
 
-  for (slot = colour_cache_count - 1; slot >= 0; slot--) {
-    if (colour_approx_equal (c, &(colour_cache[slot]), COLOUR_MAXDIFF)) {
-      return slot;
-    }
-  }
+  ce = colour_cache_lookup (c);
+  assert (ce->index >= 0);
 
-  if (colour_approx_equal (c, &colour_cache_latest, COLOUR_MAXDIFF)) {
-    return colour_cache_index_count;
-  } else {
-    colour_cache_latest = *c;
-    return ++colour_cache_index_count;
-  }
+  return ce->index;
 }
 
 
@@ -323,9 +523,6 @@ vrml_set (void)
 void
 vrml_first_plot (void)
 {
-  int slot;
-  double angle;
-
   if (!first_plot)
     yyerror ("only one plot per input file allowed for VRML 2.0");
 
@@ -353,82 +550,11 @@ vrml_first_plot (void)
 
   indent_newline();
   vrml_comment ("MolScript: begin proto definitions");
-  vrml_proto ("Ball");
-  vrml_s_newline ("exposedField SFVec3f p 0 0 0");
-  vrml_s_newline ("field SFFloat rad 1.5");
-  vrml_s_newline ("field SFColor dc 1 1 1");
-  vrml_s_newline ("field SFColor ec 0 0 0");
-  vrml_s_newline ("field SFColor sc 0.2 0.2 0.2");
-  vrml_s_newline ("field SFFloat sh 0");
-  indent_string ("field SFFloat tr 0");
-  vrml_finish_list();
-  indent_newline();
-  vrml_begin_node();
-  vrml_node ("Transform");
-  vrml_s_newline ("translation IS p");
-  vrml_list ("children");
-  vrml_node ("Shape");
-  vrml_node ("appearance Appearance");
-  vrml_node ("material Material");
-  vrml_s_newline ("diffuseColor IS dc");
-  vrml_s_newline ("emissiveColor IS ec");
-  vrml_s_newline ("specularColor IS sc");
-  vrml_s_newline ("shininess IS sh");
-  indent_string ("transparency IS tr");
-  vrml_finish_node();
-  vrml_finish_node();
-  indent_newline();
-  vrml_node ("geometry Sphere");
-  indent_string ("radius IS rad");
-  vrml_finish_node();
-  vrml_finish_node();
-  vrml_finish_list();
-  vrml_finish_node();
-  vrml_finish_node();
-
-  vrml_proto ("Cyl");
-  vrml_s_newline ("exposedField SFVec3f p 0 0 0");
-  vrml_s_newline ("exposedField SFRotation r 0 0 1 0");
-  vrml_s_newline ("exposedField SFVec3f s 1 1 1");
-  vrml_s_newline ("field SFColor dc 1 1 1");
-  vrml_s_newline ("field SFColor ec 0 0 0");
-  vrml_s_newline ("field SFColor sc 0.2 0.2 0.2");
-  vrml_s_newline ("field SFFloat sh 0");
-  indent_string ("field SFFloat tr 0");
-  vrml_finish_list();
-  indent_newline();
-  vrml_begin_node();
-  vrml_node ("Transform");
-  vrml_s_newline ("translation IS p");
-  vrml_s_newline ("rotation IS r");
-  vrml_s_newline ("scale IS s");
-  vrml_list ("children");
-  vrml_node ("Shape");
-  vrml_node ("appearance Appearance");
-  vrml_node ("material Material");
-  vrml_s_newline ("diffuseColor IS dc");
-  vrml_s_newline ("emissiveColor IS ec");
-  vrml_s_newline ("specularColor IS sc");
-  vrml_s_newline ("shininess IS sh");
-  indent_string ("transparency IS tr");
-  vrml_finish_node();
-  vrml_finish_node();
-  indent_newline();
-  indent_string ("geometry Cylinder { }");
-  vrml_finish_node();
-  vrml_finish_list();
-  vrml_finish_node();
-  vrml_finish_node();
-
-  vrml_proto ("Stick");
+  vrml_proto ("Inst");
   vrml_s_newline ("exposedField SFVec3f p 0 0 0");
   vrml_s_newline ("exposedField SFRotation r 0 0 1 0");
   vrml_s_newline ("exposedField SFVec3f s 1 1 1");
-  vrml_s_newline ("field SFColor dc 1 1 1");
-  vrml_s_newline ("field SFColor ec 0 0 0");
-  vrml_s_newline ("field SFColor sc 0.2 0.2 0.2");
-  vrml_s_newline ("field SFFloat sh 0");
-  indent_string ("field SFFloat tr 0");
+  indent_string ("field MFNode g []");
   vrml_finish_list();
   indent_newline();
   vrml_begin_node();
@@ -436,38 +562,7 @@ vrml_first_plot (void)
   vrml_s_newline ("translation IS p");
   vrml_s_newline ("rotation IS r");
   vrml_s_newline ("scale IS s");
-  vrml_list ("children");
-  vrml_node ("Shape");
-  vrml_node ("appearance Appearance");
-  vrml_node ("material Material");
-  vrml_s_newline ("diffuseColor IS dc");
-  vrml_s_newline ("emissiveColor IS ec");
-  vrml_s_newline ("specularColor IS sc");
-  vrml_s_newline ("shininess IS sh");
-  indent_string ("transparency IS tr");
-  vrml_finish_node();
-  vrml_finish_node();
-  indent_newline();
-  vrml_node ("geometry Extrusion");
-  vrml_s_newline ("spine [0 -1 0, 0 1 0]");
-  vrml_list ("crossSection");
-  vrml_g (1.0);
-  vrml_g (0.0);
-  for (slot = STICK_SEGMENTS - 1; slot > 0; slot--) {
-    angle = 2.0 * ANGLE_PI * (double) slot / (double) STICK_SEGMENTS;
-    vrml_g (cos (angle));
-    vrml_g (sin (angle));
-  }
-  vrml_g (1.0);
-  vrml_g (0.0);
-  vrml_finish_list();
-  indent_newline();
-  vrml_s_newline ("beginCap FALSE");
-  vrml_s_newline ("endCap FALSE");
-  indent_string ("creaseAngle 1.7");
-  vrml_finish_node();
-  vrml_finish_node();
-  vrml_finish_list();
+  indent_string ("children IS g");
   vrml_finish_node();
   vrml_finish_node();
 
@@ -547,6 +642,9 @@ vrml_start_plot (void)
   label_count = 0;
   def_count = 0;
 
+  shape_defs = dhash_create (64);
+  stick_geometry_def = NULL;
+
   colour_copy_to_rgb (&background_colour, &black_colour);
 
   indent_newline();
@@ -629,6 +727,11 @@ vrml_finish_plot (void)
   }
   viewpoints = NULL;
 
+  dhash_delete_contents (shape_defs);
+  shape_defs = NULL;
+  if (stick_geometry_def) free (stick_geometry_def);
+  stick_geometry_def = NULL;
+
   if (message_mode) {
     fprintf (stderr, "%i line coordinates, %i points, %i polygons, %i segment colours,\n",
 	     line_count, point_count, polygon_count, colour_count);
@@ -725,7 +828,13 @@ vrml_anchor_finish (void)
 /*------------------------------------------------------------*/
 void
 vrml_lod_start (void)
+     /*
+       The ranges and groups are kept for each open node, since a node
+       may be nested in a group of another.
+     */
 {
+  lod_node *lod;
+
   indent_newline();
   vrml_node ("LOD");
   vrml_list ("level");
@@ -733,11 +842,13 @@ vrml_lod_start (void)
   ext3d_push();
   ext3d_initialize();
 
-  if (lod_alloc == 0) {
-    lod_alloc = 8;
-    lod_ranges = malloc (lod_alloc * sizeof (double));
-  }
-  lod_count = 0;
+  lod = malloc (sizeof (lod_node));
+  lod->alloc = 8;
+  lod->ranges = malloc (lod->alloc * sizeof (double));
+  lod->count = 0;
+  lod->groups = 0;
+  lod->prev = lod_current;
+  lod_current = lod;
 }
 
 
@@ -745,16 +856,31 @@ vrml_lod_start (void)
 void
 vrml_lod_finish (void)
 {
+  lod_node *lod = lod_current;
   vector3 center, size;
   int slot;
 
-  assert (lod_ranges);
+  assert (lod);
 
   vrml_finish_list();
 
   ext3d_get_center_size (&center, &size);
   ext3d_pop (TRUE);
 
+  if ((lod->count == 0) && (lod->groups > 1)) { /* automatic detail levels */
+    double range = size.x;	/* double the range for each level */
+    if (size.y > range) range = size.y;
+    if (size.z > range) range = size.z;
+    if (lod->groups - 1 > lod->alloc) {
+      lod->alloc = lod->groups;
+      lod->ranges = realloc (lod->ranges, lod->alloc * sizeof (double));
+    }
+    for (slot = 0; slot < lod->groups - 1; slot++) {
+      range *= 2.0;
+      lod->ranges[lod->count++] = range;
+    }
+  }
+
   indent_newline();
   indent_string ("center");
   vrml_f2 (center.x);
@@ -763,10 +889,14 @@ vrml_lod_finish (void)
 
   indent_newline();
   vrml_list ("range");
-  for (slot = 0; slot < lod_count; slot++) vrml_f2 (lod_ranges[slot]);
+  for (slot = 0; slot < lod->count; slot++) vrml_f2 (lod->ranges[slot]);
   vrml_finish_list();
 
   vrml_finish_node();
+
+  lod_current = lod->prev;
+  free (lod->ranges);
+  free (lod);
 }
 
 
@@ -774,23 +904,27 @@ vrml_lod_finish (void)
 void
 vrml_lod_start_group (void)
 {
-  assert (lod_ranges);
+  lod_node *lod = lod_current;
+
+  assert (lod);
   assert ((dstack_size == 1) || (dstack_size == 0));
 
   if (dstack_size == 1) {
-    if (lod_count + 1 >= lod_alloc) {
-      lod_alloc *= 2;
-      lod_ranges = realloc (lod_ranges, lod_alloc * sizeof (double));
+    if (lod->count + 1 >= lod->alloc) {
+      lod->alloc *= 2;
+      lod->ranges = realloc (lod->ranges, lod->alloc * sizeof (double));
     }
 
-    lod_ranges[lod_count++] = dstack[0];
+    lod->ranges[lod->count++] = dstack[0];
     clear_dstack();
 
-    if (lod_count > 1 &&
-	lod_ranges[lod_count - 1] <= lod_ranges[lod_count - 2])
+    if (lod->count > 1 &&
+	lod->ranges[lod->count - 1] <= lod->ranges[lod->count - 2])
       yyerror ("level-of-detail range not in ascending order");
   }
 
+  lod->groups++;
+
   indent_newline();
   vrml_node ("Group");
   vrml_list ("children");
@@ -803,7 +937,7 @@ vrml_lod_start_group (void)
 void
 vrml_lod_finish_group (void)
 {
-  assert (lod_ranges);
+  assert (lod_current);
 
   vrml_finish_list();
   vrml_finish_node();
@@ -832,35 +966,11 @@ vrml_viewpoint_output (void)
   double angle;
 
   assert (viewpoint_str);
-  assert ((dstack_size == 4) ||
-	  (dstack_size == 6) ||
-	  (dstack_size == 7));
 
   vp = malloc (sizeof (viewpoint_node));
   vp->next = NULL;
 
-  if (dstack_size == 4) {	/* towards origin */
-    towards.x = dstack[0];
-    towards.y = dstack[1];
-    towards.z = dstack[2];
-    dir = towards;
-    v3_normalize (&dir);
-    v3_sum_scaled (&from, &towards, dstack[3], &dir);
-
-  } else {			/* to, from specified points */
-    from.x = dstack[0];
-    from.y = dstack[1];
-    from.z = dstack[2];
-    towards.x = dstack[3];
-    towards.y = dstack[4];
-    towards.z = dstack[5];
-    if (dstack_size == 7) {	/* additional distance */
-      v3_difference (&dir, &from, &towards);
-      v3_normalize (&dir);
-      v3_add_scaled (&from, dstack[6], &dir);
-    }
-  }
-  clear_dstack();
+  viewpoint_points (&from, &towards);
 
   v3_difference (&dir, &towards, &from);
   angle = v3_angle (&dir, &zdir);
@@ -1126,19 +1236,20 @@ vrml_cylinder (vector3 *v1, vector3 *v2)
   v3_middle (&middle, v1, v2);
 
   indent_newline();
-  vrml_node ("Cyl");
+  vrml_node ("Inst");
   indent_string ("p ");
   vrml_v3 (&middle);
   output_rot (&rot, angle);
   output_scale (current_state->cylinderradius,
 		v3_length (&dir) / 2.0,
 		current_state->cylinderradius);
-  output_dc (&(current_state->planecolour));
-  output_ec (&(current_state->emissivecolour));
-  output_sc (&(current_state->specularcolour));
-  output_sh (current_state->shininess);
-  output_tr (current_state->transparency);
-  vrml_finish_node();
+  if (output_instance_shape (shape_key ('C', 1.0,
+					&(current_state->planecolour)),
+			     &(current_state->planecolour))) {
+    indent_string ("geometry Cylinder { }");
+    vrml_finish_node();
+    vrml_finish_node();
+  }
 
   cylinder_count++;
 }
@@ -1368,7 +1479,6 @@ vrml_line (boolean polylines)
 
     indent_newline();
     vrml_list ("colorIndex");
-    colour_cache_index_init();
 
     if (polylines) {
       for (slot = 0; slot < line_segment_count; slot++) {
@@ -1398,17 +1508,18 @@ vrml_sphere (at3d *at, double radius)
   assert (radius > 0.0);
 
   indent_newline();
-  vrml_node ("Ball");
+  vrml_node ("Inst");
   indent_string ("p ");
   vrml_v3 (&(at->xyz));
-  indent_string ("rad");
-  vrml_g3 (radius);
-  output_dc (&(at->colour));
-  output_ec (&(current_state->emissivecolour));
-  output_sc (&(current_state->specularcolour));
-  output_sh (current_state->shininess);
-  output_tr (current_state->transparency);
-  vrml_finish_node();
+  if (output_instance_shape (shape_key ('B', radius, &(at->colour)),
+			     &(at->colour))) {
+    vrml_node ("geometry Sphere");
+    indent_string ("radius");
+    vrml_g3 (radius);
+    vrml_finish_node();
+    vrml_finish_node();
+    vrml_finish_node();
+  }
 
   sphere_count++;
 }
@@ -1435,24 +1546,21 @@ vrml_stick (vector3 *v1, vector3 *v2, double r1, double r2, colour *c)
   }
   v3_middle (&middle, v1, v2);
 
+  if (c == NULL) c = &(current_state->planecolour);
+
   indent_newline();
-  vrml_node ("Stick");
+  vrml_node ("Inst");
   indent_string ("p ");
   vrml_v3_g (&middle);		/* vrml_v3 causes gaps between half-sticks */
   output_rot (&rot, angle);
   output_scale (current_state->stickradius,
 		0.502 * v3_length (&dir), /* kludge to avoid glitches */
 		current_state->stickradius);
-  if (c) {
-    output_dc (c);
-  } else {
-    output_dc (&(current_state->planecolour));
+  if (output_instance_shape (shape_key ('S', 1.0, c), c)) {
+    output_stick_geometry();
+    vrml_finish_node();
+    vrml_finish_node();
   }
-  output_ec (&(current_state->emissivecolour));
-  output_sc (&(current_state->specularcolour));
-  output_sh (current_state->shininess);
-  output_tr (current_state->transparency);
-  vrml_finish_node();
 
   polygon_count += STICK_SEGMENTS;
 }
@@ -1973,6 +2081,67 @@ vrml_strand2 (void)
 }
 
 
+/*------------------------------------------------------------*/
+static void
+output_triangle_object (int code, vector3 *triplets, int count)
+     /* Triangle soup is welded into shared vertices before output. */
+{
+  int slot;
+  mesh *m;
+  colour rgb = {COLOUR_RGB, 1.0, 1.0, 1.0};
+
+  assert (triplets);
+  assert (count > 0);
+
+  m = mesh_from_object (code, triplets, count);
+  assert (m);
+
+  output_appearance (FALSE, &(current_state->planecolour));
+  indent_newline();
+  vrml_node ("geometry IndexedFaceSet");
+  vrml_s_newline ("solid FALSE");
+  vrml_node ("coord Coordinate");
+  vrml_list ("point");
+  for (slot = 0; slot < m->count; slot++) vrml_v3 (m->points + slot);
+  vrml_finish_list();
+  vrml_finish_node();
+  indent_newline();
+  vrml_list ("coordIndex");
+  for (slot = 0; slot < m->triangle_count; slot++)
+    vrml_tri_indices (0, m->triangles[3 * slot],
+		      m->triangles[3 * slot + 1], m->triangles[3 * slot + 2]);
+  vrml_finish_list();
+
+  if (m->normals) {
+    indent_newline();
+    vrml_node ("normal Normal");
+    vrml_list ("vector");
+    for (slot = 0; slot < m->count; slot++) vrml_v3_g3 (m->normals + slot);
+    vrml_finish_list();
+    vrml_finish_node();
+  }
+
+  if (m->colours) {
+    indent_newline();
+    vrml_node ("color Color");
+    vrml_list ("color");
+    for (slot = 0; slot < m->count; slot++) {
+      rgb.x = m->colours[slot].x;
+      rgb.y = m->colours[slot].y;
+      rgb.z = m->colours[slot].z;
+      vrml_rgb_colour (&rgb);
+    }
+    vrml_finish_list();
+    vrml_finish_node();
+  }
+
+  vrml_finish_node();
+  polygon_count += m->triangle_count;
+
+  mesh_delete (m);
+}
+
+
 /*------------------------------------------------------------*/
 void
 vrml_object (int code, vector3 *triplets, int count)
@@ -2080,114 +2249,22 @@ vrml_object (int code, vector3 *triplets, int count)
 
   case OBJ_TRIANGLES:
     vrml_comment ("MolScript: T object");
-    output_appearance (FALSE, &(current_state->planecolour));
-    indent_newline();
-    vrml_node ("geometry IndexedFaceSet");
-    vrml_s_newline ("solid FALSE");
-    vrml_node ("coord Coordinate");
-    vrml_list ("point");
-    for (slot = 0; slot < count; slot++) vrml_v3 (triplets + slot);
-    vrml_finish_list();
-    vrml_finish_node();
-    indent_newline();
-    vrml_list ("coordIndex");
-    for (slot = 0; slot < count; slot += 3) vrml_tri_indices (slot, 0, 1, 2);
-    vrml_finish_list();
-    vrml_finish_node();
-    polygon_count += count / 3;
+    output_triangle_object (code, triplets, count);
     break;
 
   case OBJ_TRIANGLES_COLOURS:
     vrml_comment ("MolScript: TC object");
-    output_appearance (FALSE, &(current_state->planecolour));
-    indent_newline();
-    vrml_node ("geometry IndexedFaceSet");
-    vrml_s_newline ("solid FALSE");
-    vrml_node ("coord Coordinate");
-    vrml_list ("point");
-    for (slot = 0; slot < count; slot += 2) vrml_v3 (triplets + slot);
-    vrml_finish_list();
-    vrml_finish_node();
-    indent_newline();
-    vrml_list ("coordIndex");
-    for (slot = 0; slot < count/2; slot += 3) vrml_tri_indices (slot, 0, 1, 2);
-    vrml_finish_list();
-    indent_newline();
-    vrml_node ("color Color");
-    vrml_list ("color");
-    for (slot = 1; slot < count; slot += 2) {
-      v = triplets + slot;
-      rgb.x = v->x;
-      rgb.y = v->y;
-      rgb.z = v->z;
-      vrml_rgb_colour (&rgb);
-    }
-    vrml_finish_list();
-    vrml_finish_node();
-    vrml_finish_node();
-    polygon_count += count / 6;
+    output_triangle_object (code, triplets, count);
     break;
 
   case OBJ_TRIANGLES_NORMALS:
     vrml_comment ("MolScript: TN object");
-    output_appearance (FALSE, &(current_state->planecolour));
-    indent_newline();
-    vrml_node ("geometry IndexedFaceSet");
-    vrml_s_newline ("solid FALSE");
-    vrml_node ("coord Coordinate");
-    vrml_list ("point");
-    for (slot = 0; slot < count; slot += 2) vrml_v3 (triplets + slot);
-    vrml_finish_list();
-    vrml_finish_node();
-    indent_newline();
-    vrml_list ("coordIndex");
-    for (slot = 0; slot < count/2; slot += 3) vrml_tri_indices (slot, 0, 1, 2);
-    vrml_finish_list();
-    indent_newline();
-    vrml_node ("normal Normal");
-    vrml_list ("vector");
-    for (slot = 1; slot < count; slot += 2) vrml_v3_g3 (triplets + slot);
-    vrml_finish_list();
-    vrml_finish_node();
-    vrml_finish_node();
-    polygon_count += count / 6;
+    output_triangle_object (code, triplets, count);
     break;
 
   case OBJ_TRIANGLES_NORMALS_COLOURS:
     vrml_comment ("MolScript: TNC object");
-    output_appearance (FALSE, &(current_state->planecolour));
-    indent_newline();
-    vrml_node ("geometry IndexedFaceSet");
-    vrml_s_newline ("solid FALSE");
-    vrml_node ("coord Coordinate");
-    vrml_list ("point");
-    for (slot = 0; slot < count; slot += 3) vrml_v3 (triplets + slot);
-    vrml_finish_list();
-    vrml_finish_node();
-    indent_newline();
-    vrml_list ("coordIndex");
-    for (slot = 0; slot < count/3; slot += 3) vrml_tri_indices (slot, 0, 1, 2);
-    vrml_finish_list();
-    indent_newline();
-    vrml_node ("normal Normal");
-    vrml_list ("vector");
-    for (slot = 1; slot < count; slot += 3) vrml_v3_g3 (triplets + slot);
-    vrml_finish_list();
-    vrml_finish_node();
-    indent_newline();
-    vrml_node ("color Color");
-    vrml_list ("color");
-    for (slot = 2; slot < count; slot += 3) {
-      v = triplets + slot;
-      rgb.x = v->x;
-      rgb.y = v->y;
-      rgb.z = v->z;
-      vrml_rgb_colour (&rgb);
-    }
-    vrml_finish_list();
-    vrml_finish_node();
-    vrml_finish_node();
-    polygon_count += count / 9;
+    output_triangle_object (code, triplets, count);
     break;
 
   case OBJ_STRIP:
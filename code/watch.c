@@ -0,0 +1,537 @@
+/* watch.c
+
+   MolScript v2.1.2
+
+   Watch mode: render the input script again whenever it is changed.
+
+   The files read during a rendering, that is, the input script, the
+   input stream files given by '@' and the coordinate files, are noted
+   with their modification times and a checksum of their contents. The
+   files are polled, and when any of them has been changed, the script
+   is rendered again into the output file. A file which has been saved
+   without changes in its contents does not cause a new rendering.
+   Coordinate files which have not been changed are not read again;
+   copies of the molecules are taken from the cache.
+
+   The geometry computed by the costly commands (cartoons and surfaces)
+   is kept between the runs. A command is identified by the hash of its
+   tokens, the values of the current state, and the hash of the tokens
+   of the earlier commands, together with the contents of the coordinate
+   files read so far. The earlier commands which make geometry, or which
+   change only the state, are left out of the latter hash. A command
+   which is identified as one in the earlier run, has the same geometry;
+   the geometry is then reused instead of computed. So only the geometry
+   of the changed commands, and of the commands which depend on a changed
+   command, is computed again.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  geometry of unchanged commands reused
+*/
+
+#define _XOPEN_SOURCE 500	/* usleep, also under -ansi */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "clib/str_utils.h"
+
+#include "watch.h"
+#include "global.h"
+#include "lex.h"
+#include "coord.h"
+#include "graphics.h"
+#include "state.h"
+#include "molscript.tab.h"
+
+#ifdef IMAGE_SUPPORT
+#include "image.h"
+#endif
+
+
+/*============================================================*/
+#define POLL_INTERVAL 200000	/* microseconds */
+#define HASH_START 2166136261UL
+
+typedef struct s_watched_file watched_file;
+
+struct s_watched_file {
+  char *name;
+  time_t mtime;
+  off_t size;
+  unsigned long checksum;
+  watched_file *next;
+};
+
+typedef struct s_stored_geometry stored_geometry;
+
+struct s_stored_geometry {
+  unsigned long context;	/* hash of the earlier commands and state */
+  unsigned long command;	/* hash of the command */
+  int order;			/* geometry of the command, in order */
+  void *data;
+  size_t size;
+  stored_geometry *next;
+};
+
+static boolean watching = FALSE;
+static watched_file *watched = NULL;	/* files read by the current run */
+static watched_file *previous = NULL;	/* files read by the earlier run */
+
+static stored_geometry *kept = NULL;		/* geometry of the current run */
+static stored_geometry *reusable = NULL;	/* geometry of the earlier run */
+static unsigned long context, command, tokens, key;
+static boolean left_out;		/* command not part of the context */
+static boolean command_start;
+static boolean state_only;		/* command changes only the state */
+static int command_order, order;
+static int run_number = 0;
+static int geometry_count, reused_count;
+
+
+/*------------------------------------------------------------*/
+static unsigned long
+hash_bytes (unsigned long sum, const void *bytes, size_t count)
+     /* Continue the FNV-1a hash 'sum' with the bytes. */
+{
+  const unsigned char *b = (const unsigned char *) bytes;
+  size_t slot;
+
+  for (slot = 0; slot < count; slot++) {
+    sum ^= b[slot];
+    sum = (sum * 16777619UL) & 0xffffffffUL;
+  }
+  return sum;
+}
+
+
+/*------------------------------------------------------------*/
+static unsigned long
+hash_state (unsigned long sum)
+     /* Continue the hash with the values of the current state. */
+{
+  state *st = current_state;
+
+  assert (st);
+
+#define HASH(field) sum = hash_bytes (sum, &(st->field), sizeof (st->field))
+#define HASH_COLOUR(c) HASH (c.spec); HASH (c.x); HASH (c.y); HASH (c.z)
+
+  HASH (adaptivesegments);
+  HASH (bonddistance);
+  HASH (bondcross);
+  HASH (coilradius);
+  HASH (colourparts);
+  HASH (cylinderradius);
+  HASH (depthcue);
+  HASH (detaillevels);
+  HASH_COLOUR (emissivecolour);
+  HASH (helixthickness);
+  HASH (helixwidth);
+  HASH (hsbramp);
+  HASH (hsbrampreverse);
+  HASH (labelbackground);
+  HASH (labelcentre);
+  HASH (labelclip);
+  HASH (labelmasklength);
+  if (st->labelmasklength > 0)
+    sum = hash_bytes (sum, st->labelmask, st->labelmasklength * sizeof (int));
+  HASH (labeloffset);
+  HASH (labelrotation);
+  HASH (labelsize);
+  HASH (lightambientintensity);
+  HASH (lightattenuation);
+  HASH_COLOUR (lightcolour);
+  HASH (lightintensity);
+  HASH (lightradius);
+  HASH_COLOUR (linecolour);
+  HASH (linedash);
+  HASH (linewidth);
+  HASH (objecttransform);
+  HASH_COLOUR (planecolour);
+  HASH_COLOUR (plane2colour);
+  HASH (regularexpression);
+  HASH (segments);
+  HASH (segmentsize);
+  HASH (shading);
+  HASH (shadingexponent);
+  HASH (shininess);
+  HASH (smoothsteps);
+  HASH_COLOUR (specularcolour);
+  HASH (splinefactor);
+  HASH (stickradius);
+  HASH (sticktaper);
+  HASH (strandthickness);
+  HASH (strandwidth);
+  HASH (surfacegrid);
+  HASH (surfaceprobe);
+  HASH (transparency);
+
+#undef HASH
+#undef HASH_COLOUR
+
+  return sum;
+}
+
+
+/*------------------------------------------------------------*/
+static unsigned long
+file_checksum (const char *filename)
+     /* FNV-1a hash of the file contents; 0 if it could not be read. */
+{
+  FILE *file;
+  unsigned char buf[8192];
+  unsigned long sum = HASH_START;
+  size_t count;
+
+  assert (filename);
+
+  file = fopen (filename, "rb");
+  if (file == NULL) return 0;
+  while ((count = fread (buf, 1, sizeof (buf), file)) > 0)
+    sum = hash_bytes (sum, buf, count);
+  fclose (file);
+  return sum;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+delete_files (watched_file *wf)
+{
+  watched_file *next;
+
+  for ( ; wf; wf = next) {
+    next = wf->next;
+    free (wf->name);
+    free (wf);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static void
+delete_geometry (stored_geometry *g)
+{
+  stored_geometry *next;
+
+  for ( ; g; g = next) {
+    next = g->next;
+    free (g->data);
+    free (g);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+static watched_file *
+note_file (const char *filename)
+     /* Note that the file has been read by the current run. */
+{
+  watched_file *wf, *old;
+  struct stat st;
+
+  assert (filename);
+
+  if (stat (filename, &st) != 0) return NULL;
+
+  for (wf = watched; wf; wf = wf->next) {
+    if (str_eq (wf->name, filename)) return wf;
+  }
+
+  wf = malloc (sizeof (watched_file));
+  wf->name = str_clone (filename);
+  wf->mtime = st.st_mtime;
+  wf->size = st.st_size;
+
+  for (old = previous; old; old = old->next) {
+    if (str_eq (old->name, filename)) break;
+  }
+  if (old && (old->mtime == wf->mtime) && (old->size == wf->size)) {
+    wf->checksum = old->checksum;
+  } else {
+    wf->checksum = file_checksum (filename);
+  }
+
+  wf->next = watched;
+  watched = wf;
+  return wf;
+}
+
+
+/*------------------------------------------------------------*/
+void
+watch_file (const char *filename)
+     /* Note that the input stream or object file has been read. */
+{
+  assert (filename);
+
+  if (watching) note_file (filename);
+}
+
+
+/*------------------------------------------------------------*/
+void
+watch_data_file (const char *filename)
+     /*
+       Note that the coordinate file has been read; the geometry of
+       the later commands depends on its contents.
+     */
+{
+  watched_file *wf;
+
+  assert (filename);
+
+  if (! watching) return;
+  wf = note_file (filename);
+  if (wf) {
+    context = hash_bytes (context, &(wf->checksum), sizeof (unsigned long));
+  } else {
+    watch_inline_data();
+  }
+}
+
+
+/*------------------------------------------------------------*/
+void
+watch_inline_data (void)
+     /*
+       Note that data has been read from the input other than as
+       tokens; the geometry of the later commands cannot be reused.
+     */
+{
+  if (watching)
+    context = hash_bytes (context, &run_number, sizeof (int));
+}
+
+
+/*------------------------------------------------------------*/
+void
+watch_token (int token, const char *text)
+     /*
+       Note the token read from the input; a command ends with ';'.
+       The atom and residue colours and radii are not in the state,
+       so a command setting those is part of the context.
+     */
+{
+  assert (text);
+
+  if (! watching) return;
+
+  if (command_start) {
+    state_only = (token == SET) || (token == PUSH) || (token == POP);
+    command_start = FALSE;
+  }
+  if ((token == ATOMCOLOUR) || (token == ATOMRADIUS) ||
+      (token == RESIDUECOLOUR)) state_only = FALSE;
+
+  tokens = hash_bytes (tokens, text, strlen (text) + 1);
+  if (token != ';') return;
+
+  if (! left_out)		/* the earlier command */
+    context = hash_bytes (context, &command, sizeof (unsigned long));
+  command = tokens;
+  tokens = HASH_START;
+  command_start = TRUE;
+  left_out = state_only;
+  command_order = 0;
+}
+
+
+/*------------------------------------------------------------*/
+void *
+watch_recall (size_t *size)
+     /*
+       The geometry stored by the current command, in the same order,
+       by the earlier run; NULL if none. The current command is not
+       part of the context of the later commands; its geometry must
+       depend only on the context, the state and its own tokens. The
+       data remains owned by the watch mode.
+     */
+{
+  stored_geometry *g, **prev;
+
+  assert (size);
+
+  if (! watching) return NULL;
+
+  left_out = TRUE;
+  order = command_order++;
+  key = hash_state (context);
+  geometry_count++;
+
+#define SAME_GEOMETRY(g) (((g)->context == key) && \
+			  ((g)->command == command) && ((g)->order == order))
+
+  for (g = kept; g; g = g->next) {
+    if (SAME_GEOMETRY (g)) break;
+  }
+  if (g == NULL) {
+    for (prev = &reusable; *prev; prev = &((*prev)->next)) {
+      if (SAME_GEOMETRY (*prev)) break;
+    }
+    g = *prev;
+    if (g) {
+      *prev = g->next;
+      g->next = kept;
+      kept = g;
+    }
+  }
+
+#undef SAME_GEOMETRY
+
+  if (g == NULL) return NULL;
+  reused_count++;
+  *size = g->size;
+  return g->data;
+}
+
+
+/*------------------------------------------------------------*/
+void
+watch_store (void *data, size_t size)
+     /*
+       Keep the geometry computed by the current command when
+       'watch_recall' gave none. The data must have been allocated
+       by malloc; it is taken over by the watch mode.
+     */
+{
+  stored_geometry *g;
+
+  assert (data);
+
+  if (! watching) {
+    free (data);
+    return;
+  }
+
+  g = malloc (sizeof (stored_geometry));
+  g->context = key;
+  g->command = command;
+  g->order = order;
+  g->data = data;
+  g->size = size;
+  g->next = kept;
+  kept = g;
+}
+
+
+/*------------------------------------------------------------*/
+static boolean
+files_changed (void)
+     /*
+       Has any of the files read been changed? A file with a new
+       modification time but the same contents is noted as unchanged.
+     */
+{
+  watched_file *wf;
+  struct stat st;
+  unsigned long checksum;
+  boolean changed = FALSE;
+
+  for (wf = watched; wf; wf = wf->next) {
+    if (stat (wf->name, &st) != 0) continue; /* being replaced; wait */
+    if ((st.st_mtime == wf->mtime) && (st.st_size == wf->size)) continue;
+    checksum = file_checksum (wf->name);
+    if (checksum != wf->checksum) {
+      if (message_mode) fprintf (stderr, "changed: %s\n", wf->name);
+      changed = TRUE;
+    }
+    wf->mtime = st.st_mtime;
+    wf->size = st.st_size;
+    wf->checksum = checksum;
+  }
+
+  return changed;
+}
+
+
+/*------------------------------------------------------------*/
+static void
+render (char *input, char *output)
+{
+  jmp_buf env;
+  struct timeval start, end;
+
+  assert (input);
+  assert (output);
+
+  delete_files (previous);
+  previous = watched;
+  watched = NULL;
+  watch_file (input);
+
+  delete_geometry (reusable);
+  reusable = kept;
+  kept = NULL;
+  context = command = tokens = HASH_START;
+  left_out = FALSE;
+  command_start = TRUE;
+  command_order = order = 0;
+  run_number++;
+  geometry_count = reused_count = 0;
+
+  gettimeofday (&start, NULL);
+
+  if (setjmp (env)) {
+    fprintf (stderr, "Error: rendering failed; waiting for changes\n");
+    if (outfile && (outfile != stdout)) fclose (outfile);
+    outfile = stdout;
+    while (reusable) {		/* still reusable by the next run */
+      stored_geometry *g = reusable;
+      reusable = g->next;
+      g->next = kept;
+      kept = g;
+    }
+#ifdef IMAGE_SUPPORT
+    image_wait_plots();
+#endif
+    error_return = NULL;
+    return;
+  }
+  error_return = &env;
+
+  render_input (input, output);
+  error_return = NULL;
+
+  if (message_mode) {
+    gettimeofday (&end, NULL);
+    fprintf (stderr, "rendered %s in %.2f s, %i of %i geometries reused;"
+	     " waiting for changes\n", output,
+	     (end.tv_sec - start.tv_sec) + 1.0e-6 * (end.tv_usec - start.tv_usec),
+	     reused_count, geometry_count);
+  }
+}
+
+
+/*------------------------------------------------------------*/
+int
+watch_run (void)
+     /* Render the input script, and again whenever it is changed. */
+{
+  char *input, *output;
+
+  assert (input_filename);
+  assert (output_filename);
+
+  input = str_clone (input_filename);
+  output = str_clone (output_filename);
+
+  cache_molecules();
+  watching = TRUE;
+
+  for (;;) {
+    render (input, output);
+    do {
+      usleep (POLL_INTERVAL);
+    } while (! files_changed());
+    usleep (POLL_INTERVAL);	/* let the editor finish writing */
+  }
+
+  return 0;
+}
@@ -0,0 +1,25 @@
+/* watch.h
+
+   MolScript v2.1.2
+
+   Watch mode: render the input script again whenever it is changed.
+
+   Copyright (C) 1997-1998 Per Kraulis
+    18-Oct-2026  first attempts
+    18-Oct-2026  geometry of unchanged commands reused
+*/
+
+#ifndef WATCH_H
+#define WATCH_H 1
+
+#include <stddef.h>
+
+void watch_file (const char *filename);
+void watch_data_file (const char *filename);
+void watch_inline_data (void);
+void watch_token (int token, const char *text);
+void *watch_recall (size_t *size);
+void watch_store (void *data, size_t size);
+int watch_run (void);
+
+#endif
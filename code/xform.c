@@ -7,9 +7,11 @@
    Copyright (C) 1997-1998 Per Kraulis
      6-Apr-1997  split out of coord.c
     23-Jun-1997  added axis rotation
+    18-Oct-2026  selected atoms transformed as one array
 */
 
 #include <assert.h>
+#include <stdlib.h>
 
 #include "clib/angle.h"
 #include "clib/matrix3.h"
@@ -177,20 +179,44 @@ xform_atoms (void)
   at3d *at;
   int *flags;
   int count = 0;
+  vector3 *coords, *c;
   named_data *nd;
 
   assert (count_atom_selections() == 1);
 
-  flags = current_atom_sel->flags;
+  flags = current_atom_sel->flags;	/* gather the selected atoms */
   for (mol = first_molecule; mol; mol = mol->next) {
     for (res = mol->first; res; res = res->next) {
       for (at = res->first; at; at = at->next) {
-	if (*flags++) {
-	  matrix3_transform (&(at->xyz), xform);
-	  count++;
+	if (*flags++) count++;
+      }
+    }
+  }
+
+  if (count > 0) {
+    coords = malloc (count * sizeof (vector3));
+    c = coords;
+    flags = current_atom_sel->flags;
+    for (mol = first_molecule; mol; mol = mol->next) {
+      for (res = mol->first; res; res = res->next) {
+	for (at = res->first; at; at = at->next) {
+	  if (*flags++) *c++ = at->xyz;
+	}
+      }
+    }
+
+    matrix3_transform_array (coords, count, sizeof (vector3), xform);
+
+    c = coords;				/* and scatter them back */
+    flags = current_atom_sel->flags;
+    for (mol = first_molecule; mol; mol = mol->next) {
+      for (res = mol->first; res; res = res->next) {
+	for (at = res->first; at; at = at->next) {
+	  if (*flags++) at->xyz = *c++;
 	}
       }
     }
+    free (coords);
   }
 
   pop_atom_selection();